@@ -0,0 +1,3 @@
+CONFIG += tstool
+TARGET = tspfarm
+include(../tsduck.pri)
@@ -257,3 +257,166 @@ bool ts::json::Parse(ValuePtr& value, TextParser& parser, bool jsonOnly, Report&
         return true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Build a deep copy of a JSON value.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::json::Clone(const Value& value)
+{
+    switch (value.type()) {
+        case Type::True:
+            return ValuePtr(new True);
+        case Type::False:
+            return ValuePtr(new False);
+        case Type::String:
+            return ValuePtr(new String(value.toString()));
+        case Type::Number:
+            return ValuePtr(new Number(value.toInteger()));
+        case Type::Object: {
+            ValuePtr obj(new Object);
+            UStringList names;
+            value.getNames(names);
+            for (const auto& it : names) {
+                obj->add(it, Clone(value.value(it)));
+            }
+            return obj;
+        }
+        case Type::Array: {
+            ValuePtr arr(new Array);
+            for (size_t i = 0; i < value.size(); ++i) {
+                arr->set(Clone(value.at(i)));
+            }
+            return arr;
+        }
+        case Type::Null:
+        default:
+            return ValuePtr(new Null);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if two JSON values are identical.
+//----------------------------------------------------------------------------
+
+bool ts::json::Equal(const Value& value1, const Value& value2)
+{
+    if (value1.type() != value2.type() || value1.size() != value2.size()) {
+        return false;
+    }
+    switch (value1.type()) {
+        case Type::String:
+            return value1.toString() == value2.toString();
+        case Type::Number:
+            return value1.toInteger() == value2.toInteger();
+        case Type::Object: {
+            // Same number of fields, check that all fields of value1 exist in value2.
+            UStringList names;
+            value1.getNames(names);
+            for (const auto& it : names) {
+                // A missing field in value2 is returned as a null literal.
+                if (!Equal(value1.value(it), value2.value(it))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case Type::Array: {
+            for (size_t i = 0; i < value1.size(); ++i) {
+                if (!Equal(value1.at(i), value2.at(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case Type::Null:
+        case Type::True:
+        case Type::False:
+        default:
+            return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the differences between two JSON values as a JSON patch.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Escape a field name as a JSON pointer reference token (RFC 6901).
+    ts::UString PointerToken(const ts::UString& name)
+    {
+        ts::UString token(name);
+        token.substitute(u"~", u"~0");
+        token.substitute(u"/", u"~1");
+        return token;
+    }
+
+    // Add one operation in a JSON patch.
+    void AddOperation(ts::json::Value& patch, const ts::UString& op, const ts::UString& path, const ts::json::Value* value)
+    {
+        ts::json::ValuePtr operation(new ts::json::Object);
+        operation->add(u"op", op);
+        operation->add(u"path", path);
+        if (value != nullptr) {
+            operation->add(u"value", ts::json::Clone(*value));
+        }
+        patch.set(operation);
+    }
+
+    // Recursively compute the differences between two values at a given path.
+    void DiffValues(ts::json::Value& patch, const ts::UString& path, const ts::json::Value& from, const ts::json::Value& to)
+    {
+        if (from.type() != to.type()) {
+            AddOperation(patch, u"replace", path, &to);
+        }
+        else if (to.isObject()) {
+            ts::UStringList from_names;
+            ts::UStringList to_names;
+            from.getNames(from_names);
+            to.getNames(to_names);
+            const std::set<ts::UString> to_set(to_names.begin(), to_names.end());
+            const std::set<ts::UString> from_set(from_names.begin(), from_names.end());
+            for (const auto& it : from_names) {
+                if (to_set.count(it) == 0) {
+                    AddOperation(patch, u"remove", path + u"/" + PointerToken(it), nullptr);
+                }
+            }
+            for (const auto& it : to_names) {
+                const ts::UString sub(path + u"/" + PointerToken(it));
+                if (from_set.count(it) == 0) {
+                    AddOperation(patch, u"add", sub, &to.value(it));
+                }
+                else {
+                    DiffValues(patch, sub, from.value(it), to.value(it));
+                }
+            }
+        }
+        else if (to.isArray()) {
+            const size_t common = std::min(from.size(), to.size());
+            for (size_t i = 0; i < common; ++i) {
+                DiffValues(patch, ts::UString::Format(u"%s/%d", {path, i}), from.at(i), to.at(i));
+            }
+            // Trailing elements are removed from the end so that each index remains valid.
+            for (size_t i = from.size(); i > common; --i) {
+                AddOperation(patch, u"remove", ts::UString::Format(u"%s/%d", {path, i - 1}), nullptr);
+            }
+            for (size_t i = common; i < to.size(); ++i) {
+                AddOperation(patch, u"add", path + u"/-", &to.at(i));
+            }
+        }
+        else if (!ts::json::Equal(from, to)) {
+            AddOperation(patch, u"replace", path, &to);
+        }
+    }
+}
+
+ts::json::ValuePtr ts::json::Diff(const Value& from, const Value& to)
+{
+    ValuePtr patch(new Array);
+    DiffValues(*patch, UString(), from, to);
+    return patch;
+}
@@ -157,5 +157,36 @@ namespace ts {
         //! @return True if @a name contains inline JSON content, false otherwise.
         //!
         TSDUCKDLL bool IsInlineJSON(const UString& name);
+
+        //!
+        //! Build a deep copy of a JSON value.
+        //! @param [in] value The JSON value to copy.
+        //! @return A smart pointer to a new independent JSON value with the same content as @a value.
+        //!
+        TSDUCKDLL ValuePtr Clone(const Value& value);
+
+        //!
+        //! Check if two JSON values are identical, in type and content.
+        //! Fields in objects are compared without consideration of their order.
+        //! @param [in] value1 A JSON value.
+        //! @param [in] value2 Another JSON value.
+        //! @return True if @a value1 and @a value2 are identical.
+        //!
+        TSDUCKDLL bool Equal(const Value& value1, const Value& value2);
+
+        //!
+        //! Compute the differences between two JSON values as a JSON patch.
+        //! The returned value is a JSON array of "add", "remove" and "replace" operations,
+        //! as defined by RFC 6902. When the patch is applied on @a from, the result is @a to.
+        //! Arrays are compared element by element; elements which are added or removed at
+        //! the end of an array are reported as such but insertions in the middle of an array
+        //! are reported as a sequence of replacements.
+        //! @param [in] from The original JSON value.
+        //! @param [in] to The new JSON value.
+        //! @return A smart pointer to a JSON array containing the patch. The array is empty
+        //! when @a from and @a to are identical.
+        //! @see https://tools.ietf.org/html/rfc6902
+        //!
+        TSDUCKDLL ValuePtr Diff(const Value& from, const Value& to);
     }
 }
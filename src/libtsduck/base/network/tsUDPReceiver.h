@@ -91,6 +91,11 @@ namespace ts {
                              const AbortInterface* abort = nullptr,
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr) override;
+        virtual bool receiveBatch(Datagram* msgs,
+                                  size_t max_count,
+                                  size_t& ret_count,
+                                  const AbortInterface* abort = nullptr,
+                                  Report& report = CERR) override;
 
     private:
         bool             _with_short_options;
@@ -108,5 +113,8 @@ namespace ts {
         SocketAddress    _use_source;         // Filter on this socket address of sender (can be a simple filter of an SSM source).
         SocketAddress    _first_source;       // Socket address of first received packet.
         SocketAddressSet _sources;            // Set of all detected packet sources.
+
+        // Check if a received message matches the filtering criteria.
+        bool checkMessage(const SocketAddress& sender, const SocketAddress& destination, MicroSecond timestamp, Report& report);
     };
 }
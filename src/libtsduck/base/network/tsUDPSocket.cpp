@@ -31,9 +31,25 @@
 #include "tsNullReport.h"
 TSDUCK_SOURCE;
 
-// Network timestampting feature in Linux.
+// Network timestampting, segmentation offload and zero-copy features in Linux.
 #if defined(TS_LINUX)
 #include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#include <netinet/udp.h>
+#include <poll.h>
+// Not defined in older system headers.
+#if !defined(UDP_SEGMENT)
+    #define UDP_SEGMENT 103
+#endif
+#if !defined(SO_ZEROCOPY)
+    #define SO_ZEROCOPY 60
+#endif
+#if !defined(MSG_ZEROCOPY)
+    #define MSG_ZEROCOPY 0x4000000
+#endif
+#if !defined(SO_EE_ORIGIN_ZEROCOPY)
+    #define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
 #endif
 
 // Furiously idiotic Windows feature, see comment in receiveOne()
@@ -41,6 +57,26 @@ TSDUCK_SOURCE;
 volatile ::LPFN_WSARECVMSG ts::UDPSocket::_wsaRevcMsg = 0;
 #endif
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::UDPSocket::MAX_BATCH_COUNT;
+#endif
+
+// Size of ancillary data buffer per message in batched receive operations.
+// Large enough for IP_PKTINFO and SO_TIMESTAMPNS.
+#define BATCH_ANCIL_SIZE 256
+
+// Maximum number of segments and total payload size in one segmentation offload operation (Linux kernel limits).
+#define GSO_MAX_SEGMENTS 64
+#define GSO_MAX_PAYLOAD  (65535 - 8 - 20)
+
+// With zero-copy, each memory page of the user buffers becomes one fragment of a kernel socket
+// buffer and the number of fragments is limited (MAX_SKB_FRAGS, 17 by default). Limit the size
+// to 15 pages so that a contiguous buffer fits, whatever its alignment.
+#define ZEROCOPY_MAX_PAYLOAD (15 * 4096)
+
+// Timeout in milliseconds when waiting for zero-copy completion notifications.
+#define ZEROCOPY_TIMEOUT 1000
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -51,7 +87,11 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     _local_address(),
     _default_destination(),
     _mcast(),
-    _ssmcast()
+    _ssmcast(),
+    _send_gso(false),
+    _zero_copy(false),
+    _zc_next_id(0),
+    _zc_pending()
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -78,6 +118,11 @@ ts::UDPSocket::~UDPSocket()
 
 bool ts::UDPSocket::open(Report& report)
 {
+    // Socket options are reset on a new socket.
+    _send_gso = _zero_copy = false;
+    _zc_next_id = 0;
+    _zc_pending.clear();
+
     // Create a datagram socket.
     if (!createSocket(PF_INET, SOCK_DGRAM, IPPROTO_UDP, report)) {
         return false;
@@ -101,8 +146,9 @@ bool ts::UDPSocket::open(Report& report)
 
 bool ts::UDPSocket::close(Report& report)
 {
-    // Leave all multicast groups.
+    // Leave all multicast groups. Wait for pending zero-copy transmissions before closing the socket.
     if (isOpen()) {
+        waitZeroCopy(report);
         dropMembership(report);
     }
 
@@ -244,6 +290,54 @@ bool ts::UDPSocket::setReceiveTimestamps(bool on, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Enable or disable UDP segmentation offload in sendBatch().
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setSendSegmentation(bool on, Report& report)
+{
+#if defined(TS_LINUX)
+    // The segment size is specified in each send operation. Setting a null default
+    // segment size on the socket checks that the feature is supported by the kernel.
+    int size = 0;
+    if (on && ::setsockopt(getSocket(), SOL_UDP, UDP_SEGMENT, &size, sizeof(size)) != 0) {
+        report.error(u"socket option UDP_SEGMENT: " + SysSocketErrorCodeMessage());
+        return false;
+    }
+    _send_gso = on;
+    return true;
+#else
+    if (on) {
+        report.error(u"UDP segmentation offload is not supported on this system");
+    }
+    return !on;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Enable or disable zero-copy transmission in sendBatch().
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setZeroCopy(bool on, Report& report)
+{
+#if defined(TS_LINUX)
+    int enable = int(on);
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0) {
+        report.error(u"socket option SO_ZEROCOPY: " + SysSocketErrorCodeMessage());
+        return false;
+    }
+    _zero_copy = on;
+    return true;
+#else
+    if (on) {
+        report.error(u"zero-copy transmission is not supported on this system");
+    }
+    return !on;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Enable or disable the broadcast option.
 //----------------------------------------------------------------------------
@@ -402,6 +496,46 @@ bool ts::UDPSocket::dropMembership(Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// UNIX: browse ancillary data of a received message.
+//----------------------------------------------------------------------------
+
+#if !defined(TS_WINDOWS)
+namespace {
+    void GetAncillaryData(::msghdr& hdr, uint16_t port, ts::SocketAddress& destination, ts::MicroSecond* timestamp)
+    {
+        // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
+        TS_PUSH_WARNING()
+        TS_GCC_NOWARNING(zero-as-null-pointer-constant)
+
+        for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+
+            // Look for destination IP address.
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
+                const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
+                destination = ts::SocketAddress(info->ipi_addr, port);
+            }
+
+            // On Linux, look for receive timestamp.
+#if defined(TS_LINUX)
+            else if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
+                // System time stamp in nanosecond.
+                const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
+                const ts::NanoSecond nano = ts::NanoSecond(ts->tv_sec) * ts::NanoSecPerSec + ts::NanoSecond(ts->tv_nsec);
+                // System time stamp is valid when not zero, convert it to micro-seconds.
+                if (nano != 0) {
+                    *timestamp = nano / ts::NanoSecPerMicroSec;
+                }
+            }
+#endif
+        }
+
+        TS_POP_WARNING()
+    }
+}
+#endif
+
+
 //----------------------------------------------------------------------------
 // Send a message to a destination address and port.
 //----------------------------------------------------------------------------
@@ -424,6 +558,292 @@ bool ts::UDPSocket::send(const void* data, size_t size, const SocketAddress& des
 }
 
 
+//----------------------------------------------------------------------------
+// Send several messages to a destination address and port.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendBatch(const void* const data[], const size_t sizes[], size_t count, const SocketAddress& dest, Report& report)
+{
+#if defined(TS_LINUX)
+    ::sockaddr addr;
+    dest.copy(addr);
+
+    ::mmsghdr hdr[MAX_BATCH_COUNT];
+    ::iovec vec[MAX_BATCH_COUNT];
+    bool success = true;
+
+    // Collect the notifications of previous zero-copy transmissions, without waiting.
+    if (!_zc_pending.empty()) {
+        readZeroCopy(false, report);
+    }
+
+    while (success && count > 0) {
+
+        // With segmentation offload, send as many messages of identical size as possible at once.
+        size_t chunk = 0;
+        if (_send_gso) {
+            success = sendSegmented(data, sizes, count, dest, chunk, report);
+        }
+
+        // Otherwise, or if segmentation offload is not usable, build a message header for each message to send.
+        if (success && chunk == 0) {
+            chunk = std::min(count, MAX_BATCH_COUNT);
+            TS_ZERO(hdr);
+            for (size_t i = 0; i < chunk; ++i) {
+                vec[i].iov_base = const_cast<void*>(data[i]);
+                vec[i].iov_len = sizes[i];
+                hdr[i].msg_hdr.msg_name = &addr;
+                hdr[i].msg_hdr.msg_namelen = sizeof(addr);
+                hdr[i].msg_hdr.msg_iov = &vec[i];
+                hdr[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            // The system may send less messages than requested.
+            for (size_t sent = 0; success && sent < chunk; ) {
+                const int n = ::sendmmsg(getSocket(), hdr + sent, static_cast<unsigned int>(chunk - sent), 0);
+                if (n < 0) {
+                    report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage());
+                    success = false;
+                }
+                else {
+                    sent += size_t(n);
+                }
+            }
+        }
+
+        data += chunk;
+        sizes += chunk;
+        count -= chunk;
+    }
+
+    return success;
+#else
+    // No batched send, one message at a time.
+    for (size_t i = 0; i < count; ++i) {
+        if (!send(data[i], sizes[i], dest, report)) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Send messages of identical size in one segmentation offload operation.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendSegmented(const void* const data[], const size_t sizes[], size_t count, const SocketAddress& dest, size_t& sent, Report& report)
+{
+    sent = 0;
+
+#if defined(TS_LINUX)
+
+    // All segments have the size of the first message, except the last one which can be shorter.
+    const size_t seg_size = sizes[0];
+    if (seg_size == 0 || seg_size > GSO_MAX_PAYLOAD) {
+        return true;
+    }
+    const size_t max_count = std::min<size_t>({count, GSO_MAX_SEGMENTS, (_zero_copy && seg_size <= ZEROCOPY_MAX_PAYLOAD ? ZEROCOPY_MAX_PAYLOAD : GSO_MAX_PAYLOAD) / seg_size});
+
+    ::iovec vec[GSO_MAX_SEGMENTS];
+    size_t vec_count = 0;
+    const uint8_t* area_begin = reinterpret_cast<const uint8_t*>(data[0]);
+    const uint8_t* area_end = area_begin;
+    while (vec_count < max_count && sizes[vec_count] <= seg_size) {
+        const uint8_t* const base = reinterpret_cast<const uint8_t*>(data[vec_count]);
+        area_begin = std::min(area_begin, base);
+        area_end = std::max(area_end, base + sizes[vec_count]);
+        vec[vec_count].iov_base = const_cast<void*>(data[vec_count]);
+        vec[vec_count].iov_len = sizes[vec_count];
+        if (sizes[vec_count++] < seg_size) {
+            break; // a shorter message is the last segment
+        }
+    }
+
+    // Build a message header with the segment size as ancillary data.
+    ::sockaddr addr;
+    dest.copy(addr);
+    uint8_t ancil_data[CMSG_SPACE(sizeof(uint16_t))];
+    TS_ZERO(ancil_data);
+
+    ::msghdr hdr;
+    TS_ZERO(hdr);
+    hdr.msg_name = &addr;
+    hdr.msg_namelen = sizeof(addr);
+    hdr.msg_iov = vec;
+    hdr.msg_iovlen = vec_count;
+    hdr.msg_control = ancil_data;
+    hdr.msg_controllen = sizeof(ancil_data);
+
+    ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const uint16_t gso_size = uint16_t(seg_size);
+    ::memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+    // Send all segments at once. Zero-copy may fail on lack of kernel memory or when
+    // the messages are scattered over too many memory pages, retry with copy.
+    bool zero_copy = _zero_copy;
+    SysSocketSignedSizeType status = ::sendmsg(getSocket(), &hdr, zero_copy ? MSG_ZEROCOPY : 0);
+    if (status < 0 && zero_copy && (LastSysSocketErrorCode() == ENOBUFS || LastSysSocketErrorCode() == EMSGSIZE)) {
+        zero_copy = false;
+        status = ::sendmsg(getSocket(), &hdr, 0);
+    }
+
+    if (status >= 0) {
+        // Each successful zero-copy send will be notified in the error queue of the socket.
+        // The memory area remains in use until then.
+        if (zero_copy) {
+            _zc_pending.push_back({area_begin, area_end, _zc_next_id++});
+        }
+        sent = vec_count;
+        return true;
+    }
+
+    const SysSocketErrorCode err = LastSysSocketErrorCode();
+    if (err == EIO || err == EINVAL || err == ENOPROTOOPT || err == EOPNOTSUPP) {
+        // Segmentation offload not supported on the network interface, revert to individual datagrams.
+        report.verbose(u"UDP segmentation offload not usable (%s), sending individual datagrams", {SysSocketErrorCodeMessage(err)});
+        _send_gso = false;
+        return true;
+    }
+    report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage(err));
+    return false;
+
+#else
+    return true;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a pending zero-copy send operation overlaps a memory area.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::zeroCopyOverlaps(const uint8_t* begin, const uint8_t* end) const
+{
+    for (const auto& area : _zc_pending) {
+        if (area.begin < end && begin < area.end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Check or wait for the completion of zero-copy send operations.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::zeroCopyBusy(const void* address, size_t size, Report& report)
+{
+    const uint8_t* const begin = reinterpret_cast<const uint8_t*>(address);
+    if (!_zc_pending.empty()) {
+        readZeroCopy(false, report);
+    }
+    return zeroCopyOverlaps(begin, begin + size);
+}
+
+bool ts::UDPSocket::waitZeroCopy(const void* address, size_t size, Report& report)
+{
+    const uint8_t* const begin = reinterpret_cast<const uint8_t*>(address);
+    while (zeroCopyOverlaps(begin, begin + size)) {
+        if (!readZeroCopy(true, report)) {
+            // The notifications will probably never come, forget all pending operations.
+            report.error(u"%d zero-copy transmission completions lost", {_zc_pending.size()});
+            _zc_pending.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::UDPSocket::waitZeroCopy(Report& report)
+{
+    while (!_zc_pending.empty()) {
+        if (!readZeroCopy(true, report)) {
+            report.error(u"%d zero-copy transmission completions lost", {_zc_pending.size()});
+            _zc_pending.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read zero-copy completion notifications.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::readZeroCopy(bool wait, Report& report)
+{
+#if defined(TS_LINUX)
+    for (bool got_one = false; !_zc_pending.empty(); ) {
+
+        // Read a notification from the error queue of the socket, without blocking.
+        uint8_t ancil_data[BATCH_ANCIL_SIZE];
+        ::msghdr hdr;
+        TS_ZERO(hdr);
+        hdr.msg_control = ancil_data;
+        hdr.msg_controllen = sizeof(ancil_data);
+
+        if (::recvmsg(getSocket(), &hdr, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            const SysSocketErrorCode err = LastSysSocketErrorCode();
+            if ((err == EAGAIN || err == EWOULDBLOCK) && (got_one || !wait)) {
+                // No more notification for now.
+                return true;
+            }
+            else if (err == EAGAIN || err == EWOULDBLOCK) {
+                // No notification yet, wait for the error queue to become non-empty (always reported as POLLERR).
+                ::pollfd pfd;
+                TS_ZERO(pfd);
+                pfd.fd = getSocket();
+                const int count = ::poll(&pfd, 1, ZEROCOPY_TIMEOUT);
+                if (count == 0) {
+                    report.error(u"timeout waiting for zero-copy transmission completion");
+                    return false;
+                }
+                else if (count < 0 && LastSysSocketErrorCode() != EINTR) {
+                    report.error(u"error waiting for zero-copy transmission completion: " + SysSocketErrorCodeMessage());
+                    return false;
+                }
+            }
+            else if (err != EINTR) {
+                report.error(u"error reading zero-copy notification: " + SysSocketErrorCodeMessage(err));
+                return false;
+            }
+            continue;
+        }
+
+        // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
+        TS_PUSH_WARNING()
+        TS_GCC_NOWARNING(zero-as-null-pointer-constant)
+
+        // Each notification contains a range of completed operations.
+        for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) {
+                const ::sock_extended_err* serr = reinterpret_cast<const ::sock_extended_err*>(CMSG_DATA(cmsg));
+                if (serr->ee_errno == 0 && serr->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                    // Sequence ids from ee_info to ee_data (inclusive) are completed. They may wrap around.
+                    const uint32_t first = serr->ee_info;
+                    const uint32_t range = serr->ee_data - first;
+                    _zc_pending.erase(std::remove_if(_zc_pending.begin(), _zc_pending.end(),
+                                                     [first, range](const ZeroCopyArea& area) { return area.id - first <= range; }),
+                                      _zc_pending.end());
+                    got_one = true;
+                }
+            }
+        }
+
+        TS_POP_WARNING()
+    }
+#endif
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
@@ -480,6 +900,80 @@ bool ts::UDPSocket::receive(void* data,
 }
 
 
+//----------------------------------------------------------------------------
+// Receive several messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::receiveBatch(Datagram* msgs, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    ret_count = 0;
+    if (msgs == nullptr || max_count == 0) {
+        report.error(u"no buffer to receive UDP messages");
+        return false;
+    }
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+
+        // Wait for at least one message.
+        const SysSocketErrorCode err = receiveMany(msgs, std::min(max_count, MAX_BATCH_COUNT), ret_count, report);
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            return false;
+        }
+        else if (err == SYS_SUCCESS) {
+            // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
+            size_t count = 0;
+            for (size_t i = 0; i < ret_count; ++i) {
+                if (msgs[i].size > 0 || msgs[i].sender.hasAddress()) {
+                    MoveDatagram(msgs[count++], msgs[i]);
+                }
+            }
+            ret_count = count;
+            if (ret_count > 0) {
+                return true;
+            }
+        }
+#if !defined(TS_WINDOWS)
+        else if (err == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+#endif
+        else {
+            // Abort on non-interrupt errors.
+            report.error(u"error receiving from UDP socket: %s", {SysSocketErrorCodeMessage(err)});
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Move a received message to another entry of a batch.
+//----------------------------------------------------------------------------
+
+void ts::UDPSocket::MoveDatagram(Datagram& to, Datagram& from)
+{
+    if (&to == &from) {
+        // Nothing to do.
+    }
+    else if (to.data != nullptr && from.data != nullptr && from.size <= to.max_size) {
+        // Move the message content, each buffer remains at the same place in the batch.
+        ::memmove(to.data, from.data, from.size);
+        to.size = from.size;
+        to.sender = from.sender;
+        to.destination = from.destination;
+        to.timestamp = from.timestamp;
+    }
+    else {
+        // Buffers of different sizes, swap the buffers.
+        std::swap(to, from);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Perform one receive operation. Hide the system mud.
 //----------------------------------------------------------------------------
@@ -595,34 +1089,8 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
         return LastSysSocketErrorCode();
     }
 
-    // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
-    TS_PUSH_WARNING()
-    TS_GCC_NOWARNING(zero-as-null-pointer-constant)
-
     // Browse returned ancillary data.
-    for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
-
-        // Look for destination IP address.
-        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
-            const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
-            destination = SocketAddress(info->ipi_addr, _local_address.port());
-        }
-
-        // On Linux, look for receive timestamp.
-#if defined(TS_LINUX)
-        else if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
-            // System time stamp in nanosecond.
-            const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
-            const NanoSecond nano = NanoSecond(ts->tv_sec) * NanoSecPerSec + NanoSecond(ts->tv_nsec);
-            // System time stamp is valid when not zero, convert it to micro-seconds.
-            if (nano != 0) {
-                *timestamp = nano / NanoSecPerMicroSec;
-            }
-        }
-#endif
-    }
-
-    TS_POP_WARNING()
+    GetAncillaryData(hdr, _local_address.port(), destination, timestamp);
 
 #endif // Windows vs. UNIX
 
@@ -632,3 +1100,64 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
 
     return SYS_SUCCESS;
 }
+
+
+//----------------------------------------------------------------------------
+// Perform one batched receive operation.
+//----------------------------------------------------------------------------
+
+ts::SysSocketErrorCode ts::UDPSocket::receiveMany(Datagram* msgs, size_t max_count, size_t& ret_count, Report& report)
+{
+    ret_count = 0;
+
+#if defined(TS_LINUX)
+
+    // Linux implementation, use recvmmsg() to get all available messages at once.
+    ::mmsghdr hdr[MAX_BATCH_COUNT];
+    ::iovec vec[MAX_BATCH_COUNT];
+    ::sockaddr sender_sock[MAX_BATCH_COUNT];
+    uint8_t ancil_data[MAX_BATCH_COUNT][BATCH_ANCIL_SIZE];
+
+    max_count = std::min(max_count, MAX_BATCH_COUNT);
+    TS_ZERO(hdr);
+    TS_ZERO(sender_sock);
+
+    for (size_t i = 0; i < max_count; ++i) {
+        vec[i].iov_base = msgs[i].data;
+        vec[i].iov_len = msgs[i].max_size;
+        hdr[i].msg_hdr.msg_name = &sender_sock[i];
+        hdr[i].msg_hdr.msg_namelen = sizeof(sender_sock[i]);
+        hdr[i].msg_hdr.msg_iov = &vec[i];
+        hdr[i].msg_hdr.msg_iovlen = 1;
+        hdr[i].msg_hdr.msg_control = ancil_data[i];
+        hdr[i].msg_hdr.msg_controllen = sizeof(ancil_data[i]);
+    }
+
+    // Wait for the first message, then get all immediately available messages.
+    const int count = ::recvmmsg(getSocket(), hdr, static_cast<unsigned int>(max_count), MSG_WAITFORONE, nullptr);
+    if (count < 0) {
+        return LastSysSocketErrorCode();
+    }
+
+    for (size_t i = 0; i < size_t(count); ++i) {
+        msgs[i].size = size_t(hdr[i].msg_len);
+        msgs[i].sender = SocketAddress(sender_sock[i]);
+        msgs[i].destination.clear();
+        msgs[i].timestamp = -1;
+        GetAncillaryData(hdr[i].msg_hdr, _local_address.port(), msgs[i].destination, &msgs[i].timestamp);
+    }
+    ret_count = size_t(count);
+    return SYS_SUCCESS;
+
+#else
+
+    // Other systems, one message at a time.
+    msgs[0].timestamp = -1;
+    const SysSocketErrorCode err = receiveOne(msgs[0].data, msgs[0].max_size, msgs[0].size, msgs[0].sender, msgs[0].destination, report, &msgs[0].timestamp);
+    if (err == SYS_SUCCESS) {
+        ret_count = 1;
+    }
+    return err;
+
+#endif
+}
@@ -56,6 +56,40 @@ namespace ts {
         //!
         UDPSocket(bool auto_open = false, Report& report = CERR);
 
+        //!
+        //! Maximum number of datagrams which are sent or received in one system call.
+        //! Larger batches are split.
+        //!
+        static constexpr size_t MAX_BATCH_COUNT = 64;
+
+        //!
+        //! Description of a datagram in a batched receive operation.
+        //! @see receiveBatch()
+        //!
+        class TSDUCKDLL Datagram
+        {
+        public:
+            void*         data;         //!< [in] Address of the buffer for the received message.
+            size_t        max_size;     //!< [in] Size in bytes of the reception buffer.
+            size_t        size;         //!< [out] Size in bytes of the received message.
+            SocketAddress sender;       //!< [out] Socket address of the sender.
+            SocketAddress destination;  //!< [out] Socket address of the packet destination.
+            MicroSecond   timestamp;    //!< [out] Receive timestamp in micro-seconds, negative if not available.
+
+            //!
+            //! Constructor.
+            //! @param [in] data_ Address of the buffer for the received message.
+            //! @param [in] max_size_ Size in bytes of the reception buffer.
+            //!
+            Datagram(void* data_ = nullptr, size_t max_size_ = 0) :
+                data(data_), max_size(max_size_), size(0), sender(), destination(), timestamp(-1) {}
+
+            //! @cond nodoxygen
+            Datagram(const Datagram&) = default;
+            Datagram& operator=(const Datagram&) = default;
+            //! @endcond
+        };
+
         //!
         //! Destructor.
         //!
@@ -204,6 +238,74 @@ namespace ts {
         //!
         bool setReceiveTimestamps(bool on, Report& report = CERR);
 
+        //!
+        //! Enable or disable UDP segmentation offload in sendBatch().
+        //!
+        //! When enabled, consecutive messages of identical size are passed to the kernel in one
+        //! single large buffer. The kernel or the network interface splits this buffer into individual
+        //! datagrams (socket option UDP_SEGMENT, also known as UDP GSO, Generic Segmentation Offload).
+        //! If the network interface rejects the operation, sendBatch() silently reverts to individual
+        //! datagrams.
+        //!
+        //! Currently, this option is supported on Linux only (kernel 4.18 or higher).
+        //!
+        //! @param [in] on If true, segmentation offload is used in sendBatch(). Otherwise, it is disabled.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or if the feature is not supported on this system.
+        //!
+        bool setSendSegmentation(bool on, Report& report = CERR);
+
+        //!
+        //! Enable or disable zero-copy transmission in sendBatch().
+        //!
+        //! When enabled, the kernel directly reads the messages from the caller's buffers, without
+        //! copy (socket option SO_ZEROCOPY, flag MSG_ZEROCOPY). Zero-copy is used only with segmentation
+        //! offload (see setSendSegmentation()) because it is not efficient with small buffers.
+        //! The transmission completes asynchronously, after sendBatch() returns. The caller shall not
+        //! modify or free the memory of the messages before the transmission is completed, see
+        //! zeroCopyBusy() and waitZeroCopy(). The socket waits for all pending transmissions when closed.
+        //! Zero-copy is most efficient when consecutive messages are contiguous in memory. Messages
+        //! which are scattered over too many memory pages are silently copied.
+        //!
+        //! Currently, this option is supported on Linux only (kernel 5.0 or higher).
+        //!
+        //! @param [in] on If true, zero-copy is used in sendBatch(). Otherwise, it is disabled.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or if the feature is not supported on this system.
+        //!
+        bool setZeroCopy(bool on, Report& report = CERR);
+
+        //!
+        //! Check if a memory area is still used by zero-copy transmissions from sendBatch().
+        //! Pending completion notifications are read without blocking.
+        //! @param [in] address Address of the memory area.
+        //! @param [in] size Size in bytes of the memory area.
+        //! @param [in,out] report Where to report error.
+        //! @return True if some zero-copy transmission still uses the memory area.
+        //! @see setZeroCopy()
+        //!
+        bool zeroCopyBusy(const void* address, size_t size, Report& report = CERR);
+
+        //!
+        //! Wait until a memory area is no longer used by zero-copy transmissions from sendBatch().
+        //! When the completion of some transmissions is not notified by the system, they are
+        //! reported as lost and the memory area is considered as released.
+        //! @param [in] address Address of the memory area.
+        //! @param [in] size Size in bytes of the memory area.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or timeout.
+        //! @see setZeroCopy()
+        //!
+        bool waitZeroCopy(const void* address, size_t size, Report& report = CERR);
+
+        //!
+        //! Wait for the completion of all zero-copy transmissions from sendBatch().
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or timeout.
+        //! @see setZeroCopy()
+        //!
+        bool waitZeroCopy(Report& report = CERR);
+
         //!
         //! Enable or disable the broadcast option.
         //!
@@ -305,6 +407,36 @@ namespace ts {
         //!
         virtual bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Send several messages to a destination address and port.
+        //!
+        //! On Linux, the messages are sent using as few system calls as possible (sendmmsg()).
+        //! On other systems, the messages are sent one by one.
+        //!
+        //! @param [in] data Array of @a count addresses of messages to send.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in] destination Socket address of the destination.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendBatch(const void* const data[], const size_t sizes[], size_t count, const SocketAddress& destination, Report& report = CERR);
+
+        //!
+        //! Send several messages to the default destination address and port.
+        //!
+        //! @param [in] data Array of @a count addresses of messages to send.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see sendBatch(const void* const[], const size_t[], size_t, const SocketAddress&, Report&)
+        //!
+        bool sendBatch(const void* const data[], const size_t sizes[], size_t count, Report& report = CERR)
+        {
+            return sendBatch(data, sizes, count, _default_destination, report);
+        }
+
         //!
         //! Receive a message.
         //!
@@ -332,10 +464,44 @@ namespace ts {
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr);
 
+        //!
+        //! Receive several messages.
+        //!
+        //! Wait for at least one message, then return all messages which are immediately
+        //! available, up to @a max_count. On Linux, the messages are received using one
+        //! single system call (recvmmsg()). On other systems, one message is returned at a time.
+        //!
+        //! @param [in,out] msgs Array of @a max_count datagram descriptions. The fields @a data
+        //! and @a max_size must be set on input. The other fields are returned.
+        //! @param [in] max_count Maximum number of messages to receive.
+        //! @param [out] ret_count Number of received messages in @a msgs.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see setReceiveTimestamps()
+        //!
+        virtual bool receiveBatch(Datagram* msgs,
+                                  size_t max_count,
+                                  size_t& ret_count,
+                                  const AbortInterface* abort = nullptr,
+                                  Report& report = CERR);
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
 
+    protected:
+        //!
+        //! Move a received message to another entry of a batch.
+        //! Used to remove messages from a batch. When possible, the content of the message
+        //! is moved into the buffer of @a to so that each buffer keeps its position in the batch.
+        //! Otherwise, the two datagram descriptions are swapped.
+        //! @param [in,out] to Destination datagram description.
+        //! @param [in,out] from Source datagram description.
+        //!
+        static void MoveDatagram(Datagram& to, Datagram& from);
+
     private:
         // Encapsulate a Plain Old C Structure.
         template <typename STRUCT>
@@ -382,6 +548,14 @@ namespace ts {
             }
         };
 
+        // Memory area of a pending zero-copy send operation.
+        struct ZeroCopyArea
+        {
+            const uint8_t* begin;  // First byte of the area.
+            const uint8_t* end;    // After last byte of the area.
+            uint32_t       id;     // Sequence id of the send operation.
+        };
+
         // Set of established multicast groups.
         typedef std::set<MReq> MReqSet;
         typedef std::set<SSMReq> SSMReqSet;
@@ -391,10 +565,28 @@ namespace ts {
         SocketAddress _default_destination;
         MReqSet       _mcast;    // Current set of multicast memberships
         SSMReqSet     _ssmcast;  // Current set of source-specific multicast memberships
+        bool          _send_gso;     // Use UDP segmentation offload in sendBatch().
+        bool          _zero_copy;    // Use zero-copy transmission in sendBatch().
+        uint32_t      _zc_next_id;   // Sequence id of the next zero-copy send operation (counted by the kernel).
+        std::deque<ZeroCopyArea> _zc_pending; // Pending zero-copy send operations, in sequence order.
 
         // Perform one receive operation. Hide the system mud.
         SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Report& report, MicroSecond* timestamp);
 
+        // Send messages of identical size in one segmentation offload operation.
+        // Return the number of sent messages in 'sent', zero when segmentation offload is not usable.
+        bool sendSegmented(const void* const data[], const size_t sizes[], size_t count, const SocketAddress& destination, size_t& sent, Report& report);
+
+        // Read zero-copy completion notifications. If 'wait' is true and none is available, wait for one.
+        // Return false on error or timeout.
+        bool readZeroCopy(bool wait, Report& report);
+
+        // Check if a pending zero-copy send operation overlaps a memory area.
+        bool zeroCopyOverlaps(const uint8_t* begin, const uint8_t* end) const;
+
+        // Perform one batched receive operation, at most MAX_BATCH_COUNT messages.
+        SysSocketErrorCode receiveMany(Datagram* msgs, size_t max_count, size_t& ret_count, Report& report);
+
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
         static volatile ::LPFN_WSARECVMSG _wsaRevcMsg;
@@ -0,0 +1,360 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+
+#include "tsIOUringReader.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+#include "tsMemory.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_LINUX)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::IOUringReader::DEFAULT_DEPTH;
+constexpr size_t ts::IOUringReader::DEFAULT_CHUNK_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::IOUringReader::IOUringReader(size_t depth, size_t chunk_size) :
+    _fd(-1),
+    _ring_fd(-1),
+    _depth(std::max<size_t>(depth, 1)),
+    _chunk_size(std::max<size_t>(chunk_size, 4096)),
+    _buffer(),
+    _requests(),
+    _head(0),
+    _pending(0),
+    _to_submit(0),
+    _next_offset(0),
+    _sq_ring(nullptr),
+    _sq_ring_size(0),
+    _cq_ring(nullptr),
+    _cq_ring_size(0),
+    _sqes(nullptr),
+    _sqes_size(0),
+    _sq_tail(nullptr),
+    _sq_mask(nullptr),
+    _sq_array(nullptr),
+    _cq_head(nullptr),
+    _cq_tail(nullptr),
+    _cq_mask(nullptr),
+    _cqes(nullptr)
+{
+}
+
+ts::IOUringReader::~IOUringReader()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Start reading a file.
+//----------------------------------------------------------------------------
+
+bool ts::IOUringReader::open(int fd, uint64_t offset, Report& report)
+{
+    close();
+
+#if defined(TS_LINUX)
+
+    // Create the ring.
+    ::io_uring_params params;
+    TS_ZERO(params);
+    _ring_fd = int(::syscall(__NR_io_uring_setup, unsigned(_depth), &params));
+    if (_ring_fd < 0) {
+        report.error(u"cannot create io_uring: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Map the submission and completion queues in memory. Recent kernels use one single mapping for both rings.
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+    const bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map) {
+        _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+    }
+    _sqes_size = params.sq_entries * sizeof(::io_uring_sqe);
+
+    _sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+    if (_sq_ring == MAP_FAILED) {
+        _sq_ring = nullptr;
+    }
+    else if (single_map) {
+        _cq_ring = _sq_ring;
+    }
+    else if ((_cq_ring = ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING)) == MAP_FAILED) {
+        _cq_ring = nullptr;
+    }
+    if (_sq_ring != nullptr && _cq_ring != nullptr &&
+        (_sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES)) == MAP_FAILED)
+    {
+        _sqes = nullptr;
+    }
+    if (_sq_ring == nullptr || _cq_ring == nullptr || _sqes == nullptr) {
+        report.error(u"cannot map io_uring: %s", {SysErrorCodeMessage()});
+        release();
+        return false;
+    }
+
+    // Locate the fields of the rings.
+    uint8_t* const sq = reinterpret_cast<uint8_t*>(_sq_ring);
+    uint8_t* const cq = reinterpret_cast<uint8_t*>(_cq_ring);
+    _sq_tail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    _sq_mask = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    _cq_head = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    _cq_mask = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    _cqes = cq + params.cq_off.cqes;
+
+    // Allocate the data buffers and start reading.
+    _fd = fd;
+    _buffer.resize(_depth * _chunk_size);
+    _requests.resize(_depth);
+    return seek(offset, report);
+
+#else
+    report.error(u"io_uring is not supported on this system");
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Stop reading the file.
+//----------------------------------------------------------------------------
+
+void ts::IOUringReader::close()
+{
+    if (_ring_fd >= 0) {
+        // The data buffers must not be released while the kernel may still write into them.
+        while (_pending > 0 && enter(true, NULLREP)) {
+            reap();
+        }
+        release();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap and close the ring.
+//----------------------------------------------------------------------------
+
+void ts::IOUringReader::release()
+{
+#if defined(TS_LINUX)
+    if (_sqes != nullptr) {
+        ::munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+        ::munmap(_cq_ring, _cq_ring_size);
+    }
+    if (_sq_ring != nullptr) {
+        ::munmap(_sq_ring, _sq_ring_size);
+    }
+    if (_ring_fd >= 0) {
+        ::close(_ring_fd);
+    }
+#endif
+    _sq_ring = _cq_ring = _sqes = _cqes = nullptr;
+    _sq_tail = _sq_mask = _sq_array = _cq_head = _cq_tail = _cq_mask = nullptr;
+    _ring_fd = _fd = -1;
+    _pending = _to_submit = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Restart reading at a given offset in the file.
+//----------------------------------------------------------------------------
+
+bool ts::IOUringReader::seek(uint64_t offset, Report& report)
+{
+    if (_ring_fd < 0) {
+        report.error(u"io_uring reader not open");
+        return false;
+    }
+
+    // Wait for the completion of all outstanding requests, their data are lost.
+    while (_pending > 0) {
+        if (!enter(true, report)) {
+            return false;
+        }
+        reap();
+    }
+
+    // Queue all requests from the new offset.
+    _head = 0;
+    _next_offset = offset;
+    for (size_t i = 0; i < _depth; ++i) {
+        queue(i);
+    }
+    return enter(false, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Queue a read request at the next offset.
+//----------------------------------------------------------------------------
+
+void ts::IOUringReader::queue(size_t index)
+{
+    Request& req(_requests[index]);
+    req.offset = _next_offset;
+    req.size = _chunk_size;
+    req.consumed = 0;
+    req.result = 0;
+    req.pending = true;
+    _next_offset += _chunk_size;
+    _pending++;
+
+#if defined(TS_LINUX)
+    // We are the only producer in the submission queue.
+    const uint32_t tail = *_sq_tail;
+    const uint32_t sq_index = tail & *_sq_mask;
+    ::io_uring_sqe* sqe = reinterpret_cast<::io_uring_sqe*>(_sqes) + sq_index;
+    TS_ZERO(*sqe);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = _fd;
+    sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(_buffer.data() + index * _chunk_size));
+    sqe->len = uint32_t(_chunk_size);
+    sqe->off = req.offset;
+    sqe->user_data = uint64_t(index);
+    _sq_array[sq_index] = sq_index;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    _to_submit++;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Submit queued requests and optionally wait for at least one completion.
+//----------------------------------------------------------------------------
+
+bool ts::IOUringReader::enter(bool wait, Report& report)
+{
+#if defined(TS_LINUX)
+    for (;;) {
+        const long status = ::syscall(__NR_io_uring_enter, _ring_fd, unsigned(_to_submit), wait ? 1U : 0U, wait ? unsigned(IORING_ENTER_GETEVENTS) : 0U, nullptr, 0);
+        if (status >= 0) {
+            _to_submit -= std::min(_to_submit, size_t(status));
+            if (_to_submit == 0) {
+                return true;
+            }
+        }
+        else if (LastSysErrorCode() != EINTR) {
+            report.error(u"io_uring error: %s", {SysErrorCodeMessage()});
+            return false;
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Process all available completions.
+//----------------------------------------------------------------------------
+
+void ts::IOUringReader::reap()
+{
+#if defined(TS_LINUX)
+    // We are the only consumer in the completion queue.
+    uint32_t head = *_cq_head;
+    const uint32_t tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const ::io_uring_cqe* cqe = reinterpret_cast<const ::io_uring_cqe*>(_cqes) + (head & *_cq_mask);
+        if (cqe->user_data < _requests.size() && _requests[cqe->user_data].pending) {
+            Request& req(_requests[cqe->user_data]);
+            req.result = cqe->res;
+            req.pending = false;
+            _pending--;
+        }
+        head++;
+    }
+    __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next data from the file.
+//----------------------------------------------------------------------------
+
+bool ts::IOUringReader::read(void* buffer, size_t max_size, size_t& ret_size, Report& report)
+{
+    ret_size = 0;
+    if (_ring_fd < 0) {
+        report.error(u"io_uring reader not open");
+        return false;
+    }
+
+    // Wait for the completion of the next request in sequence.
+    Request& req(_requests[_head]);
+    while (req.pending) {
+        if (!enter(true, report)) {
+            return false;
+        }
+        reap();
+    }
+    if (req.result < 0) {
+        report.error(u"read error: %s", {SysErrorCodeMessage(-req.result)});
+        return false;
+    }
+
+    // Return as much data as possible from this request. No more data means end of file.
+    const size_t result = size_t(req.result);
+    ret_size = std::min(max_size, result - req.consumed);
+    ::memcpy(buffer, _buffer.data() + _head * _chunk_size + req.consumed, ret_size);
+    req.consumed += ret_size;
+
+    if (ret_size > 0 && req.consumed == result) {
+        if (result < req.size) {
+            // Short read, usually at end of file. The next requests are not contiguous,
+            // restart all requests right after the last returned byte.
+            return seek(req.offset + result, report);
+        }
+        else {
+            // Reuse the request for the next chunk of the file.
+            queue(_head);
+            _head = (_head + 1) % _depth;
+            return enter(false, report);
+        }
+    }
+    return true;
+}
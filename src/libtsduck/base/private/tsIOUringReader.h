@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Sequential file reader using Linux io_uring (Linux-specific).
+//!
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Sequential file reader using Linux io_uring (Linux-specific).
+    //!
+    //! Several large read requests are permanently outstanding on the file, at consecutive
+    //! offsets. The data are returned in sequence while the next requests are in progress.
+    //! This class remains hidden inside the TSDuck library. Applications should use ts::TSFile.
+    //!
+    class IOUringReader
+    {
+        TS_NOCOPY(IOUringReader);
+    public:
+        static constexpr size_t DEFAULT_DEPTH = 4;                  //!< Default number of outstanding read requests.
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;   //!< Default size in bytes of each read request.
+
+        //!
+        //! Constructor.
+        //! @param [in] depth Number of outstanding read requests.
+        //! @param [in] chunk_size Size in bytes of each read request.
+        //!
+        IOUringReader(size_t depth = DEFAULT_DEPTH, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+        //!
+        //! Destructor.
+        //!
+        ~IOUringReader();
+
+        //!
+        //! Start reading a file.
+        //! @param [in] fd File descriptor of an open file. The file is not closed by this object.
+        //! @param [in] offset Initial offset in bytes in the file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error or if io_uring is not supported on this system.
+        //!
+        bool open(int fd, uint64_t offset, Report& report);
+
+        //!
+        //! Stop reading the file. Wait for the completion of all outstanding requests.
+        //!
+        void close();
+
+        //!
+        //! Check if a file is being read.
+        //! @return True if a file is being read.
+        //!
+        bool isOpen() const { return _ring_fd >= 0; }
+
+        //!
+        //! Restart reading at a given offset in the file.
+        //! @param [in] offset Offset in bytes in the file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool seek(uint64_t offset, Report& report);
+
+        //!
+        //! Read the next data from the file.
+        //! @param [out] buffer Address of the buffer for the returned data.
+        //! @param [in] max_size Size in bytes of the buffer.
+        //! @param [out] ret_size Returned data size in bytes. Zero at end of file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, including at end of file, false on error.
+        //!
+        bool read(void* buffer, size_t max_size, size_t& ret_size, Report& report);
+
+    private:
+        // Description of one read request.
+        class Request
+        {
+        public:
+            uint64_t offset;    // Offset in file.
+            size_t   size;      // Requested size.
+            size_t   consumed;  // Number of bytes already returned to the application.
+            int      result;    // Read size or negated error code when completed.
+            bool     pending;   // Request in progress.
+            Request() : offset(0), size(0), consumed(0), result(0), pending(false) {}
+        };
+
+        int                  _fd;            // File to read.
+        int                  _ring_fd;       // io_uring file descriptor.
+        size_t               _depth;         // Number of read requests.
+        size_t               _chunk_size;    // Size of each read request.
+        ByteBlock            _buffer;        // Data buffers of all requests.
+        std::vector<Request> _requests;      // All read requests.
+        size_t               _head;          // Index of request containing the next data to return.
+        size_t               _pending;       // Number of pending requests.
+        size_t               _to_submit;     // Number of queued requests, not yet submitted.
+        uint64_t             _next_offset;   // File offset of the next request to queue.
+        void*                _sq_ring;       // Memory-mapped submission queue ring.
+        size_t               _sq_ring_size;
+        void*                _cq_ring;       // Memory-mapped completion queue ring (can be the same as _sq_ring).
+        size_t               _cq_ring_size;
+        void*                _sqes;          // Memory-mapped submission queue entries.
+        size_t               _sqes_size;
+        uint32_t*            _sq_tail;       // Fields in submission queue ring.
+        uint32_t*            _sq_mask;
+        uint32_t*            _sq_array;
+        uint32_t*            _cq_head;       // Fields in completion queue ring.
+        uint32_t*            _cq_tail;
+        uint32_t*            _cq_mask;
+        void*                _cqes;
+
+        // Unmap and close the ring.
+        void release();
+
+        // Queue a read request at the next offset.
+        void queue(size_t index);
+
+        // Submit queued requests and optionally wait for at least one completion.
+        bool enter(bool wait, Report& report);
+
+        // Process all available completions.
+        void reap();
+    };
+}
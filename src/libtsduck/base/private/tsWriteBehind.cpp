@@ -0,0 +1,393 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+
+#include "tsWriteBehind.h"
+#include "tsGuardMutex.h"
+#include "tsGuardCondition.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+#if !defined(TS_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::WriteBehind::BLOCK_SIZE;
+constexpr size_t ts::WriteBehind::ALIGNMENT;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::WriteBehind::WriteBehind() :
+    Thread(),
+    _fd(-1),
+    _direct_io(false),
+    _prealloc(0),
+    _prealloc_end(0),
+    _offset(0),
+    _flush_offset(0),
+    _flush_size(0),
+    _memory(),
+    _blocks(nullptr),
+    _block_count(0),
+    _fill_index(0),
+    _fill_size(0),
+    _mutex(),
+    _work(),
+    _space(),
+    _idle(),
+    _write_index(0),
+    _ready_count(0),
+    _terminate(false),
+    _aborted(false),
+    _writing(false),
+    _error(0)
+{
+}
+
+ts::WriteBehind::~WriteBehind()
+{
+    if (_fd >= 0) {
+        close(NULLREP);
+    }
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start writing a file at its current position.
+//----------------------------------------------------------------------------
+
+bool ts::WriteBehind::open(int fd, size_t buffer_size, bool direct_io, uint64_t preallocate, Report& report)
+{
+    if (_fd >= 0) {
+        report.error(u"write-behind already active");
+        return false;
+    }
+
+#if defined(TS_WINDOWS)
+
+    report.error(u"write-behind is not supported on this system");
+    return false;
+
+#else
+
+    const off_t position = ::lseek(fd, 0, SEEK_CUR);
+    if (position < 0) {
+        report.error(u"error getting file position: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Allocate aligned memory blocks.
+    _block_count = std::max<size_t>(2, (buffer_size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    _memory.resize(_block_count * BLOCK_SIZE + ALIGNMENT);
+    _blocks = _memory.data() + (ALIGNMENT - reinterpret_cast<uintptr_t>(_memory.data()) % ALIGNMENT) % ALIGNMENT;
+
+    // Reset the state.
+    _offset = _prealloc_end = uint64_t(position);
+    _prealloc = preallocate;
+    _flush_offset = 0;
+    _flush_size = 0;
+    _fill_index = _fill_size = 0;
+    _write_index = _ready_count = 0;
+    _terminate = _aborted = _writing = false;
+    _error = 0;
+    _direct_io = false;
+
+    // Direct I/O requires aligned file offsets.
+    if (direct_io) {
+#if defined(TS_LINUX)
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (_offset % ALIGNMENT != 0) {
+            report.verbose(u"file position is not aligned, direct I/O not used");
+        }
+        else if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_DIRECT) < 0) {
+            report.verbose(u"direct I/O not supported on this file: %s", {SysErrorCodeMessage()});
+        }
+        else {
+            _direct_io = true;
+        }
+#else
+        report.verbose(u"direct I/O not supported on this system");
+#endif
+    }
+
+    _fd = fd;
+    if (!start()) {
+        report.error(u"cannot start write-behind thread");
+        close(NULLREP);
+        return false;
+    }
+    return true;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Write data. The data are copied and will be written later.
+//----------------------------------------------------------------------------
+
+bool ts::WriteBehind::write(const void* data, size_t size, Report& report)
+{
+    if (_fd < 0) {
+        report.error(u"write-behind not active");
+        return false;
+    }
+
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+    while (size > 0) {
+
+        // Copy as much as possible in the current block. This block is not used by the write-behind thread.
+        const size_t chunk = std::min(size, BLOCK_SIZE - _fill_size);
+        ::memcpy(_blocks + _fill_index * BLOCK_SIZE + _fill_size, input, chunk);
+        input += chunk;
+        size -= chunk;
+        _fill_size += chunk;
+
+        // Pass a full block to the write-behind thread and wait for a free block.
+        if (_fill_size == BLOCK_SIZE) {
+            GuardCondition lock(_mutex, _space);
+            _ready_count++;
+            _work.signal();
+            while (_ready_count >= _block_count && _error == 0 && !_aborted) {
+                lock.waitCondition();
+            }
+            if (_aborted) {
+                return false;
+            }
+            else if (_error != 0) {
+                report.error(u"write error: %s", {SysErrorCodeMessage(_error)});
+                return false;
+            }
+            _fill_index = (_fill_index + 1) % _block_count;
+            _fill_size = 0;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Write all pending data and stop the write-behind thread.
+//----------------------------------------------------------------------------
+
+bool ts::WriteBehind::close(Report& report)
+{
+    if (_fd < 0) {
+        return true;
+    }
+
+    // Let the write-behind thread terminate after writing all full blocks.
+    {
+        GuardMutex lock(_mutex);
+        _terminate = true;
+        _work.signal();
+    }
+    waitForTermination();
+
+    bool success = !_aborted;
+    if (_error != 0) {
+        report.error(u"write error: %s", {SysErrorCodeMessage(_error)});
+        success = false;
+    }
+
+#if !defined(TS_WINDOWS)
+#if defined(TS_LINUX)
+    // Revert to buffered I/O for the last partial block (the size is not aligned).
+    // After abort, the file descriptor may be already closed by the application.
+    if (_direct_io) {
+        const int flags = _aborted ? -1 : ::fcntl(_fd, F_GETFL);
+        if (flags >= 0) {
+            ::fcntl(_fd, F_SETFL, flags & ~O_DIRECT);
+        }
+        _direct_io = false;
+    }
+#endif
+
+    // Write the last partial block in the context of the caller.
+    if (success && _fill_size > 0) {
+        const int error = writeBlock(_blocks + _fill_index * BLOCK_SIZE, _fill_size);
+        if (error != 0) {
+            report.error(u"write error: %s", {SysErrorCodeMessage(error)});
+            success = false;
+        }
+    }
+
+    if (success) {
+        // Release the preallocated space beyond the end of the data, without truncating previous data.
+        struct stat st;
+        if (_prealloc_end > _offset && ::fstat(_fd, &st) == 0 && ::ftruncate(_fd, std::max(off_t(_offset), st.st_size)) < 0) {
+            report.error(u"error truncating file: %s", {SysErrorCodeMessage()});
+            success = false;
+        }
+        // Leave the file position at the end of the written data.
+        ::lseek(_fd, off_t(_offset), SEEK_SET);
+    }
+#endif
+
+    _fd = -1;
+    _fill_size = 0;
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Abort the write-behind operation.
+//----------------------------------------------------------------------------
+
+void ts::WriteBehind::abort()
+{
+    // Lock the mutex with the condition which is signaled when an I/O operation completes.
+    GuardCondition lock(_mutex, _idle);
+    _aborted = true;
+    _work.signal();
+    _space.signal();
+
+    // No new I/O is started once aborted. Wait for the completion of the current one, if
+    // any, because the caller is likely to close the file descriptor just after return.
+    while (_writing) {
+        lock.waitCondition();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Write-behind thread.
+//----------------------------------------------------------------------------
+
+void ts::WriteBehind::main()
+{
+    for (;;) {
+        // Wait for a block to write.
+        size_t index = 0;
+        {
+            GuardCondition lock(_mutex, _work);
+            while (_ready_count == 0 && !_terminate && !_aborted) {
+                lock.waitCondition();
+            }
+            if (_aborted || _ready_count == 0) {
+                break;
+            }
+            index = _write_index;
+            _writing = true;
+        }
+
+        // Write the block outside the critical section.
+        const int error = writeBlock(_blocks + index * BLOCK_SIZE, BLOCK_SIZE);
+
+        // Release the block.
+        GuardMutex lock(_mutex);
+        _writing = false;
+        _idle.signal();
+        _error = error;
+        _write_index = (index + 1) % _block_count;
+        _ready_count--;
+        _space.signal();
+        if (_error != 0) {
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Write a block of data at the current offset. Return an error code.
+//----------------------------------------------------------------------------
+
+int ts::WriteBehind::writeBlock(const uint8_t* data, size_t size)
+{
+#if defined(TS_WINDOWS)
+    return ERROR_NOT_SUPPORTED;
+#else
+
+#if defined(TS_LINUX)
+    // Preallocate the file by large chunks, without changing its size.
+    if (_prealloc > 0 && _offset + size > _prealloc_end) {
+        if (::fallocate(_fd, FALLOC_FL_KEEP_SIZE, off_t(_prealloc_end), off_t(_prealloc)) == 0) {
+            _prealloc_end += _prealloc;
+        }
+        else {
+            _prealloc = 0; // not supported on this file system, don't try again
+        }
+    }
+#endif
+
+    // Write the complete block.
+    const size_t block_size = size;
+    uint64_t offset = _offset;
+    while (size > 0) {
+        const ssize_t outsize = ::pwrite(_fd, data, size, off_t(offset));
+        if (outsize > 0) {
+            data += outsize;
+            size -= size_t(outsize);
+            offset += uint64_t(outsize);
+        }
+        else {
+            const int error = LastSysErrorCode();
+#if defined(TS_LINUX)
+            if (error == EINVAL && _direct_io) {
+                // Direct I/O rejected by the file system, revert to buffered I/O.
+                const int flags = ::fcntl(_fd, F_GETFL);
+                if (flags >= 0 && ::fcntl(_fd, F_SETFL, flags & ~O_DIRECT) == 0) {
+                    _direct_io = false;
+                    continue;
+                }
+            }
+#endif
+            if (error != EINTR) {
+                return error;
+            }
+        }
+    }
+
+#if defined(TS_LINUX)
+    if (!_direct_io) {
+        // Start the write-back of this block. Then wait for the write-back of the
+        // previous block and remove it from the page cache.
+        ::sync_file_range(_fd, off_t(_offset), off_t(block_size), SYNC_FILE_RANGE_WRITE);
+        if (_flush_size > 0) {
+            ::sync_file_range(_fd, off_t(_flush_offset), off_t(_flush_size), SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            ::posix_fadvise(_fd, off_t(_flush_offset), off_t(_flush_size), POSIX_FADV_DONTNEED);
+        }
+        _flush_offset = _offset;
+        _flush_size = block_size;
+    }
+#endif
+
+    _offset += block_size;
+    return 0;
+#endif
+}
@@ -0,0 +1,143 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Write-behind thread for sequential file output (UNIX-specific).
+//!
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsByteBlock.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Write-behind thread for sequential file output (UNIX-specific).
+    //!
+    //! The application data are accumulated in aligned memory blocks. A dedicated thread
+    //! writes the full blocks in the file. The application is blocked only when all blocks
+    //! are waiting to be written. On Linux, the blocks are written using direct I/O (O_DIRECT)
+    //! or, without direct I/O, the written data are immediately flushed and removed from the
+    //! page cache. The file can also be preallocated by large chunks.
+    //!
+    //! This class remains hidden inside the TSDuck library. Applications should use ts::TSFile.
+    //!
+    class WriteBehind : private Thread
+    {
+        TS_NOCOPY(WriteBehind);
+    public:
+        static constexpr size_t BLOCK_SIZE = 1024 * 1024;  //!< Size in bytes of each memory block.
+        static constexpr size_t ALIGNMENT = 4096;          //!< Alignment of memory blocks and file offsets for direct I/O.
+
+        //!
+        //! Constructor.
+        //!
+        WriteBehind();
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~WriteBehind() override;
+
+        //!
+        //! Start writing a file at its current position.
+        //! @param [in] fd File descriptor of a regular file, open for write. The file is not closed by this object.
+        //! @param [in] buffer_size Total size in bytes of the memory blocks.
+        //! @param [in] direct_io If true, use direct I/O when the file system supports it (Linux only).
+        //! @param [in] preallocate If not zero, preallocate the file by chunks of this size in bytes (Linux only).
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(int fd, size_t buffer_size, bool direct_io, uint64_t preallocate, Report& report);
+
+        //!
+        //! Write all pending data and stop the write-behind thread.
+        //! On return, the file position is at the end of the written data.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+        //!
+        //! Check if the write-behind thread is active.
+        //! @return True if the write-behind thread is active.
+        //!
+        bool isOpen() const { return _fd >= 0; }
+
+        //!
+        //! Write data. The data are copied and will be written later.
+        //! @param [in] data Address of data to write.
+        //! @param [in] size Size in bytes of data to write.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error, including errors in previous write operations.
+        //!
+        bool write(const void* data, size_t size, Report& report);
+
+        //!
+        //! Abort the write-behind operation. Can be called from any thread except the write-behind thread.
+        //! Pending data are lost. The object can be only closed. If the write-behind thread is currently
+        //! writing a block, wait until the I/O operation completes. On return, the write-behind thread no
+        //! longer accesses the file descriptor and the file can be safely closed.
+        //!
+        void abort();
+
+    private:
+        int         _fd;            // File descriptor.
+        bool        _direct_io;     // Use direct I/O.
+        uint64_t    _prealloc;      // Preallocation chunk size.
+        uint64_t    _prealloc_end;  // End of preallocated area.
+        uint64_t    _offset;        // Current write offset in file, updated by the write-behind thread.
+        uint64_t    _flush_offset;  // Offset of the previous block which is being flushed.
+        size_t      _flush_size;    // Size of the previous block which is being flushed.
+        ByteBlock   _memory;        // Memory for all blocks, unaligned.
+        uint8_t*    _blocks;        // Address of first aligned block.
+        size_t      _block_count;   // Number of blocks.
+        size_t      _fill_index;    // Index of the block which is filled by the application.
+        size_t      _fill_size;     // Size of data in the block which is filled by the application.
+        Mutex       _mutex;         // Protect the following fields.
+        Condition   _work;          // Signaled when a block is ready to write or on termination.
+        Condition   _space;         // Signaled when a block is written or on error.
+        Condition   _idle;          // Signaled when the write-behind thread leaves an I/O operation.
+        size_t      _write_index;   // Index of the first block to write.
+        size_t      _ready_count;   // Number of blocks to write.
+        bool        _terminate;     // Terminate the write-behind thread.
+        bool        _aborted;       // Operation was aborted.
+        bool        _writing;       // The write-behind thread is writing a block.
+        int         _error;         // Error code in the write-behind thread.
+
+        // Implementation of Thread.
+        virtual void main() override;
+
+        // Write a block of data at the current offset, in the context of the write-behind thread.
+        int writeBlock(const uint8_t* data, size_t size);
+    };
+}
@@ -34,6 +34,7 @@ TSDUCK_SOURCE;
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::Buffer::DEFAULT_SIZE;
 constexpr size_t ts::Buffer::MINIMUM_SIZE;
+constexpr size_t ts::Buffer::MAX_CHUNK_BITS;
 #endif
 
 
@@ -1130,6 +1131,82 @@ bool ts::Buffer::putBit(uint8_t bit)
 }
 
 
+//----------------------------------------------------------------------------
+// Fast path for big endian bit fields.
+//----------------------------------------------------------------------------
+
+uint64_t ts::Buffer::readBitsBE(size_t bits)
+{
+    // A 64-bit field is read in two chunks.
+    uint64_t val = 0;
+    while (bits > 0) {
+        const size_t count = std::min(bits, MAX_CHUNK_BITS);
+        val = (val << count) | readChunkBE(count);
+        bits -= count;
+    }
+    return val;
+}
+
+void ts::Buffer::writeBitsBE(uint64_t value, size_t bits)
+{
+    while (bits > 0) {
+        const size_t count = std::min(bits, MAX_CHUNK_BITS);
+        bits -= count;
+        writeChunkBE(value >> bits, count);
+    }
+}
+
+uint64_t ts::Buffer::readChunkBE(size_t bits)
+{
+    assert(bits > 0 && bits <= MAX_CHUNK_BITS);
+    assert(_state.rbit < 8);
+
+    // The field is left-aligned in a 64-bit value, after the first rbit bits.
+    const uint8_t* const data = _buffer + _state.rbyte;
+    const size_t last = _state.rbit + bits;  // bit after the field, from data[0]
+    uint64_t acc = 0;
+    if (_state.rbyte + 8 <= _buffer_size) {
+        acc = GetUInt64BE(data);
+    }
+    else {
+        // Close to the end of the buffer, read only the bytes containing the field.
+        for (size_t i = 0; 8 * i < last; ++i) {
+            acc |= uint64_t(data[i]) << (56 - 8 * i);
+        }
+    }
+
+    _state.rbyte += last >> 3;
+    _state.rbit = last & 7;
+    return (acc << (last - bits)) >> (64 - bits);
+}
+
+void ts::Buffer::writeChunkBE(uint64_t value, size_t bits)
+{
+    assert(bits > 0 && bits <= MAX_CHUNK_BITS);
+    assert(_state.wbit < 8);
+
+    // Place the field in a left-aligned 64-bit value, after the first wbit bits.
+    // The bits before and after the field are preserved.
+    uint8_t* const data = _buffer + _state.wbyte;
+    const size_t last = _state.wbit + bits;  // bit after the field, from data[0]
+    const uint64_t mask = ((uint64_t(1) << bits) - 1) << (64 - last);
+    const uint64_t field = (value << (64 - last)) & mask;
+    if (_state.wbyte + 8 <= _buffer_size) {
+        PutUInt64BE(data, (GetUInt64BE(data) & ~mask) | field);
+    }
+    else {
+        // Close to the end of the buffer, write only the bytes containing the field.
+        for (size_t i = 0; 8 * i < last; ++i) {
+            const size_t shift = 56 - 8 * i;
+            data[i] = uint8_t((data[i] & ~uint8_t(mask >> shift)) | uint8_t(field >> shift));
+        }
+    }
+
+    _state.wbyte += last >> 3;
+    _state.wbit = last & 7;
+}
+
+
 //----------------------------------------------------------------------------
 // Internal "read bytes" method (1 to 8 bytes).
 //----------------------------------------------------------------------------
@@ -1330,6 +1330,16 @@ namespace ts {
         // - Advance read pointer.
         const uint8_t* rdb(size_t bytes);
 
+        // Fast path for big endian bit fields of 1 to 64 bits. No error checking, the caller
+        // must have checked that the bits are available. Use 64-bit loads and stores.
+        uint64_t readBitsBE(size_t bits);
+        void writeBitsBE(uint64_t value, size_t bits);
+
+        // Same for up to 56 bits. A field of 56 bits at any bit offset fits in 8 bytes.
+        static constexpr size_t MAX_CHUNK_BITS = 56;
+        uint64_t readChunkBE(size_t bits);
+        void writeChunkBE(uint64_t value, size_t bits);
+
         // Internal put integer method.
         template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type* = nullptr>
         bool putint(INT value, size_t bytes, void (*putBE)(void*,INT), void (*putLE)(void*,INT));
@@ -66,7 +66,11 @@ INT ts::Buffer::getBits(size_t bits)
 
     INT val = 0;
 
-    if (_big_endian) {
+    if (_big_endian && bits <= 64) {
+        // Fast path using word-sized loads and shifts. Upper bits are truncated if INT is smaller.
+        val = static_cast<INT>(readBitsBE(bits));
+    }
+    else if (_big_endian) {
         // Read leading bits up to byte boundary
         while (bits > 0 && _state.rbit != 0) {
             val = INT(val << 1) | INT(getBit());
@@ -128,7 +132,11 @@ bool ts::Buffer::putBits(INT value, size_t bits)
         return false;
     }
 
-    if (_big_endian) {
+    if (_big_endian && bits <= 64) {
+        // Fast path using word-sized loads, shifts and stores.
+        writeBitsBE(static_cast<uint64_t>(value), bits);
+    }
+    else if (_big_endian) {
         // Write leading bits up to byte boundary
         while (bits > 0 && _state.wbit != 0) {
             putBit(uint8_t((value >> --bits) & 1));
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsLatencyHistogram.h"
+#include <cmath>
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::LatencyHistogram::SUB_BITS;
+constexpr size_t ts::LatencyHistogram::SUB_COUNT;
+constexpr size_t ts::LatencyHistogram::MAX_BITS;
+constexpr uint64_t ts::LatencyHistogram::MAX_VALUE;
+constexpr size_t ts::LatencyHistogram::BUCKET_COUNT;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and clear.
+//----------------------------------------------------------------------------
+
+ts::LatencyHistogram::LatencyHistogram() :
+    _count(0),
+    _sum(0),
+    _min(std::numeric_limits<uint64_t>::max()),
+    _max(0),
+    _buckets()
+{
+    clear();
+}
+
+void ts::LatencyHistogram::clear()
+{
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+
+//----------------------------------------------------------------------------
+// Bounds of a bucket.
+//----------------------------------------------------------------------------
+
+uint64_t ts::LatencyHistogram::BucketLowest(size_t index)
+{
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    else {
+        const size_t shift = index / SUB_COUNT - 1;
+        return uint64_t(SUB_COUNT + index % SUB_COUNT) << shift;
+    }
+}
+
+uint64_t ts::LatencyHistogram::BucketHighest(size_t index)
+{
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    else {
+        const size_t shift = index / SUB_COUNT - 1;
+        return BucketLowest(index) + (uint64_t(1) << shift) - 1;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Statistics on recorded values.
+//----------------------------------------------------------------------------
+
+uint64_t ts::LatencyHistogram::minimum() const
+{
+    const uint64_t min = _min.load(std::memory_order_relaxed);
+    return min == std::numeric_limits<uint64_t>::max() ? 0 : min;
+}
+
+uint64_t ts::LatencyHistogram::mean() const
+{
+    const uint64_t cnt = count();
+    return cnt == 0 ? 0 : sum() / cnt;
+}
+
+uint64_t ts::LatencyHistogram::percentile(double percent) const
+{
+    // Count the values in the buckets, not the global count, which can be slightly desynchronized.
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        total += _buckets[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the requested value, from 1 to total.
+    percent = std::max(0.0, std::min(100.0, percent));
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(percent * double(total) / 100.0)));
+
+    uint64_t cumul = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        cumul += _buckets[i].load(std::memory_order_relaxed);
+        if (cumul >= rank) {
+            return std::max(minimum(), std::min(maximum(), BucketHighest(i)));
+        }
+    }
+    return maximum();
+}
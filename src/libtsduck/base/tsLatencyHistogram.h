@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Low-overhead histogram of latencies or other positive values.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIntegerUtils.h"
+
+namespace ts {
+    //!
+    //! Low-overhead histogram of latencies or other positive values.
+    //! @ingroup system
+    //!
+    //! The values are accumulated in logarithmic buckets, in the style of HDR histograms.
+    //! Each power of two is split into 16 linear sub-buckets, giving a relative precision
+    //! of about 6% on any value, from 0 to 2^48 (about 78 hours in nanoseconds).
+    //!
+    //! Values are recorded by one single thread and can be read at any time from other
+    //! threads. The counters are atomic but updated without read-modify-write operations
+    //! (single writer). A reader may get a slightly inconsistent view (one value counted in
+    //! a bucket but not yet in the total count), which is acceptable for statistics.
+    //!
+    class TSDUCKDLL LatencyHistogram
+    {
+        TS_NOCOPY(LatencyHistogram);
+    public:
+        static constexpr size_t SUB_BITS = 4;                    //!< Number of bits of linear sub-buckets per power of two.
+        static constexpr size_t SUB_COUNT = 1 << SUB_BITS;       //!< Number of linear sub-buckets per power of two.
+        static constexpr size_t MAX_BITS = 48;                   //!< Maximum number of significant bits in a value.
+        static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_BITS) - 1; //!< Larger values are recorded as MAX_VALUE.
+        static constexpr size_t BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT; //!< Total number of buckets.
+
+        //!
+        //! Constructor.
+        //!
+        LatencyHistogram();
+
+        //!
+        //! Clear the content of the histogram.
+        //! Must be called from the writer thread only.
+        //!
+        void clear();
+
+        //!
+        //! Record a value (writer thread only).
+        //! @param [in] value The value to record.
+        //! @param [in] count Number of occurrences of @a value.
+        //!
+        void record(uint64_t value, uint64_t count = 1)
+        {
+            if (count > 0) {
+                value = std::min(value, MAX_VALUE);
+                Add(_buckets[BucketIndex(value)], count);
+                Add(_count, count);
+                Add(_sum, value * count);
+                if (value < _min.load(std::memory_order_relaxed)) {
+                    _min.store(value, std::memory_order_relaxed);
+                }
+                if (value > _max.load(std::memory_order_relaxed)) {
+                    _max.store(value, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        //!
+        //! Get the number of recorded values.
+        //! @return The number of recorded values.
+        //!
+        uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+        //!
+        //! Get the sum of all recorded values.
+        //! @return The sum of all recorded values.
+        //!
+        uint64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+
+        //!
+        //! Get the minimum recorded value.
+        //! @return The minimum recorded value, zero if there is none.
+        //!
+        uint64_t minimum() const;
+
+        //!
+        //! Get the maximum recorded value.
+        //! @return The maximum recorded value, zero if there is none.
+        //!
+        uint64_t maximum() const { return _max.load(std::memory_order_relaxed); }
+
+        //!
+        //! Get the mean value of all recorded values.
+        //! @return The mean value, zero if there is none.
+        //!
+        uint64_t mean() const;
+
+        //!
+        //! Get the value at a given percentile.
+        //! @param [in] percent A percentile, from 0.0 to 100.0.
+        //! @return The highest value of the bucket which contains the given percentile of all values,
+        //! bounded by the recorded minimum and maximum. Zero if there is no value.
+        //!
+        uint64_t percentile(double percent) const;
+
+        //!
+        //! Get the lowest value in a bucket.
+        //! @param [in] index Bucket index, from 0 to BUCKET_COUNT - 1.
+        //! @return The lowest value which is recorded in that bucket.
+        //!
+        static uint64_t BucketLowest(size_t index);
+
+        //!
+        //! Get the highest value in a bucket.
+        //! @param [in] index Bucket index, from 0 to BUCKET_COUNT - 1.
+        //! @return The highest value which is recorded in that bucket.
+        //!
+        static uint64_t BucketHighest(size_t index);
+
+        //!
+        //! Get the bucket index of a value.
+        //! @param [in] value A value, up to MAX_VALUE.
+        //! @return The index of the bucket which records @a value.
+        //!
+        static size_t BucketIndex(uint64_t value)
+        {
+            if (value < SUB_COUNT) {
+                return size_t(value);
+            }
+            else {
+#if defined(TS_GCC) || defined(TS_LLVM)
+                const size_t bits = 64 - size_t(__builtin_clzll(value));
+#else
+                const size_t bits = BitSize(value);
+#endif
+                // Keep the SUB_BITS bits after the most significant one.
+                const size_t shift = bits - 1 - SUB_BITS;
+                return (shift + 1) * SUB_COUNT + size_t((value >> shift) & (SUB_COUNT - 1));
+            }
+        }
+
+    private:
+        std::atomic<uint64_t> _count;
+        std::atomic<uint64_t> _sum;
+        std::atomic<uint64_t> _min;
+        std::atomic<uint64_t> _max;
+        std::atomic<uint64_t> _buckets[BUCKET_COUNT];
+
+        // Single-writer increment of a counter.
+        static void Add(std::atomic<uint64_t>& counter, uint64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    };
+}
@@ -51,8 +51,14 @@ namespace ts {
         //! Abort application if memory allocation fails.
         //! Do not abort if memory locking fails.
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] huge_pages If true, try to allocate the buffer in huge memory pages, to reduce
+        //! TLB misses on large buffers. Explicit huge pages (Linux hugetlbfs) are used when available.
+        //! Otherwise, transparent huge pages are requested. If both are unavailable, normal pages are
+        //! used. Currently, huge pages are supported on Linux only and ignored on other systems.
+        //! @param [in] numa_node If positive or zero, allocate the buffer on this NUMA node.
+        //! NUMA binding is currently supported on Linux only and ignored on other systems.
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, bool huge_pages = false, int numa_node = -1);
 
         //!
         //! Destructor.
@@ -68,6 +74,24 @@ namespace ts {
             return _is_locked;
         }
 
+        //!
+        //! Check if the buffer is actually allocated in huge memory pages.
+        //! @return True if the buffer was allocated with explicit or transparent huge pages.
+        //!
+        bool isHugePages() const
+        {
+            return _is_huge;
+        }
+
+        //!
+        //! Check if the buffer is actually bound to a NUMA node.
+        //! @return True if the buffer was bound to the requested NUMA node.
+        //!
+        bool isNUMABound() const
+        {
+            return _is_numa_bound;
+        }
+
         //!
         //! Get error code when not locked
         //! @return The system error code when locking failed.
@@ -103,6 +127,9 @@ namespace ts {
         size_t    _locked_size;      // Locked size (mlock, multiple of page size)
         size_t    _elem_count;       // Element count in locked region
         bool      _is_locked;        // False if mlock failed.
+        bool      _is_mapped;        // Memory is allocated using mmap, not the heap.
+        bool      _is_huge;          // Memory is allocated in huge pages.
+        bool      _is_numa_bound;    // Memory is bound to a NUMA node.
         SysErrorCode _error_code;       // Lock error code
     };
 }
@@ -45,7 +45,7 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, bool huge_pages, int numa_node) :
     _allocated_base(nullptr),
     _locked_base(nullptr),
     _base(nullptr),
@@ -53,34 +53,70 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
+    _is_mapped(false),
+    _is_huge(false),
+    _is_numa_bound(false),
     _error_code(SYS_SUCCESS)
 {
     const size_t requested_size = elem_count * sizeof(T);
     const size_t page_size = SysInfo::Instance()->memoryPageSize();
 
-    // Allocate enough space to include memory pages around the requested size
+    // With huge pages, map anonymous memory. First try explicit huge pages, which
+    // must have been reserved by the administrator, then transparent huge pages.
+    // The size of huge pages depends on the architecture and the system configuration.
+    const size_t huge_page_size = SysInfo::Instance()->hugeMemoryPageSize();
+    if (huge_pages && huge_page_size > 0) {
+#if defined(TS_LINUX)
+        const size_t size = RoundUp(requested_size, huge_page_size);
+        void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED) {
+            _is_huge = true;
+        }
+        else {
+            addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            _is_huge = addr != MAP_FAILED && ::madvise(addr, size, MADV_HUGEPAGE) == 0;
+        }
+        if (addr != MAP_FAILED) {
+            _is_mapped = true;
+            _locked_base = char_ptr(addr);
+            _locked_size = size;
+        }
+#endif
+    }
+
+    // Default allocation in the heap.
+    if (!_is_mapped) {
+
+        // Allocate enough space to include memory pages around the requested size
 
-    _allocated_size = requested_size + 2 * page_size;
-    _allocated_base = new char[_allocated_size];
+        _allocated_size = requested_size + 2 * page_size;
+        _allocated_base = new char[_allocated_size];
 
-    // Locked space starts at next page boundary after allocated base:
-    // Its size is the next multiple of page size after requested_size:
-    // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
-    // to perform arithmetics on pointers because we use modulo operations.
+        // Locked space starts at next page boundary after allocated base:
+        // Its size is the next multiple of page size after requested_size:
+        // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
+        // to perform arithmetics on pointers because we use modulo operations.
 
-    assert(sizeof(size_t) == sizeof(char_ptr));
-    _locked_base = char_ptr(RoundUp(size_t(_allocated_base), page_size));
-    _locked_size = RoundUp(requested_size, page_size);
+        assert(sizeof(size_t) == sizeof(char_ptr));
+        _locked_base = char_ptr(RoundUp(size_t(_allocated_base), page_size));
+        _locked_size = RoundUp(requested_size, page_size);
+
+        assert(_allocated_base <= _locked_base);
+        assert(_locked_base < _allocated_base + page_size);
+        assert(_locked_base + _locked_size <= _allocated_base + _allocated_size);
+        assert(_locked_size <= _allocated_size);
+    }
+
+    // Bind the memory on a NUMA node before the pages are used.
+    if (numa_node >= 0) {
+        _is_numa_bound = BindMemoryToNUMANode(_locked_base, _locked_size, size_t(numa_node));
+    }
 
     _base = new (_locked_base) T[elem_count];
 
     // Integrity checks
 
-    assert(_allocated_base <= _locked_base);
-    assert(_locked_base < _allocated_base + page_size);
-    assert(_locked_base + _locked_size <= _allocated_base + _allocated_size);
     assert(requested_size <= _locked_size);
-    assert(_locked_size <= _allocated_size);
     assert(size_t(_locked_base) % page_size == 0);
     assert(size_t(_locked_base) == size_t(_base));
     assert(char_ptr(_base + elem_count) <= _locked_base + _locked_size);
@@ -138,6 +174,11 @@ ts::ResidentBuffer<T>::~ResidentBuffer<T>()
     }
 
     // Free memory
+#if defined(TS_LINUX)
+    if (_is_mapped) {
+        ::munmap(_locked_base, _locked_size);
+    }
+#endif
     if (_allocated_base != nullptr) {
         delete[] _allocated_base;
     }
@@ -150,4 +191,7 @@ ts::ResidentBuffer<T>::~ResidentBuffer<T>()
     _locked_size = 0;
     _elem_count = 0;
     _is_locked = false;
+    _is_mapped = false;
+    _is_huge = false;
+    _is_numa_bound = false;
 }
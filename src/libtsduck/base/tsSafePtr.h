@@ -479,6 +479,15 @@ namespace ts {
             int   _ref_count;  // reference counter
             MUTEX _mutex;      // protect the SafePtrShared
 
+            // Guard on _mutex. With NullMutex, there is nothing to lock and the
+            // virtual calls of GuardMutex on each access are avoided.
+            class NullGuard
+            {
+            public:
+                NullGuard(MUTEX&) {}
+            };
+            typedef typename std::conditional<std::is_same<MUTEX, NullMutex>::value, NullGuard, GuardMutex>::type Guard;
+
         public:
             // Constructor. Initial reference count is 1.
             SafePtrShared(T* p) : _ptr(p), _ref_count(1), _mutex() {}
@@ -509,7 +518,7 @@ namespace ts {
             // Perform a class downcast (cast to a subclass).
             template <typename ST> SafePtr<ST,MUTEX> downcast()
             {
-                GuardMutex lock(_mutex);
+                Guard lock(_mutex);
                 ST* sp = dynamic_cast<ST*>(_ptr);
                 if (sp != nullptr) {
                     // Successful downcast, the original safe pointer must be released.
@@ -521,7 +530,7 @@ namespace ts {
             // Perform a class upcast.
             template <typename ST> SafePtr<ST,MUTEX> upcast()
             {
-                GuardMutex lock(_mutex);
+                Guard lock(_mutex);
                 ST* sp = _ptr;
                 _ptr = nullptr;
                 return SafePtr<ST,MUTEX>(sp);
@@ -530,7 +539,7 @@ namespace ts {
             // Change mutex type.
             template <typename NEWMUTEX> SafePtr<T,NEWMUTEX> changeMutex()
             {
-                GuardMutex lock(_mutex);
+                Guard lock(_mutex);
                 T* sp = _ptr;
                 _ptr = nullptr;
                 return SafePtr<T,NEWMUTEX>(sp);
@@ -79,7 +79,8 @@ ts::SysInfo::SysInfo() :
     _systemVersion(),
     _systemName(),
     _hostName(),
-    _memoryPageSize(0)
+    _memoryPageSize(0),
+    _hugeMemoryPageSize(0)
 {
     //
     // Get operating system name and version.
@@ -223,5 +224,28 @@ ts::SysInfo::SysInfo() :
         _memoryPageSize = size_t(pageSize);
     }
 
+#endif
+
+    //
+    // Get system huge memory page size.
+    //
+#if defined(TS_LINUX)
+
+    // Size of transparent huge pages, in bytes.
+    if (UString::Load(lines, u"/sys/kernel/mm/transparent_hugepage/hpage_pmd_size") && !lines.empty()) {
+        lines.front().toInteger(_hugeMemoryPageSize);
+    }
+
+    // Otherwise, default size of explicit huge pages, a line such as "Hugepagesize:    2048 kB".
+    if (_hugeMemoryPageSize == 0 && UString::Load(lines, u"/proc/meminfo")) {
+        for (const auto& line : lines) {
+            size_t size = 0;
+            if (line.scan(u"Hugepagesize: %d kB", {&size})) {
+                _hugeMemoryPageSize = size * 1024;
+                break;
+            }
+        }
+    }
+
 #endif
 }
@@ -117,6 +117,12 @@ namespace ts {
         //! @return The system memory page size in bytes.
         //!
         size_t memoryPageSize() const { return _memoryPageSize; }
+        //!
+        //! Get system huge memory page size.
+        //! Huge memory pages are currently supported on Linux only.
+        //! @return The system huge memory page size in bytes or zero if huge pages are not supported.
+        //!
+        size_t hugeMemoryPageSize() const { return _hugeMemoryPageSize; }
 
     private:
         bool    _isLinux;
@@ -133,5 +139,6 @@ namespace ts {
         UString _systemName;
         UString _hostName;
         size_t  _memoryPageSize;
+        size_t  _hugeMemoryPageSize;
     };
 }
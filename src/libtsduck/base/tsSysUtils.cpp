@@ -42,6 +42,8 @@ TSDUCK_SOURCE;
 
 #if defined(TS_LINUX)
 #include "tsFileUtils.h"
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 #endif
 
 #if defined(TS_MAC)
@@ -800,3 +802,74 @@ ts::UString ts::ClassName(const std::type_info& info)
     }
     return name;
 }
+
+
+//----------------------------------------------------------------------------
+// NUMA topology.
+//----------------------------------------------------------------------------
+
+size_t ts::NUMANodeCount()
+{
+#if defined(TS_LINUX)
+    size_t count = 0;
+    while (IsDirectory(UString::Format(u"/sys/devices/system/node/node%d", {count}))) {
+        count++;
+    }
+    return std::max<size_t>(1, count);
+#else
+    return 1;
+#endif
+}
+
+bool ts::GetNUMANodeCPUs(size_t node, std::set<size_t>& cpus)
+{
+    cpus.clear();
+
+#if defined(TS_LINUX)
+    // The file contains a list of CPU ranges such as "0-7,16-23".
+    UStringList lines;
+    return UString::Load(lines, UString::Format(u"/sys/devices/system/node/node%d/cpulist", {node})) &&
+           !lines.empty() &&
+           DecodeCPUList(lines.front(), cpus);
+#else
+    return false;
+#endif
+}
+
+bool ts::DecodeCPUList(const UString& list, std::set<size_t>& cpus)
+{
+    cpus.clear();
+    UStringVector ranges;
+    list.split(ranges, u',', true, true);
+    for (const auto& range : ranges) {
+        size_t first = 0;
+        size_t last = 0;
+        if (range.scan(u"%d-%d", {&first, &last}) && first <= last) {
+            for (size_t cpu = first; cpu <= last; ++cpu) {
+                cpus.insert(cpu);
+            }
+        }
+        else if (range.toInteger(first)) {
+            cpus.insert(first);
+        }
+        else {
+            cpus.clear();
+            return false;
+        }
+    }
+    return !cpus.empty();
+}
+
+bool ts::BindMemoryToNUMANode(void* address, size_t size, size_t node)
+{
+#if defined(TS_LINUX)
+    // Build a node mask with one bit per node.
+    constexpr size_t bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] = 1UL << (node % bits);
+    // The kernel ignores the last bit of the mask (historical bug of the mbind system call).
+    return ::syscall(SYS_mbind, address, size, MPOL_BIND, mask.data(), mask.size() * bits + 1, MPOL_MF_MOVE) == 0;
+#else
+    return false;
+#endif
+}
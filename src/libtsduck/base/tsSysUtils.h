@@ -320,6 +320,41 @@ namespace ts {
     //!
     TSDUCKDLL void GetProcessMetrics(ProcessMetrics& metrics);
 
+    //!
+    //! Get the number of NUMA nodes in the system.
+    //! NUMA topology is currently available on Linux only.
+    //! @return The number of NUMA nodes. On systems without NUMA support, return 1.
+    //!
+    TSDUCKDLL size_t NUMANodeCount();
+
+    //!
+    //! Get the CPU's of a NUMA node.
+    //! NUMA topology is currently available on Linux only.
+    //! @param [in] node NUMA node index.
+    //! @param [out] cpus Receive the set of CPU indexes in @a node.
+    //! @return True on success, false if @a node does not exist or NUMA is not supported.
+    //!
+    TSDUCKDLL bool GetNUMANodeCPUs(size_t node, std::set<size_t>& cpus);
+
+    //!
+    //! Decode a list of CPU indexes in the format which is used by the Linux kernel.
+    //! @param [in] list List of CPU indexes and ranges, for instance "0-3,8,10-11".
+    //! @param [out] cpus Receive the set of CPU indexes.
+    //! @return True on success, false if @a list is invalid or empty.
+    //!
+    TSDUCKDLL bool DecodeCPUList(const UString& list, std::set<size_t>& cpus);
+
+    //!
+    //! Bind a memory area on a NUMA node.
+    //! The pages of the memory area are allocated on @a node. Pages which are already
+    //! allocated on another node are moved. NUMA binding is currently implemented on Linux only.
+    //! @param [in] address Address of the memory area. Must be aligned on a memory page boundary.
+    //! @param [in] size Size in bytes of the memory area.
+    //! @param [in] node NUMA node index.
+    //! @return True on success, false on error or if NUMA is not supported.
+    //!
+    TSDUCKDLL bool BindMemoryToNUMANode(void* address, size_t size, size_t node);
+
     //!
     //! Ensure that writing to a broken pipe does not kill the current process.
     //!
@@ -34,6 +34,12 @@
 #include "tsSysUtils.h"
 #include "tsSysInfo.h"
 #include "tsIntegerUtils.h"
+
+#if defined(TS_LINUX)
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
 TSDUCK_SOURCE;
 
 
@@ -380,6 +386,33 @@ void* ts::Thread::ThreadProc(void* parameter)
     }
 #endif
 
+#if defined(TS_LINUX)
+    // Apply CPU affinity and NUMA placement from the thread itself. Errors are ignored,
+    // the thread runs anyway, without placement.
+    std::set<size_t> cpus(thread->_attributes._cpuAffinity);
+    if (cpus.empty() && thread->_attributes._numaNode >= 0) {
+        GetNUMANodeCPUs(size_t(thread->_attributes._numaNode), cpus);
+    }
+    if (!cpus.empty()) {
+        ::cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (auto cpu : cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpuset);
+            }
+        }
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuset), &cpuset);
+    }
+    if (thread->_attributes._numaNode >= 0) {
+        // Preferably allocate memory of this thread on its node.
+        constexpr size_t bits = 8 * sizeof(unsigned long);
+        const size_t node = size_t(thread->_attributes._numaNode);
+        std::vector<unsigned long> mask(node / bits + 1, 0);
+        mask[node / bits] = 1UL << (node % bits);
+        ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask.data(), mask.size() * bits + 1);
+    }
+#endif
+
     // Execute thread code.
     thread->mainWrapper();
 
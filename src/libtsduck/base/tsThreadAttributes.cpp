@@ -154,7 +154,9 @@ int ts::ThreadAttributes::Win32Priority(int priority)
 ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
-    _priority(0)
+    _priority(0),
+    _cpuAffinity(),
+    _numaNode(-1)
 {
     if (!_priorityInitialized) {
         InitializePriorities();
@@ -117,6 +117,59 @@ namespace ts {
             return _deleteWhenTerminated;
         }
 
+        //!
+        //! Set the CPU affinity of the thread.
+        //!
+        //! The thread is allowed to run only on the specified CPU's. CPU affinity is
+        //! currently implemented on Linux only. It is ignored on other systems.
+        //!
+        //! @param [in] cpus Set of allowed CPU indexes. An empty set (the default)
+        //! means that the thread can run on any CPU, or on the CPU's of its NUMA node.
+        //! @return A reference to this object.
+        //! @see setNUMANode()
+        //!
+        ThreadAttributes& setCPUAffinity(const std::set<size_t>& cpus)
+        {
+            _cpuAffinity = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //!
+        //! @return The set of allowed CPU indexes. An empty set means any CPU.
+        //!
+        const std::set<size_t>& getCPUAffinity() const
+        {
+            return _cpuAffinity;
+        }
+
+        //!
+        //! Set the NUMA node of the thread.
+        //!
+        //! When no explicit CPU affinity is set, the thread runs on the CPU's of this node.
+        //! Memory allocations by the thread are preferably done on this node.
+        //! NUMA placement is currently implemented on Linux only. It is ignored on other systems.
+        //!
+        //! @param [in] node NUMA node index. A negative value (the default) means no NUMA preference.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setNUMANode(int node)
+        {
+            _numaNode = node;
+            return *this;
+        }
+
+        //!
+        //! Get the NUMA node of the thread.
+        //!
+        //! @return The NUMA node index or a negative value for no NUMA preference.
+        //!
+        int getNUMANode() const
+        {
+            return _numaNode;
+        }
+
         //!
         //! Set the priority for the thread.
         //!
@@ -241,6 +294,8 @@ namespace ts {
         size_t _stackSize;
         bool _deleteWhenTerminated;
         int _priority;
+        std::set<size_t> _cpuAffinity;
+        int _numaNode;
 
         //
         // These fields describe the operating system priority range.
@@ -314,6 +314,22 @@ namespace ts {
         //!
         virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length);
 
+        //!
+        //! Check if encryption is allowed with the current key and increment the usage counter.
+        //! This is automatically done by encrypt() and encryptInPlace(). A subclass which provides
+        //! other encryption methods shall call it once per encrypted message.
+        //! @return True if encryption is allowed, false otherwise.
+        //!
+        bool allowEncrypt();
+
+        //!
+        //! Check if decryption is allowed with the current key and increment the usage counter.
+        //! This is automatically done by decrypt() and decryptInPlace(). A subclass which provides
+        //! other decryption methods shall call it once per decrypted message.
+        //! @return True if decryption is allowed, false otherwise.
+        //!
+        bool allowDecrypt();
+
     private:
         bool      _key_set;                // Current key successfully set.
         int       _cipher_id;              // Cipher identity (from application).
@@ -323,9 +339,5 @@ namespace ts {
         size_t    _key_decrypt_max;        // Maximum number of times a key should be used for decryption.
         ByteBlock _current_key;            // Current unscheduled key.
         BlockCipherAlertInterface* _alert; // Alert handler.
-
-        // Check if encryption or decryption is allowed. Increment counters.
-        bool allowEncrypt();
-        bool allowDecrypt();
     };
 }
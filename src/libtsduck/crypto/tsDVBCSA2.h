@@ -88,6 +88,34 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        //!
+        //! Encrypt several data blocks in place with the current control word.
+        //!
+        //! The result is the same as calling encryptInPlace() on each data block. However,
+        //! the stream cipher part of DVB-CSA2, the most expensive one, is computed on all
+        //! data blocks in parallel using a bitsliced implementation. This is typically used
+        //! to scramble the payloads of many TS packets with the same control word. On x86-64
+        //! Linux systems, the AVX2 instruction set is used when the CPU supports it.
+        //!
+        //! @param [in,out] data Array of @a count addresses of data blocks to encrypt in place.
+        //! @param [in] sizes Array of @a count sizes of the data blocks in bytes. Each data
+        //! block must not be larger than a TS packet payload (184 bytes).
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error. When the maximum number of usages of
+        //! the control word is reached, only the first data blocks are encrypted.
+        //!
+        bool encryptBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt several data blocks in place with the current control word.
+        //! @param [in,out] data Array of @a count addresses of data blocks to decrypt in place.
+        //! @param [in] sizes Array of @a count sizes of the data blocks in bytes.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //! @see encryptBatch()
+        //!
+        bool decryptBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
         // Implementation of CipherChaining interface. Cannot set IV with DVB CSA.
         virtual bool setIV(const void*, size_t) override;
         virtual size_t minIVSize() const override;
@@ -145,6 +173,9 @@ namespace ts {
             void cipher(const uint8_t* sb, uint8_t *cb);
         };
 
+        // Apply the bitsliced stream cipher on data blocks of 8 bytes or more (see tsDVBCSA2Batch.cpp).
+        void streamBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
         // DVB-CSA scrambling data
         bool         _init;
         EntropyMode  _mode;
@@ -0,0 +1,708 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  DVB-CSA2 batch processing with a bitsliced stream cipher.
+//
+//  The stream cipher is the most expensive part of DVB-CSA2. It is computed
+//  here on many data blocks in parallel, one data block per bit lane ("bit
+//  slicing"). Each bit of the cipher state is a machine word, the bit N of
+//  each word belonging to the Nth data block. The s-boxes are implemented
+//  as boolean expressions. With GCC on x86-64, 256-bit vector words are used
+//  and the code is compiled twice, for AVX2 and the base (SSE2) instruction
+//  set, the right version being selected at runtime.
+//
+//  The block cipher is not bitsliced. It is computed on each data block in
+//  place, before the stream cipher when encrypting, after it when decrypting.
+//
+//----------------------------------------------------------------------------
+
+#include "tsDVBCSA2.h"
+#include "tsMemory.h"
+TSDUCK_SOURCE;
+
+// Use 256-bit vector words when the compiler supports them.
+#if defined(TS_GCC)
+    #define TS_CSA_WIDE 1
+    #define TS_CSA_INLINE inline __attribute__((always_inline))
+#else
+    #define TS_CSA_INLINE inline
+#endif
+
+// On x86-64 Linux with GCC, compile for AVX2 and baseline, select at runtime.
+#if defined(TS_GCC_ONLY) && defined(TS_LINUX) && defined(TS_X86_64) && (__GNUC__ >= 6)
+    #define TS_CSA_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+    #define TS_CSA_TARGET_CLONES
+#endif
+
+// Maximum number of 8-byte blocks in a data block (see tsDVBCSA2.cpp).
+#define MAX_NBLOCKS (184 / 8)
+
+// Under this number of data blocks, the byte-oriented implementation is faster.
+#define MIN_BATCH 8
+
+
+//----------------------------------------------------------------------------
+// Bitsliced s-boxes of the stream cipher.
+// Each s-box has 5 input bits (x4 is the most significant one) and 2 output
+// bits. The boolean expressions were generated from the s-box tables in
+// tsDVBCSA2.cpp and verified for all input values.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    template <typename W>
+    TS_CSA_INLINE void SBox1(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = ~x0;
+        const W t1 = x4 ^ t0;
+        const W t2 = x2 | t1;
+        const W t3 = x4 ^ x2;
+        const W t4 = t3 & ~x0;
+        const W t5 = t2 ^ t4;
+        const W t6 = t5 & x1;
+        const W t7 = t2 ^ t6;
+        const W t8 = ~x2;
+        const W t9 = t3 ^ t0;
+        const W t10 = t8 ^ t9;
+        const W t11 = t10 & x1;
+        const W t12 = t8 ^ t11;
+        const W t13 = t7 ^ t12;
+        const W t14 = t13 & x3;
+        const W t15 = x2 ^ x1;
+        const W t16 = x4 ^ t15;
+        const W t17 = x1 ^ t16;
+        const W t18 = t17 & x0;
+        const W t19 = x1 ^ t18;
+        const W t20 = ~x4;
+        const W t21 = t20 & ~t15;
+        const W t22 = x2 ^ t21;
+        const W t23 = x4 & x1;
+        const W t24 = x2 ^ t23;
+        const W t25 = t22 ^ t24;
+        const W t26 = t25 & x0;
+        const W t27 = t22 ^ t26;
+        const W t28 = t19 ^ t27;
+        const W t29 = t28 & x3;
+        hi = t7 ^ t14;
+        lo = t19 ^ t29;
+    }
+
+    template <typename W>
+    TS_CSA_INLINE void SBox2(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = ~x0;
+        const W t1 = x2 | t0;
+        const W t2 = x2 & ~x4;
+        const W t3 = x0 ^ t2;
+        const W t4 = t1 ^ t3;
+        const W t5 = t4 & x1;
+        const W t6 = t1 ^ t5;
+        const W t7 = x4 ^ x0;
+        const W t8 = x4 ^ x2;
+        const W t9 = t7 & ~t8;
+        const W t10 = t8 ^ t0;
+        const W t11 = t9 ^ t10;
+        const W t12 = t11 & x1;
+        const W t13 = t9 ^ t12;
+        const W t14 = t6 ^ t13;
+        const W t15 = t14 & x3;
+        const W t16 = x2 & ~x0;
+        const W t17 = ~x1;
+        const W t18 = t16 ^ t17;
+        const W t19 = ~x2;
+        const W t20 = x1 & ~x0;
+        const W t21 = t19 ^ t20;
+        const W t22 = t18 ^ t21;
+        const W t23 = t22 & x3;
+        const W t24 = t18 ^ t23;
+        const W t25 = x2 & x0;
+        const W t26 = t25 | t20;
+        const W t27 = ~t26;
+        const W t28 = t27 ^ t26;
+        const W t29 = t28 & x3;
+        const W t30 = t27 ^ t29;
+        const W t31 = t24 ^ t30;
+        const W t32 = t31 & x4;
+        hi = t6 ^ t15;
+        lo = t24 ^ t32;
+    }
+
+    template <typename W>
+    TS_CSA_INLINE void SBox3(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = x3 & ~x2;
+        const W t1 = x3 ^ x2;
+        const W t2 = ~x0;
+        const W t3 = t1 | t2;
+        const W t4 = t0 ^ t3;
+        const W t5 = x2 ^ x0;
+        const W t6 = t4 ^ t5;
+        const W t7 = t6 & x1;
+        const W t8 = t4 ^ t7;
+        const W t9 = x3 ^ t5;
+        const W t10 = x3 & x0;
+        const W t11 = x2 ^ t10;
+        const W t12 = t9 ^ t11;
+        const W t13 = t12 & x1;
+        const W t14 = t9 ^ t13;
+        const W t15 = t8 ^ t14;
+        const W t16 = t15 & x4;
+        const W t17 = x4 ^ x3;
+        const W t18 = ~x3;
+        const W t19 = x4 ^ t18;
+        const W t20 = t17 ^ t19;
+        const W t21 = t20 & x1;
+        const W t22 = t17 ^ t21;
+        const W t23 = x4 ^ t1;
+        const W t24 = t22 ^ t23;
+        const W t25 = t24 & x0;
+        hi = t8 ^ t16;
+        lo = t22 ^ t25;
+    }
+
+    template <typename W>
+    TS_CSA_INLINE void SBox4(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = x1 & ~x2;
+        const W t1 = ~x0;
+        const W t2 = t0 | t1;
+        const W t3 = x2 ^ t2;
+        const W t4 = x2 | x0;
+        const W t5 = x1 ^ x0;
+        const W t6 = t4 & t5;
+        const W t7 = x2 ^ t6;
+        const W t8 = t3 ^ t7;
+        const W t9 = t8 & x3;
+        const W t10 = t3 ^ t9;
+        const W t11 = x1 & ~x0;
+        const W t12 = x2 ^ t11;
+        const W t13 = t12 ^ t5;
+        const W t14 = t13 & x3;
+        const W t15 = t12 ^ t14;
+        const W t16 = t10 ^ t15;
+        const W t17 = t16 & x4;
+        const W t18 = ~x2;
+        const W t19 = t18 ^ t11;
+        const W t20 = x1 ^ t1;
+        const W t21 = t19 ^ t20;
+        const W t22 = t21 & x3;
+        const W t23 = t19 ^ t22;
+        const W t24 = t23 ^ t10;
+        const W t25 = t24 & x4;
+        hi = t10 ^ t17;
+        lo = t23 ^ t25;
+    }
+
+    template <typename W>
+    TS_CSA_INLINE void SBox5(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = x2 & ~x3;
+        const W t1 = ~x1;
+        const W t2 = t0 | t1;
+        const W t3 = x3 ^ t2;
+        const W t4 = x3 ^ x2;
+        const W t5 = x3 & ~x1;
+        const W t6 = t4 & ~t5;
+        const W t7 = t3 ^ t6;
+        const W t8 = t7 & x0;
+        const W t9 = t3 ^ t8;
+        const W t10 = ~x2;
+        const W t11 = t5 ^ t10;
+        const W t12 = x3 ^ t1;
+        const W t13 = t11 ^ t12;
+        const W t14 = t13 & x0;
+        const W t15 = t11 ^ t14;
+        const W t16 = t9 ^ t15;
+        const W t17 = t16 & x4;
+        const W t18 = x4 & x3;
+        const W t19 = x2 & ~x4;
+        const W t20 = t18 | t19;
+        const W t21 = x3 & ~x2;
+        const W t22 = x4 ^ t21;
+        const W t23 = t20 ^ t22;
+        const W t24 = t23 & x0;
+        const W t25 = t20 ^ t24;
+        const W t26 = ~x4;
+        const W t27 = t26 ^ t0;
+        const W t28 = t4 ^ t27;
+        const W t29 = t28 & x0;
+        const W t30 = t4 ^ t29;
+        const W t31 = t25 ^ t30;
+        const W t32 = t31 & x1;
+        hi = t9 ^ t17;
+        lo = t25 ^ t32;
+    }
+
+    template <typename W>
+    TS_CSA_INLINE void SBox6(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = x3 | x0;
+        const W t1 = x2 & t0;
+        const W t2 = ~x3;
+        const W t3 = x3 | x2;
+        const W t4 = x2 ^ x0;
+        const W t5 = t3 & ~t4;
+        const W t6 = t2 ^ t5;
+        const W t7 = t1 ^ t6;
+        const W t8 = t7 & x1;
+        const W t9 = t1 ^ t8;
+        const W t10 = t0 & t4;
+        const W t11 = t6 ^ t10;
+        const W t12 = t11 & x1;
+        const W t13 = t6 ^ t12;
+        const W t14 = t9 ^ t13;
+        const W t15 = t14 & x4;
+        const W t16 = x2 & ~x3;
+        const W t17 = x0 ^ t16;
+        const W t18 = x0 & ~x2;
+        const W t19 = x3 ^ t18;
+        const W t20 = x3 & x0;
+        const W t21 = t3 ^ t20;
+        const W t22 = t19 ^ t21;
+        const W t23 = t22 & x4;
+        const W t24 = t19 ^ t23;
+        const W t25 = t17 ^ t24;
+        const W t26 = t25 & x1;
+        hi = t9 ^ t15;
+        lo = t17 ^ t26;
+    }
+
+    template <typename W>
+    TS_CSA_INLINE void SBox7(W& hi, W& lo, const W& x4, const W& x3, const W& x2, const W& x1, const W& x0)
+    {
+        const W t0 = x2 ^ x0;
+        const W t1 = x3 ^ t0;
+        const W t2 = x3 & ~x0;
+        const W t3 = ~x2;
+        const W t4 = t2 ^ t3;
+        const W t5 = t1 ^ t4;
+        const W t6 = t5 & x1;
+        const W t7 = t1 ^ t6;
+        const W t8 = x3 ^ x0;
+        const W t9 = t8 | t3;
+        const W t10 = x3 ^ t9;
+        const W t11 = x3 ^ t10;
+        const W t12 = t11 & x1;
+        const W t13 = x3 ^ t12;
+        const W t14 = t7 ^ t13;
+        const W t15 = t14 & x4;
+        const W t16 = x3 | x2;
+        const W t17 = x4 ^ t16;
+        const W t18 = ~x4;
+        const W t19 = t18 ^ t16;
+        const W t20 = t17 ^ t19;
+        const W t21 = t20 & x0;
+        const W t22 = t17 ^ t21;
+        const W t23 = x4 | x3;
+        const W t24 = x3 & x2;
+        const W t25 = t23 ^ t24;
+        const W t26 = t25 ^ t17;
+        const W t27 = t26 & x0;
+        const W t28 = t25 ^ t27;
+        const W t29 = t22 ^ t28;
+        const W t30 = t29 & x1;
+        hi = t7 ^ t15;
+        lo = t22 ^ t30;
+    }
+
+
+    // Access a 64-bit chunk of a bitsliced word (64 data blocks per chunk).
+    template <typename W>
+    TS_CSA_INLINE uint64_t& Chunk(W& w, size_t index)
+    {
+        return reinterpret_cast<uint64_t*>(&w)[index];
+    }
+
+    // XOR two 8-byte blocks.
+    TS_CSA_INLINE void Xor8(uint8_t* res, const uint8_t* a, const uint8_t* b)
+    {
+        ts::PutUInt64LE(res, ts::GetUInt64LE(a) ^ ts::GetUInt64LE(b));
+    }
+
+    // Transpose a 64x64 bit matrix: bit c of m[r] is swapped with bit r of m[c].
+    TS_CSA_INLINE void Transpose64(uint64_t* m)
+    {
+        static const uint64_t masks[6] = {
+            TS_UCONST64(0x00000000FFFFFFFF),
+            TS_UCONST64(0x0000FFFF0000FFFF),
+            TS_UCONST64(0x00FF00FF00FF00FF),
+            TS_UCONST64(0x0F0F0F0F0F0F0F0F),
+            TS_UCONST64(0x3333333333333333),
+            TS_UCONST64(0x5555555555555555),
+        };
+        size_t level = 0;
+        for (size_t j = 32; j != 0; j >>= 1, level++) {
+            const uint64_t mask = masks[level];
+            for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+                const uint64_t t = ((m[k] >> j) ^ m[k | j]) & mask;
+                m[k | j] ^= t;
+                m[k] ^= t << j;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Bitsliced stream cipher on up to 8*sizeof(W) data blocks.
+    // - key: 8-byte control word, after entropy reduction.
+    // - data, sizes, count: data blocks to process (all at least 8 bytes).
+    // The first 8 bytes of each data block initialize the stream cipher.
+    // The generated key stream is XOR'ed with the rest of the data block.
+    //------------------------------------------------------------------------
+
+    template <typename W>
+    TS_CSA_INLINE void StreamBatch(const uint8_t* key, uint8_t* const data[], const size_t sizes[], size_t count)
+    {
+        static const size_t CHUNKS = sizeof(W) / sizeof(uint64_t);
+        static const size_t STEPS = 32;  // 4 steps per byte, 8 bytes per block.
+        assert(count <= 64 * CHUNKS);
+
+        const W zero = W();
+        const W ones = ~W();
+
+        // Number of key stream blocks to generate, including residue.
+        size_t nblocks = 0;
+        for (size_t i = 0; i < count; ++i) {
+            nblocks = std::max(nblocks, (sizes[i] - 1) / 8);
+        }
+
+        // Register A and B history: A[k] at step s is a[10+s-k]. Other registers are nibbles.
+        W a[10 + STEPS][4];
+        W b[10 + STEPS][4];
+        W X[4], Y[4], Z[4], D[4], E[4], F[4];
+        W p = zero, q = zero, r = zero;
+
+        // Load first 32 bits of key into A[1]..A[8], last 32 bits into B[1]..B[8], all other registers to zero.
+        for (size_t k = 1; k <= 10; ++k) {
+            const uint8_t ka = k > 8 ? 0 : uint8_t(key[(k - 1) / 2] >> (k % 2 == 1 ? 4 : 0));
+            const uint8_t kb = k > 8 ? 0 : uint8_t(key[4 + (k - 1) / 2] >> (k % 2 == 1 ? 4 : 0));
+            for (size_t bit = 0; bit < 4; ++bit) {
+                a[10 - k][bit] = (ka >> bit) & 1 ? ones : zero;
+                b[10 - k][bit] = (kb >> bit) & 1 ? ones : zero;
+            }
+        }
+        for (size_t bit = 0; bit < 4; ++bit) {
+            X[bit] = Y[bit] = Z[bit] = D[bit] = E[bit] = F[bit] = zero;
+        }
+
+        // Bitsliced input (initialization block) and output (key stream block). Index is bit number in little endian 64-bit value.
+        W io[64];
+        uint64_t matrix[64];
+
+        // Transpose the first 8 bytes of each data block into the input rows.
+        for (size_t chunk = 0; chunk < CHUNKS; ++chunk) {
+            for (size_t lane = 0; lane < 64; ++lane) {
+                const size_t i = 64 * chunk + lane;
+                matrix[lane] = i < count ? ts::GetUInt64LE(data[i]) : 0;
+            }
+            Transpose64(matrix);
+            for (size_t n = 0; n < 64; ++n) {
+                Chunk(io[n], chunk) = matrix[n];
+            }
+        }
+
+        // Block 0 is the initialization, the others generate the key stream.
+        for (size_t blk = 0; blk <= nblocks; ++blk) {
+            const bool init = blk == 0;
+            for (size_t s = 0; s < STEPS; ++s) {
+                // A[k] is A[-k] and B[k] is B[-k].
+                W (*const A)[4] = a + 10 + s;
+                W (*const B)[4] = b + 10 + s;
+                const size_t byte = s / 4;
+                const size_t j = s % 4;
+
+                // From A[1]..A[10], 35 bits are selected as inputs to 7 s-boxes.
+                W s1[2], s2[2], s3[2], s4[2], s5[2], s6[2], s7[2];
+                SBox1(s1[1], s1[0], A[-4][0], A[-1][2], A[-6][1], A[-7][3], A[-9][0]);
+                SBox2(s2[1], s2[0], A[-2][1], A[-3][2], A[-6][3], A[-7][0], A[-9][1]);
+                SBox3(s3[1], s3[0], A[-1][3], A[-2][0], A[-5][1], A[-5][3], A[-6][2]);
+                SBox4(s4[1], s4[0], A[-3][3], A[-1][1], A[-2][3], A[-4][2], A[-8][0]);
+                SBox5(s5[1], s5[0], A[-5][2], A[-4][3], A[-6][0], A[-8][1], A[-9][2]);
+                SBox6(s6[1], s6[0], A[-3][1], A[-4][1], A[-5][0], A[-7][2], A[-9][3]);
+                SBox7(s7[1], s7[0], A[-2][2], A[-3][0], A[-7][1], A[-8][2], A[-8][3]);
+
+                // Use 4x4 xor to produce extra nibble for T3.
+                W extra_B[4];
+                extra_B[3] = B[-3][0] ^ B[-6][1] ^ B[-7][2] ^ B[-9][3];
+                extra_B[2] = B[-6][0] ^ B[-8][1] ^ B[-3][3] ^ B[-4][2];
+                extra_B[1] = B[-5][3] ^ B[-8][2] ^ B[-4][0] ^ B[-5][1];
+                extra_B[0] = B[-9][2] ^ B[-6][3] ^ B[-3][1] ^ B[-8][0];
+
+                // T1 and T2: in1, in2 and D are only used during initialization.
+                // in1 is the most significant nibble of the input byte, in2 the least significant one.
+                W next_A1[4], next_B1[4];
+                for (size_t bit = 0; bit < 4; ++bit) {
+                    next_A1[bit] = A[-10][bit] ^ X[bit];
+                    next_B1[bit] = B[-7][bit] ^ B[-10][bit] ^ Y[bit];
+                    if (init) {
+                        const W& in1 = io[8 * byte + 4 + bit];
+                        const W& in2 = io[8 * byte + bit];
+                        next_A1[bit] ^= D[bit] ^ (j % 2 != 0 ? in2 : in1);
+                        next_B1[bit] ^= j % 2 != 0 ? in1 : in2;
+                    }
+                }
+
+                // If p=1, rotate next_B1 left.
+                const W b3 = next_B1[3];
+                next_B1[3] ^= (next_B1[3] ^ next_B1[2]) & p;
+                next_B1[2] ^= (next_B1[2] ^ next_B1[1]) & p;
+                next_B1[1] ^= (next_B1[1] ^ next_B1[0]) & p;
+                next_B1[0] ^= (next_B1[0] ^ b3) & p;
+
+                // T3 and T4: if q=1, F = Z + E + r, with r as carry, else F = E.
+                W carry = r;
+                for (size_t bit = 0; bit < 4; ++bit) {
+                    D[bit] = E[bit] ^ Z[bit] ^ extra_B[bit];
+                    const W ze = Z[bit] ^ E[bit];
+                    const W sum = ze ^ carry;
+                    carry = (Z[bit] & E[bit]) | (carry & ze);
+                    const W next_E = F[bit];
+                    F[bit] = E[bit] ^ ((E[bit] ^ sum) & q);
+                    E[bit] = next_E;
+                }
+                r ^= (r ^ carry) & q;
+
+                // Shift registers A and B.
+                for (size_t bit = 0; bit < 4; ++bit) {
+                    A[0][bit] = next_A1[bit];
+                    B[0][bit] = next_B1[bit];
+                }
+
+                X[3] = s4[0]; X[2] = s3[0]; X[1] = s2[1]; X[0] = s1[1];
+                Y[3] = s6[0]; Y[2] = s5[0]; Y[1] = s4[1]; Y[0] = s3[1];
+                Z[3] = s2[0]; Z[2] = s1[0]; Z[1] = s6[1]; Z[0] = s5[1];
+                p = s7[1];
+                q = s7[0];
+
+                // 2 output bits are a function of the 4 bits of D.
+                if (!init) {
+                    io[8 * byte + 7 - 2 * j] = D[3] ^ D[2];
+                    io[8 * byte + 6 - 2 * j] = D[1] ^ D[0];
+                }
+            }
+
+            // Restart the register histories from the last 10 values.
+            for (size_t k = 0; k < 10; ++k) {
+                for (size_t bit = 0; bit < 4; ++bit) {
+                    a[k][bit] = a[STEPS + k][bit];
+                    b[k][bit] = b[STEPS + k][bit];
+                }
+            }
+
+            // Transpose the key stream and XOR it with the data blocks.
+            if (!init) {
+                const size_t offset = 8 * blk;
+                for (size_t chunk = 0; chunk < CHUNKS && 64 * chunk < count; ++chunk) {
+                    for (size_t n = 0; n < 64; ++n) {
+                        matrix[n] = Chunk(io[n], chunk);
+                    }
+                    Transpose64(matrix);
+                    for (size_t lane = 0; lane < 64 && 64 * chunk + lane < count; ++lane) {
+                        const size_t i = 64 * chunk + lane;
+                        if (offset + 8 <= sizes[i]) {
+                            ts::PutUInt64LE(data[i] + offset, ts::GetUInt64LE(data[i] + offset) ^ matrix[lane]);
+                        }
+                        else {
+                            for (size_t k = 0; offset + k < sizes[i]; ++k) {
+                                data[i][offset + k] ^= uint8_t(matrix[lane] >> (8 * k));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Non-inline instances, possibly compiled for several instruction sets.
+    void StreamBatch64(const uint8_t* key, uint8_t* const data[], const size_t sizes[], size_t count)
+    {
+        StreamBatch<uint64_t>(key, data, sizes, count);
+    }
+
+#if defined(TS_CSA_WIDE)
+    typedef uint64_t WideWord __attribute__((vector_size(32)));
+
+    TS_CSA_TARGET_CLONES
+    void StreamBatchWide(const uint8_t* key, uint8_t* const data[], const size_t sizes[], size_t count)
+    {
+        StreamBatch<WideWord>(key, data, sizes, count);
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Process a batch of data blocks with the bitsliced stream cipher.
+// Data blocks must be at least 8 bytes long.
+//----------------------------------------------------------------------------
+
+void ts::DVBCSA2::streamBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    while (count > 0) {
+#if defined(TS_CSA_WIDE)
+        // Use wide words when there is more than 64 data blocks.
+        if (count > 64) {
+            const size_t n = std::min<size_t>(count, 8 * sizeof(WideWord));
+            StreamBatchWide(_key, data, sizes, n);
+            data += n;
+            sizes += n;
+            count -= n;
+            continue;
+        }
+#endif
+        const size_t n = std::min<size_t>(count, 64);
+        StreamBatch64(_key, data, sizes, n);
+        data += n;
+        sizes += n;
+        count -= n;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt several data blocks with the same control word.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCSA2::encryptBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    // Filter invalid parameters.
+    if (!_init || (count > 0 && (data == nullptr || sizes == nullptr))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == nullptr || sizes[i] > 8 * MAX_NBLOCKS) {
+            return false;
+        }
+    }
+
+    // With small batches, use the byte-oriented implementation.
+    if (count < MIN_BATCH) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = encryptInPlace(data[i], sizes[i]);
+        }
+        return ok;
+    }
+
+    // Check key usage for each data block, process only allowed ones.
+    size_t allowed = 0;
+    while (allowed < count && allowEncrypt()) {
+        allowed++;
+    }
+
+    // Select data blocks to scramble, packets smaller than 8 bytes are left unscrambled.
+    std::vector<uint8_t*> bdata;
+    std::vector<size_t> bsizes;
+    bdata.reserve(allowed);
+    bsizes.reserve(allowed);
+
+    // Perform block cipher in reverse CBC mode on each data block, in place.
+    // After last block is initialization vector (zero in DVB-CSA).
+    for (size_t i = 0; i < allowed; ++i) {
+        const size_t nblocks = sizes[i] / 8;
+        if (nblocks > 0) {
+            uint8_t* const blocks = data[i];
+            uint8_t iblock[8];
+            _block.encipher(blocks + 8 * (nblocks - 1), blocks + 8 * (nblocks - 1));
+            for (size_t b = nblocks - 1; b > 0; b--) {
+                Xor8(iblock, blocks + 8 * (b - 1), blocks + 8 * b);
+                _block.encipher(iblock, blocks + 8 * (b - 1));
+            }
+            bdata.push_back(blocks);
+            bsizes.push_back(sizes[i]);
+        }
+    }
+
+    // The first block is scrambled using the block cipher only. Its scrambled value
+    // initializes the stream cipher which scrambles the rest of the data block.
+    streamBatch(bdata.data(), bsizes.data(), bdata.size());
+    return allowed == count;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several data blocks with the same control word.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCSA2::decryptBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    // Filter invalid parameters.
+    if (!_init || (count > 0 && (data == nullptr || sizes == nullptr))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == nullptr || sizes[i] > 8 * MAX_NBLOCKS) {
+            return false;
+        }
+    }
+
+    // With small batches, use the byte-oriented implementation.
+    if (count < MIN_BATCH) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = decryptInPlace(data[i], sizes[i]);
+        }
+        return ok;
+    }
+
+    // Check key usage for each data block, process only allowed ones.
+    size_t allowed = 0;
+    while (allowed < count && allowDecrypt()) {
+        allowed++;
+    }
+
+    // Select data blocks to descramble, packets smaller than 8 bytes are left unscrambled.
+    std::vector<uint8_t*> bdata;
+    std::vector<size_t> bsizes;
+    bdata.reserve(allowed);
+    bsizes.reserve(allowed);
+    for (size_t i = 0; i < allowed; ++i) {
+        if (sizes[i] >= 8) {
+            bdata.push_back(data[i]);
+            bsizes.push_back(sizes[i]);
+        }
+    }
+
+    // The first 8 bytes of each data block initialize the stream cipher
+    // which descrambles the rest of the data block, including the residue.
+    streamBatch(bdata.data(), bsizes.data(), bdata.size());
+
+    // Decipher all blocks in place. The block after the last one is the IV (zero in DVB-CSA).
+    for (size_t i = 0; i < bdata.size(); ++i) {
+        const size_t nblocks = bsizes[i] / 8;
+        uint8_t* const blocks = bdata[i];
+        for (size_t b = 0; b < nblocks; ++b) {
+            _block.decipher(blocks + 8 * b, blocks + 8 * b);
+            if (b + 1 < nblocks) {
+                Xor8(blocks + 8 * b, blocks + 8 * b, blocks + 8 * (b + 1));
+            }
+        }
+    }
+    return allowed == count;
+}
@@ -32,6 +32,10 @@
 #include "tsArgs.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::TSScrambling::DEFAULT_PACKET_WINDOW;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructors.
@@ -41,6 +45,7 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _report(report),
     _scrambling_type(scrambling),
     _explicit_type(false),
+    _packet_window(DEFAULT_PACKET_WINDOW),
     _out_cw_name(),
     _out_cw_file(),
     _cw_list(),
@@ -61,6 +66,7 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _report(other._report),
     _scrambling_type(other._scrambling_type),
     _explicit_type(other._explicit_type),
+    _packet_window(other._packet_window),
     _out_cw_name(),
     _out_cw_file(),
     _cw_list(other._cw_list),
@@ -83,6 +89,7 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _report(other._report),
     _scrambling_type(other._scrambling_type),
     _explicit_type(other._explicit_type),
+    _packet_window(other._packet_window),
     _out_cw_name(),
     _out_cw_file(),
     _cw_list(other._cw_list),
@@ -241,6 +248,13 @@ void ts::TSScrambling::defineArgs(Args &args) const
     args.option(u"dvb-csa2");
     args.help(u"dvb-csa2", u"Use DVB-CSA2 scrambling. This is the default.");
 
+    args.option(u"packet-window", 0, Args::UNSIGNED);
+    args.help(u"packet-window", u"count",
+              u"With DVB-CSA2, number of TS packets which are processed at once in a batch, using a much "
+              u"faster bitsliced implementation. A larger window increases the latency of the stream "
+              u"processing. Zero means that packets are processed one by one. "
+              u"The default is " + UString::Decimal(DEFAULT_PACKET_WINDOW) + u" packets.");
+
     args.option(u"no-entropy-reduction", 'n');
     args.help(u"no-entropy-reduction",
               u"With DVB-CSA2, do not perform control word entropy reduction to 48 bits. "
@@ -290,6 +304,9 @@ bool ts::TSScrambling::loadArgs(DuckContext& duck, Args& args)
     // Set DVB-CSA2 entropy mode regardless of --atis-idsa or --dvb-cissa in case we switch later to DVB-CSA2.
     setEntropyMode(args.present(u"no-entropy-reduction") ? DVBCSA2::FULL_CW : DVBCSA2::REDUCE_ENTROPY);
 
+    // Number of packets to process at once.
+    args.getIntValue(_packet_window, u"packet-window", DEFAULT_PACKET_WINDOW);
+
     // Set AES-CBC/CTR initialization vector. The default is all zeroes.
     ByteBlock iv(AES::BLOCK_SIZE, 0x00);
     const UString hex_iv(args.value(u"iv"));
@@ -582,3 +599,140 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt a batch of TS packets with the current parity and corresponding CW.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* const pkts[], size_t count)
+{
+    // If no current parity is set, start with even by default.
+    if (count > 0 && _encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+        return false;
+    }
+
+    // Without DVB-CSA2, encrypt packets one by one.
+    assert(_encrypt_scv == SC_EVEN_KEY || _encrypt_scv == SC_ODD_KEY || count == 0);
+    DVBCSA2& csa(_dvbcsa[_encrypt_scv & 1]);
+    if (_scrambler[_encrypt_scv & 1] != &csa) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = encrypt(*pkts[i]);
+        }
+        return ok;
+    }
+
+    // Collect payloads up to the first already encrypted packet, if any.
+    // Packets without payload are silently passed. DVB-CSA2 includes the residue.
+    std::vector<uint8_t*> data;
+    std::vector<size_t> sizes;
+    data.reserve(count);
+    sizes.reserve(count);
+    size_t end = 0;
+    for (; end < count && !pkts[end]->isScrambled(); ++end) {
+        if (pkts[end]->hasPayload()) {
+            data.push_back(pkts[end]->getPayload());
+            sizes.push_back(pkts[end]->getPayloadSize());
+        }
+    }
+
+    // Encrypt all packets at once.
+    if (!csa.encryptBatch(data.data(), sizes.data(), data.size())) {
+        _report.error(u"packet encryption error using %s", {csa.name()});
+        return false;
+    }
+    for (size_t i = 0; i < end; ++i) {
+        if (pkts[i]->hasPayload()) {
+            pkts[i]->setScrambling(_encrypt_scv);
+        }
+    }
+
+    if (end < count) {
+        _report.error(u"try to scramble an already scrambled packet");
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt a batch of TS packets with the CW corresponding to the parity in each packet.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decrypt(TSPacket* const pkts[], size_t count)
+{
+    // Process sequences of packets with the same scrambling control value.
+    // Clear and invalid packets are silently accepted, they do not break a sequence.
+    bool ok = true;
+    size_t start = 0;
+    uint8_t scv = SC_CLEAR;
+    for (size_t i = 0; ok && i <= count; ++i) {
+        const uint8_t pkt_scv = i < count ? pkts[i]->getScrambling() : uint8_t(SC_CLEAR);
+        if (i == count || ((pkt_scv == SC_EVEN_KEY || pkt_scv == SC_ODD_KEY) && pkt_scv != scv)) {
+            ok = decryptBatch(pkts + start, i - start);
+            start = i;
+            scv = pkt_scv;
+        }
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt packets with the same scrambling control value.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decryptBatch(TSPacket* const pkts[], size_t count)
+{
+    // Locate the first scrambled packet, the sequence starts there.
+    size_t first = 0;
+    while (first < count && pkts[first]->getScrambling() != SC_EVEN_KEY && pkts[first]->getScrambling() != SC_ODD_KEY) {
+        first++;
+    }
+    if (first >= count) {
+        return true;
+    }
+
+    // Without DVB-CSA2, decrypt packets one by one.
+    const uint8_t scv = pkts[first]->getScrambling();
+    DVBCSA2& csa(_dvbcsa[scv & 1]);
+    if (_scrambler[scv & 1] != &csa) {
+        bool ok = true;
+        for (size_t i = first; ok && i < count; ++i) {
+            ok = decrypt(*pkts[i]);
+        }
+        return ok;
+    }
+
+    // Update current parity. In case of fixed control word, use next key when the scrambling control changes.
+    const uint8_t previous_scv = _decrypt_scv;
+    _decrypt_scv = scv;
+    if (hasFixedCW() && previous_scv != _decrypt_scv && !setNextFixedCW(_decrypt_scv)) {
+        return false;
+    }
+
+    // Collect payloads of scrambled packets. DVB-CSA2 includes the residue.
+    std::vector<uint8_t*> data;
+    std::vector<size_t> sizes;
+    data.reserve(count - first);
+    sizes.reserve(count - first);
+    for (size_t i = first; i < count; ++i) {
+        if (pkts[i]->getScrambling() == scv) {
+            data.push_back(pkts[i]->getPayload());
+            sizes.push_back(pkts[i]->getPayloadSize());
+        }
+    }
+
+    // Decrypt all packets at once.
+    if (!csa.decryptBatch(data.data(), sizes.data(), data.size())) {
+        _report.error(u"packet decryption error using %s", {csa.name()});
+        return false;
+    }
+    for (size_t i = first; i < count; ++i) {
+        if (pkts[i]->getScrambling() == scv) {
+            pkts[i]->setScrambling(SC_CLEAR);
+        }
+    }
+    return true;
+}
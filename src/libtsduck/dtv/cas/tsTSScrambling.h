@@ -66,6 +66,11 @@ namespace ts {
     class TSDUCKDLL TSScrambling : public ArgsSupplierInterface, private BlockCipherAlertInterface
     {
     public:
+        //!
+        //! Default number of packets to process at once in a batch (see packetWindow()).
+        //!
+        static constexpr size_t DEFAULT_PACKET_WINDOW = 256;
+
         //!
         //! Default constructor.
         //! @param [in,out] report Where to report error and information.
@@ -121,6 +126,14 @@ namespace ts {
         //!
         size_t cwSize() const { return _scrambler[0]->minKeySize(); }
 
+        //!
+        //! Get the number of TS packets to process at once in a batch, from the command line.
+        //! This is a hint for applications which collect packets before calling the batch
+        //! versions of encrypt() and decrypt().
+        //! @return The number of packets to process at once, zero means one by one.
+        //!
+        size_t packetWindow() const { return _packet_window; }
+
         //!
         //! Force the usage of a given algorithm.
         //! @param [in] scrambling Scrambling type.
@@ -192,6 +205,27 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt a batch of TS packets with the current parity and corresponding CW.
+        //! The result is the same as calling encrypt() on each packet. With DVB-CSA2,
+        //! all packets are scrambled at once using DVBCSA2::encryptBatch().
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //!
+        bool encrypt(TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Decrypt a batch of TS packets with the CW corresponding to the parity in each packet.
+        //! The result is the same as calling decrypt() on each packet. With DVB-CSA2,
+        //! consecutive packets with the same parity are descrambled at once using
+        //! DVBCSA2::decryptBatch().
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. A clear packet is not an error.
+        //!
+        bool decrypt(TSPacket* const pkts[], size_t count);
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
@@ -199,6 +233,7 @@ namespace ts {
         Report&          _report;
         uint8_t          _scrambling_type;
         bool             _explicit_type;
+        size_t           _packet_window;
         UString          _out_cw_name;
         std::ofstream    _out_cw_file;
         CWList           _cw_list;
@@ -215,6 +250,9 @@ namespace ts {
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
 
+        // Decrypt packets with the same scrambling control value, using DVB-CSA2 batch processing.
+        bool decryptBatch(TSPacket* const pkts[], size_t count);
+
         // Implementation of BlockCipherAlertInterface.
         virtual bool handleBlockCipherAlert(BlockCipher& cipher, AlertReason reason) override;
 
@@ -35,6 +35,10 @@
 #include "tsEIT.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::SectionDemux::SECTION_POOL_SIZE;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Demux status information.
@@ -130,18 +134,24 @@ ts::SectionDemux::ETIDContext::ETIDContext() :
 }
 
 // Init for a new table.
-void ts::SectionDemux::ETIDContext::init(uint8_t new_version, uint8_t last_section)
+void ts::SectionDemux::ETIDContext::init(SectionDemux& demux, uint8_t new_version, uint8_t last_section)
 {
     notified = false;
     version = new_version;
     sect_expected = size_t(last_section) + 1;
     sect_received = 0;
-    sects.resize(sect_expected);
 
-    // Mark all section entries as unused
-    for (size_t i = 0; i < sect_expected; i++) {
-        sects[i].reset();
+    // Mark all section entries as unused. Sections which are still referenced by the
+    // application (through a notified table) are detached, the others are recycled.
+    for (size_t i = 0; i < sects.size(); i++) {
+        if (sects[i].count() > 1) {
+            sects[i].clear();
+        }
+        else if (!sects[i].isNull()) {
+            demux.recycleSection(sects[i].release());
+        }
     }
+    sects.resize(sect_expected);
 }
 
 // Notify the application if the table is complete.
@@ -183,8 +193,47 @@ ts::SectionDemux::PIDContext::PIDContext() :
     continuity(0),
     sync(false),
     ts(),
-    tids()
+    tids(),
+    last_etid(),
+    last_tc(nullptr)
+{
+}
+
+ts::SectionDemux::PIDContext::PIDContext(const PIDContext& other) :
+    pusi_pkt_index(other.pusi_pkt_index),
+    continuity(other.continuity),
+    sync(other.sync),
+    ts(other.ts),
+    tids(other.tids),
+    last_etid(),
+    last_tc(nullptr)
+{
+}
+
+ts::SectionDemux::PIDContext& ts::SectionDemux::PIDContext::operator=(const PIDContext& other)
+{
+    if (&other != this) {
+        pusi_pkt_index = other.pusi_pkt_index;
+        continuity = other.continuity;
+        sync = other.sync;
+        ts = other.ts;
+        tids = other.tids;
+        last_tc = nullptr;
+    }
+    return *this;
+}
+
+// Get the context of an ETID. Most PID's carry one single table and the
+// successive sections on a PID are often from the same table. The last context
+// is cached. The ETID contexts are never individually erased, so the address
+// of an element in the map remains valid.
+ts::SectionDemux::ETIDContext& ts::SectionDemux::PIDContext::getETID(const ETID& etid)
 {
+    if (last_tc == nullptr || etid != last_etid) {
+        last_etid = etid;
+        last_tc = &tids[etid];
+    }
+    return *last_tc;
 }
 
 // Called when packet synchronization is lost on the pid.
@@ -203,6 +252,8 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
     SuperClass(duck, pid_filter),
     _table_handler(table_handler),
     _section_handler(section_handler),
+    _view_handler(nullptr),
+    _section_pool(),
     _pids(),
     _status(),
     _get_current(true),
@@ -210,6 +261,48 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
 {
 }
 
+ts::SectionDemux::~SectionDemux()
+{
+    for (auto it = _section_pool.begin(); it != _section_pool.end(); ++it) {
+        delete *it;
+    }
+    _section_pool.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Pool of recycled Section objects.
+//----------------------------------------------------------------------------
+
+ts::Section* ts::SectionDemux::getSection(const uint8_t* data, size_t size, PID pid, PacketCounter first_pkt, PacketCounter last_pkt)
+{
+    Section* sect = nullptr;
+    if (_section_pool.empty()) {
+        sect = new Section(data, size, pid, CRC32::IGNORE);
+    }
+    else {
+        // Reuse the memory of the section data when not shared with the application.
+        sect = _section_pool.back();
+        _section_pool.pop_back();
+        sect->reload(data, size, pid, CRC32::IGNORE);
+    }
+    sect->setFirstTSPacketIndex(first_pkt);
+    sect->setLastTSPacketIndex(last_pkt);
+    return sect;
+}
+
+void ts::SectionDemux::recycleSection(Section* sect)
+{
+    if (sect != nullptr) {
+        if (_section_pool.size() < SECTION_POOL_SIZE) {
+            _section_pool.push_back(sect);
+        }
+        else {
+            delete sect;
+        }
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Reset the analysis context (partially built sections and tables).
@@ -464,7 +557,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             // The ETID context is created if did not exist.
             // Avoid accumulating partial sections when there is no table handler.
 
-            ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.tids[etid];
+            ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.getETID(etid);
 
             // If this is a new version of the table, reset the TID context.
             // Note that short sections do not have versions, so the version
@@ -476,7 +569,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
                     tc->sect_expected == 0 ||    // new TID on this PID
                     tc->version != version)      // new version
                 {
-                    tc->init(version, last_section_number);
+                    tc->init(*this, version, last_section_number);
                 }
 
                 // Check that the total number of sections in the table
@@ -487,48 +580,68 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
                 }
             }
 
-            // Create a new Section object if necessary (ie. if a section
-            // hendler is registered or if this is a new section).
-            SectionPtr sect_ptr;
+            // Check if this is a new section to save in the TID context.
+            const bool new_section = section_ok && tc != nullptr && tc->sects[section_number].isNull();
 
-            if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number].isNull()))) {
-                sect_ptr = new Section(ts_start, section_length, pid, CRC32::CHECK);
-                sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
-                sect_ptr->setLastTSPacketIndex(_packet_count);
-                if (!sect_ptr->isValid()) {
+            // Check the CRC32 of long sections in the TS buffer, if the section is used.
+            if (section_ok && long_header && (new_section || _section_handler != nullptr || _view_handler != nullptr)) {
+                const size_t crc_offset = section_length - SECTION_CRC32_SIZE;
+                if (CRC32(ts_start, crc_offset) != GetUInt32(ts_start + crc_offset)) {
                     _status.wrong_crc++;  // only possible error (hum?)
                     section_ok = false;
                 }
             }
 
-            // Mark that we are in the context of a table or section handler.
-            // This is used to prevent the destruction of PID contexts during
-            // the execution of a handler.
-            beforeCallingHandler(pid);
-            try {
-                // If a handler is defined for sections, invoke it.
-                if (section_ok && _section_handler != nullptr) {
-                    _section_handler->handleSection(*this, *sect_ptr);
+            if (section_ok) {
+
+                // Unmanaged Section object, from the pool of recycled sections.
+                // Created only if a section handler is registered or if this is a new section.
+                Section* sect = nullptr;
+
+                // Mark that we are in the context of a table or section handler.
+                // This is used to prevent the destruction of PID contexts during
+                // the execution of a handler.
+                beforeCallingHandler(pid);
+                try {
+                    // If a handler is defined for section views, invoke it without copying the section.
+                    if (_view_handler != nullptr) {
+                        _view_handler->handleSectionView(*this, SectionView(ts_start, section_length, pid, pusi_pkt_index, _packet_count));
+                    }
+
+                    if (_section_handler != nullptr || new_section) {
+                        sect = getSection(ts_start, section_length, pid, pusi_pkt_index, _packet_count);
+                    }
+
+                    // If a handler is defined for sections, invoke it.
+                    if (_section_handler != nullptr) {
+                        _section_handler->handleSection(*this, *sect);
+                    }
+
+                    // Save the section in the TID context if this is a new one.
+                    if (new_section) {
+
+                        // Save the section. The null safe pointer is not shared, reuse it.
+                        tc->sects[section_number].reset(sect);
+                        sect = nullptr;
+                        tc->sect_received++;
+
+                        // If the table is completed and a handler is present, build the table.
+                        tc->notify(*this, false, false);
+                    }
+                }
+                catch (...) {
+                    delete sect;
+                    afterCallingHandler(false);
+                    throw;
                 }
 
-                // Save the section in the TID context if this is a new one.
-                if (section_ok && tc != nullptr && tc->sects[section_number].isNull()) {
-
-                    // Save the section
-                    tc->sects[section_number] = sect_ptr;
-                    tc->sect_received++;
+                // Recycle the section if not saved in the TID context.
+                recycleSection(sect);
 
-                    // If the table is completed and a handler is present, build the table.
-                    tc->notify(*this, false, false);
+                if (afterCallingHandler(true)) {
+                    return;  // the PID of this packet or the complete demux was reset.
                 }
             }
-            catch (...) {
-                afterCallingHandler(false);
-                throw;
-            }
-            if (afterCallingHandler(true)) {
-                return;  // the PID of this packet or the complete demux was reset.
-            }
         }
 
         // Move to next section in the buffer
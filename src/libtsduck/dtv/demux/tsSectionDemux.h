@@ -36,6 +36,8 @@
 #include "tsAbstractDemux.h"
 #include "tsTableHandlerInterface.h"
 #include "tsSectionHandlerInterface.h"
+#include "tsSectionViewHandlerInterface.h"
+#include "tsFlatPIDMap.h"
 #include "tsETID.h"
 
 namespace ts {
@@ -47,6 +49,12 @@ namespace ts {
     //!
     //! Sections with the @e next indicator are ignored. Only sections with the @e current indicator are reported.
     //!
+    //! The Section objects are recycled inside the demux: in steady state, demuxing sections
+    //! does not allocate memory. A Section which is passed to a section handler is reused
+    //! after the handler returns, unless the application keeps a reference on it (through
+    //! a SectionPtr or BinaryTable). Handlers which only need to inspect the sections should
+    //! preferably use a SectionViewHandlerInterface: the sections are then not even copied.
+    //!
     class TSDUCKDLL SectionDemux: public AbstractDemux
     {
         TS_NOBUILD_NOCOPY(SectionDemux);
@@ -69,6 +77,11 @@ namespace ts {
                               SectionHandlerInterface* section_handler = nullptr,
                               const PIDSet& pid_filter = NoPID);
 
+        //!
+        //! Destructor.
+        //!
+        virtual ~SectionDemux() override;
+
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
 
@@ -124,6 +137,16 @@ namespace ts {
             _section_handler = h;
         }
 
+        //!
+        //! Replace the section view handler.
+        //! The section view handler is invoked for each section, before the section handler, if any.
+        //! @param [in] h The new handler.
+        //!
+        void setSectionViewHandler(SectionViewHandlerInterface* h)
+        {
+            _view_handler = h;
+        }
+
         //!
         //! Filter sections based on current/next indicator.
         //! @param [in] current Get "current" tables. This is true by default.
@@ -221,8 +244,8 @@ namespace ts {
             // Default constructor.
             ETIDContext();
 
-            // Init for a new table.
-            void init(uint8_t new_version, uint8_t last_section);
+            // Init for a new table. Previous sections are recycled in the demux.
+            void init(SectionDemux& demux, uint8_t new_version, uint8_t last_section);
 
             // Notify the application if the table is complete.
             // Do not notify twice the same table.
@@ -239,10 +262,19 @@ namespace ts {
             bool          sync;               // We are synchronous in this PID
             ByteBlock     ts;                 // TS payload buffer
             std::map<ETID,ETIDContext> tids;  // TID analysis contexts
+            ETID          last_etid;          // Last accessed ETID (usually the same one in successive sections)
+            ETIDContext*  last_tc;            // Context of last_etid in tids, null if none
 
             // Default constructor.
             PIDContext();
 
+            // Copy constructor and assignment, required by FlatPIDMap, do not copy the last_tc cache.
+            PIDContext(const PIDContext&);
+            PIDContext& operator=(const PIDContext&);
+
+            // Get the context of an ETID, create it if it does not exist.
+            ETIDContext& getETID(const ETID& etid);
+
             // Called when packet synchronization is lost on the pid.
             void syncLost();
         };
@@ -253,13 +285,25 @@ namespace ts {
         // If fill_eit is true, add missing sections in EIT.
         void fixAndFlush(bool pack, bool fill_eit);
 
+        // Get a Section object from the pool of recycled sections, or allocate a new one.
+        // The content is loaded without CRC32 check. The returned object is not managed.
+        Section* getSection(const uint8_t* data, size_t size, PID pid, PacketCounter first_pkt, PacketCounter last_pkt);
+
+        // Return an unmanaged Section object to the pool of recycled sections.
+        void recycleSection(Section* sect);
+
+        // Maximum number of Section objects in the pool. Each one retains up to 4 kB of data.
+        static constexpr size_t SECTION_POOL_SIZE = 256;
+
         // Private members:
-        TableHandlerInterface*   _table_handler;
-        SectionHandlerInterface* _section_handler;
-        std::map<PID,PIDContext> _pids;
-        Status                   _status;
-        bool                     _get_current;
-        bool                     _get_next;
+        TableHandlerInterface*       _table_handler;
+        SectionHandlerInterface*     _section_handler;
+        SectionViewHandlerInterface* _view_handler;
+        std::vector<Section*>        _section_pool;
+        FlatPIDMap<PIDContext>       _pids;
+        Status                       _status;
+        bool                         _get_current;
+        bool                         _get_next;
     };
 }
 
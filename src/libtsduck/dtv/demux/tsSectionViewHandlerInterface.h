@@ -0,0 +1,67 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Abstract interface to receive transient views of MPEG sections from a SectionDemux.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSectionView.h"
+
+namespace ts {
+
+    class SectionDemux;
+
+    //!
+    //! Abstract interface to receive transient views of MPEG sections from a SectionDemux.
+    //! @ingroup mpeg
+    //!
+    //! This abstract interface must be implemented by classes which need to be
+    //! notified of individual sections using a SectionDemux but which do not
+    //! keep them. The section is not copied into a Section object, the view
+    //! directly references the internal buffers of the demux.
+    //!
+    class TSDUCKDLL SectionViewHandlerInterface
+    {
+    public:
+        //!
+        //! This hook is invoked when a complete section is available.
+        //! @param [in,out] demux The demux which sends the section.
+        //! @param [in] section A view of the new section. The CRC32 of long sections
+        //! is already checked. The view is valid only during the execution of the hook.
+        //!
+        virtual void handleSectionView(SectionDemux& demux, const SectionView& section) = 0;
+
+        //!
+        //! Virtual destructor
+        //!
+        virtual ~SectionViewHandlerInterface();
+    };
+}
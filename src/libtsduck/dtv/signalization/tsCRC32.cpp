@@ -28,8 +28,20 @@
 //----------------------------------------------------------------------------
 
 #include "tsCRC32.h"
+#include "tsMemory.h"
 TSDUCK_SOURCE;
 
+// The carry-less multiplication engine is implemented on x86-64 with GCC and clang.
+// The instruction set is selected at function level, the CPU is checked at run time.
+#if defined(TS_X86_64) && defined(TS_GCC) && !defined(TS_NO_CRC32_CLMUL)
+    #define TS_CRC32_CLMUL 1
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+
+// Minimum data size for the carry-less multiplication engine (4 lanes of 16 bytes).
+#define CLMUL_MIN_SIZE 64
+
 
 // The FCS-32 generator polynomial:
 //     x**0 + x**1 + x**2 + x**4 + x**5 +
@@ -105,13 +117,216 @@ namespace {
     };
 }
 
+//----------------------------------------------------------------------------
+// Slice-by-8 tables: slice8_tables()[k][i] is the CRC of byte i followed by
+// k zero bytes, starting from a null CRC. The first table is fcstab_32.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Slice8Tables
+    {
+    public:
+        uint32_t tab[8][256];
+        Slice8Tables();
+    };
+
+    Slice8Tables::Slice8Tables() : tab()
+    {
+        for (size_t i = 0; i < 256; ++i) {
+            tab[0][i] = fcstab_32[i];
+        }
+        for (size_t k = 1; k < 8; ++k) {
+            for (size_t i = 0; i < 256; ++i) {
+                const uint32_t prev = tab[k-1][i];
+                tab[k][i] = (prev << 8) ^ fcstab_32[prev >> 24];
+            }
+        }
+    }
+
+    // Built on first use, in case a CRC is computed during static initialization.
+    const Slice8Tables& slice8_tables()
+    {
+        static const Slice8Tables tables;
+        return tables;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Bytewise engine, the reference implementation.
+//----------------------------------------------------------------------------
+
+namespace {
+    uint32_t crc_bytewise(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        while (size-- > 0) {
+            fcs = (fcs << 8) ^ fcstab_32[((fcs >> 24) ^ (*cp++)) & 0xFF];
+        }
+        return fcs;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Slice-by-8 engine.
+//----------------------------------------------------------------------------
+
+namespace {
+    uint32_t crc_slice8(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        const uint32_t (&tab)[8][256](slice8_tables().tab);
+
+        while (size >= 8) {
+            const uint32_t hi = fcs ^ ts::GetUInt32BE(cp);
+            const uint32_t lo = ts::GetUInt32BE(cp + 4);
+            fcs = tab[7][hi >> 24] ^ tab[6][(hi >> 16) & 0xFF] ^ tab[5][(hi >> 8) & 0xFF] ^ tab[4][hi & 0xFF] ^
+                  tab[3][lo >> 24] ^ tab[2][(lo >> 16) & 0xFF] ^ tab[1][(lo >> 8) & 0xFF] ^ tab[0][lo & 0xFF];
+            cp += 8;
+            size -= 8;
+        }
+        while (size-- > 0) {
+            fcs = (fcs << 8) ^ tab[0][((fcs >> 24) ^ (*cp++)) & 0xFF];
+        }
+        return fcs;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Carry-less multiplication engine.
+//
+// The data are loaded in 128-bit registers in big-endian order (MSB first, as
+// the MPEG CRC is not bit-reflected). Four lanes of 128 bits are folded in
+// parallel over 512-bit distances, using the constants x^(512+64) mod P and
+// x^512 mod P. The lanes are then folded into one over 128-bit distances,
+// using x^(128+64) mod P and x^128 mod P. Folding preserves the value modulo P.
+// The final 128-bit remainder and the trailing bytes are then processed using
+// the slice-by-8 engine, starting from a null CRC.
+//----------------------------------------------------------------------------
+
+#if defined(TS_CRC32_CLMUL)
+
+namespace {
+    bool clmul_supported()
+    {
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 && (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSSE3) != 0;
+    }
+
+    #define TS_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+
+    TS_CLMUL_TARGET inline __m128i clmul_load(const uint8_t* cp, __m128i bswap)
+    {
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cp)), bswap);
+    }
+
+    TS_CLMUL_TARGET inline __m128i clmul_fold(__m128i x, __m128i k)
+    {
+        return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00));
+    }
+
+    TS_CLMUL_TARGET uint32_t crc_clmul(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        // Reverse the byte order of a 128-bit register.
+        const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        // Folding constants (high lane multiplier, low lane multiplier).
+        const __m128i k512 = _mm_set_epi64x(0x8833794C, 0xE6228B11);
+        const __m128i k128 = _mm_set_epi64x(0xC5B9CD4C, 0xE8A45605);
+
+        // Load the first 64 bytes, the previous CRC is added to the first 32 bits.
+        __m128i x0 = _mm_xor_si128(clmul_load(cp, bswap), _mm_set_epi32(int(fcs), 0, 0, 0));
+        __m128i x1 = clmul_load(cp + 16, bswap);
+        __m128i x2 = clmul_load(cp + 32, bswap);
+        __m128i x3 = clmul_load(cp + 48, bswap);
+        cp += 64;
+        size -= 64;
+
+        // Fold four lanes in parallel.
+        while (size >= 64) {
+            x0 = _mm_xor_si128(clmul_fold(x0, k512), clmul_load(cp, bswap));
+            x1 = _mm_xor_si128(clmul_fold(x1, k512), clmul_load(cp + 16, bswap));
+            x2 = _mm_xor_si128(clmul_fold(x2, k512), clmul_load(cp + 32, bswap));
+            x3 = _mm_xor_si128(clmul_fold(x3, k512), clmul_load(cp + 48, bswap));
+            cp += 64;
+            size -= 64;
+        }
+
+        // Reduce to one lane, then fold the remaining 16-byte blocks.
+        x1 = _mm_xor_si128(clmul_fold(x0, k128), x1);
+        x2 = _mm_xor_si128(clmul_fold(x1, k128), x2);
+        x0 = _mm_xor_si128(clmul_fold(x2, k128), x3);
+        while (size >= 16) {
+            x0 = _mm_xor_si128(clmul_fold(x0, k128), clmul_load(cp, bswap));
+            cp += 16;
+            size -= 16;
+        }
+
+        // Final reduction of the 128-bit remainder, followed by the trailing bytes.
+        uint8_t rem[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rem), _mm_shuffle_epi8(x0, bswap));
+        return crc_slice8(crc_slice8(0, rem, sizeof(rem)), cp, size);
+    }
+
+    // Checked once, on first use.
+    bool clmul_available()
+    {
+        static const bool available = clmul_supported();
+        return available;
+    }
+}
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Check if a computation engine is supported on this system.
+//----------------------------------------------------------------------------
+
+bool ts::CRC32::IsSupported(Engine engine)
+{
+    switch (engine) {
+        case BYTEWISE:
+        case SLICE8:
+        case AUTO:
+            return true;
+        case CLMUL:
+#if defined(TS_CRC32_CLMUL)
+            return clmul_available();
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
 // Continue the computation of a data area, following a previous CRC32
+//----------------------------------------------------------------------------
 
-void ts::CRC32::add (const void* data, size_t size)
+void ts::CRC32::add(const void* data, size_t size, Engine engine)
 {
-    const uint8_t* cp = static_cast <const uint8_t*> (data);
+    const uint8_t* cp = static_cast<const uint8_t*>(data);
 
-    while (size-- > 0) {
-        _fcs = (_fcs << 8) ^ fcstab_32 [((_fcs >> 24) ^ (*cp++)) & 0xFF];
+    switch (engine) {
+        case BYTEWISE:
+            _fcs = crc_bytewise(_fcs, cp, size);
+            break;
+        case SLICE8:
+            _fcs = crc_slice8(_fcs, cp, size);
+            break;
+        case CLMUL:
+        case AUTO:
+        default:
+#if defined(TS_CRC32_CLMUL)
+            if (size >= CLMUL_MIN_SIZE && clmul_available()) {
+                _fcs = crc_clmul(_fcs, cp, size);
+                break;
+            }
+#endif
+            // Use slice-by-8 when carry-less multiplication is not usable.
+            _fcs = crc_slice8(_fcs, cp, size);
+            break;
     }
 }
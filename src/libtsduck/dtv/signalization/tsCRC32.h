@@ -45,6 +45,17 @@ namespace ts {
     class TSDUCKDLL CRC32
     {
     public:
+        //!
+        //! Computation engines for the CRC32.
+        //! All engines produce identical results, they differ in performance only.
+        //!
+        enum Engine {
+            BYTEWISE,  //!< Reference implementation, one table lookup per byte.
+            SLICE8,    //!< Portable "slice-by-8" implementation, processes 8 bytes per iteration.
+            CLMUL,     //!< Carry-less multiplication folding, requires PCLMULQDQ on x86-64.
+            AUTO       //!< Select the fastest available engine, depending on the CPU and the data size.
+        };
+
         //!
         //! Default constructor.
         //!
@@ -66,7 +77,27 @@ namespace ts {
         //! @param [in] data Address of area to analyze.
         //! @param [in] size Size in bytes of area to analyze.
         //!
-        void add(const void* data, size_t size);
+        void add(const void* data, size_t size)
+        {
+            add(data, size, AUTO);
+        }
+
+        //!
+        //! Continue the computation of a data area using a specific engine.
+        //! This is typically used to test or benchmark the engines.
+        //! @param [in] data Address of area to analyze.
+        //! @param [in] size Size in bytes of area to analyze.
+        //! @param [in] engine The computation engine to use. If the engine is not
+        //! supported on this system, the fastest supported engine is used instead.
+        //!
+        void add(const void* data, size_t size, Engine engine);
+
+        //!
+        //! Check if a computation engine is supported on this system.
+        //! @param [in] engine The computation engine to check.
+        //! @return True if @a engine is supported on this system.
+        //!
+        static bool IsSupported(Engine engine);
 
         //!
         //! Get the value of the CRC32 as computed so far.
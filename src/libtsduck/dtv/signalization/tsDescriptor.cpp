@@ -43,17 +43,20 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 ts::Descriptor::Descriptor(const void* addr, size_t size) :
-    _data(size >= 2 && size < 258 && (reinterpret_cast<const uint8_t*>(addr))[1] == size - 2 ? new ByteBlock(addr, size) : nullptr)
+    _data(size >= 2 && size < 258 && (reinterpret_cast<const uint8_t*>(addr))[1] == size - 2 ? new ByteBlock(addr, size) : nullptr),
+    _offset(0)
 {
 }
 
 ts::Descriptor::Descriptor(const ByteBlock& bb) :
-    _data(bb.size() >= 2 && bb.size() < 258 && bb[1] == bb.size() - 2 ? new ByteBlock(bb) : nullptr)
+    _data(bb.size() >= 2 && bb.size() < 258 && bb[1] == bb.size() - 2 ? new ByteBlock(bb) : nullptr),
+    _offset(0)
 {
 }
 
 ts::Descriptor::Descriptor(DID tag, const void* data, size_t size) :
-    _data(size < 256 ? new ByteBlock(size + 2) : nullptr)
+    _data(size < 256 ? new ByteBlock(size + 2) : nullptr),
+    _offset(0)
 {
     if (!_data.isNull()) {
         (*_data)[0] = tag;
@@ -63,7 +66,8 @@ ts::Descriptor::Descriptor(DID tag, const void* data, size_t size) :
 }
 
 ts::Descriptor::Descriptor(DID tag, const ByteBlock& data) :
-    _data(data.size() < 256 ? new ByteBlock(2) : nullptr)
+    _data(data.size() < 256 ? new ByteBlock(2) : nullptr),
+    _offset(0)
 {
     if (!_data.isNull()) {
         (*_data)[0] = tag;
@@ -73,7 +77,8 @@ ts::Descriptor::Descriptor(DID tag, const ByteBlock& data) :
 }
 
 ts::Descriptor::Descriptor(const ByteBlockPtr& bbp, ShareMode mode) :
-    _data(nullptr)
+    _data(nullptr),
+    _offset(0)
 {
     if (!bbp.isNull() && bbp->size() >= 2 && bbp->size() < 258 && (*bbp)[1] == bbp->size() - 2) {
         switch (mode) {
@@ -90,15 +95,34 @@ ts::Descriptor::Descriptor(const ByteBlockPtr& bbp, ShareMode mode) :
     }
 }
 
+namespace {
+    // Check if a descriptor completely fits inside a memory block at a given offset.
+    bool FitsInBlock(const ts::ByteBlockPtr& bbp, size_t offset)
+    {
+        return !bbp.isNull() && offset + 2 <= bbp->size() && offset + 2 + (*bbp)[offset + 1] <= bbp->size();
+    }
+}
+
+// Directly initialize _data, avoiding an allocation of a null SafePtr.
+ts::Descriptor::Descriptor(const ByteBlockPtr& bbp, size_t offset) :
+    _data(FitsInBlock(bbp, offset) ? bbp : ByteBlockPtr()),
+    _offset(_data.isNull() ? 0 : offset)
+{
+}
+
 ts::Descriptor::Descriptor(const Descriptor& desc, ShareMode mode) :
-    _data(nullptr)
+    _data(nullptr),
+    _offset(0)
 {
     switch (mode) {
         case ShareMode::SHARE:
             _data = desc._data;
+            _offset = desc._offset;
             break;
         case ShareMode::COPY:
-            _data = new ByteBlock(*desc._data);
+            if (!desc._data.isNull()) {
+                _data = new ByteBlock(desc.content(), desc.size());
+            }
             break;
         default:
             // should not get there
@@ -107,7 +131,8 @@ ts::Descriptor::Descriptor(const Descriptor& desc, ShareMode mode) :
 }
 
 ts::Descriptor::Descriptor(Descriptor&& desc) noexcept :
-    _data(std::move(desc._data))
+    _data(std::move(desc._data)),
+    _offset(desc._offset)
 {
 }
 
@@ -120,6 +145,7 @@ ts::Descriptor& ts::Descriptor::operator=(const Descriptor& desc)
 {
     if (&desc != this) {
         _data = desc._data;
+        _offset = desc._offset;
     }
     return *this;
 }
@@ -128,6 +154,7 @@ ts::Descriptor& ts::Descriptor::operator=(Descriptor&& desc) noexcept
 {
     if (&desc != this) {
         _data = std::move(desc._data);
+        _offset = desc._offset;
     }
     return *this;
 }
@@ -135,7 +162,8 @@ ts::Descriptor& ts::Descriptor::operator=(Descriptor&& desc) noexcept
 ts::Descriptor& ts::Descriptor::copy(const Descriptor& desc)
 {
     if (&desc != this) {
-        _data = new ByteBlock(*desc._data);
+        _data = desc._data.isNull() ? nullptr : new ByteBlock(desc.content(), desc.size());
+        _offset = 0;
     }
     return *this;
 }
@@ -188,9 +216,12 @@ void ts::Descriptor::replacePayload(const void* addr, size_t size)
 {
     if (size > 255) {
         // Payload size too long, invalidate descriptor
-        _data.clear();
+        invalidate();
     }
     else if (!_data.isNull()) {
+        // Keep the previous memory block alive, in case the new payload is inside it.
+        const ByteBlockPtr previous(_data);
+        detach();
         assert(_data->size() >= 2);
         // Erase previous payload
         _data->erase(2, _data->size() - 2);
@@ -212,9 +243,10 @@ void ts::Descriptor::resizePayload(size_t new_size)
 {
     if (new_size > 255) {
         // Payload size too long, invalidate descriptor
-        _data.clear();
+        invalidate();
     }
     else if (!_data.isNull()) {
+        detach();
         assert(_data->size() >= 2);
         size_t old_size = _data->size() - 2;
         _data->resize (new_size + 2);
@@ -234,9 +266,22 @@ void ts::Descriptor::resizePayload(size_t new_size)
 
 bool ts::Descriptor::operator== (const Descriptor& desc) const
 {
-    return _data == desc._data ||
+    return (_data == desc._data && _offset == desc._offset) ||
         (_data.isNull() && desc._data.isNull()) ||
-        (!_data.isNull() && !desc._data.isNull() && *_data == *desc._data);
+        (!_data.isNull() && !desc._data.isNull() && size() == desc.size() && ::memcmp(content(), desc.content(), size()) == 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Make sure the descriptor is the only content of its memory block.
+//----------------------------------------------------------------------------
+
+void ts::Descriptor::detach()
+{
+    if (!_data.isNull() && (_offset != 0 || _data->size() != size())) {
+        _data = new ByteBlock(content(), size());
+        _offset = 0;
+    }
 }
 
 
@@ -349,6 +394,7 @@ bool ts::Descriptor::fromXML(DuckContext& duck, const xml::Element* node, TID ti
         if (node->getIntAttribute<DID>(tag, u"tag", true, 0xFF, 0x00, 0xFF) && node->getHexaText(payload, 0, 255)) {
             // Build descriptor.
             _data = new ByteBlock(2);
+            _offset = 0;
             (*_data)[0] = tag;
             (*_data)[1] = uint8_t(payload.size());
             _data->append(payload);
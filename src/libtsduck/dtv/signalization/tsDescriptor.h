@@ -46,13 +46,19 @@ namespace ts {
     //! Representation of a MPEG PSI/SI descriptors in binary format.
     //! @ingroup mpeg
     //!
+    //! The binary content of a descriptor is either a memory block of its own or a
+    //! view inside a memory block which is shared with other descriptors. The latter
+    //! case is used when a descriptor list is deserialized: the complete descriptor
+    //! loop is copied once and all its descriptors are views inside this copy.
+    //! The descriptor data are duplicated only when the size of a view is modified.
+    //!
     class TSDUCKDLL Descriptor
     {
     public:
         //!
         //! Default constructor.
         //!
-        Descriptor() : _data(nullptr) {}
+        Descriptor() : _data(nullptr), _offset(0) {}
 
         //!
         //! Copy constructor.
@@ -109,6 +115,16 @@ namespace ts {
         //!
         Descriptor(const ByteBlockPtr& bb, ShareMode mode);
 
+        //!
+        //! Constructor of a view inside a memory block, typically a descriptor loop.
+        //! The memory block is shared, not copied. It can be shared with other descriptors.
+        //! @param [in] bb Memory block containing the descriptor.
+        //! @param [in] offset Offset of the descriptor in @a bb. The descriptor size is
+        //! read from the descriptor header. The descriptor is valid only if it completely
+        //! fits inside @a bb.
+        //!
+        Descriptor(const ByteBlockPtr& bb, size_t offset);
+
         //!
         //! Assignment operator.
         //! The content is referenced, and thus shared between the two objects.
@@ -147,6 +163,7 @@ namespace ts {
         void invalidate()
         {
             _data.clear();
+            _offset = 0;
         }
 
         //!
@@ -155,7 +172,7 @@ namespace ts {
         //!
         DID tag() const
         {
-            return _data.isNull() ? 0 : _data->at(0);
+            return _data.isNull() ? 0 : _data->at(_offset);
         }
 
         //!
@@ -180,7 +197,7 @@ namespace ts {
         //!
         const uint8_t* content() const
         {
-            return _data->data();
+            return _data->data() + _offset;
         }
 
         //!
@@ -189,7 +206,7 @@ namespace ts {
         //!
         size_t size() const
         {
-            return _data->size();
+            return size_t(_data->data()[_offset + 1]) + 2;
         }
 
         //!
@@ -198,7 +215,7 @@ namespace ts {
         //!
         const uint8_t* payload() const
         {
-            return _data->data() + 2;
+            return _data->data() + _offset + 2;
         }
 
         //!
@@ -207,7 +224,7 @@ namespace ts {
         //!
         uint8_t* payload()
         {
-            return _data->data() + 2;
+            return _data->data() + _offset + 2;
         }
 
         //!
@@ -216,7 +233,7 @@ namespace ts {
         //!
         size_t payloadSize() const
         {
-            return _data->size() - 2;
+            return size_t(_data->data()[_offset + 1]);
         }
 
         //!
@@ -310,7 +327,11 @@ namespace ts {
     private:
         Descriptor(const Descriptor&) = delete;
 
+        // Make sure the descriptor is the only content of its memory block, before resizing it.
+        void detach();
+
         // Private fields
-        ByteBlockPtr _data; // full binary content of the descriptor
+        ByteBlockPtr _data;    // memory block containing the full binary content of the descriptor
+        size_t       _offset;  // offset of the descriptor in _data
     };
 }
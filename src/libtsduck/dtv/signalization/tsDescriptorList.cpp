@@ -156,16 +156,23 @@ void ts::DescriptorList::add(DuckContext& duck, const AbstractDescriptor& desc)
 
 bool ts::DescriptorList::add(const void* data, size_t size)
 {
-    const uint8_t* desc = reinterpret_cast<const uint8_t*>(data);
+    if (size == 0) {
+        return true;
+    }
+
+    // The memory area is copied once. All descriptors are views inside this copy.
+    const ByteBlockPtr block(new ByteBlock(data, size));
+    CheckNonNull(block.pointer());
+    const uint8_t* const desc = block->data();
+    size_t offset = 0;
     size_t length = 0;
 
-    while (size >= 2 && (length = size_t(desc[1]) + 2) <= size) {
-        add(DescriptorPtr(new Descriptor(desc, length)));
-        desc += length;
-        size -= length;
+    while (offset + 2 <= size && (length = size_t(desc[offset + 1]) + 2) <= size - offset) {
+        add(DescriptorPtr(new Descriptor(block, offset)));
+        offset += length;
     }
 
-    return size == 0;
+    return offset == size;
 }
 
 
@@ -189,6 +189,7 @@ namespace ts {
 
         //!
         //! Add descriptors from a memory area at end of list
+        //! The memory area is copied once and the new descriptors share this copy.
         //! @param [in] addr Address of descriptors in memory.
         //! @param [in] size Size in bytes of descriptors in memory.
         //! @return True in case of succee, false in case of truncated descriptor.
@@ -153,6 +153,8 @@ namespace ts {
         //!
         //! Reload from full binary content.
         //! The content is copied into the section if valid.
+        //! If the previous content of the section is not shared with another
+        //! Section object, its memory is reused, without heap allocation.
         //! @param [in] content Address of the binary section data.
         //! @param [in] content_size Size in bytes of the section.
         //! @param [in] source_pid PID from which the section was read.
@@ -161,10 +163,7 @@ namespace ts {
         void reload(const void* content,
                     size_t content_size,
                     PID source_pid = PID_NULL,
-                    CRC32::Validation crc_op = CRC32::IGNORE)
-        {
-            initialize(new ByteBlock(content, content_size), source_pid, crc_op);
-        }
+                    CRC32::Validation crc_op = CRC32::IGNORE);
 
         //!
         //! Reload from full binary content.
@@ -176,7 +175,7 @@ namespace ts {
                      PID source_pid = PID_NULL,
                      CRC32::Validation crc_op = CRC32::IGNORE)
         {
-            initialize(new ByteBlock(content), source_pid, crc_op);
+            reload(content.data(), content.size(), source_pid, crc_op);
         }
 
         //!
@@ -694,6 +693,9 @@ namespace ts {
         void initialize(PID);
         void initialize(const ByteBlockPtr&, PID, CRC32::Validation);
 
+        // Check the validity of the content of _data.
+        void validate(CRC32::Validation);
+
         // Inaccessible operations
         Section(const Section&) = delete;
     };
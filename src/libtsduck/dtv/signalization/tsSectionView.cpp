@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSectionView.h"
+#include "tsMemory.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::SectionView::SectionView(const uint8_t* content, size_t content_size, PID source_pid, PacketCounter first_pkt, PacketCounter last_pkt) :
+    _data(nullptr),
+    _size(0),
+    _source_pid(source_pid),
+    _first_pkt(first_pkt),
+    _last_pkt(last_pkt)
+{
+    // Same structural checks as in Section, without CRC32 validation.
+    const size_t total_size = Section::SectionSize(content, content_size);
+    if (total_size > 0 && total_size == content_size &&
+        (!Section::StartLongSection(content, content_size) || (content_size >= MIN_LONG_SECTION_SIZE && content[6] <= content[7])))
+    {
+        _data = content;
+        _size = content_size;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the section has a "diversified" payload.
+//----------------------------------------------------------------------------
+
+bool ts::SectionView::hasDiversifiedPayload() const
+{
+    return _data != nullptr && !IdenticalBytes(payload(), payloadSize());
+}
+
+
+//----------------------------------------------------------------------------
+// Build a Section object with a copy of the viewed data.
+//----------------------------------------------------------------------------
+
+void ts::SectionView::toSection(Section& section) const
+{
+    if (_data == nullptr) {
+        section.clear();
+    }
+    else {
+        section.reload(_data, _size, _source_pid, CRC32::IGNORE);
+        section.setFirstTSPacketIndex(_first_pkt);
+        section.setLastTSPacketIndex(_last_pkt);
+    }
+}
@@ -0,0 +1,262 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over the binary content of an MPEG PSI/SI section.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSection.h"
+
+namespace ts {
+    //!
+    //! Read-only view over the binary content of an MPEG PSI/SI section.
+    //! @ingroup mpeg
+    //!
+    //! A SectionView does not own the section data, it only references memory
+    //! which is owned by someone else, typically a demux. Building a SectionView
+    //! never allocates memory. The view is valid only as long as the referenced
+    //! memory is unmodified. When the section must be kept, use toSection().
+    //!
+    class TSDUCKDLL SectionView
+    {
+    public:
+        //!
+        //! Constructor.
+        //! The view is marked invalid if the content is not a well-formed section.
+        //! The CRC32 is not checked.
+        //! @param [in] content Address of the binary section data. Not copied.
+        //! @param [in] content_size Size in bytes of the section.
+        //! @param [in] source_pid PID from which the section was read.
+        //! @param [in] first_pkt Index of the first TS packet of the section in the demultiplexed stream.
+        //! @param [in] last_pkt Index of the last TS packet of the section in the demultiplexed stream.
+        //!
+        SectionView(const uint8_t* content = nullptr,
+                    size_t content_size = 0,
+                    PID source_pid = PID_NULL,
+                    PacketCounter first_pkt = 0,
+                    PacketCounter last_pkt = 0);
+
+        //!
+        //! Check if the view references a well-formed section.
+        //! @return True if valid, false otherwise.
+        //!
+        bool isValid() const
+        {
+            return _data != nullptr;
+        }
+
+        //!
+        //! Get the table id.
+        //! @return The table id or TID_NULL if the view is invalid.
+        //!
+        TID tableId() const
+        {
+            return _data != nullptr ? _data[0] : uint8_t(TID_NULL);
+        }
+
+        //!
+        //! Check if the section is a long one.
+        //! @return True if the section is a long one.
+        //!
+        bool isLongSection() const
+        {
+            return _data != nullptr && Section::StartLongSection(_data, _size);
+        }
+
+        //!
+        //! Check if the section is a short one.
+        //! @return True if the section is a short one.
+        //!
+        bool isShortSection() const
+        {
+            return _data != nullptr && !isLongSection();
+        }
+
+        //!
+        //! Check if the section is a private one (ie. not MPEG-defined).
+        //! @return True if the section is a private one.
+        //!
+        bool isPrivateSection() const
+        {
+            return _data != nullptr && (_data[1] & 0x40) != 0;
+        }
+
+        //!
+        //! Get the table id extension (long section only).
+        //! @return The table id extension or zero for a short section.
+        //!
+        uint16_t tableIdExtension() const
+        {
+            return isLongSection() ? GetUInt16(_data + 3) : 0;
+        }
+
+        //!
+        //! Get the section version number (long section only).
+        //! @return The section version number or zero for a short section.
+        //!
+        uint8_t version() const
+        {
+            return isLongSection() ? ((_data[5] >> 1) & 0x1F) : 0;
+        }
+
+        //!
+        //! Check if the section is "current", not "next" (long section only).
+        //! @return True if the section is "current", false for a short section.
+        //!
+        bool isCurrent() const
+        {
+            return isLongSection() && (_data[5] & 0x01) != 0;
+        }
+
+        //!
+        //! Check if the section is "next", not "current" (long section only).
+        //! @return True if the section is "next", false for a short section.
+        //!
+        bool isNext() const
+        {
+            return isLongSection() && (_data[5] & 0x01) == 0;
+        }
+
+        //!
+        //! Get the section number in the table (long section only).
+        //! @return The section number or zero for a short section.
+        //!
+        uint8_t sectionNumber() const
+        {
+            return isLongSection() ? _data[6] : 0;
+        }
+
+        //!
+        //! Get the number of the last section in the table (long section only).
+        //! @return The number of the last section or zero for a short section.
+        //!
+        uint8_t lastSectionNumber() const
+        {
+            return isLongSection() ? _data[7] : 0;
+        }
+
+        //!
+        //! Get the table extended id (table id and table id extension).
+        //! @return The table extended id.
+        //!
+        ETID etid() const
+        {
+            return isLongSection() ? ETID(tableId(), tableIdExtension()) : ETID(tableId());
+        }
+
+        //!
+        //! Get the source PID.
+        //! @return The source PID.
+        //!
+        PID sourcePID() const
+        {
+            return _source_pid;
+        }
+
+        //!
+        //! Access to the full binary content of the section.
+        //! @return Address of the full binary content of the section.
+        //!
+        const uint8_t* content() const
+        {
+            return _data;
+        }
+
+        //!
+        //! Size of the binary content of the section.
+        //! @return Size of the binary content of the section.
+        //!
+        size_t size() const
+        {
+            return _size;
+        }
+
+        //!
+        //! Access to the payload of the section.
+        //! @return Address of the payload of the section.
+        //! @see Section::payload()
+        //!
+        const uint8_t* payload() const
+        {
+            return _data == nullptr ? nullptr : _data + (isLongSection() ? LONG_SECTION_HEADER_SIZE : SHORT_SECTION_HEADER_SIZE);
+        }
+
+        //!
+        //! Get the size of the payload of the section.
+        //! For long sections, the payload ends before the CRC32 field.
+        //! @return Size in bytes of the payload of the section.
+        //!
+        size_t payloadSize() const
+        {
+            return _data == nullptr ? 0 : _size - (isLongSection() ? LONG_SECTION_HEADER_SIZE + SECTION_CRC32_SIZE : SHORT_SECTION_HEADER_SIZE);
+        }
+
+        //!
+        //! Index of first TS packet of the section in the demultiplexed stream.
+        //! @return The first TS packet of the section in the demultiplexed stream.
+        //!
+        PacketCounter getFirstTSPacketIndex() const
+        {
+            return _first_pkt;
+        }
+
+        //!
+        //! Index of last TS packet of the section in the demultiplexed stream.
+        //! @return The last TS packet of the section in the demultiplexed stream.
+        //!
+        PacketCounter getLastTSPacketIndex() const
+        {
+            return _last_pkt;
+        }
+
+        //!
+        //! Check if the section has a "diversified" payload.
+        //! @return True if the payload is diversified.
+        //! @see Section::hasDiversifiedPayload()
+        //!
+        bool hasDiversifiedPayload() const;
+
+        //!
+        //! Build a Section object with a copy of the viewed data.
+        //! Use this when the section must be kept after the referenced memory is released.
+        //! @param [out] section Section object receiving a copy of the content.
+        //! The memory of @a section is reused when possible.
+        //!
+        void toSection(Section& section) const;
+
+    private:
+        const uint8_t* _data;        // Full binary content of the section, null if invalid
+        size_t         _size;        // Size of the section
+        PID            _source_pid;  // Source PID (informational)
+        PacketCounter  _first_pkt;   // Index of first packet in stream (informational)
+        PacketCounter  _last_pkt;    // Index of last packet in stream (informational)
+    };
+}
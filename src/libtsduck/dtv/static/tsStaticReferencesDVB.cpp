@@ -79,6 +79,8 @@ ts::StaticReferencesDVB::StaticReferencesDVB() :
     REF_OBJECT(SRTOutputPlugin::REFERENCE);
     REF_OBJECT(MemoryInputPlugin::REFERENCE);
     REF_OBJECT(MemoryOutputPlugin::REFERENCE);
+    REF_OBJECT(SharedMemoryInputPlugin::REFERENCE);
+    REF_OBJECT(SharedMemoryOutputPlugin::REFERENCE);
     REF_OBJECT(SkipPlugin::REFERENCE);
     REF_OBJECT(TablesPlugin::REFERENCE);
     REF_OBJECT(PSIPlugin::REFERENCE);
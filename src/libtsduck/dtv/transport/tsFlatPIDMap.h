@@ -0,0 +1,252 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Map of contexts, directly indexed by PID.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Map of contexts, directly indexed by PID.
+    //! @ingroup mpeg
+    //!
+    //! This class is a replacement for @c std::map<PID,T> in classes which need to
+    //! locate a per-PID context for each TS packet, typically demuxes and analyzers.
+    //! A lookup is a direct access in a flat array of 8192 entries instead of a
+    //! search in a binary tree. The contexts are allocated on first access only,
+    //! as in a @c std::map. The flat array itself is allocated on first insertion.
+    //!
+    //! The interface is a subset of the interface of @c std::map. Iterators
+    //! enumerate the existing contexts in increasing order of PID. Unlike
+    //! @c std::map, iterating over the contents requires a scan of the 8192 entries.
+    //! This is appropriate for reporting but not in the processing of each packet.
+    //!
+    //! Iterators and references remain valid until the referenced element is erased.
+    //!
+    //! @tparam T The type of the per-PID contexts. Must be default-constructible.
+    //!
+    template <typename T>
+    class FlatPIDMap
+    {
+    public:
+        typedef PID key_type;                        //!< Type of the keys, the PID values.
+        typedef T mapped_type;                       //!< Type of the per-PID contexts.
+        typedef std::pair<const PID, T> value_type;  //!< Type of the elements, as in @c std::map.
+        typedef size_t size_type;                    //!< Type of sizes.
+
+    private:
+        // Iterators are instances of this template, with constant or modifiable contexts.
+        template <bool CONST_ITER>
+        class Iterator
+        {
+        private:
+            typedef typename std::conditional<CONST_ITER, const FlatPIDMap, FlatPIDMap>::type MapType;
+            MapType* _map;
+            size_t   _pid;
+            friend class FlatPIDMap;
+            friend class Iterator<!CONST_ITER>;
+            Iterator(MapType* map, size_t pid) : _map(map), _pid(pid) {}
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef typename FlatPIDMap::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef typename std::conditional<CONST_ITER, const value_type*, value_type*>::type pointer;
+            typedef typename std::conditional<CONST_ITER, const value_type&, value_type&>::type reference;
+
+            Iterator() : _map(nullptr), _pid(PID_MAX) {}
+            template <bool C = CONST_ITER, typename std::enable_if<C>::type* = nullptr>
+            Iterator(const Iterator<false>& other) : _map(other._map), _pid(other._pid) {}
+
+            reference operator*() const { return *_map->_index[_pid]; }
+            pointer operator->() const { return _map->_index[_pid]; }
+            Iterator& operator++() { _pid = _map->nextPID(_pid + 1); return *this; }
+            Iterator operator++(int) { Iterator it(*this); ++*this; return it; }
+            bool operator==(const Iterator& other) const { return _pid == other._pid; }
+            bool operator!=(const Iterator& other) const { return _pid != other._pid; }
+        };
+
+    public:
+        typedef Iterator<false> iterator;       //!< Iterator over the elements, in increasing order of PID.
+        typedef Iterator<true>  const_iterator; //!< Constant iterator over the elements, in increasing order of PID.
+
+        //!
+        //! Default constructor.
+        //! No memory is allocated until the first element is inserted.
+        //!
+        FlatPIDMap() : _index(), _count(0) {}
+
+        //!
+        //! Copy constructor.
+        //! @param [in] other Another instance to copy. All elements are duplicated.
+        //!
+        FlatPIDMap(const FlatPIDMap& other);
+
+        //!
+        //! Move constructor.
+        //! @param [in,out] other Another instance to move.
+        //!
+        FlatPIDMap(FlatPIDMap&& other) noexcept : _index(std::move(other._index)), _count(other._count) { other._count = 0; }
+
+        //!
+        //! Destructor.
+        //!
+        ~FlatPIDMap() { clear(); }
+
+        //!
+        //! Assignment operator.
+        //! @param [in] other Another instance to copy. All elements are duplicated.
+        //! @return A reference to this object.
+        //!
+        FlatPIDMap& operator=(const FlatPIDMap& other);
+
+        //!
+        //! Move assignment operator.
+        //! @param [in,out] other Another instance to move.
+        //! @return A reference to this object.
+        //!
+        FlatPIDMap& operator=(FlatPIDMap&& other) noexcept;
+
+        //!
+        //! Access the context of a PID, create it if it does not exist.
+        //! @param [in] pid The PID to access. Must be lower than PID_MAX.
+        //! @return A reference to the context of the PID.
+        //!
+        T& operator[](PID pid)
+        {
+            assert(pid < PID_MAX);
+            if (pid < _index.size() && _index[pid] != nullptr) {
+                return _index[pid]->second;
+            }
+            else {
+                return insert(pid)->second;
+            }
+        }
+
+        //!
+        //! Find the context of a PID.
+        //! @param [in] pid The PID to search.
+        //! @return An iterator to the element of the PID or end() if not found.
+        //!
+        iterator find(PID pid)
+        {
+            return iterator(this, pid < _index.size() && _index[pid] != nullptr ? pid : PID_MAX);
+        }
+
+        //!
+        //! Find the context of a PID.
+        //! @param [in] pid The PID to search.
+        //! @return A constant iterator to the element of the PID or end() if not found.
+        //!
+        const_iterator find(PID pid) const
+        {
+            return const_iterator(this, pid < _index.size() && _index[pid] != nullptr ? pid : PID_MAX);
+        }
+
+        //!
+        //! Count the number of contexts for a PID.
+        //! @param [in] pid The PID to search.
+        //! @return One if the PID has a context, zero otherwise.
+        //!
+        size_type count(PID pid) const
+        {
+            return pid < _index.size() && _index[pid] != nullptr ? 1 : 0;
+        }
+
+        //!
+        //! Erase the context of a PID.
+        //! @param [in] pid The PID to erase.
+        //! @return The number of erased elements, one or zero.
+        //!
+        size_type erase(PID pid);
+
+        //!
+        //! Erase an element.
+        //! @param [in] it An iterator to the element to erase.
+        //! @return An iterator to the element after the erased one.
+        //!
+        iterator erase(const_iterator it);
+
+        //!
+        //! Erase all contexts.
+        //!
+        void clear();
+
+        //!
+        //! Get the number of PID's with a context.
+        //! @return The number of PID's with a context.
+        //!
+        size_type size() const { return _count; }
+
+        //!
+        //! Check if there is no context.
+        //! @return True if there is no context.
+        //!
+        bool empty() const { return _count == 0; }
+
+        //!
+        //! Get an iterator to the first element.
+        //! @return An iterator to the element with the lowest PID.
+        //!
+        iterator begin() { return iterator(this, nextPID(0)); }
+
+        //!
+        //! Get an iterator after the last element.
+        //! @return An iterator after the element with the highest PID.
+        //!
+        iterator end() { return iterator(this, PID_MAX); }
+
+        //!
+        //! Get a constant iterator to the first element.
+        //! @return A constant iterator to the element with the lowest PID.
+        //!
+        const_iterator begin() const { return const_iterator(this, nextPID(0)); }
+
+        //!
+        //! Get a constant iterator after the last element.
+        //! @return A constant iterator after the element with the highest PID.
+        //!
+        const_iterator end() const { return const_iterator(this, PID_MAX); }
+
+    private:
+        std::vector<value_type*> _index;  // Flat index of PID_MAX entries, empty until first insertion.
+        size_type                _count;  // Number of non-null entries in _index.
+
+        // Create the context of a PID which does not exist yet.
+        value_type* insert(PID pid);
+
+        // Get the first PID with a context, starting at pid, PID_MAX if there is none.
+        size_t nextPID(size_t pid) const;
+    };
+}
+
+#include "tsFlatPIDMapTemplate.h"
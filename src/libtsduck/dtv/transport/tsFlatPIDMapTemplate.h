@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+
+//----------------------------------------------------------------------------
+// Copy and move.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::FlatPIDMap<T>::FlatPIDMap(const FlatPIDMap& other) :
+    _index(),
+    _count(0)
+{
+    *this = other;
+}
+
+template <typename T>
+ts::FlatPIDMap<T>& ts::FlatPIDMap<T>::operator=(const FlatPIDMap& other)
+{
+    if (&other != this) {
+        clear();
+        for (auto it = other.begin(); it != other.end(); ++it) {
+            insert(it->first)->second = it->second;
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+ts::FlatPIDMap<T>& ts::FlatPIDMap<T>::operator=(FlatPIDMap&& other) noexcept
+{
+    if (&other != this) {
+        clear();
+        _index.swap(other._index);
+        _count = other._count;
+        other._count = 0;
+    }
+    return *this;
+}
+
+
+//----------------------------------------------------------------------------
+// Create the context of a PID which does not exist yet.
+//----------------------------------------------------------------------------
+
+template <typename T>
+typename ts::FlatPIDMap<T>::value_type* ts::FlatPIDMap<T>::insert(PID pid)
+{
+    if (_index.empty()) {
+        _index.resize(PID_MAX, nullptr);
+    }
+    assert(_index[pid] == nullptr);
+    value_type* const elem = new value_type(std::piecewise_construct, std::forward_as_tuple(pid), std::forward_as_tuple());
+    _index[pid] = elem;
+    _count++;
+    return elem;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the first PID with a context, starting at pid.
+//----------------------------------------------------------------------------
+
+template <typename T>
+size_t ts::FlatPIDMap<T>::nextPID(size_t pid) const
+{
+    if (_count == 0) {
+        return PID_MAX;
+    }
+    while (pid < _index.size() && _index[pid] == nullptr) {
+        ++pid;
+    }
+    return pid < _index.size() ? pid : PID_MAX;
+}
+
+
+//----------------------------------------------------------------------------
+// Erase elements.
+//----------------------------------------------------------------------------
+
+template <typename T>
+typename ts::FlatPIDMap<T>::size_type ts::FlatPIDMap<T>::erase(PID pid)
+{
+    if (pid < _index.size() && _index[pid] != nullptr) {
+        // Clear the entry before deleting the context, in case its destructor accesses this map.
+        value_type* const elem = _index[pid];
+        _index[pid] = nullptr;
+        _count--;
+        delete elem;
+        return 1;
+    }
+    else {
+        return 0;
+    }
+}
+
+template <typename T>
+typename ts::FlatPIDMap<T>::iterator ts::FlatPIDMap<T>::erase(const_iterator it)
+{
+    const size_t pid = it._pid;
+    if (pid < PID_MAX) {
+        erase(PID(pid));
+    }
+    return iterator(this, nextPID(pid + 1));
+}
+
+template <typename T>
+void ts::FlatPIDMap<T>::clear()
+{
+    for (size_t pid = 0; _count > 0 && pid < _index.size(); ++pid) {
+        erase(PID(pid));
+    }
+    assert(_count == 0);
+}
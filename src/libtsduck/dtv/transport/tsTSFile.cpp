@@ -31,8 +31,28 @@
 #include "tsTSPacketMetadata.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#include "tsSysInfo.h"
+#include "tsIOUringReader.h"
+#include "tsWriteBehind.h"
 TSDUCK_SOURCE;
 
+#if !defined(TS_WINDOWS)
+#include <sys/mman.h>
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::TSFile::DEFAULT_WRITE_BEHIND_SIZE;
+#endif
+
+// Size of the mapped windows in READ_MMAP mode.
+#define MMAP_WINDOW_SIZE (64 * 1024 * 1024)
+
+const ts::Enumeration ts::TSFile::ReadModeEnum({
+    {u"read",     ts::TSFile::READ_SYSCALL},
+    {u"mmap",     ts::TSFile::READ_MMAP},
+    {u"io-uring", ts::TSFile::READ_IO_URING},
+});
+
 
 //----------------------------------------------------------------------------
 // Default constructor.
@@ -55,10 +75,22 @@ ts::TSFile::TSFile() :
     _aborted(false),
     _rewindable(false),
     _regular(false),
+    _read_mode(READ_SYSCALL),
+    _cur_mode(READ_SYSCALL),
+    _wb_size(0),
+    _wb_direct(false),
+    _wb_prealloc(0),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
-    _fd(-1)
+    _fd(-1),
+    _read_offset(0),
+    _file_size(0),
+    _map_base(nullptr),
+    _map_offset(0),
+    _map_size(0),
+    _uring(nullptr),
+    _writer(nullptr)
 #endif
 {
 }
@@ -85,10 +117,22 @@ ts::TSFile::TSFile(const TSFile& other) :
     _aborted(false),
     _rewindable(false),
     _regular(false),
+    _read_mode(other._read_mode),
+    _cur_mode(READ_SYSCALL),
+    _wb_size(other._wb_size),
+    _wb_direct(other._wb_direct),
+    _wb_prealloc(other._wb_prealloc),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
-    _fd(-1)
+    _fd(-1),
+    _read_offset(0),
+    _file_size(0),
+    _map_base(nullptr),
+    _map_offset(0),
+    _map_size(0),
+    _uring(nullptr),
+    _writer(nullptr)
 #endif
 {
 }
@@ -115,18 +159,34 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _aborted(other._aborted),
     _rewindable(other._rewindable),
     _regular(other._regular),
+    _read_mode(other._read_mode),
+    _cur_mode(other._cur_mode),
+    _wb_size(other._wb_size),
+    _wb_direct(other._wb_direct),
+    _wb_prealloc(other._wb_prealloc),
 #if defined(TS_WINDOWS)
     _handle(other._handle)
 #else
-    _fd(other._fd)
+    _fd(other._fd),
+    _read_offset(other._read_offset),
+    _file_size(other._file_size),
+    _map_base(other._map_base),
+    _map_offset(other._map_offset),
+    _map_size(other._map_size),
+    _uring(other._uring),
+    _writer(other._writer)
 #endif
 {
     // Mark other object as closed, just in case.
     other._is_open = false;
+    other._cur_mode = READ_SYSCALL;
 #if defined(TS_WINDOWS)
     other._handle = INVALID_HANDLE_VALUE;
 #else
     other._fd = -1;
+    other._map_base = nullptr;
+    other._uring = nullptr;
+    other._writer = nullptr;
 #endif
 }
 
@@ -140,6 +200,12 @@ ts::TSFile::~TSFile()
     if (_is_open) {
         close(NULLREP);
     }
+#if !defined(TS_WINDOWS)
+    delete _uring;
+    delete _writer;
+    _uring = nullptr;
+    _writer = nullptr;
+#endif
 }
 
 
@@ -175,6 +241,18 @@ void ts::TSFile::setStuffing(size_t initial, size_t final)
 }
 
 
+//----------------------------------------------------------------------------
+// Set the write-behind mode.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::setWriteBehind(size_t buffer_size, bool direct_io, uint64_t preallocate)
+{
+    _wb_size = buffer_size;
+    _wb_direct = direct_io;
+    _wb_prealloc = preallocate;
+}
+
+
 //----------------------------------------------------------------------------
 // Open file for read in a rewindable mode.
 //----------------------------------------------------------------------------
@@ -456,10 +534,19 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
         _total_read = _total_write = 0;
     }
 
+    // Set up the requested read method.
+    startReadMode(report);
+
     // Clean initial state.
     _at_eof = _aborted = false;
     _is_open = true;
 
+    // Start the write-behind thread when requested.
+    if (write_access && !startWriteBehind(report)) {
+        close(report);
+        return false;
+    }
+
     // In write mode, write initial null packets.
     if (write_access && !reopen && _open_null > 0 && !writeStuffing(_open_null, report)) {
         close(report);
@@ -508,6 +595,31 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
 
     report.debug(u"seeking %s at offset %'d", {_filename, _start_offset + index});
 
+#if !defined(TS_WINDOWS)
+    // With memory-mapped files and io_uring, the read offset is not the file pointer.
+    if (_cur_mode == READ_MMAP) {
+        _read_offset = _start_offset + index;
+        _at_eof = false;
+        return true;
+    }
+    else if (_cur_mode == READ_IO_URING) {
+        if (!_uring->seek(_start_offset + index, report)) {
+            report.log(_severity, u"error seeking file %s", {getDisplayFileName()});
+            return false;
+        }
+        _at_eof = false;
+        return true;
+    }
+#endif
+
+#if !defined(TS_WINDOWS)
+    // In write-behind mode, write all pending data before moving and restart at the new position.
+    const bool write_behind = _writer != nullptr && _writer->isOpen();
+    if (write_behind && !_writer->close(report)) {
+        return false;
+    }
+#endif
+
 #if defined(TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -522,7 +634,11 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
     }
     else {
         _at_eof = false;
+#if !defined(TS_WINDOWS)
+        return !write_behind || startWriteBehind(report);
+#else
         return true;
+#endif
     }
 }
 
@@ -563,6 +679,9 @@ bool ts::TSFile::close(Report& report)
         writeStuffing(_close_null, report);
     }
 
+    stopReadMode();
+    const bool success = stopWriteBehind(report);
+
     if (!_filename.empty()) {
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -575,7 +694,7 @@ bool ts::TSFile::close(Report& report)
     _flags = NONE;
     _filename.clear();
 
-    return true;
+    return success;
 }
 
 
@@ -630,6 +749,18 @@ bool ts::TSFile::readStreamPartial(void* buffer, size_t request_size, size_t& re
 #else
 
     // UNIX implementation
+    if (_cur_mode == READ_MMAP) {
+        return readMapped(buffer, request_size, read_size, report);
+    }
+    else if (_cur_mode == READ_IO_URING) {
+        // No data means end of file.
+        if (!_uring->read(buffer, request_size, read_size, report)) {
+            return false;
+        }
+        _at_eof = read_size == 0;
+        return !_at_eof;
+    }
+
     for (;;) {
         const ssize_t insize = ::read(_fd, buffer, request_size);
         if (insize == 0) {
@@ -657,6 +788,163 @@ bool ts::TSFile::readStreamPartial(void* buffer, size_t request_size, size_t& re
 }
 
 
+//----------------------------------------------------------------------------
+// Set up the requested read method when the file is open.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::startReadMode(Report& report)
+{
+    stopReadMode();
+
+    // Only regular files, in read-only mode, can use another method.
+    if (_read_mode == READ_SYSCALL) {
+        return;
+    }
+    else if (!_regular || (_flags & (READ | WRITE)) != READ) {
+        report.verbose(u"%s is not a regular file open for read only, using standard read mode", {getDisplayFileName()});
+        return;
+    }
+
+#if defined(TS_WINDOWS)
+    report.verbose(u"read mode %s not supported on this system, using standard read mode", {ReadModeEnum.name(_read_mode)});
+#else
+    if (_read_mode == READ_MMAP) {
+        // The mapped windows are created on demand, starting at the initial offset.
+        _read_offset = _start_offset;
+        _file_size = 0;
+        _cur_mode = READ_MMAP;
+    }
+    else if (_read_mode == READ_IO_URING) {
+        if (_uring == nullptr) {
+            _uring = new IOUringReader;
+        }
+        if (_uring->open(_fd, _start_offset, report)) {
+            _cur_mode = READ_IO_URING;
+        }
+        else {
+            report.verbose(u"io_uring not usable on %s, using standard read mode", {getDisplayFileName()});
+        }
+    }
+#endif
+
+    report.debug(u"reading %s in mode %s", {getDisplayFileName(), ReadModeEnum.name(_cur_mode)});
+}
+
+
+//----------------------------------------------------------------------------
+// Release the resources of the current read method.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::stopReadMode()
+{
+#if !defined(TS_WINDOWS)
+    if (_map_base != nullptr) {
+        ::munmap(_map_base, _map_size);
+        _map_base = nullptr;
+        _map_size = 0;
+    }
+    if (_uring != nullptr) {
+        _uring->close();
+    }
+#endif
+    _cur_mode = READ_SYSCALL;
+}
+
+
+//----------------------------------------------------------------------------
+// Start the write-behind thread when requested. Return false on error.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::startWriteBehind(Report& report)
+{
+    // Only regular files, in write-only mode, can use write-behind.
+    if (_wb_size == 0) {
+        return true;
+    }
+    else if (!_regular || (_flags & (READ | WRITE)) != WRITE) {
+        report.verbose(u"%s is not a regular file open for write only, write-behind not used", {getDisplayFileName()});
+        return true;
+    }
+
+#if defined(TS_WINDOWS)
+    report.verbose(u"write-behind not supported on this system");
+    return true;
+#else
+    if (_writer == nullptr) {
+        _writer = new WriteBehind;
+    }
+    if (!_writer->open(_fd, _wb_size, _wb_direct, _wb_prealloc, report)) {
+        report.log(_severity, u"cannot start write-behind on %s", {getDisplayFileName()});
+        return false;
+    }
+    report.debug(u"writing %s using write-behind, %'d bytes", {getDisplayFileName(), _wb_size});
+    return true;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the write-behind thread, write all pending data.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::stopWriteBehind(Report& report)
+{
+#if !defined(TS_WINDOWS)
+    // After abort(), the pending data are lost, this is not an error.
+    if (_writer != nullptr && _writer->isOpen() && !_writer->close(report) && !_aborted) {
+        report.log(_severity, u"error writing %s", {getDisplayFileName()});
+        return false;
+    }
+#endif
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read data from a memory-mapped file.
+//----------------------------------------------------------------------------
+
+#if !defined(TS_WINDOWS)
+
+bool ts::TSFile::readMapped(void* buffer, size_t request_size, size_t& read_size, Report& report)
+{
+    // At end of the known file size, check if the file has grown since then.
+    if (_read_offset >= _file_size) {
+        struct stat st;
+        if (::fstat(_fd, &st) < 0 || uint64_t(st.st_size) <= _read_offset) {
+            _at_eof = true;
+            return false;
+        }
+        _file_size = uint64_t(st.st_size);
+    }
+
+    // Map a new window when the read offset is outside the current one.
+    if (_map_base == nullptr || _read_offset < _map_offset || _read_offset >= _map_offset + _map_size) {
+        if (_map_base != nullptr) {
+            ::munmap(_map_base, _map_size);
+            _map_base = nullptr;
+        }
+        _map_offset = _read_offset - _read_offset % SysInfo::Instance()->memoryPageSize();
+        _map_size = size_t(std::min<uint64_t>(MMAP_WINDOW_SIZE, _file_size - _map_offset));
+        void* addr = ::mmap(nullptr, _map_size, PROT_READ, MAP_SHARED, _fd, off_t(_map_offset));
+        if (addr == MAP_FAILED) {
+            report.error(u"error mapping %s in memory: %s", {getDisplayFileName(), SysErrorCodeMessage()});
+            return false;
+        }
+        _map_base = reinterpret_cast<uint8_t*>(addr);
+        ::madvise(addr, _map_size, MADV_SEQUENTIAL);
+    }
+
+    // Return as much data as possible from the current window.
+    read_size = size_t(std::min<uint64_t>(request_size, _map_offset + _map_size - _read_offset));
+    ::memcpy(buffer, _map_base + (_read_offset - _map_offset), read_size);
+    _read_offset += read_size;
+    return true;
+}
+
+#endif
+
+
 //----------------------------------------------------------------------------
 // Read TS packets. Return the actual number of read packets.
 // Override TSPacketStream implementation
@@ -761,6 +1049,16 @@ bool ts::TSFile::writeStream(const void* buffer, size_t data_size, size_t& writt
 #else
 
     // UNIX implementation
+    if (_writer != nullptr && _writer->isOpen()) {
+        // Write-behind mode, the data are written later.
+        if (!_writer->write(buffer, data_size, report)) {
+            report.log(_severity, u"error writing %s", {getDisplayFileName()});
+            return false;
+        }
+        written_size = data_size;
+        return true;
+    }
+
     const char* data = reinterpret_cast<const char*>(buffer);
     size_t remain = data_size;
     ssize_t outsize = 0;
@@ -832,6 +1130,10 @@ void ts::TSFile::abort()
         ::CloseHandle(_handle);
         _handle = INVALID_HANDLE_VALUE;
 #else // UNIX
+        // Stop the write-behind thread first, it must no longer use the file descriptor.
+        if (_writer != nullptr) {
+            _writer->abort();
+        }
         ::close(_fd);
         _fd = -1;
 #endif
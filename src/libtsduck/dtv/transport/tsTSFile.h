@@ -37,10 +37,13 @@
 #include "tsAbstractReadStreamInterface.h"
 #include "tsAbstractWriteStreamInterface.h"
 #include "tsEnumUtils.h"
+#include "tsEnumeration.h"
 
 namespace ts {
 
     class TSPacketMetadata;
+    class IOUringReader;
+    class WriteBehind;
 
     //!
     //! Transport stream file, input and/or output.
@@ -178,6 +181,61 @@ namespace ts {
         //!
         void setStuffing(size_t initial, size_t final);
 
+        //!
+        //! Methods to read a file.
+        //! The read mode applies to regular files which are open in read-only mode.
+        //! Other files, such as pipes, are always read using the standard method.
+        //!
+        enum ReadMode {
+            READ_SYSCALL,   //!< Standard read system calls (default).
+            READ_MMAP,      //!< Map the file in memory, by successive windows, for sequential access (UNIX only).
+            READ_IO_URING,  //!< Several outstanding large read requests using io_uring (Linux only).
+        };
+
+        //!
+        //! Enumeration description of ts::TSFile::ReadMode.
+        //!
+        static const Enumeration ReadModeEnum;
+
+        //!
+        //! Set the method to read the file.
+        //! This method shall be called before opening the file.
+        //! When the read mode is not supported on the file or on this system,
+        //! the file is read using the standard method.
+        //! @param [in] mode Read mode.
+        //!
+        void setReadMode(ReadMode mode) { _read_mode = mode; }
+
+        //!
+        //! Get the method to read the file.
+        //! @return The read mode which was set using setReadMode().
+        //!
+        ReadMode readMode() const { return _read_mode; }
+
+        //!
+        //! Default size in bytes of the write-behind buffer.
+        //!
+        static constexpr size_t DEFAULT_WRITE_BEHIND_SIZE = 16 * 1024 * 1024;
+
+        //!
+        //! Set the write-behind mode.
+        //! This method shall be called before opening the file.
+        //!
+        //! The write-behind mode applies to regular files which are open in write-only mode
+        //! (UNIX only). The written packets are accumulated in memory and a dedicated thread
+        //! writes them in the file. Thus, the application is not blocked when the system
+        //! flushes its page cache. Additionally, on Linux, the written data are immediately
+        //! removed from the page cache, to avoid evicting more useful data from the cache.
+        //!
+        //! @param [in] buffer_size Size in bytes of the write-behind buffer. If zero, the
+        //! write-behind mode is disabled (the default).
+        //! @param [in] direct_io If true, the data are written using direct I/O when the file
+        //! system supports it, bypassing the page cache (Linux only).
+        //! @param [in] preallocate If not zero, the file space is preallocated on disk by chunks
+        //! of this size in bytes, reducing the fragmentation (Linux only).
+        //!
+        void setWriteBehind(size_t buffer_size, bool direct_io = false, uint64_t preallocate = 0);
+
         //!
         //! Abort any currenly read/write operation in progress.
         //! The file is left in a broken state and can be only closed.
@@ -223,10 +281,22 @@ namespace ts {
         volatile bool _aborted;          //!< Operation has been aborted, no operation available
         bool          _rewindable;       //!< Opened in rewindable mode
         bool          _regular;          //!< Is a regular file (ie. not a pipe or special device)
+        ReadMode      _read_mode;        //!< Requested read mode.
+        ReadMode      _cur_mode;         //!< Actual read mode of the open file.
+        size_t        _wb_size;          //!< Write-behind buffer size.
+        bool          _wb_direct;        //!< Use direct I/O in write-behind mode.
+        uint64_t      _wb_prealloc;      //!< Preallocation size in write-behind mode.
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle;           //!< File handle
 #else
         int           _fd;               //!< File descriptor
+        uint64_t      _read_offset;      //!< Current offset in file in READ_MMAP mode.
+        uint64_t      _file_size;        //!< Last known file size in READ_MMAP mode.
+        uint8_t*      _map_base;         //!< Address of the current mapped window in READ_MMAP mode.
+        uint64_t      _map_offset;       //!< Offset in file of the current mapped window.
+        size_t        _map_size;         //!< Size in bytes of the current mapped window.
+        IOUringReader* _uring;           //!< Reader in READ_IO_URING mode.
+        WriteBehind*  _writer;           //!< Write-behind thread.
 #endif
 
         // Implementation of AbstractReadStreamInterface
@@ -244,6 +314,13 @@ namespace ts {
         bool openInternal(bool reopen, Report& report);
         bool seekCheck(Report& report);
         bool seekInternal(uint64_t index, Report& report);
+        void startReadMode(Report& report);
+        void stopReadMode();
+        bool startWriteBehind(Report& report);
+        bool stopWriteBehind(Report& report);
+#if !defined(TS_WINDOWS)
+        bool readMapped(void* addr, size_t max_size, size_t& ret_size, Report& report);
+#endif
 
         // Inaccessible operations.
         TSFile& operator=(TSFile&) = delete;
@@ -0,0 +1,230 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketHeaderScan.h"
+#include "tsMemory.h"
+TSDUCK_SOURCE;
+
+// On x86-64, SSE2 is always available. Eight packets are processed at a time.
+#if defined(TS_X86_64) && !defined(TS_NO_PACKET_SCAN_SSE2)
+    #define TS_PACKET_SCAN_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+
+//----------------------------------------------------------------------------
+// Extraction of the fields, one packet at a time.
+// The header is read as a 32-bit word w (bytes 0-3) and the beginning of
+// the adaptation field as a 16-bit word x (adaptation_field_length, flags).
+// The vectorized version applies the same operations on each lane.
+//----------------------------------------------------------------------------
+
+namespace {
+    inline uint8_t HeaderFlags(uint32_t w, uint32_t x)
+    {
+        const uint32_t af_ok = (w & 0x20) != 0 && (x & 0xFF00) != 0 ? 0xFF : 0x00;
+        return uint8_t(((w >> 22) & 0x03) |                            // PUSI, TEI
+                       ((w >> 19) & 0x04) |                            // PRIORITY
+                       ((w >> 2) & 0x08) |                             // HAS_AF
+                       (w & 0x10) |                                    // HAS_PAYLOAD
+                       ((((x << 1) & 0x20) | ((x >> 1) & 0x40)) & af_ok) | // HAS_PCR, DISCONTINUITY
+                       ((w >> 24) != ts::SYNC_BYTE ? 0x80 : 0x00));    // INVALID
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Vectorized extraction of the fields of 4 packets, one per 32-bit lane.
+//----------------------------------------------------------------------------
+
+#if defined(TS_PACKET_SCAN_SSE2)
+namespace {
+    struct Lanes
+    {
+        __m128i pid;
+        __m128i cc;
+        __m128i sc;
+        __m128i flags;
+    };
+
+    inline void ScanLanes(const ts::TSPacket* pkt, Lanes& out)
+    {
+        const __m128i w = _mm_set_epi32(int(ts::GetUInt32(pkt[3].b)), int(ts::GetUInt32(pkt[2].b)), int(ts::GetUInt32(pkt[1].b)), int(ts::GetUInt32(pkt[0].b)));
+        const __m128i x = _mm_set_epi32(ts::GetUInt16(pkt[3].b + 4), ts::GetUInt16(pkt[2].b + 4), ts::GetUInt16(pkt[1].b + 4), ts::GetUInt16(pkt[0].b + 4));
+
+        out.pid = _mm_and_si128(_mm_srli_epi32(w, 8), _mm_set1_epi32(0x1FFF));
+        out.cc = _mm_and_si128(w, _mm_set1_epi32(0x0F));
+        out.sc = _mm_and_si128(_mm_srli_epi32(w, 6), _mm_set1_epi32(0x03));
+
+        __m128i fl = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(w, 22), _mm_set1_epi32(0x03)),
+                                  _mm_and_si128(_mm_srli_epi32(w, 19), _mm_set1_epi32(0x04)));
+        fl = _mm_or_si128(fl, _mm_and_si128(_mm_srli_epi32(w, 2), _mm_set1_epi32(0x08)));
+        fl = _mm_or_si128(fl, _mm_and_si128(w, _mm_set1_epi32(0x10)));
+
+        const __m128i has_af = _mm_cmpeq_epi32(_mm_and_si128(w, _mm_set1_epi32(0x20)), _mm_set1_epi32(0x20));
+        const __m128i no_af_len = _mm_cmpeq_epi32(_mm_and_si128(x, _mm_set1_epi32(0xFF00)), _mm_setzero_si128());
+        const __m128i af_ok = _mm_andnot_si128(no_af_len, has_af);
+        const __m128i af_flags = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(x, 1), _mm_set1_epi32(0x20)),
+                                              _mm_and_si128(_mm_srli_epi32(x, 1), _mm_set1_epi32(0x40)));
+        fl = _mm_or_si128(fl, _mm_and_si128(af_ok, af_flags));
+
+        const __m128i sync_ok = _mm_cmpeq_epi32(_mm_srli_epi32(w, 24), _mm_set1_epi32(ts::SYNC_BYTE));
+        out.flags = _mm_or_si128(fl, _mm_andnot_si128(sync_ok, _mm_set1_epi32(0x80)));
+    }
+
+    // Pack two vectors of 4 x 32-bit values into 8 bytes.
+    inline void StoreBytes(uint8_t* dest, __m128i lo, __m128i hi)
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128()));
+    }
+}
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSPacketHeaderScan::TSPacketHeaderScan() :
+    _size(0),
+    _pids(),
+    _cc(),
+    _scrambling(),
+    _flags()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Resize the arrays for a new scan.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketHeaderScan::resize(size_t count)
+{
+    _size = count;
+    if (_pids.size() < count) {
+        _pids.resize(count);
+        _cc.resize(count);
+        _scrambling.resize(count);
+        _flags.resize(count);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Extract the header fields of TS packets.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketHeaderScan::scan(const TSPacket* packets, size_t count)
+{
+    resize(count);
+    scanContiguous(packets, count, 0);
+}
+
+void ts::TSPacketHeaderScan::scan(const TSPacketWindow& win)
+{
+    resize(win.size());
+
+    // Process each range of physically contiguous packets at once.
+    size_t index = 0;
+    while (index < _size) {
+        const TSPacket* const first = win.packet(index);
+        if (first == nullptr) {
+            // Dropped packet.
+            _pids[index] = PID_NULL;
+            _cc[index] = _scrambling[index] = 0;
+            _flags[index] = INVALID;
+            index++;
+        }
+        else {
+            size_t count = 1;
+            while (index + count < _size && win.packet(index + count) == first + count) {
+                count++;
+            }
+            scanContiguous(first, count, index);
+            index += count;
+        }
+    }
+}
+
+void ts::TSPacketHeaderScan::scanContiguous(const TSPacket* pkt, size_t count, size_t index)
+{
+    PID* pid = _pids.data() + index;
+    uint8_t* cc = _cc.data() + index;
+    uint8_t* sc = _scrambling.data() + index;
+    uint8_t* fl = _flags.data() + index;
+
+#if defined(TS_PACKET_SCAN_SSE2)
+    Lanes lo, hi;
+    for (; count >= 8; count -= 8, pkt += 8, pid += 8, cc += 8, sc += 8, fl += 8) {
+        ScanLanes(pkt, lo);
+        ScanLanes(pkt + 4, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pid), _mm_packs_epi32(lo.pid, hi.pid));
+        StoreBytes(cc, lo.cc, hi.cc);
+        StoreBytes(sc, lo.sc, hi.sc);
+        StoreBytes(fl, lo.flags, hi.flags);
+    }
+#endif
+
+    // Remaining packets (or all packets without vectorization).
+    for (; count > 0; --count, ++pkt) {
+        const uint32_t w = GetUInt32(pkt->b);
+        *pid++ = PID((w >> 8) & 0x1FFF);
+        *cc++ = uint8_t(w & 0x0F);
+        *sc++ = uint8_t((w >> 6) & 0x03);
+        *fl++ = HeaderFlags(w, GetUInt16(pkt->b + 4));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Select packets from the last scan.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketHeaderScan::selectPIDs(std::vector<size_t>& indexes, const PIDSet& filter, bool negate) const
+{
+    indexes.clear();
+    for (size_t i = 0; i < _size; ++i) {
+        if ((_flags[i] & INVALID) == 0 && filter.test(_pids[i]) != negate) {
+            indexes.push_back(i);
+        }
+    }
+    return indexes.size();
+}
+
+size_t ts::TSPacketHeaderScan::selectFlags(std::vector<size_t>& indexes, uint8_t mask) const
+{
+    indexes.clear();
+    for (size_t i = 0; i < _size; ++i) {
+        if ((_flags[i] & INVALID) == 0 && (_flags[i] & mask) != 0) {
+            indexes.push_back(i);
+        }
+    }
+    return indexes.size();
+}
@@ -0,0 +1,168 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Extraction of the header fields of a group of TS packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketWindow.h"
+
+namespace ts {
+    //!
+    //! Extraction of the header fields of a group of TS packets.
+    //! @ingroup mpeg
+    //!
+    //! The main header fields of N packets are extracted at once into compact arrays,
+    //! one array per field ("structure of arrays"). The extraction is vectorized when
+    //! possible, several packets being processed in parallel. This class is typically
+    //! used by processor plugins in "packet window" mode, which classify packets by PID
+    //! or flags before processing the selected ones.
+    //!
+    //! An instance of this class can be reused for successive groups of packets.
+    //! The memory of the arrays is allocated once.
+    //!
+    class TSDUCKDLL TSPacketHeaderScan
+    {
+        TS_NOCOPY(TSPacketHeaderScan);
+    public:
+        //!
+        //! Bit masks in the flags of each packet.
+        //!
+        enum : uint8_t {
+            PUSI          = 0x01,  //!< Payload unit start indicator.
+            TEI           = 0x02,  //!< Transport error indicator.
+            PRIORITY      = 0x04,  //!< Transport priority.
+            HAS_AF        = 0x08,  //!< The packet has an adaptation field.
+            HAS_PAYLOAD   = 0x10,  //!< The packet has a payload.
+            HAS_PCR       = 0x20,  //!< The packet has a PCR.
+            DISCONTINUITY = 0x40,  //!< The discontinuity indicator is set in the adaptation field.
+            INVALID       = 0x80,  //!< Invalid sync byte or packet dropped from a packet window, other fields are meaningless.
+        };
+
+        //!
+        //! Constructor.
+        //!
+        TSPacketHeaderScan();
+
+        //!
+        //! Extract the header fields of contiguous TS packets.
+        //! @param [in] packets Address of the first packet.
+        //! @param [in] count Number of packets.
+        //!
+        void scan(const TSPacket* packets, size_t count);
+
+        //!
+        //! Extract the header fields of the packets in a packet window.
+        //! Dropped packets are marked with the flag INVALID.
+        //! @param [in] win Packet window.
+        //!
+        void scan(const TSPacketWindow& win);
+
+        //!
+        //! Get the number of packets in the last scan.
+        //! @return The number of packets in the last scan.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the PID of a packet.
+        //! @param [in] index Index of the packet in the last scan, from 0 to size()-1.
+        //! @return The PID of the packet.
+        //!
+        PID pid(size_t index) const { return _pids[index]; }
+
+        //!
+        //! Get the continuity counter of a packet.
+        //! @param [in] index Index of the packet in the last scan, from 0 to size()-1.
+        //! @return The continuity counter of the packet.
+        //!
+        uint8_t cc(size_t index) const { return _cc[index]; }
+
+        //!
+        //! Get the transport scrambling control value of a packet.
+        //! @param [in] index Index of the packet in the last scan, from 0 to size()-1.
+        //! @return The 2-bit transport scrambling control value of the packet.
+        //!
+        uint8_t scrambling(size_t index) const { return _scrambling[index]; }
+
+        //!
+        //! Get the flags of a packet.
+        //! @param [in] index Index of the packet in the last scan, from 0 to size()-1.
+        //! @return A bit mask of PUSI, TEI, etc.
+        //!
+        uint8_t flags(size_t index) const { return _flags[index]; }
+
+        //!
+        //! Check if a packet is valid.
+        //! @param [in] index Index of the packet in the last scan, from 0 to size()-1.
+        //! @return True if the packet is valid.
+        //!
+        bool isValid(size_t index) const { return (_flags[index] & INVALID) == 0; }
+
+        //!
+        //! Get the array of PID's of all packets.
+        //! @return The address of the array of size() PID's.
+        //!
+        const PID* pids() const { return _pids.data(); }
+
+        //!
+        //! Select the valid packets with a PID in a set of PID's.
+        //! @param [out] indexes Returned indexes of the selected packets.
+        //! @param [in] filter Set of PID's to select.
+        //! @param [in] negate If true, select the packets with a PID which is not in @a filter.
+        //! @return The number of selected packets.
+        //!
+        size_t selectPIDs(std::vector<size_t>& indexes, const PIDSet& filter, bool negate = false) const;
+
+        //!
+        //! Select the valid packets with some flags.
+        //! @param [out] indexes Returned indexes of the selected packets.
+        //! @param [in] mask A combination of flags to select. A packet is selected if
+        //! at least one of these flags is set.
+        //! @return The number of selected packets.
+        //!
+        size_t selectFlags(std::vector<size_t>& indexes, uint8_t mask) const;
+
+    private:
+        size_t               _size;        // Number of packets in last scan.
+        std::vector<PID>     _pids;        // PID values.
+        std::vector<uint8_t> _cc;          // Continuity counters.
+        std::vector<uint8_t> _scrambling;  // Transport scrambling control values.
+        std::vector<uint8_t> _flags;       // Flags.
+
+        // Resize the arrays for a new scan.
+        void resize(size_t count);
+
+        // Extract the fields of contiguous packets at a given index in the arrays.
+        void scanContiguous(const TSPacket* packets, size_t count, size_t index);
+    };
+}
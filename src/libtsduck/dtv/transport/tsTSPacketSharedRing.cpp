@@ -0,0 +1,745 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketSharedRing.h"
+#include "tsSysUtils.h"
+#include "tsIntegerUtils.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_UNIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(TS_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::TSPacketSharedRing::DEFAULT_SIZE;
+constexpr size_t ts::TSPacketSharedRing::DEFAULT_MAX_READERS;
+constexpr size_t ts::TSPacketSharedRing::MAX_READERS;
+constexpr ts::MilliSecond ts::TSPacketSharedRing::DEFAULT_READER_TIMEOUT;
+#endif
+
+namespace {
+    // Identification of the shared memory layout.
+    constexpr uint32_t RING_MAGIC = 0x54535252;   // "TSRR"
+    constexpr uint32_t RING_VERSION = 1;
+
+    // Size of a metadata slot in shared memory (serialized metadata, rounded up).
+    constexpr size_t METADATA_SLOT_SIZE = 16;
+    static_assert(ts::TSPacketMetadata::SERIALIZATION_SIZE <= METADATA_SLOT_SIZE, "metadata slot too small");
+
+    // The futexes are 32-bit words in shared memory.
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomic<uint32_t> not usable as futex");
+
+    // Maximum duration of one wait, to periodically check for dead processes or abort.
+    constexpr ts::MilliSecond POLL_INTERVAL = 100;
+}
+
+// Reader slot in shared memory, one cache line per slot.
+struct alignas(64) ReaderSlot
+{
+    std::atomic<uint64_t> read_index;  // Index of next packet to read.
+    std::atomic<uint32_t> token;       // Zero if the slot is free, unique reader token otherwise.
+    std::atomic<int32_t>  pid;         // Reader process id, zero while the reader is attaching.
+};
+
+// Shared memory layout. The packet and metadata areas follow the header.
+struct ts::TSPacketSharedRing::Header
+{
+    std::atomic<uint32_t> magic;            // Set by the writer when the ring is ready.
+    uint32_t              version;          // Layout version.
+    uint64_t              total_size;       // Total size of the shared memory object.
+    uint32_t              capacity;         // Size of the ring in packets.
+    uint32_t              max_readers;      // Number of reader slots.
+    int32_t               writer_pid;       // Writer process id.
+    std::atomic<uint32_t> closed;           // Set by the writer at end of stream.
+    std::atomic<int64_t>  bitrate;          // Raw value of the bitrate.
+    std::atomic<uint32_t> next_token;       // Next reader token.
+    alignas(64)
+    std::atomic<uint64_t> write_index;      // Index of next packet to write.
+    std::atomic<uint64_t> write_limit;      // Index after the last packet being written.
+    std::atomic<uint32_t> write_seq;        // Futex, incremented after each write.
+    std::atomic<uint32_t> readers_waiting;  // Number of readers waiting on write_seq.
+    alignas(64)
+    std::atomic<uint32_t> read_seq;         // Futex, incremented after each read.
+    std::atomic<uint32_t> writer_waiting;   // The writer is waiting on read_seq.
+    ReaderSlot            slots[MAX_READERS];
+};
+
+namespace {
+    // Wait on a futex while its value is the expected one, at most the specified time.
+    void FutexWait(std::atomic<uint32_t>& word, uint32_t expected, ts::MilliSecond timeout)
+    {
+#if defined(TS_LINUX)
+        ::timespec ts;
+        ts.tv_sec = time_t(timeout / ts::MilliSecPerSec);
+        ts.tv_nsec = long((timeout % ts::MilliSecPerSec) * ts::NanoSecPerMilliSec);
+        // Not a private futex since it is shared between processes.
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+        // No futex, poll the shared memory.
+        if (word.load() == expected) {
+            ts::SleepThread(std::min<ts::MilliSecond>(timeout, 1));
+        }
+#endif
+    }
+
+    // Wake up all processes waiting on a futex.
+    void FutexWake(std::atomic<uint32_t>& word)
+    {
+#if defined(TS_LINUX)
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    // Check if a process is still alive.
+    bool ProcessAlive(int32_t pid)
+    {
+#if defined(TS_UNIX)
+        return pid > 0 && (::kill(pid_t(pid), 0) == 0 || errno == EPERM);
+#else
+        return pid > 0;
+#endif
+    }
+
+    // Build a valid POSIX shared memory object name.
+    std::string ObjectName(const ts::UString& name)
+    {
+        return name.startWith(u"/") ? name.toUTF8() : "/" + name.toUTF8();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::TSPacketSharedRing::TSPacketSharedRing() :
+    _name(),
+    _writer(false),
+    _aborted(false),
+    _base(nullptr),
+    _map_size(0),
+    _header(nullptr),
+    _packets(nullptr),
+    _metadata(nullptr),
+    _capacity(0),
+    _max_readers(0),
+    _drop(false),
+    _reader_timeout(DEFAULT_READER_TIMEOUT),
+    _blocked(false),
+    _blocked_since(),
+    _receive_timeout(0),
+    _slot(0),
+    _token(0),
+    _read_index(0),
+    _lost(0)
+{
+}
+
+ts::TSPacketSharedRing::~TSPacketSharedRing()
+{
+    close(NULLREP);
+}
+
+bool ts::TSPacketSharedRing::IsSupported()
+{
+#if defined(TS_UNIX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ts::TSPacketSharedRing::setBackPressure(bool drop, MilliSecond reader_timeout)
+{
+    _drop = drop;
+    _reader_timeout = reader_timeout;
+}
+
+
+//----------------------------------------------------------------------------
+// Create a ring as writer.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSharedRing::create(const UString& name, size_t size, size_t max_readers, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring %s already open", {_name});
+        return false;
+    }
+
+#if defined(TS_UNIX)
+
+    const std::string objname(ObjectName(name));
+    const size_t capacity = std::max<size_t>(size, 1);
+    const size_t header_size = RoundUp(sizeof(Header), size_t(64));
+    const size_t total_size = header_size + capacity * (PKT_SIZE + METADATA_SLOT_SIZE);
+    max_readers = std::max<size_t>(1, std::min(max_readers, MAX_READERS));
+
+    if (capacity > 0xFFFFFFFF) {
+        report.error(u"shared memory ring size too large: %'d packets", {capacity});
+        return false;
+    }
+
+    // Create the shared memory object. If it already exists, check if its writer is still alive.
+    int fd = ::shm_open(objname.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd < 0 && errno == EEXIST) {
+        const int oldfd = ::shm_open(objname.c_str(), O_RDONLY, 0);
+        struct ::stat st;
+        if (oldfd >= 0 && ::fstat(oldfd, &st) == 0 && size_t(st.st_size) >= sizeof(Header)) {
+            void* addr = ::mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, oldfd, 0);
+            if (addr != MAP_FAILED) {
+                const Header* old = reinterpret_cast<const Header*>(addr);
+                const bool in_use = old->magic.load() == RING_MAGIC && old->closed.load() == 0 && ProcessAlive(old->writer_pid);
+                const int32_t old_pid = old->writer_pid;
+                ::munmap(addr, sizeof(Header));
+                if (in_use) {
+                    ::close(oldfd);
+                    report.error(u"shared memory ring %s already used by writer process %d", {name, old_pid});
+                    return false;
+                }
+            }
+        }
+        if (oldfd >= 0) {
+            ::close(oldfd);
+        }
+        // Replace the stale object. Readers which are still attached to it keep their mapping.
+        report.debug(u"replacing stale shared memory object %s", {name});
+        ::shm_unlink(objname.c_str());
+        fd = ::shm_open(objname.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    }
+    if (fd < 0) {
+        report.error(u"error creating shared memory object %s: %s", {name, SysErrorCodeMessage()});
+        return false;
+    }
+    if (::ftruncate(fd, off_t(total_size)) < 0) {
+        report.error(u"error sizing shared memory object %s: %s", {name, SysErrorCodeMessage()});
+        ::close(fd);
+        ::shm_unlink(objname.c_str());
+        return false;
+    }
+    void* addr = ::mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping shared memory object %s: %s", {name, SysErrorCodeMessage()});
+        ::shm_unlink(objname.c_str());
+        return false;
+    }
+
+    // Initialize the header. The object is zero-filled by ftruncate(). The magic number is set last.
+    _base = reinterpret_cast<uint8_t*>(addr);
+    _header = new(_base) Header;
+    _header->version = RING_VERSION;
+    _header->total_size = total_size;
+    _header->capacity = uint32_t(capacity);
+    _header->max_readers = uint32_t(max_readers);
+    _header->writer_pid = int32_t(CurrentProcessId());
+    _header->closed = 0;
+    _header->bitrate = 0;
+    _header->next_token = 1;
+    _header->write_index = 0;
+    _header->write_limit = 0;
+    _header->write_seq = 0;
+    _header->readers_waiting = 0;
+    _header->read_seq = 0;
+    _header->writer_waiting = 0;
+    for (size_t i = 0; i < MAX_READERS; ++i) {
+        _header->slots[i].read_index = 0;
+        _header->slots[i].token = 0;
+        _header->slots[i].pid = 0;
+    }
+    _header->magic.store(RING_MAGIC, std::memory_order_release);
+
+    _name = name;
+    _writer = true;
+    _aborted = false;
+    _map_size = total_size;
+    _packets = reinterpret_cast<TSPacket*>(_base + header_size);
+    _metadata = _base + header_size + capacity * PKT_SIZE;
+    _capacity = capacity;
+    _max_readers = max_readers;
+    _blocked = false;
+    report.debug(u"created shared memory ring %s, %'d packets, %d readers max", {name, capacity, max_readers});
+    return true;
+
+#else
+    report.error(u"shared memory rings are not supported on this platform");
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Attach to a ring as reader.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSharedRing::attach(const UString& name, MilliSecond timeout, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring %s already open", {_name});
+        return false;
+    }
+
+#if defined(TS_UNIX)
+
+    const std::string objname(ObjectName(name));
+    const Monotonic start(true);
+    bool waiting = false;
+    _aborted = false;
+
+    // Wait for the writer to create and initialize the ring.
+    for (;;) {
+        const int fd = ::shm_open(objname.c_str(), O_RDWR, 0);
+        if (fd < 0 && errno != ENOENT) {
+            report.error(u"error opening shared memory object %s: %s", {name, SysErrorCodeMessage()});
+            return false;
+        }
+        if (fd >= 0) {
+            struct ::stat st;
+            const size_t size = ::fstat(fd, &st) == 0 ? size_t(st.st_size) : 0;
+            void* addr = size < sizeof(Header) ? MAP_FAILED : ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (addr != MAP_FAILED) {
+                Header* hdr = reinterpret_cast<Header*>(addr);
+                if (hdr->magic.load(std::memory_order_acquire) == RING_MAGIC) {
+                    const size_t header_size = RoundUp(sizeof(Header), size_t(64));
+                    if (hdr->version != RING_VERSION || hdr->total_size != size || hdr->max_readers > MAX_READERS ||
+                        size != header_size + hdr->capacity * (PKT_SIZE + METADATA_SLOT_SIZE))
+                    {
+                        ::munmap(addr, size);
+                        report.error(u"invalid or incompatible shared memory ring %s", {name});
+                        return false;
+                    }
+                    _base = reinterpret_cast<uint8_t*>(addr);
+                    _header = hdr;
+                    _map_size = size;
+                    _capacity = hdr->capacity;
+                    _max_readers = hdr->max_readers;
+                    _packets = reinterpret_cast<TSPacket*>(_base + header_size);
+                    _metadata = _base + header_size + _capacity * PKT_SIZE;
+                    break;
+                }
+                ::munmap(addr, size);
+            }
+        }
+        // The ring does not exist yet or is not yet initialized.
+        if (_aborted || (timeout != Infinite && Monotonic(true) - start >= timeout * NanoSecPerMilliSec)) {
+            report.error(u"shared memory ring %s not found", {name});
+            return false;
+        }
+        if (!waiting) {
+            report.verbose(u"waiting for shared memory ring %s", {name});
+            waiting = true;
+        }
+        SleepThread(POLL_INTERVAL);
+    }
+
+    _name = name;
+    _writer = false;
+    _lost = 0;
+    if (!claimSlot(report)) {
+        close(report);
+        return false;
+    }
+    report.debug(u"attached to shared memory ring %s, %'d packets, reader slot %d", {name, _capacity, _slot});
+    return true;
+
+#else
+    report.error(u"shared memory rings are not supported on this platform");
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Reader: claim a free reader slot.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSharedRing::claimSlot(Report& report)
+{
+    const uint32_t token = _header->next_token.fetch_add(1) | 0x80000000;
+    for (size_t i = 0; i < _max_readers; ++i) {
+        ReaderSlot& slot(_header->slots[i]);
+        uint32_t current = slot.token.load();
+        // Reuse free slots and slots of terminated readers which did not detach.
+        if (current == 0 || (slot.pid.load() != 0 && !ProcessAlive(slot.pid.load()))) {
+            if (slot.token.compare_exchange_strong(current, token)) {
+                // Start at the live point. The writer ignores the slot until the pid is set.
+                // The read index is set again after the pid since the writer may have progressed.
+                slot.pid = 0;
+                slot.read_index = _header->write_index.load();
+                slot.pid = int32_t(CurrentProcessId());
+                _read_index = _header->write_index.load();
+                slot.read_index = _read_index;
+                _slot = i;
+                _token = token;
+                return true;
+            }
+        }
+    }
+    report.error(u"no free reader slot in shared memory ring %s, %d readers max", {_name, _max_readers});
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the ring.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSharedRing::close(Report& report)
+{
+    if (!isOpen()) {
+        return true;
+    }
+    bool ok = true;
+
+#if defined(TS_UNIX)
+    if (_writer) {
+        // Signal end of stream to all readers and remove the object.
+        _header->closed = 1;
+        _header->write_seq++;
+        FutexWake(_header->write_seq);
+        if (::shm_unlink(ObjectName(_name).c_str()) < 0 && errno != ENOENT) {
+            report.error(u"error removing shared memory object %s: %s", {_name, SysErrorCodeMessage()});
+            ok = false;
+        }
+    }
+    else {
+        // Release the reader slot if it is still ours, unblock the writer.
+        uint32_t token = _token;
+        ReaderSlot& slot(_header->slots[_slot]);
+        if (slot.token.compare_exchange_strong(token, 0)) {
+            slot.pid = 0;
+        }
+        _header->read_seq++;
+        FutexWake(_header->read_seq);
+    }
+    if (::munmap(_base, _map_size) < 0) {
+        report.error(u"error unmapping shared memory object %s: %s", {_name, SysErrorCodeMessage()});
+        ok = false;
+    }
+#endif
+
+    _base = nullptr;
+    _header = nullptr;
+    _packets = nullptr;
+    _metadata = nullptr;
+    _map_size = 0;
+    _capacity = 0;
+    _max_readers = 0;
+    _token = 0;
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Bitrate and readers.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSharedRing::setBitrate(const BitRate& bitrate)
+{
+    if (isWriter()) {
+        _header->bitrate = bitrate.raw();
+    }
+}
+
+ts::BitRate ts::TSPacketSharedRing::getBitrate() const
+{
+    return isOpen() ? BitRate(_header->bitrate.load(), true) : BitRate(0);
+}
+
+size_t ts::TSPacketSharedRing::readersCount() const
+{
+    size_t count = 0;
+    for (size_t i = 0; isOpen() && i < _max_readers; ++i) {
+        if (_header->slots[i].token.load() != 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until a minimum number of readers are attached to the ring.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSharedRing::waitReaders(size_t count, MilliSecond timeout, Report& report, const AbortInterface* abort)
+{
+    if (!isWriter()) {
+        report.error(u"shared memory ring not open as writer");
+        return false;
+    }
+    const Monotonic start(true);
+    while (readersCount() < count) {
+        if (_aborted || (abort != nullptr && abort->aborting())) {
+            return false;
+        }
+        if (timeout != Infinite && Monotonic(true) - start >= timeout * NanoSecPerMilliSec) {
+            report.error(u"shared memory ring %s: timeout waiting for %d readers", {_name, count});
+            return false;
+        }
+        // Readers do not signal their attachment, poll the slots.
+        SleepThread(10);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Writer: get the index of the slowest reader.
+//----------------------------------------------------------------------------
+
+uint64_t ts::TSPacketSharedRing::slowestReader(uint64_t write_index, bool check_alive, Report& report)
+{
+    uint64_t slowest = write_index;
+    for (size_t i = 0; i < _max_readers; ++i) {
+        ReaderSlot& slot(_header->slots[i]);
+        uint32_t token = slot.token.load();
+        const int32_t pid = slot.pid.load();
+        if (token == 0 || pid == 0) {
+            continue; // free slot or reader still attaching
+        }
+        if (check_alive && !ProcessAlive(pid)) {
+            // The reader process terminated without detaching.
+            if (slot.token.compare_exchange_strong(token, 0)) {
+                slot.pid = 0;
+                report.verbose(u"shared memory ring %s: reader process %d terminated, slot %d released", {_name, pid, i});
+            }
+            continue;
+        }
+        const uint64_t index = slot.read_index.load(std::memory_order_acquire);
+        // A reader which was overrun in drop mode resynchronizes by itself.
+        if (index < slowest && write_index - index <= _capacity) {
+            slowest = index;
+        }
+    }
+    return slowest;
+}
+
+
+//----------------------------------------------------------------------------
+// Writer: evict all readers which are at the specified read index.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSharedRing::evictReaders(uint64_t read_index, Report& report)
+{
+    for (size_t i = 0; i < _max_readers; ++i) {
+        ReaderSlot& slot(_header->slots[i]);
+        uint32_t token = slot.token.load();
+        const int32_t pid = slot.pid.load();
+        if (token != 0 && pid != 0 && slot.read_index.load() == read_index && slot.token.compare_exchange_strong(token, 0)) {
+            slot.pid = 0;
+            report.warning(u"shared memory ring %s: reader process %d stuck for %'d ms, evicted", {_name, pid, _reader_timeout});
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Write packets into the ring.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSharedRing::write(const TSPacket* packets, const TSPacketMetadata* metadata, size_t count, Report& report, const AbortInterface* abort)
+{
+    if (!isWriter()) {
+        report.error(u"shared memory ring not open as writer");
+        return false;
+    }
+
+    while (count > 0) {
+        if (_aborted || (abort != nullptr && abort->aborting())) {
+            return false;
+        }
+
+        // Compute the free space, taking the slowest reader into account.
+        const uint64_t windex = _header->write_index.load(std::memory_order_relaxed);
+        const uint64_t rindex = _drop ? windex : slowestReader(windex, false, report);
+        const size_t space = _capacity - size_t(windex - rindex);
+
+        if (space == 0) {
+            // Back-pressure: wait for the slowest reader.
+            if (!_blocked) {
+                _blocked = true;
+                _blocked_since.getSystemTime();
+            }
+            else if (_reader_timeout > 0 && Monotonic(true) - _blocked_since >= _reader_timeout * NanoSecPerMilliSec) {
+                evictReaders(rindex, report);
+                _blocked = false;
+                continue;
+            }
+            _header->writer_waiting = 1;
+            const uint32_t seq = _header->read_seq.load();
+            // Check again after announcing the wait to avoid missing a wake-up.
+            // Terminated readers are checked here only, to avoid system calls in the steady state.
+            if (slowestReader(windex, true, report) == rindex) {
+                FutexWait(_header->read_seq, seq, POLL_INTERVAL);
+            }
+            _header->writer_waiting = 0;
+            continue;
+        }
+        _blocked = false;
+
+        // Write a contiguous chunk. In drop mode, readers detect that they are overrun using write_limit.
+        const size_t first = size_t(windex % _capacity);
+        const size_t chunk = std::min(count, std::min(space, _capacity - first));
+        _header->write_limit.store(windex + chunk);
+        std::atomic_thread_fence(std::memory_order_release);
+        TSPacket::Copy(_packets + first, packets, chunk);
+        uint8_t* mdata = _metadata + first * METADATA_SLOT_SIZE;
+        for (size_t i = 0; i < chunk; ++i) {
+            if (metadata != nullptr) {
+                metadata[i].serialize(mdata + i * METADATA_SLOT_SIZE, METADATA_SLOT_SIZE);
+            }
+            else {
+                TSPacketMetadata().serialize(mdata + i * METADATA_SLOT_SIZE, METADATA_SLOT_SIZE);
+            }
+        }
+
+        // Publish the packets and wake up the waiting readers.
+        _header->write_index.store(windex + chunk, std::memory_order_release);
+        _header->write_seq++;
+        if (_header->readers_waiting.load() > 0) {
+            FutexWake(_header->write_seq);
+        }
+        packets += chunk;
+        if (metadata != nullptr) {
+            metadata += chunk;
+        }
+        count -= chunk;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read packets from the ring.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketSharedRing::read(TSPacket* packets, TSPacketMetadata* metadata, size_t max_packets, Report& report, const AbortInterface* abort)
+{
+    if (!isOpen() || _writer) {
+        report.error(u"shared memory ring not open as reader");
+        return 0;
+    }
+
+    ReaderSlot& slot(_header->slots[_slot]);
+    Monotonic start;
+    bool started = false;
+
+    while (max_packets > 0 && !_aborted && (abort == nullptr || !abort->aborting())) {
+
+        // Check if the writer evicted this reader.
+        if (slot.token.load() != _token) {
+            const uint64_t previous = _read_index;
+            report.warning(u"shared memory ring %s: reader evicted by writer, resynchronizing", {_name});
+            if (!claimSlot(report)) {
+                return 0;
+            }
+            _lost += _read_index - previous;
+            continue;
+        }
+
+        const uint64_t windex = _header->write_index.load(std::memory_order_acquire);
+
+        // Check if this reader was overrun by the writer in drop mode.
+        // Resynchronize on the oldest packet which is still in the ring.
+        if (windex - _read_index > _capacity) {
+            const uint64_t oldest = windex - _capacity;
+            report.warning(u"shared memory ring %s: reader overrun, %'d packets lost", {_name, oldest - _read_index});
+            _lost += oldest - _read_index;
+            _read_index = oldest;
+            slot.read_index.store(_read_index, std::memory_order_release);
+            continue;
+        }
+
+        if (windex > _read_index) {
+            // Copy a contiguous chunk.
+            const size_t first = size_t(_read_index % _capacity);
+            const size_t chunk = std::min(max_packets, std::min(size_t(windex - _read_index), _capacity - first));
+            TSPacket::Copy(packets, _packets + first, chunk);
+            const uint8_t* mdata = _metadata + first * METADATA_SLOT_SIZE;
+            for (size_t i = 0; metadata != nullptr && i < chunk; ++i) {
+                metadata[i].deserialize(mdata + i * METADATA_SLOT_SIZE, TSPacketMetadata::SERIALIZATION_SIZE);
+            }
+
+            // In drop mode, the writer may have overwritten the chunk during the copy.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t limit = _header->write_limit.load();
+            if (limit > _read_index + _capacity) {
+                const uint64_t oldest = limit - _capacity;
+                report.warning(u"shared memory ring %s: reader overrun, %'d packets lost", {_name, oldest - _read_index});
+                _lost += oldest - _read_index;
+                _read_index = oldest;
+                slot.read_index.store(_read_index, std::memory_order_release);
+                continue;
+            }
+
+            // Release the chunk and wake up the writer if it waits for free space.
+            _read_index += chunk;
+            slot.read_index.store(_read_index, std::memory_order_release);
+            _header->read_seq++;
+            if (_header->writer_waiting.load() != 0) {
+                FutexWake(_header->read_seq);
+            }
+            return chunk;
+        }
+
+        // No packet available.
+        if (_header->closed.load() != 0) {
+            return 0; // end of stream
+        }
+        if (!ProcessAlive(_header->writer_pid)) {
+            report.error(u"shared memory ring %s: writer process %d terminated", {_name, _header->writer_pid});
+            return 0;
+        }
+        if (!started) {
+            start.getSystemTime();
+            started = true;
+        }
+        else if (_receive_timeout > 0 && Monotonic(true) - start >= _receive_timeout * NanoSecPerMilliSec) {
+            report.error(u"shared memory ring %s: receive timeout", {_name});
+            return 0;
+        }
+
+        // Wait for the writer. Check again after announcing the wait to avoid missing a wake-up.
+        _header->readers_waiting++;
+        const uint32_t seq = _header->write_seq.load();
+        if (_header->write_index.load() == _read_index && _header->closed.load() == 0) {
+            FutexWait(_header->write_seq, seq, _receive_timeout > 0 ? std::min(_receive_timeout, POLL_INTERVAL) : POLL_INTERVAL);
+        }
+        _header->readers_waiting--;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream packet ring in shared memory for inter-process communication.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+#include "tsMonotonic.h"
+#include "tsReport.h"
+#include "tsAbortInterface.h"
+
+namespace ts {
+    //!
+    //! Transport stream packet ring in shared memory for inter-process communication.
+    //! @ingroup mpeg
+    //!
+    //! One writer process creates a named POSIX shared memory object containing a
+    //! circular buffer of TS packets and their metadata. Any number of reader
+    //! processes, up to a maximum which is set by the writer, attach to the ring
+    //! and receive all packets which are written after their attachment.
+    //!
+    //! Packets are transferred with one copy into the ring and one copy out of
+    //! it, without system call in the steady state. When a reader waits for
+    //! packets or the writer waits for free space, the waiting process sleeps
+    //! on a futex (Linux) or polls the ring (other UNIX systems).
+    //!
+    //! Back-pressure: by default, the writer waits for the slowest reader. A reader
+    //! which does not progress during the "reader timeout" is evicted by the writer.
+    //! An evicted reader resynchronizes on the most recent packet of the ring.
+    //! In "drop" mode, the writer never waits and overwrites the oldest packets.
+    //! A reader which is overrun resynchronizes on the oldest packet of the ring.
+    //!
+    //! Crash recovery: the slot of a reader process which terminated without detaching
+    //! is reclaimed by the writer or by other readers. When the writer process terminates
+    //! without closing the ring, the readers detect it and report an end of stream.
+    //!
+    //! Shared memory rings are not supported on Windows.
+    //!
+    class TSDUCKDLL TSPacketSharedRing
+    {
+        TS_NOCOPY(TSPacketSharedRing);
+    public:
+        static constexpr size_t DEFAULT_SIZE = 10000;             //!< Default size in packets of the ring.
+        static constexpr size_t DEFAULT_MAX_READERS = 16;         //!< Default maximum number of readers.
+        static constexpr size_t MAX_READERS = 64;                 //!< Absolute maximum number of readers.
+        static constexpr MilliSecond DEFAULT_READER_TIMEOUT = 5000; //!< Default timeout before evicting a stuck reader.
+
+        //!
+        //! Constructor.
+        //!
+        TSPacketSharedRing();
+
+        //!
+        //! Destructor.
+        //! The ring is closed if it was open.
+        //!
+        ~TSPacketSharedRing();
+
+        //!
+        //! Check if shared memory rings are supported on this platform.
+        //! @return True if shared memory rings are supported.
+        //!
+        static bool IsSupported();
+
+        //!
+        //! Create a ring as writer.
+        //! An existing shared memory object with the same name is replaced,
+        //! unless it is still used by a running writer process.
+        //! @param [in] name Name of the shared memory object.
+        //! @param [in] size Size in packets of the ring.
+        //! @param [in] max_readers Maximum number of simultaneous readers.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool create(const UString& name, size_t size, size_t max_readers, Report& report);
+
+        //!
+        //! Attach to a ring as reader.
+        //! The reader receives the packets which are written after its attachment.
+        //! @param [in] name Name of the shared memory object.
+        //! @param [in] timeout Maximum time to wait for the writer to create the ring.
+        //! Zero means fail immediately when the ring does not exist. Use Infinite to wait forever.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool attach(const UString& name, MilliSecond timeout, Report& report);
+
+        //!
+        //! Close the ring.
+        //! When called by the writer, the readers get an end of stream after
+        //! reading the remaining packets and the shared memory object is removed.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+        //!
+        //! Check if the ring is open.
+        //! @return True if the ring is open.
+        //!
+        bool isOpen() const { return _base != nullptr; }
+
+        //!
+        //! Check if this object is the writer of the ring.
+        //! @return True if the ring is open as writer.
+        //!
+        bool isWriter() const { return _base != nullptr && _writer; }
+
+        //!
+        //! Get the size of the ring in packets.
+        //! @return The size of the ring in packets or zero if the ring is not open.
+        //!
+        size_t size() const { return _capacity; }
+
+        //!
+        //! Set the back-pressure policy of the writer.
+        //! @param [in] drop If true, the writer never waits for slow readers and overwrites
+        //! the oldest packets. If false (the default), the writer waits for the slowest reader.
+        //! @param [in] reader_timeout When the writer waits for slow readers, evict a reader
+        //! which does not progress during that time. Zero means never evict a reader.
+        //!
+        void setBackPressure(bool drop, MilliSecond reader_timeout = DEFAULT_READER_TIMEOUT);
+
+        //!
+        //! Set the timeout of the reader.
+        //! @param [in] timeout When no packet is written during this time, read() returns zero.
+        //! Zero means no timeout (the default).
+        //!
+        void setReceiveTimeout(MilliSecond timeout) { _receive_timeout = timeout; }
+
+        //!
+        //! Write packets into the ring (writer only).
+        //! @param [in] packets Address of the packets to write.
+        //! @param [in] metadata Address of the packet metadata. Can be null.
+        //! @param [in] count Number of packets to write.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] abort If not null, abort the wait for free space when this interface reports an abort.
+        //! @return True on success, false on error or abort.
+        //!
+        bool write(const TSPacket* packets, const TSPacketMetadata* metadata, size_t count, Report& report, const AbortInterface* abort = nullptr);
+
+        //!
+        //! Read packets from the ring (reader only).
+        //! The reader waits until at least one packet is available.
+        //! @param [out] packets Address of the buffer for the packets.
+        //! @param [out] metadata Address of the buffer for the packet metadata. Can be null.
+        //! @param [in] max_packets Maximum number of packets to read.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] abort If not null, abort the wait for packets when this interface reports an abort.
+        //! @return The number of read packets. Zero on end of stream, error, timeout or abort.
+        //!
+        size_t read(TSPacket* packets, TSPacketMetadata* metadata, size_t max_packets, Report& report, const AbortInterface* abort = nullptr);
+
+        //!
+        //! Publish the bitrate of the stream (writer only).
+        //! @param [in] bitrate Bitrate of the stream. Zero if unknown.
+        //!
+        void setBitrate(const BitRate& bitrate);
+
+        //!
+        //! Get the bitrate of the stream, as published by the writer.
+        //! @return Bitrate of the stream. Zero if unknown.
+        //!
+        BitRate getBitrate() const;
+
+        //!
+        //! Get the number of packets which were lost by this reader.
+        //! Packets are lost when the reader is evicted or overrun by the writer.
+        //! @return The number of lost packets.
+        //!
+        PacketCounter lostPackets() const { return _lost; }
+
+        //!
+        //! Get the number of readers which are currently attached to the ring.
+        //! @return The number of attached readers.
+        //!
+        size_t readersCount() const;
+
+        //!
+        //! Wait until a minimum number of readers are attached to the ring (writer only).
+        //! @param [in] count Minimum number of readers.
+        //! @param [in] timeout Maximum time to wait. Use Infinite to wait forever.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] abort If not null, abort the wait when this interface reports an abort.
+        //! @return True when the readers are attached, false on timeout or abort.
+        //!
+        bool waitReaders(size_t count, MilliSecond timeout, Report& report, const AbortInterface* abort = nullptr);
+
+        //!
+        //! Abort any pending or future wait in write() or read().
+        //! Can be called from another thread.
+        //!
+        void abort() { _aborted = true; }
+
+    private:
+        struct Header;  // Shared memory layout, defined in implementation.
+
+        UString        _name;            // Name of the shared memory object.
+        bool           _writer;          // This process is the writer.
+        volatile bool  _aborted;         // Abort all waits.
+        uint8_t*       _base;            // Base address of the mapped shared memory.
+        size_t         _map_size;        // Size of the mapped shared memory.
+        Header*        _header;          // Header in shared memory (same as _base).
+        TSPacket*      _packets;         // Packet area in shared memory.
+        uint8_t*       _metadata;        // Metadata area in shared memory.
+        size_t         _capacity;        // Size of the ring in packets.
+        size_t         _max_readers;     // Number of reader slots.
+        bool           _drop;            // Writer: never wait for readers.
+        MilliSecond    _reader_timeout;  // Writer: evict a reader which does not progress during that time.
+        bool           _blocked;         // Writer: currently blocked by a reader.
+        Monotonic      _blocked_since;   // Writer: start time of blocking.
+        MilliSecond    _receive_timeout; // Reader: timeout on read().
+        size_t         _slot;            // Reader: index of reader slot.
+        uint32_t       _token;           // Reader: token in reader slot.
+        uint64_t       _read_index;      // Reader: index of next packet to read.
+        PacketCounter  _lost;            // Reader: number of lost packets.
+
+        // Reader: claim a free reader slot, starting at the current write index.
+        bool claimSlot(Report& report);
+
+        // Writer: get the index of the slowest reader, release slots of terminated readers.
+        uint64_t slowestReader(uint64_t write_index, bool check_alive, Report& report);
+
+        // Writer: evict all readers which are at the specified read index.
+        void evictReaders(uint64_t read_index, Report& report);
+    };
+}
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsTSPacket.h"
 #include "tsReport.h"
+#include "tsFlatPIDMap.h"
 
 namespace ts {
     //!
@@ -253,7 +254,7 @@ namespace ts {
         };
 
         // A map of PID state, indexed by PID.
-        typedef std::map<PID,PIDState> PIDStateMap;
+        typedef FlatPIDMap<PIDState> PIDStateMap;
 
         // Private members.
         Report*       _report;            // Where to report errors, never null.
@@ -0,0 +1,117 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsContinuitySplicer.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::ContinuitySplicer::ContinuitySplicer() :
+    _splice_count(0),
+    _pids(PID_MAX)
+{
+    reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Reset all collected information.
+//----------------------------------------------------------------------------
+
+void ts::ContinuitySplicer::reset()
+{
+    _splice_count = 0;
+    for (auto it = _pids.begin(); it != _pids.end(); ++it) {
+        it->splice = 0;
+        it->last_cc = 0;
+        it->offset = 0;
+        it->known = false;
+        it->pcr = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Signal that subsequent packets come from another stream.
+//----------------------------------------------------------------------------
+
+void ts::ContinuitySplicer::splice()
+{
+    // The offsets are lazily recomputed on the first packet of each PID after the splice.
+    _splice_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Process and modify TS packets.
+//----------------------------------------------------------------------------
+
+void ts::ContinuitySplicer::feedPackets(TSPacket* pkt, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        feedPacket(pkt[i]);
+    }
+}
+
+void ts::ContinuitySplicer::feedPacket(TSPacket& pkt)
+{
+    const PID pid = pkt.getPID();
+    if (pid == PID_NULL) {
+        // Continuity counters are undefined on null packets.
+        return;
+    }
+
+    PIDContext& ctx(_pids[pid]);
+    if (ctx.splice != _splice_count) {
+        // First packet of this PID after a splice: compute the offset from the previous stream.
+        ctx.splice = _splice_count;
+        ctx.pcr = true;
+        if (ctx.known) {
+            const uint8_t expected = pkt.hasPayload() ? (ctx.last_cc + 1) & CC_MASK : ctx.last_cc;
+            ctx.offset = (expected - pkt.getCC()) & CC_MASK;
+        }
+        else {
+            ctx.offset = 0;
+        }
+    }
+
+    if (ctx.offset != 0) {
+        pkt.setCC((pkt.getCC() + ctx.offset) & CC_MASK);
+    }
+    if (ctx.pcr && pkt.hasPCR()) {
+        // First PCR after a splice, signal the new time base.
+        pkt.setDiscontinuityIndicator();
+        ctx.pcr = false;
+    }
+    ctx.last_cc = pkt.getCC();
+    ctx.known = true;
+}
@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Keep continuity counters continuous when splicing transport streams.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+
+namespace ts {
+    //!
+    //! Keep continuity counters continuous when splicing transport streams.
+    //! @ingroup mpeg
+    //!
+    //! Packets from several transport streams are successively passed through an instance
+    //! of this class. Each time the input switches to another stream, splice() is called.
+    //!
+    //! The packets are never modified before the first splice. After a splice, the first packet
+    //! of each PID in the new stream defines a continuity counter offset between the previous
+    //! stream and the new one. This offset is then applied to all subsequent packets of the PID,
+    //! until the next splice. Thus, duplicate packets and continuity errors in the new stream are
+    //! preserved and the discontinuity_indicator of the packets is never cleared. The only
+    //! modification is the discontinuity_indicator which is set in the first packet with a PCR
+    //! in each PID after a splice, to signal the new time base.
+    //!
+    class TSDUCKDLL ContinuitySplicer
+    {
+    public:
+        //!
+        //! Constructor.
+        //!
+        ContinuitySplicer();
+
+        //!
+        //! Reset all collected information.
+        //!
+        void reset();
+
+        //!
+        //! Signal that subsequent packets come from another stream.
+        //!
+        void splice();
+
+        //!
+        //! Get the number of splices since the last reset.
+        //! @return The number of splices since the last reset.
+        //!
+        size_t spliceCount() const { return _splice_count; }
+
+        //!
+        //! Process and modify a TS packet.
+        //! @param [in,out] pkt A transport stream packet.
+        //!
+        void feedPacket(TSPacket& pkt);
+
+        //!
+        //! Process and modify a contiguous area of TS packets.
+        //! @param [in,out] pkt Address of the first packet.
+        //! @param [in] count Number of packets.
+        //!
+        void feedPackets(TSPacket* pkt, size_t count);
+
+    private:
+        // Description of one PID.
+        struct PIDContext
+        {
+            size_t  splice;  // Index of the last splice when the offset was computed.
+            uint8_t last_cc; // Last output continuity counter.
+            uint8_t offset;  // Offset to add to the continuity counters of the current stream.
+            bool    known;   // The PID was already output, last_cc is valid.
+            bool    pcr;     // Waiting for the first PCR after a splice.
+        };
+
+        size_t                  _splice_count;  // Number of splices since last reset.
+        std::vector<PIDContext> _pids;          // Indexed by PID.
+    };
+}
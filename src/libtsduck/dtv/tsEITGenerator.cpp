@@ -34,6 +34,10 @@
 #include "tsBCD.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::EITGenerator::MIN_SERVICES_PER_THREAD;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor.
@@ -58,7 +62,8 @@ ts::EITGenerator::EITGenerator(DuckContext& duck, PID pid, EITOption options, co
     _packetizer(_duck, _eit_pid, this),
     _services(),
     _injects(),
-    _obsolete_count(0)
+    _obsolete_count(0),
+    _max_threads(1)
 {
     // We need the PAT as long as the TS id is not known.
     _demux.addPID(PID_PAT);
@@ -104,7 +109,13 @@ void ts::EITGenerator::reset()
 // Event: Constructor of the structure containing binary events.
 //----------------------------------------------------------------------------
 
+namespace {
+    // Serial numbers of events. Never reused, even in distinct instances of EITGenerator.
+    std::atomic<uint64_t> NextEventSerial(0);
+}
+
 ts::EITGenerator::Event::Event(const uint8_t*& data, size_t& size) :
+    serial(NextEventSerial++),
     event_id(0),
     start_time(),
     end_time(),
@@ -133,7 +144,8 @@ ts::EITGenerator::ESection::ESection(const ServiceIdTriplet& srv, TID tid, uint8
     obsolete(false),
     injected(false),
     next_inject(),
-    section()
+    section(),
+    events()
 {
     // Build section data.
     ByteBlockPtr section_data(new ByteBlock(LONG_SECTION_HEADER_SIZE + EIT::EIT_PAYLOAD_FIXED_SIZE + SECTION_CRC32_SIZE));
@@ -618,16 +630,9 @@ void ts::EITGenerator::setCurrentTime(Time current_utc)
 
 
 //----------------------------------------------------------------------------
-// Mark a segment or section as obsolete, garbage collect obsolete sections
+// Mark a section as obsolete, garbage collect obsolete sections
 //----------------------------------------------------------------------------
 
-void ts::EITGenerator::markObsoleteSegment(ESegment &seg)
-{
-    for (auto it = seg.sections.begin(); it != seg.sections.end(); ++it) {
-        markObsoleteSection(**it);
-    }
-}
-
 void ts::EITGenerator::markObsoleteSection(ESection& sec)
 {
     // Don't do anything if the section is already obsolete.
@@ -810,178 +815,268 @@ void ts::EITGenerator::regenerateSchedule(const Time& now)
     // Reference time for EIT schedule.
     const Time last_midnight(now.thisDay());
 
-    // Loop on all services, regenerating those which are marked for regeneration.
+    // List of services which are marked for regeneration.
+    ScheduleJobVector jobs;
     for (auto srv_iter = _services.begin(); srv_iter != _services.end(); ++srv_iter) {
         if (srv_iter->second.regenerate) {
+            jobs.push_back(ScheduleJob(srv_iter));
+        }
+    }
 
-            const ServiceIdTriplet& service_id(srv_iter->first);
-            EService& srv(srv_iter->second);
-            const bool actual = service_id.transport_stream_id == _actual_ts_id;
+    // Regenerate the services, in parallel when there are many of them.
+    // The current thread also processes jobs while the other threads are running.
+    std::atomic<size_t> next_job(0);
+    const size_t thread_count = std::min(_max_threads, std::max<size_t>(1, jobs.size() / MIN_SERVICES_PER_THREAD));
+    if (thread_count > 1) {
+        _duck.report().debug(u"regenerating EIT schedule in %d services using %d threads", {jobs.size(), thread_count});
+    }
+    std::vector<SafePtr<ScheduleThread>> threads;
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads.push_back(new ScheduleThread(*this, jobs, next_job, last_midnight));
+        CheckNonNull(threads.back().pointer());
+        threads.back()->start();
+    }
+    runScheduleJobs(jobs, next_job, last_midnight);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->waitForTermination();
+    }
 
-            // Check if EIT schedule are needed for the service.
-            const bool need_eits = (actual && (_options & (EITOption::GEN_SCHED | EITOption::GEN_ACTUAL)) == (EITOption::GEN_SCHED | EITOption::GEN_ACTUAL)) ||
-                                   (!actual && (_options & (EITOption::GEN_SCHED | EITOption::GEN_OTHER)) == (EITOption::GEN_SCHED | EITOption::GEN_OTHER));
+    // Update the injection lists with all regenerated sections at once, in the order of services.
+    size_t modified_count = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        ScheduleUpdate& update(jobs[i].update);
+        modified_count += update.modified_count;
+        for (auto it = update.obsolete_sections.begin(); it != update.obsolete_sections.end(); ++it) {
+            markObsoleteSection(**it);
+        }
+        for (auto it = update.new_sections.begin(); it != update.new_sections.end(); ++it) {
+            enqueueInjectSection(*it, now, true);
+        }
+    }
+    _duck.report().debug(u"regenerated EIT schedule in %d services, %d sections modified", {jobs.size(), modified_count});
 
-            // Remove initial segments before last midnight.
-            while (!srv.segments.empty() && srv.segments.front()->start_time < last_midnight) {
-                markObsoleteSegment(*srv.segments.front());
-                srv.segments.pop_front();
-            }
+    // Clear global regeneration flag.
+    _regenerate = false;
+}
 
-            // Remove final empty segments (no events). Keep at least one segment for last midnight, even if empty.
-            while (!srv.segments.empty() && srv.segments.back()->events.empty() && srv.segments.back()->start_time > last_midnight) {
-                markObsoleteSegment(*srv.segments.back());
-                srv.segments.pop_back();
-            }
 
-            // Make sure that the first segment exists for last midnight.
-            if (srv.segments.empty() || srv.segments.front()->start_time != last_midnight) {
-                _duck.report().debug(u"creating EIT segment starting at %s for %s", {last_midnight, service_id});
-                const ESegmentPtr seg(new ESegment(last_midnight));
-                CheckNonNull(seg.pointer());
-                srv.segments.push_front(seg);
-            }
+//----------------------------------------------------------------------------
+// Run schedule regeneration jobs until none is left.
+//----------------------------------------------------------------------------
 
-            // Loop on all segments. The first segment must be at last midnight.
-            Time segment_start_time(last_midnight);
-            size_t segment_number = 0;
-            for (auto seg_iter = srv.segments.begin(); seg_iter != srv.segments.end(); ++seg_iter) {
-
-                // Enforce the existence of contiguous segments. Create missing segments when necessary.
-                if ((*seg_iter)->start_time != segment_start_time) {
-                    _duck.report().debug(u"creating EIT segment starting at %s for %s", {segment_start_time, service_id});
-                    assert((*seg_iter)->start_time > segment_start_time);
-                    const ESegmentPtr seg(new ESegment(segment_start_time));
-                    CheckNonNull(seg.pointer());
-                    seg_iter = srv.segments.insert(seg_iter, seg);
-                }
-                ESegment& seg(**seg_iter);
+void ts::EITGenerator::runScheduleJobs(ScheduleJobVector& jobs, std::atomic<size_t>& next_job, const Time& last_midnight) const
+{
+    for (size_t index = next_job++; index < jobs.size(); index = next_job++) {
+        regenerateServiceSchedule(jobs[index].service->first, jobs[index].service->second, last_midnight, jobs[index].update);
+    }
+}
 
-                if (!need_eits) {
-                    // We do not need EIT schedule here, delete all sections.
-                    markObsoleteSegment(seg);
-                    seg.sections.clear();
-                }
-                else if (seg.regenerate) {
-                    // Regenerate EIT schedule in the segment.
-
-                    // Table id and first section number in that segment.
-                    const TID table_id = EIT::SegmentToTableId(actual, segment_number);
-                    uint8_t section_number = EIT::SegmentToSection(segment_number);
-
-                    // We need at least one section, possibly empty, in each segment.
-                    if (seg.sections.empty()) {
-                        const ESectionPtr sec(new ESection(service_id, table_id, section_number, section_number));
-                        CheckNonNull(sec.pointer());
-                        seg.sections.push_back(sec);
-                        enqueueInjectSection(sec, getCurrentTime(), true);
-                    }
+ts::EITGenerator::ScheduleThread::ScheduleThread(EITGenerator& gen, ScheduleJobVector& jobs, std::atomic<size_t>& next_job, const Time& last_midnight) :
+    Thread(ThreadAttributes().setStackSize(256 * 1024)),
+    _gen(gen),
+    _jobs(jobs),
+    _next_job(next_job),
+    _last_midnight(last_midnight)
+{
+}
 
-                    // Update or generate all sections.
-                    auto ev_iter = seg.events.begin();
-                    auto sec_iter = seg.sections.begin();
-                    while (ev_iter != seg.events.end()) {
-
-                        // Check if the current event can fit into the current section.
-                        if ((*sec_iter)->section->payloadSize() + (*ev_iter)->event_data.size() > MAX_PRIVATE_LONG_SECTION_PAYLOAD_SIZE) {
-                            // The current event does not fit. Need to use another section in this segment.
-                            // Close current section and move to next one.
-                            (*sec_iter)->section->recomputeCRC();
-                            ++sec_iter;
-                            ++section_number;
-                            // If there is no existing next section, create a new one.
-                            if (sec_iter == seg.sections.end()) {
-                                // If too many sections for that segment, skip the last events.
-                                if (seg.sections.size() >= EIT::SECTIONS_PER_SEGMENT) {
-                                    break;
-                                }
-                                const ESectionPtr sec(new ESection(service_id, table_id, section_number, section_number));
-                                CheckNonNull(sec.pointer());
-                                sec_iter = seg.sections.insert(sec_iter, sec);
-                                enqueueInjectSection(sec, getCurrentTime(), true);
-                            }
-                        }
+ts::EITGenerator::ScheduleThread::~ScheduleThread()
+{
+    waitForTermination();
+}
 
-                        // Now append the event to the section payload.
-                        (*sec_iter)->section->appendPayload((*ev_iter)->event_data, false);
-                        ++ev_iter;
-                    }
+void ts::EITGenerator::ScheduleThread::main()
+{
+    _gen.runScheduleJobs(_jobs, _next_job, _last_midnight);
+}
 
-                    // Close last section if still open.
-                    // Note: sec_iter == seg.sections.end() when all possible sections for that segment were created.
-                    if (sec_iter != seg.sections.end()) {
-                        (*sec_iter)->section->recomputeCRC();
-                        ++sec_iter;
-                    }
 
-                    // Deallocate remaining sections, if any.
-                    while (sec_iter != seg.sections.end()) {
-                        markObsoleteSection(**sec_iter);
-                        sec_iter = seg.sections.erase(sec_iter);
-                    }
+//----------------------------------------------------------------------------
+// Regenerate the EIT schedule in one service.
+//----------------------------------------------------------------------------
+
+void ts::EITGenerator::regenerateServiceSchedule(const ServiceIdTriplet& service_id, EService& srv, const Time& last_midnight, ScheduleUpdate& update) const
+{
+    const bool actual = service_id.transport_stream_id == _actual_ts_id;
+
+    // Check if EIT schedule are needed for the service.
+    const bool need_eits = (actual && (_options & (EITOption::GEN_SCHED | EITOption::GEN_ACTUAL)) == (EITOption::GEN_SCHED | EITOption::GEN_ACTUAL)) ||
+                           (!actual && (_options & (EITOption::GEN_SCHED | EITOption::GEN_OTHER)) == (EITOption::GEN_SCHED | EITOption::GEN_OTHER));
+
+    // Remove initial segments before last midnight.
+    while (!srv.segments.empty() && srv.segments.front()->start_time < last_midnight) {
+        update.obsolete_sections.splice(update.obsolete_sections.end(), srv.segments.front()->sections);
+        srv.segments.pop_front();
+    }
+
+    // Remove final empty segments (no events). Keep at least one segment for last midnight, even if empty.
+    while (!srv.segments.empty() && srv.segments.back()->events.empty() && srv.segments.back()->start_time > last_midnight) {
+        update.obsolete_sections.splice(update.obsolete_sections.end(), srv.segments.back()->sections);
+        srv.segments.pop_back();
+    }
+
+    // Make sure that the first segment exists for last midnight.
+    if (srv.segments.empty() || srv.segments.front()->start_time != last_midnight) {
+        _duck.report().debug(u"creating EIT segment starting at %s for %s", {last_midnight, service_id});
+        const ESegmentPtr seg(new ESegment(last_midnight));
+        CheckNonNull(seg.pointer());
+        srv.segments.push_front(seg);
+    }
+
+    // Loop on all segments. The first segment must be at last midnight.
+    Time segment_start_time(last_midnight);
+    size_t segment_number = 0;
+    for (auto seg_iter = srv.segments.begin(); seg_iter != srv.segments.end(); ++seg_iter) {
+
+        // Enforce the existence of contiguous segments. Create missing segments when necessary.
+        if ((*seg_iter)->start_time != segment_start_time) {
+            _duck.report().debug(u"creating EIT segment starting at %s for %s", {segment_start_time, service_id});
+            assert((*seg_iter)->start_time > segment_start_time);
+            const ESegmentPtr seg(new ESegment(segment_start_time));
+            CheckNonNull(seg.pointer());
+            seg_iter = srv.segments.insert(seg_iter, seg);
+        }
+        ESegment& seg(**seg_iter);
+
+        if (!need_eits) {
+            // We do not need EIT schedule here, delete all sections.
+            update.obsolete_sections.splice(update.obsolete_sections.end(), seg.sections);
+        }
+        else if (seg.regenerate) {
+            // Some events changed in the segment. Distribute the events in sections and rebuild
+            // only the sections with a different list of events. Events are never modified,
+            // a modified event is a new event object with a new serial number.
+
+            // Table id and first section number in that segment.
+            const TID table_id = EIT::SegmentToTableId(actual, segment_number);
+            uint8_t section_number = EIT::SegmentToSection(segment_number);
+
+            auto ev_iter = seg.events.begin();
+            auto sec_iter = seg.sections.begin();
+            std::vector<uint64_t> serials;
+
+            // We need at least one section, possibly empty, in each segment.
+            do {
+                // Skip the events which cannot fit in any section.
+                while (ev_iter != seg.events.end() && EIT::EIT_PAYLOAD_FIXED_SIZE + (*ev_iter)->event_data.size() > MAX_PRIVATE_LONG_SECTION_PAYLOAD_SIZE) {
+                    _duck.report().warning(u"EPG event id 0x%X (%<d) in %s too large for an EIT section, ignored", {(*ev_iter)->event_id, service_id});
+                    ++ev_iter;
                 }
 
-                // Clear segment regeneration flag.
-                seg.regenerate = false;
+                // Collect the events which fit in the next section.
+                const auto first_ev = ev_iter;
+                size_t payload_size = EIT::EIT_PAYLOAD_FIXED_SIZE;
+                serials.clear();
+                while (ev_iter != seg.events.end() && payload_size + (*ev_iter)->event_data.size() <= MAX_PRIVATE_LONG_SECTION_PAYLOAD_SIZE) {
+                    payload_size += (*ev_iter)->event_data.size();
+                    serials.push_back((*ev_iter)->serial);
+                    ++ev_iter;
+                }
 
-                // Time and index of next expected segment:
-                segment_start_time += EIT::SEGMENT_DURATION;
-                segment_number++;
-            }
+                // No more event after skipped ones. Only the first section of the segment can be empty.
+                if (serials.empty() && section_number != EIT::SegmentToSection(segment_number)) {
+                    break;
+                }
 
-            // Fix synthetic fields in all EIT-schedule sections: last_section_number, segment_last_section_number, last_table_id.
-            if (need_eits) {
-                assert(!srv.segments.empty());
-                assert(!srv.segments.back()->sections.empty());
-
-                segment_number = srv.segments.size();
-                TID previous_table_id = TID_NULL;
-                TID last_table_id = TID_NULL;
-                uint8_t last_section_number = 0;
-
-                // Loop on segments from last to first.
-                for (auto seg_iter = srv.segments.rbegin(); seg_iter != srv.segments.rend(); ++seg_iter) {
-                    ESegment& seg(**seg_iter);
-                    assert(!seg.sections.empty());
-
-                    const TID table_id = EIT::SegmentToTableId(actual, --segment_number);
-                    uint8_t section_number = EIT::SegmentToSection(segment_number);
-                    const uint8_t segment_last_section_number = uint8_t(section_number + seg.sections.size() - 1);
-
-                    if (table_id != previous_table_id) {
-                        // Changed table. We are on the last segment of the previous table.
-                        last_section_number = segment_last_section_number;
-                        previous_table_id = table_id;
-                    }
-                    if (seg_iter == srv.segments.rbegin()) {
-                        // Last segment.
-                        last_table_id = table_id;
+                // Get the next section or create it.
+                bool created = false;
+                if (sec_iter == seg.sections.end()) {
+                    // If too many sections for that segment, skip the last events.
+                    if (seg.sections.size() >= EIT::SECTIONS_PER_SEGMENT) {
+                        break;
                     }
-                    for (auto sec_iter = seg.sections.begin(); sec_iter != seg.sections.end(); ++sec_iter) {
-                        ESection& sec(**sec_iter);
-                        const uint8_t* pl = sec.section->payload();
-                        if (sec.section->sectionNumber() != section_number ||
-                            sec.section->lastSectionNumber() != last_section_number ||
-                            pl[4] != segment_last_section_number ||
-                            pl[5] != last_table_id)
-                        {
-                            sec.section->setSectionNumber(section_number, false);
-                            sec.section->setLastSectionNumber(last_section_number, false);
-                            sec.section->setUInt8(4, segment_last_section_number, false);
-                            sec.section->setUInt8(5, last_table_id, true);
-                        }
-                        section_number++;
+                    const ESectionPtr sec(new ESection(service_id, table_id, section_number, section_number));
+                    CheckNonNull(sec.pointer());
+                    sec_iter = seg.sections.insert(sec_iter, sec);
+                    update.new_sections.push_back(sec);
+                    created = true;
+                }
+                ESection& sec(**sec_iter);
+
+                // Rebuild the section payload only if its list of events changed.
+                // A new section is always built, at least to compute its CRC32.
+                if (created || sec.events != serials) {
+                    sec.startModifying();
+                    sec.section->truncatePayload(EIT::EIT_PAYLOAD_FIXED_SIZE, false);
+                    for (auto it = first_ev; it != ev_iter; ++it) {
+                        sec.section->appendPayload((*it)->event_data, false);
                     }
+                    sec.section->recomputeCRC();
+                    sec.events.swap(serials);
+                    update.modified_count++;
                 }
+                ++sec_iter;
+                ++section_number;
+            } while (ev_iter != seg.events.end());
+
+            // Deallocate remaining sections, if any.
+            while (sec_iter != seg.sections.end()) {
+                update.obsolete_sections.push_back(*sec_iter);
+                sec_iter = seg.sections.erase(sec_iter);
             }
+        }
+
+        // Clear segment regeneration flag.
+        seg.regenerate = false;
+
+        // Time and index of next expected segment:
+        segment_start_time += EIT::SEGMENT_DURATION;
+        segment_number++;
+    }
+
+    // Fix synthetic fields in all EIT-schedule sections: table_id, last_section_number, segment_last_section_number, last_table_id.
+    // After midnight, all segments move and most sections are modified.
+    if (need_eits) {
+        assert(!srv.segments.empty());
+        assert(!srv.segments.back()->sections.empty());
 
-            // Clear service regeneration flag.
-            srv.regenerate = false;
+        segment_number = srv.segments.size();
+        TID previous_table_id = TID_NULL;
+        TID last_table_id = TID_NULL;
+        uint8_t last_section_number = 0;
+
+        // Loop on segments from last to first.
+        for (auto seg_iter = srv.segments.rbegin(); seg_iter != srv.segments.rend(); ++seg_iter) {
+            ESegment& seg(**seg_iter);
+            assert(!seg.sections.empty());
+
+            const TID table_id = EIT::SegmentToTableId(actual, --segment_number);
+            uint8_t section_number = EIT::SegmentToSection(segment_number);
+            const uint8_t segment_last_section_number = uint8_t(section_number + seg.sections.size() - 1);
+
+            if (table_id != previous_table_id) {
+                // Changed table. We are on the last segment of the previous table.
+                last_section_number = segment_last_section_number;
+                previous_table_id = table_id;
+            }
+            if (seg_iter == srv.segments.rbegin()) {
+                // Last segment.
+                last_table_id = table_id;
+            }
+            for (auto sec_iter = seg.sections.begin(); sec_iter != seg.sections.end(); ++sec_iter) {
+                ESection& sec(**sec_iter);
+                const uint8_t* pl = sec.section->payload();
+                if (sec.section->tableId() != table_id ||
+                    sec.section->sectionNumber() != section_number ||
+                    sec.section->lastSectionNumber() != last_section_number ||
+                    pl[4] != segment_last_section_number ||
+                    pl[5] != last_table_id)
+                {
+                    sec.startModifying();
+                    sec.section->setTableId(table_id, false);
+                    sec.section->setSectionNumber(section_number, false);
+                    sec.section->setLastSectionNumber(last_section_number, false);
+                    sec.section->setUInt8(4, segment_last_section_number, false);
+                    sec.section->setUInt8(5, last_table_id, true);
+                    update.modified_count++;
+                }
+                section_number++;
+            }
         }
     }
 
-    // Clear global regeneration flag.
-    _regenerate = false;
+    // Clear service regeneration flag.
+    srv.regenerate = false;
 }
 
 
@@ -40,6 +40,7 @@
 #include "tsServiceIdTriplet.h"
 #include "tsTSPacket.h"
 #include "tsEnumUtils.h"
+#include "tsThread.h"
 
 namespace ts {
     //!
@@ -86,6 +87,12 @@ namespace ts {
     //! (see EITGenerator::setProfile()). The maximum EIT bandwidth can be limited using
     //! EITGenerator::setMaxBitRate().
     //!
+    //! When events are added or removed, only the EIT schedule sections which contain these
+    //! events or follow them in the same segment are rebuilt. When many services must be
+    //! regenerated at the same time (typically at midnight when all segments are renumbered),
+    //! the services can be regenerated in parallel (see EITGenerator::setMaxThreads()).
+    //! All regenerated sections are queued for injection after the complete regeneration.
+    //!
     //! EPG database
     //! ------------
     //! The EPG database is entirely in memory. It is initially empty and emptied using
@@ -257,6 +264,21 @@ namespace ts {
         //!
         void setMaxBitRate(BitRate bitrate) { setBitRateField(&EITGenerator::_max_bitrate, bitrate); }
 
+        //!
+        //! Set the maximum number of threads to regenerate the EIT schedule.
+        //! When many services must be regenerated at the same time, they are distributed
+        //! over several threads. The generated sections are the same, regardless of the
+        //! number of threads.
+        //! @param [in] count Maximum number of threads. The default is 1 (no additional thread).
+        //!
+        void setMaxThreads(size_t count) { _max_threads = std::max<size_t>(1, count); }
+
+        //!
+        //! Minimum number of services to regenerate per thread.
+        //! Below this number, creating threads costs more than it saves.
+        //!
+        static constexpr size_t MIN_SERVICES_PER_THREAD = 16;
+
         //!
         //! Set the current time in the stream processing.
         //!
@@ -376,6 +398,7 @@ namespace ts {
         {
             TS_NOBUILD_NOCOPY(Event);
         public:
+            const uint64_t serial; // Unique serial number of the event object, never reused.
             uint16_t  event_id;    // Event id.
             Time      start_time;  // Decoded event start time.
             Time      end_time;    // Decoded event end time.
@@ -401,6 +424,7 @@ namespace ts {
             bool       injected;     // Indicate that the data part of the section is used in a packetizer.
             Time       next_inject;  // Date of next injection.
             SectionPtr section;      // Safe pointer to the EIT section.
+            std::vector<uint64_t> events;  // EIT schedule: serial numbers of the events in the section.
 
             // Constructor, build an empty section for the specified service (CRC32 not set).
             ESection(const ServiceIdTriplet& service_id, TID tid, uint8_t section_number, uint8_t last_section_number);
@@ -426,7 +450,7 @@ namespace ts {
             TS_NOBUILD_NOCOPY(ESegment);
         public:
             const Time   start_time;      // Segment start time (a multiple of 3 hours). Never change.
-            bool         regenerate;      // Regenerate all EIT schedule sections in the segment.
+            bool         regenerate;      // Some events changed, rebuild the affected EIT schedule sections in the segment.
             EventList    events;          // List of events in the segment, sorted by start time.
             ESectionList sections;        // Current list of sections in the segment, sorted by start time.
 
@@ -495,6 +519,42 @@ namespace ts {
         EServiceMap          _services;          // Map of services -> segments -> events and sections.
         ESectionListArray    _injects;           // Arrays of sections for injection.
         size_t               _obsolete_count;    // Number of obsolete sections in the injection lists.
+        size_t               _max_threads;       // Max number of threads to regenerate EIT schedule.
+
+        // Result of the EIT schedule regeneration in one service.
+        class ScheduleUpdate
+        {
+        public:
+            ESectionList new_sections;       // New sections to enqueue for injection.
+            ESectionList obsolete_sections;  // Sections to mark as obsolete.
+            size_t       modified_count;     // Number of modified sections.
+            ScheduleUpdate() : new_sections(), obsolete_sections(), modified_count(0) {}
+        };
+
+        // Description of the EIT schedule regeneration in one service.
+        class ScheduleJob
+        {
+        public:
+            EServiceMap::iterator service;  // Service to regenerate.
+            ScheduleUpdate        update;   // Result of the regeneration.
+            ScheduleJob(EServiceMap::iterator srv) : service(srv), update() {}
+        };
+        typedef std::vector<ScheduleJob> ScheduleJobVector;
+
+        // A thread which regenerates EIT schedule in a set of services.
+        class ScheduleThread : public Thread
+        {
+            TS_NOBUILD_NOCOPY(ScheduleThread);
+        public:
+            ScheduleThread(EITGenerator& gen, ScheduleJobVector& jobs, std::atomic<size_t>& next_job, const Time& last_midnight);
+            virtual ~ScheduleThread() override;
+        private:
+            EITGenerator&        _gen;
+            ScheduleJobVector&   _jobs;
+            std::atomic<size_t>& _next_job;
+            const Time           _last_midnight;
+            virtual void main() override;
+        };
 
         // Set a bitrate field and update EIT inter-packet.
         void setBitRateField(BitRate EITGenerator::* field, BitRate bitrate);
@@ -511,10 +571,16 @@ namespace ts {
         // Regenerate all EIT schedule, create missing segments and sections.
         void regenerateSchedule(const Time& now);
 
+        // Regenerate the EIT schedule in one service. Only access the service, can be called in parallel
+        // for distinct services. Created and deleted sections are returned in the update, for the injection lists.
+        void regenerateServiceSchedule(const ServiceIdTriplet& service_id, EService& srv, const Time& last_midnight, ScheduleUpdate& update) const;
+
+        // Run schedule regeneration jobs until none is left.
+        void runScheduleJobs(ScheduleJobVector& jobs, std::atomic<size_t>& next_job, const Time& last_midnight) const;
+
         // Mark a section as obsolete, garbage collect obsolete sections if too many were not
-        // naturally discarded from the injection lists. Also apply to entire segments.
+        // naturally discarded from the injection lists.
         void markObsoleteSection(ESection& sec);
-        void markObsoleteSegment(ESegment& seg);
 
         // Enqueue a section for injection.
         void enqueueInjectSection(const ESectionPtr& sec, const Time& next_inject, bool try_front);
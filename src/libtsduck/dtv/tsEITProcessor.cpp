@@ -34,6 +34,7 @@
 #include "tsMJD.h"
 #include "tsFatal.h"
 #include "tsAlgorithm.h"
+#include "tsFileUtils.h"
 TSDUCK_SOURCE;
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
@@ -59,12 +60,23 @@ ts::EITProcessor::EITProcessor(DuckContext& duck, PID pid) :
     _removed_tids(),
     _removed(),
     _kept(),
-    _renamed()
+    _renamed(),
+    _spill_dir(),
+    _spill_name(),
+    _spill_file(),
+    _spill_count(0),
+    _spill_read_pos(0),
+    _spill_write_pos(0)
 {
     _input_pids.set(pid);
     _demux.addPID(pid);
 }
 
+ts::EITProcessor::~EITProcessor()
+{
+    deleteSpillFile();
+}
+
 void ts::EITProcessor::reset()
 {
     _start_time_offset = 0;
@@ -76,6 +88,7 @@ void ts::EITProcessor::reset()
     _removed.clear();
     _kept.clear();
     _renamed.clear();
+    deleteSpillFile();
 }
 
 
@@ -170,6 +183,87 @@ void ts::EITProcessor::provideSection(SectionCounter counter, SectionPtr& sectio
         section = _sections.front();
         _sections.pop_front();
     }
+
+    // Reload spilled sections, if any, in the free room.
+    reloadSpilledSections();
+}
+
+
+//----------------------------------------------------------------------------
+// Spill file management.
+//----------------------------------------------------------------------------
+
+// Store a section at end of the spill file.
+bool ts::EITProcessor::spillSection(const Section& section)
+{
+    // Create the spill file on first use.
+    if (!_spill_file.is_open()) {
+        if (_spill_dir.empty()) {
+            return false;
+        }
+        _spill_name = _spill_dir + PathSeparator + BaseName(TempFile(u".eit"));
+        _spill_file.open(_spill_name.toUTF8().c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!_spill_file) {
+            _duck.report().error(u"error creating EIT spill file %s", {_spill_name});
+            _spill_file.close();
+            _spill_name.clear();
+            _spill_dir.clear();  // don't retry on each section
+            return false;
+        }
+        _spill_count = 0;
+        _spill_read_pos = _spill_write_pos = 0;
+        _duck.report().verbose(u"too many buffered EIT sections, using spill file %s", {_spill_name});
+    }
+
+    // Append the section at end of file.
+    _spill_file.clear();
+    _spill_file.seekp(_spill_write_pos);
+    if (!section.write(_spill_file, _duck.report())) {
+        return false;
+    }
+    _spill_write_pos += std::streamoff(section.size());
+    _spill_count++;
+    return true;
+}
+
+// Reload sections from the spill file until the memory buffer is full.
+void ts::EITProcessor::reloadSpilledSections()
+{
+    if (_spill_count > 0 && _sections.size() < _max_buffered_sections) {
+        _spill_file.clear();
+        _spill_file.seekg(_spill_read_pos);
+        while (_spill_count > 0 && _sections.size() < _max_buffered_sections) {
+            const SectionPtr sp(new Section);
+            CheckNonNull(sp.pointer());
+            if (!sp->read(_spill_file, CRC32::IGNORE, _duck.report())) {
+                // Cannot recover from a corrupted spill file, drop all spilled sections.
+                _duck.report().error(u"error reading EIT spill file %s, %d sections lost", {_spill_name, _spill_count});
+                _spill_count = 0;
+                break;
+            }
+            _spill_read_pos += std::streamoff(sp->size());
+            _spill_count--;
+            _sections.push_back(sp);
+        }
+        // When the spill file is empty, restart at the beginning of the file.
+        if (_spill_count == 0) {
+            _spill_read_pos = _spill_write_pos = 0;
+        }
+    }
+}
+
+// Close and delete the spill file.
+void ts::EITProcessor::deleteSpillFile()
+{
+    if (_spill_file.is_open()) {
+        _spill_file.close();
+    }
+    if (!_spill_name.empty()) {
+        DeleteFile(_spill_name, _duck.report());
+        _spill_name.clear();
+    }
+    _spill_count = 0;
+    _spill_read_pos = _spill_write_pos = 0;
 }
 
 
@@ -430,10 +524,15 @@ void ts::EITProcessor::handleSection(SectionDemux& demux, const Section& section
     // The queue shall never grow much because we replace packet by packet on one PID.
     // However, we still may collect many small sections while serializing a very big one.
     // But it should stay within some finite limits. These limits are difficult to anticipate.
-    // Just check that the queue does not become crazy.
-    if (_sections.size() <_max_buffered_sections) {
+    // Just check that the queue does not become crazy. When the memory queue is full, store
+    // the section in the spill file, if there is one. As long as the spill file is not empty,
+    // all sections go there to preserve the order of sections.
+    if (_spill_count == 0 && _sections.size() < _max_buffered_sections) {
         _sections.push_back(sp);
     }
+    else if (spillSection(*sp)) {
+        // Section stored in spill file.
+    }
     else {
         _duck.report().warning(u"dropping EIT section (%d bytes), too many buffered EIT sections (%d)", {sp->size(), _sections.size()});
     }
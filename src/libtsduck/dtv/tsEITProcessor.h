@@ -39,6 +39,7 @@
 #include "tsService.h"
 #include "tsTransportStreamId.h"
 #include "tsReport.h"
+#include "tsUString.h"
 
 namespace ts {
     //!
@@ -71,6 +72,12 @@ namespace ts {
         //!
         explicit EITProcessor(DuckContext& duck, PID pid = PID_EIT);
 
+        //!
+        //! Destructor.
+        //! The spill file, if any, is deleted.
+        //!
+        ~EITProcessor();
+
         //!
         //! Change the single PID containing EIT's to process.
         //! @param [in] pid The PID containing EIT's to process.
@@ -229,8 +236,11 @@ namespace ts {
         //! number and since EIT sections are never enlarged, there is no global overflow.
         //!
         //! This method is used to adjust the maximum number of buffered sections.
+        //! When a spill directory is set, this is the maximum number of sections
+        //! which are buffered in memory, the other ones are stored on disk.
         //!
         //! @param [in] count New maximum number of buffered sections.
+        //! @see setSpillDirectory()
         //!
         void setMaxBufferedSections(size_t count);
 
@@ -260,6 +270,33 @@ namespace ts {
         //!
         size_t getCurrentBufferedSections() const { return _sections.size(); }
 
+        //!
+        //! Set a directory where buffered sections are spilled when the memory buffer is full.
+        //!
+        //! By default, when the maximum number of buffered sections is reached, new EIT sections
+        //! are dropped. This may happen on transit EIT PID's carrying huge EPG's with hundreds of
+        //! thousands of schedule sections. When a spill directory is set, the sections in excess
+        //! are instead appended to a temporary file in this directory. They are reloaded in
+        //! memory in the same order when room is available in the memory buffer. Thus, no section
+        //! is lost and the memory usage is bounded by the maximum number of buffered sections.
+        //!
+        //! The temporary file is created when needed and deleted when the object is destroyed
+        //! or reset. Its size is bounded by the peak number of spilled sections.
+        //!
+        //! @param [in] directory Directory for the spill file. If empty, sections are dropped
+        //! when the memory buffer is full (the default). Sections which are already spilled
+        //! are not lost when the directory is changed.
+        //! @see setMaxBufferedSections()
+        //!
+        void setSpillDirectory(const UString& directory) { _spill_dir = directory; }
+
+        //!
+        //! Get the current number of sections in the spill file.
+        //! @return The current number of sections in the spill file.
+        //! @see setSpillDirectory()
+        //!
+        size_t getCurrentSpilledSections() const { return _spill_count; }
+
     private:
         DuckContext&          _duck;
         PIDSet                _input_pids;
@@ -274,6 +311,21 @@ namespace ts {
         std::list<Service>    _removed;
         std::list<Service>    _kept;
         std::list<std::pair<Service,Service>> _renamed;
+        UString               _spill_dir;        // Directory for the spill file, empty means drop sections.
+        UString               _spill_name;       // Name of the spill file, empty if not created.
+        std::fstream          _spill_file;       // Spill file, a FIFO of binary sections.
+        size_t                _spill_count;      // Number of sections in the spill file.
+        std::streamoff        _spill_read_pos;   // Position of next section to reload from the spill file.
+        std::streamoff        _spill_write_pos;  // Position of next section to write in the spill file.
+
+        // Store a section at end of the spill file. Return false on error.
+        bool spillSection(const Section& section);
+
+        // Reload sections from the spill file until the memory buffer is full.
+        void reloadSpilledSections();
+
+        // Close and delete the spill file.
+        void deleteSpillFile();
 
         // Check if a service matches a DVB triplet.
         // The service must have at least a service id or transport id.
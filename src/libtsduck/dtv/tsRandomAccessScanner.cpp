@@ -0,0 +1,97 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRandomAccessScanner.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::RandomAccessScanner::RandomAccessScanner() :
+    _ref_pid(PID_NULL)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset all collected information.
+//----------------------------------------------------------------------------
+
+void ts::RandomAccessScanner::reset()
+{
+    _ref_pid = PID_NULL;
+}
+
+
+//----------------------------------------------------------------------------
+// Process TS packets from the stream, looking for the reference PID.
+//----------------------------------------------------------------------------
+
+bool ts::RandomAccessScanner::feedPackets(const TSPacket* pkt, size_t count)
+{
+    // Once the reference PID is known, there is nothing more to do.
+    for (size_t i = 0; _ref_pid == PID_NULL && i < count; ++i) {
+        if (pkt[i].hasPCR()) {
+            _ref_pid = pkt[i].getPID();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Locate random access points.
+//----------------------------------------------------------------------------
+
+size_t ts::RandomAccessScanner::firstRandomAccess(const TSPacket* pkt, size_t count) const
+{
+    if (_ref_pid == PID_NULL) {
+        return count;
+    }
+    size_t i = 0;
+    while (i < count && !isRandomAccess(pkt[i])) {
+        ++i;
+    }
+    return i;
+}
+
+size_t ts::RandomAccessScanner::lastRandomAccess(const TSPacket* pkt, size_t count) const
+{
+    if (_ref_pid != PID_NULL) {
+        for (size_t i = count; i > 0; --i) {
+            if (isRandomAccess(pkt[i-1])) {
+                return i - 1;
+            }
+        }
+    }
+    return NPOS;
+}
@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Locate random access points in a transport stream.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+
+namespace ts {
+    //!
+    //! Locate random access points in a transport stream.
+    //! @ingroup mpeg
+    //!
+    //! A random access point is a packet with the random_access_indicator set in its adaptation
+    //! field. This indicator may be set in packets of any PID, typically the video and audio PID's.
+    //! Switching from one stream to another is clean only on a random access point of the video
+    //! PID, not on a random access point of an audio PID.
+    //!
+    //! This class restricts the random access points to the reference PID of the stream. The
+    //! reference PID is the first PID which carries a PCR. In the usual case of a single program
+    //! transport stream, this is the video PID of the service. On a multi-program transport
+    //! stream, only the service which carries the PCR on the reference PID can be cleanly switched.
+    //! Before the first PCR, there is no random access point.
+    //!
+    class TSDUCKDLL RandomAccessScanner
+    {
+    public:
+        //!
+        //! Constructor.
+        //!
+        RandomAccessScanner();
+
+        //!
+        //! Reset all collected information.
+        //!
+        void reset();
+
+        //!
+        //! Process TS packets from the stream, looking for the reference PID.
+        //! @param [in] pkt Address of the first packet.
+        //! @param [in] count Number of packets.
+        //! @return True if the reference PID was found in these packets, false otherwise.
+        //!
+        bool feedPackets(const TSPacket* pkt, size_t count);
+
+        //!
+        //! Get the reference PID, the first PID which carries a PCR.
+        //! @return The reference PID or PID_NULL if not yet found.
+        //!
+        PID referencePID() const { return _ref_pid; }
+
+        //!
+        //! Check if a packet is a random access point.
+        //! @param [in] pkt A TS packet.
+        //! @return True if @a pkt is on the reference PID and has the random_access_indicator set.
+        //!
+        bool isRandomAccess(const TSPacket& pkt) const
+        {
+            return _ref_pid != PID_NULL && pkt.getPID() == _ref_pid && pkt.getRandomAccessIndicator();
+        }
+
+        //!
+        //! Locate the first random access point in a contiguous area of TS packets.
+        //! @param [in] pkt Address of the first packet.
+        //! @param [in] count Number of packets.
+        //! @return Index of the first random access point or @a count if there is none.
+        //!
+        size_t firstRandomAccess(const TSPacket* pkt, size_t count) const;
+
+        //!
+        //! Locate the last random access point in a contiguous area of TS packets.
+        //! @param [in] pkt Address of the first packet.
+        //! @param [in] count Number of packets.
+        //! @return Index of the last random access point or NPOS if there is none.
+        //!
+        size_t lastRandomAccess(const TSPacket* pkt, size_t count) const;
+
+    private:
+        PID _ref_pid;  // Reference PID, PID_NULL if not yet found.
+    };
+}
@@ -33,6 +33,8 @@
 #include "tsDuckContext.h"
 #include "tsNames.h"
 #include "tsAlgorithm.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
 TSDUCK_SOURCE;
 
 // Constant string "Unreferenced"
@@ -89,14 +91,18 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, BitRate bitrate_hint) :
     _modified(false),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
+    _pid_totals(),
     _preceding_errors(0),
     _preceding_suspects(0),
     _min_error_before_suspect(1),
     _max_consecutive_suspects(1),
-    _demux(_duck, this, this),
+    _demux(_duck, this),
     _pes_demux(_duck, this),
-    _t2mi_demux(_duck, this)
+    _t2mi_demux(_duck, this),
+    _shards()
 {
+    // Sections are only inspected, they don't need to be copied out of the demux.
+    _demux.setSectionViewHandler(this);
     resetSectionDemux();
 }
 
@@ -108,6 +114,7 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, BitRate bitrate_hint) :
 ts::TSAnalyzer::~TSAnalyzer()
 {
     this->reset();
+    setAnalysisThreads(0);
 }
 
 
@@ -117,6 +124,9 @@ ts::TSAnalyzer::~TSAnalyzer()
 
 void ts::TSAnalyzer::reset()
 {
+    // Make sure that the PID shards no longer use the PID contexts.
+    mergePIDShards();
+
     _modified = false;
     _ts_id = 0;
     _ts_id_valid = false;
@@ -161,6 +171,7 @@ void ts::TSAnalyzer::reset()
     _services.clear();
     _ts_bitrate_sum = 0;
     _ts_bitrate_cnt = 0;
+    _pid_totals.clear();
     _preceding_errors = 0;
     _preceding_suspects = 0;
     _pes_demux.reset();
@@ -376,7 +387,7 @@ ts::UString ts::TSAnalyzer::ServiceContext::getName() const
 // Return an ETID context. Allocate a new entry if ETID not found.
 //----------------------------------------------------------------------------
 
-ts::TSAnalyzer::ETIDContextPtr ts::TSAnalyzer::getETID(const Section& section)
+ts::TSAnalyzer::ETIDContextPtr ts::TSAnalyzer::getETID(const SectionView& section)
 {
     const ETID etid = section.etid();
     const PIDContextPtr pc(getPID(section.sourcePID()));
@@ -463,10 +474,10 @@ void ts::TSAnalyzer::PIDContext::addService(uint16_t service_id)
 
 //----------------------------------------------------------------------------
 // This hook is invoked when a complete section is available.
-// Implementation of SectionHandlerInterface
+// Implementation of SectionViewHandlerInterface
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::handleSection(SectionDemux&, const Section& section)
+void ts::TSAnalyzer::handleSectionView(SectionDemux&, const SectionView& section)
 {
     ETIDContextPtr etc(getETID(section));
     const uint8_t version = section.version();
@@ -512,7 +523,9 @@ void ts::TSAnalyzer::handleSection(SectionDemux&, const Section& section)
     // the same version number to carry an ever-changing time. As a consequence,
     // it is reported only once as a table.
     if (section.tableId() == TID_STT) {
-        const STT stt(_duck, section);
+        Section sect;
+        section.toSection(sect);
+        const STT stt(_duck, sect);
         if (stt.isValid()) {
             analyzeSTT(stt);
         }
@@ -1379,8 +1392,6 @@ void ts::TSAnalyzer::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, co
 
 void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 {
-    bool broken_rate(false);
-
     // Store system times of first packet
     if (_first_utc == Time::Epoch) {
         _first_utc = Time::CurrentUTC();
@@ -1432,103 +1443,121 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 
     // Get PID context
     PIDContextPtr ps(getPID(pkt.getPID()));
-    ps->ts_pkt_cnt++;
+
+    // Per-PID analysis, in this thread or in the PID shard.
+    if (_shards.empty()) {
+        analyzePIDPacket(*ps, pkt, packet_index, _pid_totals);
+    }
+    else {
+        _shards[pkt.getPID() % _shards.size()]->addPacket(ps.pointer(), pkt, packet_index);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Per-PID analysis of a TS packet.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::analyzePIDPacket(PIDContext& ps, const TSPacket& pkt, uint64_t packet_index, PIDTotals& totals)
+{
+    bool broken_rate(false);
+    ps.ts_pkt_cnt++;
 
     // Accumulate stat from packet
     if (pkt.hasAF()) {
-        ps->ts_af_cnt++;
+        ps.ts_af_cnt++;
     }
     if (pkt.getPUSI()) {
-        ps->unit_start_cnt++;
+        ps.unit_start_cnt++;
     }
     if (pkt.getPUSI() && pkt.hasPayload()) {
-        ps->pl_start_cnt++;
+        ps.pl_start_cnt++;
     }
 
     // Process scrambling information
-    if (pkt.getScrambling() != SC_CLEAR && !ps->scrambled) {
-        ps->scrambled = true;
-        _scrambled_pid_cnt++;
+    if (pkt.getScrambling() != SC_CLEAR && !ps.scrambled) {
+        ps.scrambled = true;
+        totals.scrambled_pid_cnt++;
     }
     if (pkt.getScrambling() == SC_DVB_RESERVED) {
-        ps->inv_ts_sc_cnt++;
+        ps.inv_ts_sc_cnt++;
     }
     else if (pkt.getScrambling() != SC_CLEAR) {
-        ps->ts_sc_cnt++;
+        ps.ts_sc_cnt++;
     }
-    if (pkt.getScrambling() != ps->cur_ts_sc) {
+    if (pkt.getScrambling() != ps.cur_ts_sc) {
         // Change of crypto-period
-        if (ps->cur_ts_sc != SC_CLEAR) {
+        if (ps.cur_ts_sc != SC_CLEAR) {
             // End of a crypto-period, not a clear/scramble transition.
             // Count number of crypto-periods:
-            ps->cryptop_cnt++;
+            ps.cryptop_cnt++;
             // Count number of TS packets in all crypto-periods.
             // Ignore first crypto-period since it is truncated and
             // not significant for evaluation of duration.
-            if (ps->cryptop_cnt > 1) {
-                ps->cryptop_ts_cnt += packet_index - ps->cur_ts_sc_pkt;
+            if (ps.cryptop_cnt > 1) {
+                ps.cryptop_ts_cnt += packet_index - ps.cur_ts_sc_pkt;
             }
         }
-        ps->cur_ts_sc = pkt.getScrambling();
-        ps->cur_ts_sc_pkt = packet_index;
+        ps.cur_ts_sc = pkt.getScrambling();
+        ps.cur_ts_sc_pkt = packet_index;
     }
 
     // Process discontinuities.
     // The continuity counter of null packets is undefined.
-    if (ps->pid != PID_NULL) {
-        if (ps->ts_pkt_cnt == 1) {
+    if (ps.pid != PID_NULL) {
+        if (ps.ts_pkt_cnt == 1) {
             // First packet, initialize continuity
-            ps->cur_continuity = pkt.getCC();
+            ps.cur_continuity = pkt.getCC();
         }
         else if (pkt.getDiscontinuityIndicator()) {
             // Expected discontinuity
-            ps->exp_discont++;
+            ps.exp_discont++;
             broken_rate = true;
         }
         else if (pkt.hasPayload()) {
             // Packet has payload.
-            if (pkt.getCC() == ps->cur_continuity) {
+            if (pkt.getCC() == ps.cur_continuity) {
                 // Same counter means duplicated packet.
-                ps->duplicated++;
+                ps.duplicated++;
             }
-            else if (pkt.getCC() != (ps->cur_continuity + 1) % CC_MAX) {
+            else if (pkt.getCC() != (ps.cur_continuity + 1) % CC_MAX) {
                 // Counter not following previous -> discontinuity
-                ps->unexp_discont++;
+                ps.unexp_discont++;
                 broken_rate = true;
             }
         }
-        else if (pkt.getCC() != ps->cur_continuity) {
+        else if (pkt.getCC() != ps.cur_continuity) {
             // Packet has no payload -> should have same counter
-            ps->unexp_discont++;
+            ps.unexp_discont++;
             broken_rate = true;
         }
-        ps->cur_continuity = pkt.getCC();
+        ps.cur_continuity = pkt.getCC();
     }
 
     // Process PCR
     if (broken_rate) {
         // Suspected packet loss, forget last PCR.
-        ps->last_pcr = 0;
+        ps.last_pcr = 0;
     }
     if (pkt.hasPCR()) {
         uint64_t pcr(pkt.getPCR());
         // Count PID's with PCR
-        if (ps->pcr_cnt++ == 0)
-            _pcr_pid_cnt++;
+        if (ps.pcr_cnt++ == 0)
+            totals.pcr_pid_cnt++;
         // If last PCR valid, compute transport rate between the two
-        if (ps->last_pcr != 0 && ps->last_pcr < pcr) {
+        if (ps.last_pcr != 0 && ps.last_pcr < pcr) {
             // Compute transport rate in b/s since last PCR
-            BitRate ts_bitrate = BitRate((packet_index - ps->last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / (pcr - ps->last_pcr);
+            BitRate ts_bitrate = BitRate((packet_index - ps.last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / (pcr - ps.last_pcr);
             // Per-PID statistics:
-            ps->ts_bitrate_sum += ts_bitrate;
-            ps->ts_bitrate_cnt++;
+            ps.ts_bitrate_sum += ts_bitrate;
+            ps.ts_bitrate_cnt++;
             // Transport stream statistics:
-            _ts_bitrate_sum += ts_bitrate;
-            _ts_bitrate_cnt++;
+            totals.ts_bitrate_sum += ts_bitrate;
+            totals.ts_bitrate_cnt++;
         }
         // Save PCR for next calculation
-        ps->last_pcr = pcr;
-        ps->last_pcr_pkt = packet_index;
+        ps.last_pcr = pcr;
+        ps.last_pcr_pkt = packet_index;
     }
 
     // Check PES start code: PES packet headers start with the constant
@@ -1552,9 +1581,9 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             // PID carries sections (we may not yet know this, so count
             // all these errors now and ignore them later if we know
             // that the PID does not carry PES packets).
-            ps->inv_pes_start++;
+            ps.inv_pes_start++;
         }
-        else if (header_size <= PKT_SIZE - 4 && ps->pid != 0) {
+        else if (header_size <= PKT_SIZE - 4 && ps.pid != 0) {
             // Here, the start of the packet payload is 00 00 01.
             // The only case where this can happen on a section is a PAT
             // (first 00 = "pointer field", second 00 = table_id = PAT).
@@ -1563,20 +1592,208 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             // As a consequence, we are pretty sure to have a PES packet.
             // Remember the stream_id of the PES packets on this PID
             // (the PES stream_id is next byte after PES start code).
-            if (ps->pes_stream_id == 0) {
+            if (ps.pes_stream_id == 0) {
                 // First PES stream_id found on this PID
-                ps->pes_stream_id = pkt.b [header_size + 3];
-                ps->same_stream_id = true;
+                ps.pes_stream_id = pkt.b [header_size + 3];
+                ps.same_stream_id = true;
             }
-            else if (ps->pes_stream_id != pkt.b [header_size + 3]) {
+            else if (ps.pes_stream_id != pkt.b [header_size + 3]) {
                 // Got different values of stream_id in PES packets
-                ps->same_stream_id = false;
+                ps.same_stream_id = false;
             }
         }
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Global counters which are updated by the per-PID analysis.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzer::PIDTotals::PIDTotals() :
+    scrambled_pid_cnt(0),
+    pcr_pid_cnt(0),
+    ts_bitrate_sum(0),
+    ts_bitrate_cnt(0)
+{
+}
+
+void ts::TSAnalyzer::PIDTotals::clear()
+{
+    scrambled_pid_cnt = 0;
+    pcr_pid_cnt = 0;
+    ts_bitrate_sum = 0;
+    ts_bitrate_cnt = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Set the number of threads for the per-PID analysis.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::setAnalysisThreads(size_t count)
+{
+    // Complete the analysis of all pending packets before redistributing the PID's.
+    mergePIDShards();
+
+    for (auto it = _shards.begin(); it != _shards.end(); ++it) {
+        delete *it;
+    }
+    _shards.clear();
+
+    if (count > 1) {
+        for (size_t i = 0; i < count; ++i) {
+            PIDShard* shard = new PIDShard;
+            _shards.push_back(shard);
+            shard->start();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for the completion of the per-PID analysis and merge the global counters.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergePIDShards()
+{
+    for (auto it = _shards.begin(); it != _shards.end(); ++it) {
+        (*it)->wait();
+        _pid_totals.scrambled_pid_cnt += (*it)->totals.scrambled_pid_cnt;
+        _pid_totals.pcr_pid_cnt += (*it)->totals.pcr_pid_cnt;
+        _pid_totals.ts_bitrate_sum += (*it)->totals.ts_bitrate_sum;
+        _pid_totals.ts_bitrate_cnt += (*it)->totals.ts_bitrate_cnt;
+        (*it)->totals.clear();
+    }
+    _scrambled_pid_cnt += _pid_totals.scrambled_pid_cnt;
+    _pcr_pid_cnt += _pid_totals.pcr_pid_cnt;
+    _ts_bitrate_sum += _pid_totals.ts_bitrate_sum;
+    _ts_bitrate_cnt += _pid_totals.ts_bitrate_cnt;
+    _pid_totals.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// PID shard: a thread for the per-PID analysis of a subset of PID's.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzer::PIDShard::PIDShard() :
+    Thread(),
+    totals(),
+    _current(nullptr),
+    _mutex(),
+    _work_to_do(),
+    _work_done(),
+    _queue(),
+    _free(),
+    _busy(false),
+    _terminate(false)
+{
+}
+
+ts::TSAnalyzer::PIDShard::~PIDShard()
+{
+    // Terminate the shard thread, if started.
+    {
+        GuardCondition lock(_mutex, _work_to_do);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+
+    // Deallocate all batches.
+    delete _current;
+    for (auto it = _queue.begin(); it != _queue.end(); ++it) {
+        delete *it;
+    }
+    for (auto it = _free.begin(); it != _free.end(); ++it) {
+        delete *it;
+    }
+}
+
+// Add a packet to analyze, in the thread of the analyzer.
+void ts::TSAnalyzer::PIDShard::addPacket(PIDContext* ps, const TSPacket& pkt, uint64_t packet_index)
+{
+    if (_current == nullptr) {
+        // Get a recycled batch or allocate a new one.
+        GuardMutex lock(_mutex);
+        if (_free.empty()) {
+            _current = new Batch;
+            _current->reserve(BATCH_SIZE);
+        }
+        else {
+            _current = _free.back();
+            _free.pop_back();
+        }
+    }
+    _current->push_back({ps, packet_index, pkt});
+    if (_current->size() >= BATCH_SIZE) {
+        flush();
+    }
+}
+
+// Queue the current batch, in the thread of the analyzer.
+void ts::TSAnalyzer::PIDShard::flush()
+{
+    if (_current != nullptr && !_current->empty()) {
+        // If the shard thread is too late, wait for some batches to be analyzed.
+        {
+            GuardCondition lock(_mutex, _work_done);
+            while (_queue.size() >= MAX_QUEUED) {
+                lock.waitCondition();
+            }
+        }
+        GuardCondition lock(_mutex, _work_to_do);
+        _queue.push_back(_current);
+        _current = nullptr;
+        lock.signal();
+    }
+}
+
+// Wait for the analysis of all packets, in the thread of the analyzer.
+void ts::TSAnalyzer::PIDShard::wait()
+{
+    flush();
+    GuardCondition lock(_mutex, _work_done);
+    while (_busy || !_queue.empty()) {
+        lock.waitCondition();
+    }
+}
+
+// Main code of the shard thread.
+void ts::TSAnalyzer::PIDShard::main()
+{
+    for (;;) {
+        // Wait for a batch to analyze.
+        Batch* batch = nullptr;
+        {
+            GuardCondition lock(_mutex, _work_to_do);
+            while (_queue.empty() && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_terminate) {
+                break;
+            }
+            batch = _queue.front();
+            _queue.pop_front();
+            _busy = true;
+        }
+
+        // Analyze the packets outside the mutex.
+        for (auto it = batch->begin(); it != batch->end(); ++it) {
+            analyzePIDPacket(*it->ps, it->pkt, it->index, totals);
+        }
+        batch->clear();
+
+        // Recycle the batch and signal the end of analysis to the analyzer.
+        GuardCondition lock(_mutex, _work_done);
+        _free.push_back(batch);
+        _busy = false;
+        lock.signal();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Specify a "bitrate hint" for the analysis. It is the user-specified
 // bitrate in bits/seconds, based on 188-byte packets. The bitrate is
@@ -1601,6 +1818,9 @@ void ts::TSAnalyzer::recomputeStatistics()
         return;
     }
 
+    // Get the global counters from the per-PID analysis.
+    mergePIDShards();
+
     // Store "last" system times
     _last_utc = Time::CurrentUTC();
     _last_local = Time::CurrentLocalTime();
@@ -50,6 +50,10 @@
 #include "tsTime.h"
 #include "tsUString.h"
 #include "tsSafePtr.h"
+#include "tsFlatPIDMap.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
 
 namespace ts {
     //!
@@ -58,7 +62,7 @@ namespace ts {
     //!
     class TSDUCKDLL TSAnalyzer:
         private TableHandlerInterface,
-        private SectionHandlerInterface,
+        private SectionViewHandlerInterface,
         private PESHandlerInterface,
         private T2MIHandlerInterface
     {
@@ -123,6 +127,24 @@ namespace ts {
             _max_consecutive_suspects = count;
         }
 
+        //!
+        //! Set the number of threads for the per-PID analysis.
+        //! By default, the complete analysis is done in the thread which calls feedPacket().
+        //! With two or more threads, the per-PID statistics of the packets (counters, continuity,
+        //! scrambling, PCR) are computed in separate threads, each one handling a subset of the PID's.
+        //! The analysis of the signalization and the audio/video attributes remains in the thread
+        //! of feedPacket(). The results are merged before reporting and are identical to the
+        //! analysis in one single thread.
+        //! @param [in] count Number of per-PID analysis threads. Zero or one means no separate thread.
+        //!
+        void setAnalysisThreads(size_t count);
+
+        //!
+        //! Get the number of threads for the per-PID analysis.
+        //! @return The number of per-PID analysis threads, zero if the analysis is done in the thread of feedPacket().
+        //!
+        size_t analysisThreads() const { return _shards.size(); }
+
         //!
         //! Get the list of service ids.
         //! @param [out] list The returned list of service ids.
@@ -287,7 +309,7 @@ namespace ts {
         //! @param [in] section A section containing the ETID to search.
         //! @return A safe pointer to the ETID context.
         //!
-        ETIDContextPtr getETID(const Section& section);
+        ETIDContextPtr getETID(const SectionView& section);
 
     protected:
 
@@ -399,7 +421,7 @@ namespace ts {
         //!
         //! Map of PIDContext, indexed by PID.
         //!
-        typedef std::map<PID, PIDContextPtr> PIDContextMap;
+        typedef FlatPIDMap<PIDContextPtr> PIDContextMap;
 
         //!
         //! Check if a PID context exists.
@@ -478,6 +500,78 @@ namespace ts {
         // Constant string "Unreferenced"
         static const UString UNREFERENCED;
 
+        // Global counters which are updated by the per-PID analysis of packets.
+        // They are accumulated separately in each PID shard and merged in recomputeStatistics().
+        struct PIDTotals
+        {
+            size_t   scrambled_pid_cnt;  // Number of new scrambled PID's.
+            size_t   pcr_pid_cnt;        // Number of new PID's with PCR's.
+            BitRate  ts_bitrate_sum;     // Sum of computed TS bitrates.
+            uint64_t ts_bitrate_cnt;     // Number of computed TS bitrates.
+
+            // Constructor.
+            PIDTotals();
+
+            // Reset all counters.
+            void clear();
+        };
+
+        // Per-PID analysis of a TS packet. Only the analysis data of the PID context are updated.
+        // This can be executed in a PID shard thread, concurrently with the rest of the analysis.
+        static void analyzePIDPacket(PIDContext& ps, const TSPacket& pkt, uint64_t packet_index, PIDTotals& totals);
+
+        // A PID shard: a thread which executes the per-PID analysis of the packets of a subset of PID's.
+        // The packets are passed by batches, in order, from the thread which calls feedPacket().
+        class PIDShard: public Thread
+        {
+            TS_NOCOPY(PIDShard);
+        public:
+            // Constructor, destructor (terminate the thread).
+            PIDShard();
+            virtual ~PIDShard() override;
+
+            // Add a packet to analyze. The PID context must remain valid until the next call to wait().
+            void addPacket(PIDContext* ps, const TSPacket& pkt, uint64_t packet_index);
+
+            // Wait for the end of the analysis of all packets which were passed to addPacket().
+            void wait();
+
+            // Global counters, can be read and cleared after wait().
+            PIDTotals totals;
+
+        private:
+            // One packet to analyze.
+            struct Entry
+            {
+                PIDContext* ps;     // PID context of the packet.
+                uint64_t    index;  // Index of the packet in the TS.
+                TSPacket    pkt;    // Copy of the packet.
+            };
+            typedef std::vector<Entry> Batch;
+
+            // Number of packets per batch and maximum number of queued batches.
+            static constexpr size_t BATCH_SIZE = 256;
+            static constexpr size_t MAX_QUEUED = 64;
+
+            Batch*              _current;     // Batch which is filled by addPacket(), not yet queued.
+            Mutex               _mutex;       // Protect the following fields.
+            Condition           _work_to_do;  // Signaled when a batch is queued or the thread shall terminate.
+            Condition           _work_done;   // Signaled when a batch is analyzed.
+            std::deque<Batch*>  _queue;       // Batches to analyze.
+            std::vector<Batch*> _free;        // Recycled batches.
+            bool                _busy;        // The shard thread is analyzing a batch.
+            bool                _terminate;   // The shard thread shall terminate.
+
+            // Queue the current batch, if not empty.
+            void flush();
+
+            // Inherited from Thread.
+            virtual void main() override;
+        };
+
+        // Wait for the completion of the per-PID analysis and merge the global counters.
+        void mergePIDShards();
+
         // Reset the section demux.
         void resetSectionDemux();
 
@@ -506,8 +600,8 @@ namespace ts {
         // Implementation of TableHandlerInterface
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
 
-        // Implementation of SectionHandlerInterface
-        virtual void handleSection(SectionDemux&, const Section&) override;
+        // Implementation of SectionViewHandlerInterface
+        virtual void handleSectionView(SectionDemux&, const SectionView&) override;
 
         // Implementation of PESHandlerInterface
         virtual void handleNewMPEG2AudioAttributes(PESDemux&, const PESPacket&, const MPEG2AudioAttributes&) override;
@@ -525,6 +619,7 @@ namespace ts {
         bool         _modified;                  // Internal data modified, need recomputeStatistics
         BitRate      _ts_bitrate_sum;            // Sum of all computed TS bitrates
         uint64_t     _ts_bitrate_cnt;            // Number of computed TS bitrates
+        PIDTotals    _pid_totals;                // Global counters from per-PID analysis, not yet merged
         uint64_t     _preceding_errors;          // Number of contiguous invalid packets before current packet
         uint64_t     _preceding_suspects;        // Number of contiguous suspects packets before current packet
         uint64_t     _min_error_before_suspect;  // Required number of invalid packets before starting suspect
@@ -532,5 +627,6 @@ namespace ts {
         SectionDemux _demux;                     // PSI tables analysis
         PESDemux     _pes_demux;                 // Audio/video analysis
         T2MIDemux    _t2mi_demux;                // T2-MI analysis
+        std::vector<PIDShard*> _shards;          // Per-PID analysis threads (empty if none)
     };
 }
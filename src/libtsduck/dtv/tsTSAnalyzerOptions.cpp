@@ -57,7 +57,8 @@ ts::TSAnalyzerOptions::TSAnalyzerOptions() :
     prefix(),
     title(),
     suspect_min_error_count(1),
-    suspect_max_consecutive(1)
+    suspect_max_consecutive(1),
+    analysis_threads(0)
 {
 }
 
@@ -151,6 +152,14 @@ void ts::TSAnalyzerOptions::defineArgs(Args &args) const
     args.option(u"title", 0, Args::STRING);
     args.help(u"title", u"Display the specified string as title header.");
 
+    args.option(u"analysis-threads", 0, Args::UNSIGNED);
+    args.help(u"analysis-threads", u"count",
+              u"Number of threads for the per-PID analysis (packet counters, continuity, "
+              u"scrambling, PCR). The analysis of PSI/SI and audio/video attributes remains "
+              u"in one thread. The results are identical to a single-threaded analysis. "
+              u"Use this option when the analysis of a high-bitrate stream cannot keep up "
+              u"with real time. By default, the whole analysis is done in one thread.");
+
     args.option(u"suspect-min-error-count", 0, Args::UNSIGNED);
     args.help(u"suspect-min-error-count",
               u"Specifies the minimum number of consecutive packets with errors before "
@@ -203,6 +212,7 @@ bool ts::TSAnalyzerOptions::loadArgs(DuckContext &duck, Args &args)
     args.getValue(title, u"title");
     args.getIntValue(suspect_min_error_count, u"suspect-min-error-count", 1);
     args.getIntValue(suspect_max_consecutive, u"suspect-max-consecutive", 1);
+    args.getIntValue(analysis_threads, u"analysis-threads", 0);
 
     bool ok = json.loadArgs(duck, args);
 
@@ -87,6 +87,7 @@ namespace ts {
         // Suspect packets detection
         uint64_t suspect_min_error_count;  //!< Option -\-suspect-min-error-count
         uint64_t suspect_max_consecutive;  //!< Option -\-suspect-max-consecutive
+        size_t   analysis_threads;         //!< Option -\-analysis-threads
 
         // Implementation of ArgsSupplierInterface.
         virtual void defineArgs(Args& args) const override;
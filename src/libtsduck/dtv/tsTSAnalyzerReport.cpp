@@ -83,6 +83,7 @@ void ts::TSAnalyzerReport::setAnalysisOptions(const TSAnalyzerOptions& opt)
 {
     setMinErrorCountBeforeSuspect(opt.suspect_min_error_count);
     setMaxConsecutiveSuspectCount(opt.suspect_max_consecutive);
+    setAnalysisThreads(opt.analysis_threads);
 }
 
 
@@ -1060,13 +1061,25 @@ void ts::TSAnalyzerReport::reportNormalized(const TSAnalyzerOptions& opt, std::o
 //----------------------------------------------------------------------------
 
 void ts::TSAnalyzerReport::reportJSON(const TSAnalyzerOptions& opt, std::ostream& stm, const UString& title, Report& rep)
+{
+    // Build the JSON document.
+    json::Object root;
+    buildJSON(opt, root, title);
+
+    // An output text formatter for JSON output.
+    opt.json.report(root, stm, rep);
+}
+
+
+//----------------------------------------------------------------------------
+// Build the JSON tree of the analysis.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzerReport::buildJSON(const TSAnalyzerOptions& opt, json::Value& root, const UString& title)
 {
     // Update the global statistics value if internal data were modified.
     recomputeStatistics();
 
-    // JSON root.
-    json::Object root;
-
     // Add user-supplied title.
     if (!title.empty()) {
         root.add(u"title", title);
@@ -1276,9 +1289,6 @@ void ts::TSAnalyzerReport::reportJSON(const TSAnalyzerOptions& opt, std::ostream
             }
         }
     }
-
-    // An output text formatter for JSON output.
-    opt.json.report(root, stm, rep);
 }
 
 
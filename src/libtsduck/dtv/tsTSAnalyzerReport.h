@@ -138,6 +138,14 @@ namespace ts {
         //!
         void reportJSON(const TSAnalyzerOptions& opt, std::ostream& strm, const UString& title = UString(), Report& rep = NULLREP);
 
+        //!
+        //! This methods builds the JSON tree of the analysis, as displayed by reportJSON().
+        //! @param [in] opt Analysis options.
+        //! @param [in,out] root JSON object which receives the analysis. Existing fields are not cleared.
+        //! @param [in] title Title string.
+        //!
+        void buildJSON(const TSAnalyzerOptions& opt, json::Value& root, const UString& title = UString());
+
     private:
         // Display header of a service PID list.
         void reportServiceHeader(Grid& grid, const UString& usage, bool scrambled, BitRate bitrate, BitRate ts_bitrate, bool wide) const;
@@ -0,0 +1,316 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzerSnapshot.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzerSnapshot::TSAnalyzerSnapshot() :
+    _background(nullptr),
+    _buffers(),
+    _current(0),
+    _readers(),
+    _sequence(0),
+    _last()
+{
+    _readers[0] = 0;
+    _readers[1] = 0;
+}
+
+ts::TSAnalyzerSnapshot::~TSAnalyzerSnapshot()
+{
+    stopBackground();
+}
+
+ts::TSAnalyzerSnapshot::Batch::Batch() :
+    packets(),
+    publish(false),
+    bitrate(0)
+{
+}
+
+ts::TSAnalyzerSnapshot::Buffer::Buffer() :
+    sequence(0),
+    previous(0),
+    full(),
+    patch()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the snapshots.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzerSnapshot::reset()
+{
+    // Keep sequence numbers increasing so that readers see the next snapshot
+    // as a new one. Since it has no patch, they will receive a complete report.
+    _last.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Publish a new snapshot (writer thread).
+//----------------------------------------------------------------------------
+
+bool ts::TSAnalyzerSnapshot::publish(TSAnalyzerReport& analyzer, const TSAnalyzerOptions& opt, const UString& title)
+{
+    // Work in the buffer which is not the current one. If a reader is still there
+    // (it started to read before the last publication), skip this publication.
+    const size_t next = 1 - _current;
+    if (_readers[next] != 0) {
+        return false;
+    }
+
+    // Build the new complete report.
+    json::ValuePtr root(new json::Object);
+    analyzer.buildJSON(opt, *root, title);
+
+    // Fill the buffer. The previously published report is still referenced by the
+    // current buffer: this is the origin of the patch.
+    Buffer& buf(_buffers[next]);
+    buf.previous = _last.isNull() ? 0 : _sequence;
+    buf.sequence = ++_sequence;
+    buf.patch = _last.isNull() ? json::ValuePtr() : json::Diff(*_last, *root);
+    buf.full = root;
+    _last = root;
+
+    // Make the new snapshot visible to readers.
+    _current = next;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Report the latest published snapshot (any thread).
+//----------------------------------------------------------------------------
+
+bool ts::TSAnalyzerSnapshot::report(const json::OutputArgs& args, std::ostream& strm, uint64_t& sequence, Report& rep) const
+{
+    // Register as a reader of the current buffer. The current buffer may change
+    // between the load and the registration: in that case, the writer may be
+    // overwriting the buffer we got and we must retry.
+    size_t index = 0;
+    for (;;) {
+        index = _current;
+        ++_readers[index];
+        if (_current == index) {
+            break;
+        }
+        --_readers[index];
+    }
+
+    // Now, the writer cannot modify the buffer until we leave.
+    const Buffer& buf(_buffers[index]);
+    const bool fresh = buf.sequence != 0 && buf.sequence != sequence;
+    if (fresh) {
+        const bool delta = !buf.patch.isNull() && buf.previous == sequence;
+        args.report(delta ? *buf.patch : *buf.full, strm, rep);
+        sequence = buf.sequence;
+    }
+
+    --_readers[index];
+    return fresh;
+}
+
+
+//----------------------------------------------------------------------------
+// Background analysis, interface in the thread which receives the packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSAnalyzerSnapshot::startBackground(TSAnalyzerReport& analyzer, const TSAnalyzerOptions& opt, const UString& title, TSAnalyzerSnapshotHandlerInterface* handler)
+{
+    if (_background != nullptr) {
+        return false;
+    }
+    _background = new Background(*this, analyzer, opt, title, handler);
+    if (!_background->start()) {
+        delete _background;
+        _background = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void ts::TSAnalyzerSnapshot::stopBackground()
+{
+    // The destructor of the background thread analyzes all pending batches.
+    if (_background != nullptr) {
+        _background->flush(false, 0);
+        delete _background;
+        _background = nullptr;
+    }
+}
+
+void ts::TSAnalyzerSnapshot::feedPacket(const TSPacket& pkt)
+{
+    if (_background != nullptr) {
+        _background->addPacket(pkt);
+    }
+}
+
+void ts::TSAnalyzerSnapshot::requestPublish(BitRate bitrate_hint)
+{
+    if (_background != nullptr) {
+        _background->flush(true, bitrate_hint);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Background analysis thread.
+//----------------------------------------------------------------------------
+
+ts::TSAnalyzerSnapshot::Background::Background(TSAnalyzerSnapshot& snapshot, TSAnalyzerReport& analyzer, const TSAnalyzerOptions& opt, const UString& title, TSAnalyzerSnapshotHandlerInterface* handler) :
+    Thread(),
+    _snapshot(snapshot),
+    _analyzer(analyzer),
+    _opt(opt),
+    _title(title),
+    _handler(handler),
+    _current(nullptr),
+    _mutex(),
+    _work_to_do(),
+    _work_done(),
+    _queue(),
+    _free(),
+    _terminate(false)
+{
+}
+
+ts::TSAnalyzerSnapshot::Background::~Background()
+{
+    // Terminate the thread, if started, after analyzing all queued batches.
+    {
+        GuardCondition lock(_mutex, _work_to_do);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+
+    // Deallocate all batches.
+    delete _current;
+    for (auto it = _queue.begin(); it != _queue.end(); ++it) {
+        delete *it;
+    }
+    for (auto it = _free.begin(); it != _free.end(); ++it) {
+        delete *it;
+    }
+}
+
+// Add a packet to analyze, in the thread which receives the packets.
+void ts::TSAnalyzerSnapshot::Background::addPacket(const TSPacket& pkt)
+{
+    if (_current == nullptr) {
+        // Get a recycled batch or allocate a new one.
+        GuardMutex lock(_mutex);
+        if (_free.empty()) {
+            _current = new Batch;
+            _current->packets.reserve(BATCH_SIZE);
+        }
+        else {
+            _current = _free.back();
+            _free.pop_back();
+        }
+    }
+    _current->packets.push_back(pkt);
+    if (_current->packets.size() >= BATCH_SIZE) {
+        flush(false, 0);
+    }
+}
+
+// Queue the current batch, in the thread which receives the packets.
+void ts::TSAnalyzerSnapshot::Background::flush(bool publish, BitRate bitrate)
+{
+    if (_current == nullptr && publish) {
+        // Publication without new packets.
+        _current = new Batch;
+    }
+    if (_current != nullptr && (publish || !_current->packets.empty())) {
+        _current->publish = publish;
+        _current->bitrate = bitrate;
+        // If the background thread is too late, wait for some batches to be analyzed.
+        {
+            GuardCondition lock(_mutex, _work_done);
+            while (_queue.size() >= MAX_QUEUED) {
+                lock.waitCondition();
+            }
+        }
+        GuardCondition lock(_mutex, _work_to_do);
+        _queue.push_back(_current);
+        _current = nullptr;
+        lock.signal();
+    }
+}
+
+// Main code of the background thread.
+void ts::TSAnalyzerSnapshot::Background::main()
+{
+    for (;;) {
+        // Wait for a batch to analyze. Terminate only when all batches are processed.
+        Batch* batch = nullptr;
+        {
+            GuardCondition lock(_mutex, _work_to_do);
+            while (_queue.empty() && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_queue.empty()) {
+                break;
+            }
+            batch = _queue.front();
+            _queue.pop_front();
+        }
+
+        // Analyze the packets and build the snapshot outside the mutex.
+        for (auto it = batch->packets.begin(); it != batch->packets.end(); ++it) {
+            _analyzer.feedPacket(*it);
+        }
+        if (batch->publish) {
+            _analyzer.setBitrateHint(batch->bitrate);
+            _snapshot.publish(_analyzer, _opt, _title);
+            if (_handler != nullptr) {
+                _handler->handleSnapshot(_snapshot);
+            }
+        }
+        batch->packets.clear();
+        batch->publish = false;
+
+        // Recycle the batch and signal the end of analysis.
+        GuardCondition lock(_mutex, _work_done);
+        _free.push_back(batch);
+        lock.signal();
+    }
+}
@@ -0,0 +1,213 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Incremental snapshots of a transport stream analysis.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerSnapshotHandlerInterface.h"
+#include "tsjsonOutputArgs.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+
+namespace ts {
+    //!
+    //! Incremental snapshots of a transport stream analysis.
+    //! @ingroup mpeg
+    //!
+    //! A snapshot is the JSON tree of a TSAnalyzerReport at some point in time, as
+    //! produced by TSAnalyzerReport::buildJSON(). Each snapshot also carries a JSON
+    //! patch (RFC 6902) from the previous snapshot. A reader which already received
+    //! the previous snapshot only needs the patch, which is usually much smaller than
+    //! the complete report on long-running analyses.
+    //!
+    //! Snapshots are published by one single writer thread, typically the thread which
+    //! feeds packets into the analyzer. Any number of other threads can read the latest
+    //! snapshot concurrently. Publication and reading never block: the snapshots are
+    //! double-buffered and a publication is skipped when a reader still uses the buffer
+    //! to be overwritten. The skipped state is reported in the next successful publication.
+    //!
+    //! Building the report and the patch is expensive on large transport streams. To avoid
+    //! stalling the thread which receives the packets, the analysis can be delegated to a
+    //! background thread, see startBackground(). The packets are then passed by batches to the
+    //! background thread which feeds the analyzer and publishes the snapshots on request.
+    //!
+    class TSDUCKDLL TSAnalyzerSnapshot
+    {
+        TS_NOCOPY(TSAnalyzerSnapshot);
+    public:
+        //!
+        //! Constructor.
+        //!
+        TSAnalyzerSnapshot();
+
+        //!
+        //! Destructor.
+        //! Stop the background analysis, if started.
+        //!
+        ~TSAnalyzerSnapshot();
+
+        //!
+        //! Reset the snapshots. The next publication will restart from a complete report.
+        //! Must be called from the writer thread only.
+        //!
+        void reset();
+
+        //!
+        //! Publish a new snapshot of an analysis.
+        //! Must be called from the writer thread only.
+        //! @param [in,out] analyzer The analyzer to snapshot.
+        //! @param [in] opt Analysis options.
+        //! @param [in] title Title string.
+        //! @return True if the snapshot was published, false if it was skipped because a
+        //! reader still uses the previous snapshot buffer.
+        //!
+        bool publish(TSAnalyzerReport& analyzer, const TSAnalyzerOptions& opt, const UString& title = UString());
+
+        //!
+        //! Report the latest published snapshot, if not already reported.
+        //! Can be called from any thread.
+        //! @param [in] args JSON output options, as used by TSAnalyzerReport::reportJSON().
+        //! @param [in,out] strm Output text stream.
+        //! @param [in,out] sequence On input, sequence number of the last snapshot which was reported
+        //! by the caller, zero if none. If the latest snapshot immediately follows it, only a JSON
+        //! patch (a JSON array) is reported. Otherwise, the complete report (a JSON object) is reported.
+        //! On output, receive the sequence number of the reported snapshot.
+        //! @param [in,out] rep Where to report errors.
+        //! @return True if a snapshot was reported, false if there is no new snapshot after @a sequence.
+        //!
+        bool report(const json::OutputArgs& args, std::ostream& strm, uint64_t& sequence, Report& rep = NULLREP) const;
+
+        //!
+        //! Start a background analysis thread.
+        //! Until stopBackground() is called, the analyzer is exclusively used by the background thread,
+        //! which becomes the writer thread. The packets must be passed using feedPacket() instead of
+        //! TSAnalyzer::feedPacket(). The snapshots are published using requestPublish().
+        //! @param [in,out] analyzer The analyzer to use. It must remain valid until stopBackground().
+        //! @param [in] opt Analysis options. It must remain valid and unmodified until stopBackground().
+        //! @param [in] title Title string.
+        //! @param [in] handler If not null, notified in the background thread after each publication.
+        //! @return True on success, false if the background analysis is already started.
+        //!
+        bool startBackground(TSAnalyzerReport& analyzer, const TSAnalyzerOptions& opt, const UString& title = UString(), TSAnalyzerSnapshotHandlerInterface* handler = nullptr);
+
+        //!
+        //! Stop the background analysis thread.
+        //! All packets which were passed to feedPacket() are analyzed and all requested snapshots
+        //! are published before returning. Then, the analyzer can be used again by the caller.
+        //!
+        void stopBackground();
+
+        //!
+        //! Pass a packet to the background analysis.
+        //! Must be called from the thread which called startBackground() only.
+        //! The packets are passed by batches to the background thread.
+        //! @param [in] pkt The packet to analyze.
+        //!
+        void feedPacket(const TSPacket& pkt);
+
+        //!
+        //! Request the publication of a snapshot by the background analysis.
+        //! The snapshot will contain all packets which were previously passed to feedPacket().
+        //! Must be called from the thread which called startBackground() only. Does not wait
+        //! for the publication. The handler, if any, is notified when the snapshot is published.
+        //! @param [in] bitrate_hint Bitrate hint for the analyzer, see TSAnalyzer::setBitrateHint().
+        //!
+        void requestPublish(BitRate bitrate_hint = 0);
+
+    private:
+        // One snapshot buffer. All smart pointers are manipulated by the writer thread only.
+        // Readers only access the pointed values, which are never modified once published.
+        struct Buffer
+        {
+            Buffer();
+            uint64_t      sequence;  // Sequence number of this snapshot, zero if none.
+            uint64_t      previous;  // Sequence number of the snapshot that the patch applies to.
+            json::ValuePtr full;     // Complete report.
+            json::ValuePtr patch;    // Patch from previous snapshot, null on first snapshot.
+        };
+
+        // A batch of packets for the background analysis.
+        struct Batch
+        {
+            Batch();
+            std::vector<TSPacket> packets;  // Packets to analyze.
+            bool                  publish;  // Publish a snapshot after analyzing the packets.
+            BitRate               bitrate;  // Bitrate hint for the publication.
+        };
+
+        // Background analysis thread. The batches are passed in order from the thread which calls feedPacket().
+        class Background: public Thread
+        {
+            TS_NOBUILD_NOCOPY(Background);
+        public:
+            // Constructor, destructor (analyze all pending batches, then terminate the thread).
+            Background(TSAnalyzerSnapshot& snapshot, TSAnalyzerReport& analyzer, const TSAnalyzerOptions& opt, const UString& title, TSAnalyzerSnapshotHandlerInterface* handler);
+            virtual ~Background() override;
+
+            // Add a packet to analyze.
+            void addPacket(const TSPacket& pkt);
+
+            // Queue the current batch, optionally followed by a publication.
+            void flush(bool publish, BitRate bitrate);
+
+        private:
+            // Number of packets per batch and maximum number of queued batches.
+            static constexpr size_t BATCH_SIZE = 1024;
+            static constexpr size_t MAX_QUEUED = 32;
+
+            TSAnalyzerSnapshot&       _snapshot;
+            TSAnalyzerReport&         _analyzer;
+            const TSAnalyzerOptions& _opt;
+            const UString             _title;
+            TSAnalyzerSnapshotHandlerInterface* _handler;
+            Batch*              _current;     // Batch which is filled by addPacket(), not yet queued.
+            Mutex               _mutex;       // Protect the following fields.
+            Condition           _work_to_do;  // Signaled when a batch is queued or the thread shall terminate.
+            Condition           _work_done;   // Signaled when a batch is analyzed.
+            std::deque<Batch*>  _queue;       // Batches to analyze.
+            std::vector<Batch*> _free;        // Recycled batches.
+            bool                _terminate;   // The thread shall terminate when the queue is empty.
+
+            // Inherited from Thread.
+            virtual void main() override;
+        };
+
+        Background*                 _background;  // Background analysis thread, if started.
+        Buffer                      _buffers[2];  // Double buffer.
+        std::atomic<size_t>         _current;     // Index of the latest published buffer.
+        mutable std::atomic<size_t> _readers[2];  // Number of active readers per buffer.
+        uint64_t                    _sequence;    // Last published sequence number (writer only).
+        json::ValuePtr              _last;        // Last published complete report (writer only).
+    };
+}
@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Interface for classes which are notified of new TS analysis snapshots.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+
+    class TSAnalyzerSnapshot;
+
+    //!
+    //! Interface for classes which are notified of new TS analysis snapshots.
+    //! @ingroup mpeg
+    //!
+    //! This abstract interface must be implemented by classes which need to be
+    //! notified of the snapshots which are published by a background analysis
+    //! in a TSAnalyzerSnapshot.
+    //!
+    class TSDUCKDLL TSAnalyzerSnapshotHandlerInterface
+    {
+    public:
+        //!
+        //! This hook is invoked when a new snapshot is published by the background analysis.
+        //! It is executed in the context of the background analysis thread.
+        //! @param [in,out] snapshot A reference to the snapshot object. The new snapshot
+        //! can be reported using TSAnalyzerSnapshot::report().
+        //!
+        virtual void handleSnapshot(TSAnalyzerSnapshot& snapshot) = 0;
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~TSAnalyzerSnapshotHandlerInterface();
+    };
+}
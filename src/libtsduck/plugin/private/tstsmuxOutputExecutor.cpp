@@ -132,7 +132,9 @@ void ts::tsmux::OutputExecutor::main()
             // Output some packets. Not more that --max-output-packets, not more than up to end of circular buffer.
             const size_t send_count = std::min(std::min(count, _opt.maxOutputPackets), _buffer_size - _packets_first);
             if (_output->send(&_packets[first], &_metadata[first], send_count)) {
-                // Packets successfully sent.
+                // Packets successfully sent. Wait until the plugin no longer uses them (asynchronous transmission).
+                while (_output->oldestBusyPacket(true) != nullptr) {
+                }
                 GuardCondition lock(_mutex, _got_freespace);
                 _packets_count -= send_count;
                 _packets_first = (_packets_first + send_count) % _buffer_size;
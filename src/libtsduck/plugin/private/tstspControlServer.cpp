@@ -29,6 +29,8 @@
 
 #include "tstspControlServer.h"
 #include "tstspPluginExecutor.h"
+#include "tstspStatisticsReporter.h"
+#include "tsjsonObject.h"
 #include "tsNullMutex.h"
 #include "tsNullReport.h"
 #include "tsReportBuffer.h"
@@ -58,7 +60,8 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
               {TSPControlCommand::CMD_LIST,    &ControlServer::executeList},
               {TSPControlCommand::CMD_SUSPEND, &ControlServer::executeSuspend},
               {TSPControlCommand::CMD_RESUME,  &ControlServer::executeResume},
-              {TSPControlCommand::CMD_RESTART, &ControlServer::executeRestart}}
+              {TSPControlCommand::CMD_RESTART, &ControlServer::executeRestart},
+              {TSPControlCommand::CMD_STATS,   &ControlServer::executeStats}}
 {
     // Locate output plugin, count packet processor plugins.
     if (_input != nullptr) {
@@ -163,6 +166,14 @@ void ts::tsp::ControlServer::main()
         else if (conn.setReceiveTimeout(_options.control_timeout, _log) && conn.receiveLine(line, nullptr, _log)) {
             _log.verbose(u"received from %s: %s", {source, line});
 
+            // An HTTP request is not a control command.
+            if (line.startWith(u"GET ")) {
+                executeHTTP(line, conn);
+                conn.closeWriter(_log);
+                conn.close(_log);
+                continue;
+            }
+
             // Reset the severity of the connection before analysing the line.
             // A previous analysis may have used --verbose or --debug.
             conn.setMaxSeverity(Severity::Info);
@@ -356,3 +367,167 @@ void ts::tsp::ControlServer::executeRestart(const Args* args, Report& response)
         plugin->restart(params, response);
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Stats command.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::executeStats(const Args* args, Report& response)
+{
+    json::Object root;
+    StatisticsReporter::BuildJSON(_input, root);
+
+    if (args->present(u"json")) {
+        response.info(root.printed());
+        return;
+    }
+
+    const json::Value& plugins(root.value(u"plugins"));
+    for (size_t i = 0; i < plugins.size(); ++i) {
+        const json::Value& pl(plugins.at(i));
+        const json::Value& proc(pl.value(u"process-ns-per-packet"));
+        const json::Value& wait(pl.value(u"wait-ns"));
+        const json::Value& buf(pl.value(u"buffer-packets"));
+        response.info(u"%2d: %s%s: %'d packets, %'d pkt/s, busy: %d%%",
+                      {pl.value(u"index").toInteger(),
+                       pl.value(u"suspended").isTrue() ? u"(suspended) " : u"",
+                       pl.value(u"name").toString(),
+                       pl.value(u"packets").toInteger(),
+                       pl.value(u"packets-per-second").toInteger(),
+                       pl.value(u"busy-percent").toInteger()});
+        response.info(u"    process/packet: mean %'d ns, p50 %'d ns, p99 %'d ns, max %'d ns",
+                      {proc.value(u"mean").toInteger(), proc.value(u"p50").toInteger(), proc.value(u"p99").toInteger(), proc.value(u"max").toInteger()});
+        response.info(u"    wait: mean %'d ns, p50 %'d ns, p99 %'d ns, max %'d ns",
+                      {wait.value(u"mean").toInteger(), wait.value(u"p50").toInteger(), wait.value(u"p99").toInteger(), wait.value(u"max").toInteger()});
+        response.info(u"    buffer: mean %'d, p50 %'d, p99 %'d, max %'d packets",
+                      {buf.value(u"mean").toInteger(), buf.value(u"p50").toInteger(), buf.value(u"p99").toInteger(), buf.value(u"max").toInteger()});
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// HTTP requests.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::executeHTTP(const UString& request, TelnetConnection& conn)
+{
+    // Skip all request headers, up to the empty line.
+    UString header;
+    while (conn.receiveLine(header, nullptr, _log) && !header.empty()) {
+    }
+
+    // Get the requested path, without query.
+    UStringVector fields;
+    request.split(fields, u' ', true, true);
+    UString path(fields.size() < 2 ? UString() : fields[1]);
+    const size_t query = path.find(u'?');
+    if (query != NPOS) {
+        path.resize(query);
+    }
+
+    // Only the metrics are served.
+    if (path == u"/metrics") {
+        UString text;
+        buildMetrics(text);
+        conn.send(u"HTTP/1.1 200 OK\r\n"
+                  u"Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                  u"Connection: close\r\n\r\n" + text, _log);
+    }
+    else {
+        conn.send(u"HTTP/1.1 404 Not Found\r\n"
+                  u"Content-Type: text/plain; charset=utf-8\r\n"
+                  u"Connection: close\r\n\r\n"
+                  u"not found, use /metrics\n", _log);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the metrics of all plugins in OpenMetrics text format.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::buildMetrics(UString& text)
+{
+    // All plugin executors, in order of the chain.
+    std::vector<PluginExecutor*> chain;
+    chain.push_back(_input);
+    chain.insert(chain.end(), _plugins.begin(), _plugins.end());
+    chain.push_back(_output);
+
+    // Labels of each plugin.
+    UStringVector labels;
+    for (size_t i = 0; i < chain.size(); ++i) {
+        labels.push_back(UString::Format(u"index=\"%d\",plugin=\"%s\"", {i, chain[i]->pluginName()}));
+    }
+
+    // Description of one metric family.
+    struct Family {
+        UString name;
+        UString type;
+        UString help;
+        UString samples;
+    };
+    std::list<Family> families;
+    const auto family = [&families](const UString& name, const UString& type, const UString& help) -> Family& {
+        for (auto& fam : families) {
+            if (fam.name == name) {
+                return fam;
+            }
+        }
+        families.push_back(Family{name, type, help, UString()});
+        return families.back();
+    };
+
+    // Execution statistics of each plugin.
+    Family& packets(family(u"tsp_plugin_packets", u"counter", u"Number of packets processed by the plugin"));
+    Family& bitrate(family(u"tsp_plugin_bitrate_bits_per_second", u"gauge", u"Transport stream bitrate as seen by the plugin"));
+    Family& suspended(family(u"tsp_plugin_suspended", u"gauge", u"Plugin is suspended"));
+    Family& busy(family(u"tsp_plugin_busy_ratio", u"gauge", u"Ratio of time the plugin spends processing packets"));
+    Family& process(family(u"tsp_plugin_process_nanoseconds", u"summary", u"Processing time per packet"));
+    Family& wait(family(u"tsp_plugin_wait_nanoseconds", u"summary", u"Waiting time for packets from the previous plugin"));
+
+    static const std::pair<const UChar*, double> quantiles[] = {{u"0.5", 50.0}, {u"0.9", 90.0}, {u"0.99", 99.0}};
+    const auto summary = [](Family& fam, const UString& lab, const LatencyHistogram& histo) {
+        for (const auto& q : quantiles) {
+            fam.samples.format(u"%s{%s,quantile=\"%s\"} %d\n", {fam.name, lab, q.first, histo.percentile(q.second)});
+        }
+        fam.samples.format(u"%s_sum{%s} %d\n", {fam.name, lab, histo.sum()});
+        fam.samples.format(u"%s_count{%s} %d\n", {fam.name, lab, histo.count()});
+    };
+
+    for (size_t i = 0; i < chain.size(); ++i) {
+        const PluginExecutor* pe = chain[i];
+        const UString& lab(labels[i]);
+        const uint64_t busy_ns = pe->processTimeHistogram().sum();
+        const uint64_t total_ns = busy_ns + pe->waitTimeHistogram().sum();
+        packets.samples.format(u"%s_total{%s} %d\n", {packets.name, lab, pe->statisticsPackets()});
+        bitrate.samples.format(u"%s{%s} %d\n", {bitrate.name, lab, pe->bitrate().toInt()});
+        suspended.samples.format(u"%s{%s} %d\n", {suspended.name, lab, pe->getSuspended() ? 1 : 0});
+        busy.samples.format(u"%s{%s} %s\n", {busy.name, lab, total_ns == 0 ? u"0" : UString::Format(u"%d.%03d", {(1000 * busy_ns / total_ns) / 1000, (1000 * busy_ns / total_ns) % 1000})});
+        summary(process, lab, pe->processTimeHistogram());
+        summary(wait, lab, pe->waitTimeHistogram());
+    }
+
+    // Metrics which are published by the plugins themselves.
+    PluginMetrics::SampleList samples;
+    for (size_t i = 0; i < chain.size(); ++i) {
+        chain[i]->metrics().getSamples(samples);
+        for (const auto& smp : samples) {
+            const bool counter = smp.type == PluginMetrics::Type::COUNTER;
+            Family& fam(family(u"tsp_plugin_" + smp.name, counter ? u"counter" : u"gauge", smp.help));
+            fam.samples.format(u"%s%s{%s} %d\n", {fam.name, counter ? u"_total" : u"", labels[i], smp.value});
+        }
+    }
+
+    // Format all families.
+    text.clear();
+    for (const auto& fam : families) {
+        text.format(u"# TYPE %s %s\n", {fam.name, fam.type});
+        if (!fam.help.empty()) {
+            text.format(u"# HELP %s %s\n", {fam.name, fam.help});
+        }
+        text.append(fam.samples);
+    }
+    text.append(u"# EOF\n");
+}
@@ -41,6 +41,7 @@
 #include "tsThread.h"
 #include "tsMutex.h"
 #include "tsTCPServer.h"
+#include "tsTelnetConnection.h"
 #include "tsReportWithPrefix.h"
 
 namespace ts {
@@ -106,6 +107,11 @@ namespace ts {
             void executeResume(const Args*, Report&);
             void executeSuspendResume(bool state, const Args*, Report&);
             void executeRestart(const Args*, Report&);
+            void executeStats(const Args*, Report&);
+
+            // HTTP requests, typically from an OpenMetrics scraper.
+            void executeHTTP(const UString& request, TelnetConnection& conn);
+            void buildMetrics(UString& text);
         };
     }
 }
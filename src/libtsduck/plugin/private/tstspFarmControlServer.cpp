@@ -0,0 +1,231 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspFarmControlServer.h"
+#include "tsTSProcessorFarm.h"
+#include "tsNullMutex.h"
+#include "tsNullReport.h"
+#include "tsReportBuffer.h"
+#include "tsTelnetConnection.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::FarmControlServer::FarmControlServer(const TSProcessorFarmArgs& options, Report& log, TSProcessorFarm& farm) :
+    _is_open(false),
+    _terminate(false),
+    _options(options),
+    _log(log, u"control commands: "),
+    _reference(),
+    _server(),
+    _farm(farm),
+    _handlers{{TSPControlCommand::CMD_EXIT,   &FarmControlServer::executeExit},
+              {TSPControlCommand::CMD_CHAINS, &FarmControlServer::executeChains},
+              {TSPControlCommand::CMD_START,  &FarmControlServer::executeStart},
+              {TSPControlCommand::CMD_STOP,   &FarmControlServer::executeStop}}
+{
+}
+
+ts::tsp::FarmControlServer::~FarmControlServer()
+{
+    // Terminate the thread and wait for actual thread termination.
+    close();
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start/stop the command receiver.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::FarmControlServer::open()
+{
+    if (_options.control_port == 0) {
+        // No control server, do nothing.
+        return true;
+    }
+    else if (_is_open) {
+        _log.error(u"tspfarm control command server alread started");
+        return false;
+    }
+    else {
+        // Open the TCP server.
+        const SocketAddress addr(_options.control_local, _options.control_port);
+        if (!_server.open(_log) ||
+            !_server.reusePort(_options.control_reuse, _log) ||
+            !_server.bind(addr, _log) ||
+            !_server.listen(5, _log))
+        {
+            _server.close(NULLREP);
+            _log.error(u"error starting TCP server for control commands.");
+            return false;
+        }
+
+        // Start the thread.
+        _is_open = true;
+        return start();
+    }
+}
+
+void ts::tsp::FarmControlServer::close()
+{
+    if (_is_open) {
+        // Close the TCP server. This will force the server thread to terminate.
+        _terminate = true;
+        _server.close(NULLREP);
+
+        // Wait for the termination of the thread.
+        waitForTermination();
+        _is_open = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the context of the server thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FarmControlServer::main()
+{
+    _log.debug(u"control command thread started");
+
+    // Get accept errors in a buffer since some errors are normal.
+    ReportBuffer<NullMutex> error(_log.maxSeverity());
+
+    // Client address and connection.
+    SocketAddress source;
+    TelnetConnection conn;
+    UString line;
+
+    // Loop on incoming connections, one command at a time.
+    while (_server.accept(conn, source, error)) {
+
+        // Filter allowed sources.
+        // Set receive timeout on the connection and read one line.
+        if (std::find(_options.control_sources.begin(), _options.control_sources.end(), source) == _options.control_sources.end()) {
+            _log.warning(u"connection attempt from unauthorized source %s (ignored)", {source});
+            conn.sendLine("error: client address is not authorized", _log);
+        }
+        else if (conn.setReceiveTimeout(_options.control_timeout, _log) && conn.receiveLine(line, nullptr, _log)) {
+            _log.verbose(u"received from %s: %s", {source, line});
+
+            // Reset the severity of the connection before analysing the line.
+            conn.setMaxSeverity(Severity::Info);
+
+            // Analyze the command, return errors on the client connection.
+            TSPControlCommand::ControlCommand cmd = TSPControlCommand::CMD_NONE;
+            const Args* args = nullptr;
+            CommandHandler handler = nullptr;
+            if (_reference.analyze(line, cmd, args, conn)) {
+                const auto it = _handlers.find(cmd);
+                if (it != _handlers.end()) {
+                    handler = it->second;
+                }
+            }
+
+            // Execute the handler for this command or return an error message.
+            if (handler != nullptr && args != nullptr) {
+                (this->*handler)(args, conn);
+            }
+            else {
+                conn.error(u"invalid tspfarm control command: %s", {line});
+            }
+        }
+
+        conn.closeWriter(_log);
+        conn.close(_log);
+    }
+
+    // If termination was requested, receive error is not an error.
+    if (!_terminate && !error.emptyMessages()) {
+        _log.error(error.getMessages());
+    }
+    _log.debug(u"control command thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Exit command.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FarmControlServer::executeExit(const Args* args, Report& response)
+{
+    if (args->present(u"abort")) {
+        // Immediate exit.
+        ::exit(EXIT_FAILURE);
+    }
+    else {
+        _log.info(u"exit requested by remote tspcontrol");
+        _farm.abort();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Chains command.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FarmControlServer::executeChains(const Args* args, Report& response)
+{
+    TSProcessorFarm::ChainStatusVector chains;
+    _farm.getChains(chains);
+
+    // Compute width of name column.
+    size_t width = 0;
+    for (auto it = chains.begin(); it != chains.end(); ++it) {
+        width = std::max(width, it->name.width());
+    }
+    for (auto it = chains.begin(); it != chains.end(); ++it) {
+        response.info(u"%-*s  %-7s  threads: %d, starts: %d", {width, it->name, TSProcessorFarm::ChainStateEnum.name(it->state), it->threads, it->starts});
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start/stop commands.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FarmControlServer::executeStart(const Args* args, Report& response)
+{
+    const UString name(args->value(u""));
+    if (_farm.startChain(name, response)) {
+        _log.verbose(u"start of chain %s requested", {name});
+    }
+}
+
+void ts::tsp::FarmControlServer::executeStop(const Args* args, Report& response)
+{
+    const UString name(args->value(u""));
+    if (_farm.stopChain(name, response)) {
+        _log.verbose(u"stop of chain %s requested", {name});
+    }
+}
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Control command server of a farm of transport stream processors.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSProcessorFarmArgs.h"
+#include "tsTSPControlCommand.h"
+#include "tsThread.h"
+#include "tsTCPServer.h"
+#include "tsReportWithPrefix.h"
+
+namespace ts {
+
+    class TSProcessorFarm;
+
+    namespace tsp {
+        //!
+        //! Control command server of a farm of transport stream processors.
+        //! This class is internal to the TSDuck library and cannot be called by applications.
+        //! @ingroup plugin
+        //!
+        class FarmControlServer : private Thread
+        {
+            TS_NOBUILD_NOCOPY(FarmControlServer);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] options Command line options for tspfarm.
+            //! @param [in,out] log Log report.
+            //! @param [in,out] farm The farm of processing chains to control.
+            //!
+            FarmControlServer(const TSProcessorFarmArgs& options, Report& log, TSProcessorFarm& farm);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~FarmControlServer() override;
+
+            //!
+            //! Start the control command server (do nothing if there is no control port).
+            //! @return True on success, false on error.
+            //!
+            bool open();
+
+            //!
+            //! Stop the control command server.
+            //!
+            void close();
+
+        private:
+            volatile bool       _is_open;
+            volatile bool       _terminate;
+            TSProcessorFarmArgs _options;
+            ReportWithPrefix    _log;
+            TSPControlCommand   _reference;
+            TCPServer           _server;
+            TSProcessorFarm&    _farm;
+
+            // Implementation of Thread.
+            virtual void main() override;
+
+            // Command handlers.
+            typedef void (FarmControlServer::* CommandHandler)(const Args*, Report&);
+            std::map<TSPControlCommand::ControlCommand, CommandHandler> _handlers;
+
+            void executeExit(const Args*, Report&);
+            void executeChains(const Args*, Report&);
+            void executeStart(const Args*, Report&);
+            void executeStop(const Args*, Report&);
+        };
+    }
+}
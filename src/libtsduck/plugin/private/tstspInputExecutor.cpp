@@ -61,7 +61,12 @@ ts::tsp::InputExecutor::InputExecutor(const TSProcessorArgs& options,
     _use_dts_analyzer(false),
     _watchdog(this, options.receive_timeout, 0, *this),
     _use_watchdog(false),
-    _start_time(true) // initialized with current system time
+    _start_time(true), // initialized with current system time
+    _input_timestamp(metrics().metric(u"input_timestamp_microseconds", PluginMetrics::Type::GAUGE, u"Input timestamp of the last received packet")),
+    _window(),
+    _window_metric(metrics().metric(u"buffer_window_packets", PluginMetrics::Type::GAUGE, u"Maximum number of packets in the buffer between input and output")),
+    _reserve(),
+    _dropped_metric(metrics().metric(u"dropped_packets", PluginMetrics::Type::COUNTER, u"Number of input packets which were dropped because the buffer was full"))
 {
     if (options.log_plugin_index) {
         // Make sure that plugins display their index. Input plugin is always at index 0.
@@ -93,9 +98,18 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer, PacketMetadata
     // Pre-declare buffer for input plugin.
     initBuffer(buffer, metadata, 0, buffer->count(), false, false, 0);
 
-    // Pre-load half of the buffer (the default) with packets from the input device.
-    const size_t init_packets = _options.init_input_pkt == 0 ? buffer->count() / 2 : std::min(_options.init_input_pkt, buffer->count());
-    const size_t pkt_read = receiveAndStuff(0, init_packets);
+    // With --adaptive-buffer, start with the minimum window. Otherwise, use the full buffer.
+    _window.reset(_options.adaptive_buffer ? _options.adaptive_min_pkt : buffer->count(), buffer->count(), Monotonic(true));
+    _window_metric.set(int64_t(_window.size()));
+
+    // Allocate the reserve of packets when the input shall not block on a full buffer.
+    if (_options.back_pressure != TSProcessorArgs::BackPressure::BLOCK) {
+        _reserve.reset(_options.reserve_pkt, _options.back_pressure == TSProcessorArgs::BackPressure::DROP_NULL_FIRST);
+    }
+
+    // Pre-load half of the buffer or window (the default) with packets from the input device.
+    const size_t init_packets = _options.init_input_pkt == 0 ? std::max<size_t>(1, _window.size() / 2) : std::min(_options.init_input_pkt, buffer->count());
+    const size_t pkt_read = receiveAndStuff(buffer->base(), metadata->base(), init_packets);
 
     if (pkt_read == 0) {
         debug(u"no initial packet read");
@@ -193,6 +207,16 @@ size_t ts::tsp::InputExecutor::pluginIndex() const
 }
 
 
+//----------------------------------------------------------------------------
+// Number of threads of this plugin executor, including the watchdog.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::InputExecutor::threadCount() const
+{
+    return PluginExecutor::threadCount() + (_use_watchdog ? 1 : 0);
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of WatchDogHandlerInterface
 //----------------------------------------------------------------------------
@@ -210,11 +234,8 @@ void ts::tsp::InputExecutor::handleWatchDogTimeout(WatchDog& watchdog)
 // Receive null packets.
 //----------------------------------------------------------------------------
 
-size_t ts::tsp::InputExecutor::receiveNullPackets(size_t index, size_t max_packets)
+size_t ts::tsp::InputExecutor::receiveNullPackets(TSPacket* pkt, TSPacketMetadata* data, size_t max_packets)
 {
-    TSPacket* const pkt = _buffer->base() + index;
-    TSPacketMetadata* const data = _metadata->base() + index;
-
     // Fill the buffer with null packets.
     for (size_t n = 0; n < max_packets; ++n) {
         pkt[n] = NullPacket;
@@ -235,16 +256,13 @@ size_t ts::tsp::InputExecutor::receiveNullPackets(size_t index, size_t max_packe
 // checking the validity of the input.
 //----------------------------------------------------------------------------
 
-size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packets)
+size_t ts::tsp::InputExecutor::receiveAndValidate(TSPacket* pkt, TSPacketMetadata* data, size_t max_packets)
 {
     // If synchronization lost, report an error
     if (_in_sync_lost) {
         return 0;
     }
 
-    TSPacket* const pkt = _buffer->base() + index;
-    TSPacketMetadata* const data = _metadata->base() + index;
-
     // Reset metadata for new incoming packets.
     for (size_t n = 0; n < max_packets; ++n) {
         data[n].reset();
@@ -308,18 +326,19 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
 // taking into account the tsp input stuffing options.
 //----------------------------------------------------------------------------
 
-size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
+size_t ts::tsp::InputExecutor::receiveAndStuff(TSPacket* pkt, TSPacketMetadata* data, size_t max_packets)
 {
     size_t pkt_done = 0;              // Number of received packets in buffer
     size_t pkt_remain = max_packets;  // Remaining number of packets to read
 
     // If initial stuffing not yet completed, add initial stuffing.
     while (_instuff_start_remain > 0 && pkt_remain > 0) {
-        _buffer->base()[index] = NullPacket;
-        _metadata->base()[index].reset();
-        _metadata->base()[index].setInputStuffing(true);
+        *pkt = NullPacket;
+        data->reset();
+        data->setInputStuffing(true);
         _instuff_start_remain--;
-        index++;
+        pkt++;
+        data++;
         pkt_remain--;
         pkt_done++;
         addNonPluginPackets(1);
@@ -328,16 +347,17 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
     // Now read real packets.
     if (_options.instuff_inpkt == 0) {
         // There is no --add-input-stuffing option, simply call the plugin
-        pkt_done += receiveAndValidate(index, pkt_remain);
+        pkt_done += receiveAndValidate(pkt, data, pkt_remain);
     }
     else {
         // Otherwise, we have to alternate input packets and null packets.
         while (pkt_remain > 0) {
 
             // Stuff null packets.
-            size_t count = receiveNullPackets(index, std::min(_instuff_nullpkt_remain, pkt_remain));
+            size_t count = receiveNullPackets(pkt, data, std::min(_instuff_nullpkt_remain, pkt_remain));
             _instuff_nullpkt_remain -= count;
-            index += count;
+            pkt += count;
+            data += count;
             pkt_remain -= count;
             pkt_done += count;
 
@@ -353,8 +373,9 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
 
             // Read input packets from the plugin
             const size_t max_input = std::min(pkt_remain, _instuff_inpkt_remain);
-            count = receiveAndValidate(index, max_input);
-            index += count;
+            count = receiveAndValidate(pkt, data, max_input);
+            pkt += count;
+            data += count;
             pkt_remain -= count;
             pkt_done += count;
             _instuff_inpkt_remain -= count;
@@ -374,6 +395,46 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
 }
 
 
+//----------------------------------------------------------------------------
+// Adapt the window to the lag between input and output (--adaptive-buffer).
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputExecutor::adaptWindow(bool blocked, NanoSecond wait_time, NanoSecond read_time)
+{
+    // Packets which were previously passed and not yet released by the output plugin.
+    const size_t lag = _buffer->count() - areaPackets();
+    const size_t previous = _window.size();
+
+    if (_window.update(lag, blocked, wait_time, read_time, Monotonic(true))) {
+        debug(u"adaptive buffer: window %s to %'d packets", {_window.size() > previous ? u"increased" : u"decreased", _window.size()});
+        _window_metric.set(int64_t(_window.size()));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive packets in the reserve when the buffer is full (--back-pressure).
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::InputExecutor::receiveInReserve()
+{
+    const size_t chunk = std::max<size_t>(1, _reserve.capacity() / 4);
+
+    // Make room for one chunk of packets in the reserve.
+    const size_t dropped = _reserve.makeRoom(chunk);
+    if (dropped > 0) {
+        if (_reserve.droppedCount() == dropped) {
+            warning(u"packet buffer is full, dropping input packets (%s)", {TSProcessorArgs::BackPressureEnum.name(_options.back_pressure)});
+        }
+        _dropped_metric.add(int64_t(dropped));
+    }
+
+    // Read the input plugin at the end of the reserve.
+    _reserve.commit(receiveAndStuff(_reserve.freePackets(), _reserve.freeMetadata(), chunk));
+    return dropped;
+}
+
+
 //----------------------------------------------------------------------------
 // Input plugin thread
 //----------------------------------------------------------------------------
@@ -396,9 +457,28 @@ void ts::tsp::InputExecutor::main()
         BitRate bitrate = 0;
         bool timeout = false;
 
-        // Wait for space in the input buffer.
+        // When the window is full and the back-pressure policy drops packets, do not wait for
+        // free space in the buffer, continue to read the input plugin in the reserve.
+        const bool blocked = _window.isFull(_buffer->count() - areaPackets());
+        const bool use_reserve = blocked && _options.back_pressure != TSProcessorArgs::BackPressure::BLOCK && !_plugin_completed;
+
+        // With --adaptive-buffer, measure how long the input waits for the output and reads the plugin.
+        Monotonic clock;
+        NanoSecond wait_time = 0;
+        if (_options.adaptive_buffer) {
+            clock.getSystemTime();
+        }
+
+        // Wait for space in the input buffer, within the window. When the reserve is used, don't
+        // wait but still collect the state of the buffer and the abort condition of the next plugin.
         // Ignore input_end and bitrate from previous, we are the input processor.
-        waitWork(1, pkt_first, pkt_max, bitrate, input_end, aborted, timeout);
+        waitWork(use_reserve ? 0 : _buffer->count() - _window.size() + 1, pkt_first, pkt_max, bitrate, input_end, aborted, timeout);
+
+        if (_options.adaptive_buffer) {
+            const Monotonic now(true);
+            wait_time = now - clock;
+            clock = now;
+        }
 
         // Process restart requests.
         if (!processPendingRestart(restarted)) {
@@ -419,28 +499,58 @@ void ts::tsp::InputExecutor::main()
             break;
         }
 
+        // Read the input plugin in the reserve if the window is still full.
+        if (use_reserve && _window.isFull(_buffer->count() - areaPackets())) {
+            const size_t dropped = receiveInReserve();
+            // With --adaptive-buffer, dropped packets mean that the window did not absorb the burst:
+            // the time which was spent in the reserve is accounted as waiting for the output.
+            if (_options.adaptive_buffer) {
+                adaptWindow(dropped > 0, Monotonic(true) - clock, 0);
+            }
+            continue;
+        }
+
         // Do not read more packets than request by --max-input-packets
         if (_options.max_input_pkt > 0 && pkt_max > _options.max_input_pkt) {
             pkt_max = _options.max_input_pkt;
         }
 
+        // With a window smaller than the buffer, the returned area may wrap up at end of buffer
+        // and may exceed the window. Keep only what fits in both.
+        if (_window.size() < _buffer->count()) {
+            pkt_max = std::min(pkt_max, _buffer->count() - pkt_first);
+            pkt_max = std::min(pkt_max, _window.freeSize(_buffer->count() - areaPackets()));
+        }
+
         // Now read at most the specified number of packets (pkt_max).
+        TSPacket* const pkt = _buffer->base() + pkt_first;
+        TSPacketMetadata* const data = _metadata->base() + pkt_first;
         size_t pkt_read = 0;
 
+        // Packets from the reserve come first. Don't wait for the plugin once some are moved.
+        if (!_reserve.empty()) {
+            pkt_read = _reserve.flush(pkt, data, pkt_max);
+        }
+
         // Read from the plugin if not already terminated.
-        if (!_plugin_completed) {
-            pkt_read = receiveAndStuff(pkt_first, pkt_max);
+        if (!_plugin_completed && pkt_read == 0) {
+            pkt_read = receiveAndStuff(pkt, data, pkt_max);
         }
 
         // Read additional trailing stuffing after completion of the input plugin.
-        if (_plugin_completed && _instuff_stop_remain > 0 && pkt_read < pkt_max) {
-            const size_t count = receiveNullPackets(pkt_first + pkt_read, std::min(_instuff_stop_remain, pkt_max - pkt_read));
+        if (_plugin_completed && _reserve.empty() && _instuff_stop_remain > 0 && pkt_read < pkt_max) {
+            const size_t count = receiveNullPackets(pkt + pkt_read, data + pkt_read, std::min(_instuff_stop_remain, pkt_max - pkt_read));
             pkt_read += count;
             _instuff_stop_remain -= count;
         }
 
-        // Overall input is completed when input plugin and trailing stuffing are completed.
-        input_end = _plugin_completed && _instuff_stop_remain == 0;
+        // Overall input is completed when input plugin, reserve and trailing stuffing are completed.
+        input_end = _plugin_completed && _reserve.empty() && _instuff_stop_remain == 0;
+
+        // Adjust the window to the lag of the output.
+        if (_options.adaptive_buffer) {
+            adaptWindow(blocked, wait_time, Monotonic(true) - clock);
+        }
 
         // Process periodic bitrate adjustment.
         // In initial phase, as long as the bitrate is unknown, retry every init_bitrate_adj packets.
@@ -471,6 +581,14 @@ void ts::tsp::InputExecutor::main()
             }
         }
 
+        // Publish the input timestamp of the last received packet, if there is one.
+        if (pkt_read > 0) {
+            const TSPacketMetadata& last(data[pkt_read - 1]);
+            if (last.hasInputTimeStamp()) {
+                _input_timestamp.set(int64_t(last.getInputTimeStamp() / (SYSTEM_CLOCK_FREQ / MicroSecPerSec)));
+            }
+        }
+
         // Pass received packets to next processor
         passPackets(pkt_read, _tsp_bitrate, input_end, false);
 
@@ -480,5 +598,8 @@ void ts::tsp::InputExecutor::main()
     debug(u"stopping the input plugin");
     _input->stop();
 
+    if (_reserve.droppedCount() > 0) {
+        verbose(u"dropped %'d packets because the buffer was full", {_reserve.droppedCount()});
+    }
     debug(u"input thread %s after %'d packets", {aborted ? u"aborted" : u"terminated", totalPacketsInThread()});
 }
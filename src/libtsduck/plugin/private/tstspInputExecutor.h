@@ -36,6 +36,8 @@
 #include "tstspPluginExecutor.h"
 #include "tsInputPlugin.h"
 #include "tsPCRAnalyzer.h"
+#include "tsAdaptivePacketWindow.h"
+#include "tsPacketReserve.h"
 #include "tsMonotonic.h"
 #include "tsWatchDog.h"
 
@@ -89,6 +91,7 @@ namespace ts {
             // Overridden methods.
             virtual void setAbort() override;
             virtual size_t pluginIndex() const override;
+            virtual size_t threadCount() const override;
 
         private:
             InputPlugin* _input;                  // Plugin API
@@ -104,6 +107,11 @@ namespace ts {
             WatchDog     _watchdog;               // Watchdog when plugin does not support receive timeout.
             bool         _use_watchdog;           // The watchdog shall be used.
             Monotonic    _start_time;             // Creation time in a monotonic clock.
+            PluginMetrics::Metric& _input_timestamp; // Exported metric: last input timestamp in microseconds.
+            AdaptivePacketWindow _window;         // Max number of packets in the buffer between input and output (--adaptive-buffer).
+            PluginMetrics::Metric& _window_metric; // Exported metric: current size of the window.
+            PacketReserve _reserve;               // Reserve of packets when the buffer is full (--back-pressure).
+            PluginMetrics::Metric& _dropped_metric; // Exported metric: number of dropped packets.
 
             // Inherited from Thread
             virtual void main() override;
@@ -112,13 +120,20 @@ namespace ts {
             virtual void handleWatchDogTimeout(WatchDog& watchdog) override;
 
             // Receive null packets.
-            size_t receiveNullPackets(size_t index, size_t max_packets);
+            size_t receiveNullPackets(TSPacket* pkt, TSPacketMetadata* data, size_t max_packets);
 
             // Encapsulation of the plugin's receive() method, checking the validity of the input.
-            size_t receiveAndValidate(size_t index, size_t max_packets);
+            size_t receiveAndValidate(TSPacket* pkt, TSPacketMetadata* data, size_t max_packets);
 
             // Encapsulation of receiveAndValidate() method, adding tsp input stuffing options.
-            size_t receiveAndStuff(size_t index, size_t max_packets);
+            size_t receiveAndStuff(TSPacket* pkt, TSPacketMetadata* data, size_t max_packets);
+
+            // Adapt the window to the lag between input and output, after waiting for free space and reading packets.
+            void adaptWindow(bool blocked, NanoSecond wait_time, NanoSecond read_time);
+
+            // Receive packets in the reserve when the buffer is full, dropping packets according to --back-pressure.
+            // Return the number of dropped packets.
+            size_t receiveInReserve();
 
             // Encapsulation of the plugin's getBitrate() method, taking into account the tsp input
             // stuffing options. Use PCR analysis if bitrate not otherwise available.
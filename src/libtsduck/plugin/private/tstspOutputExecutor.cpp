@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tstspOutputExecutor.h"
+#include "tsTSProcessor.h"
 TSDUCK_SOURCE;
 
 
@@ -43,7 +44,8 @@ ts::tsp::OutputExecutor::OutputExecutor(const TSProcessorArgs& options,
                                         Report* report) :
 
     PluginExecutor(options, handlers, PluginType::OUTPUT, pl_options, attributes, global_mutex, report),
-    _output(dynamic_cast<OutputPlugin*>(PluginThread::plugin()))
+    _output(dynamic_cast<OutputPlugin*>(PluginThread::plugin())),
+    _completed(false)
 {
     if (options.log_plugin_index) {
         // Make sure that plugins display their index. Output plugin is always last.
@@ -77,6 +79,7 @@ void ts::tsp::OutputExecutor::main()
     debug(u"output thread started");
 
     PacketCounter output_packets = 0;
+    size_t busy_count = 0;  // Sent packets at start of our area, still in use by the plugin.
     bool aborted = false;
     bool restarted = false;
 
@@ -107,23 +110,27 @@ void ts::tsp::OutputExecutor::main()
         }
 
         // Exit thread if no more packet to process
-        if ((pkt_cnt == 0 && input_end) || aborted) {
+        if ((pkt_cnt <= busy_count && input_end) || aborted) {
             break;
         }
 
+        // The first packets in our area were already sent and are still in use by the plugin.
+        assert(busy_count <= pkt_cnt);
+        size_t new_cnt = pkt_cnt - busy_count;
+
         // Check if "joint termination" agreed on a last packet to output
         const PacketCounter jt_limit = totalPacketsBeforeJointTermination();
-        if (totalPacketsInThread() + pkt_cnt > jt_limit) {
-            pkt_cnt = totalPacketsInThread() > jt_limit ? 0 : size_t (jt_limit - totalPacketsInThread());
+        if (totalPacketsInThread() + new_cnt > jt_limit) {
+            new_cnt = totalPacketsInThread() > jt_limit ? 0 : size_t (jt_limit - totalPacketsInThread());
             aborted = true;
         }
 
         // Output the packets. Output may be segmented if dropped packets
         // (ie. starting with a zero byte) are in the middle of the buffer.
 
-        TSPacket* pkt = _buffer->base() + pkt_first;
-        TSPacketMetadata* data = _metadata->base() + pkt_first;
-        size_t pkt_remain = pkt_cnt;
+        TSPacket* pkt = _buffer->base() + pkt_first + busy_count;
+        TSPacketMetadata* data = _metadata->base() + pkt_first + busy_count;
+        size_t pkt_remain = new_cnt;
 
         while (!aborted && pkt_remain > 0) {
 
@@ -166,9 +173,23 @@ void ts::tsp::OutputExecutor::main()
             }
         }
 
+        // Packets which are still in use by the plugin (asynchronous transmission) must not be
+        // reused by the input processor. When there was nothing new to send, wait for the release
+        // of the oldest packet instead of looping on the same packets. When aborting, wait for all.
+        const TSPacket* busy = _output->oldestBusyPacket(new_cnt == 0 && busy_count > 0);
+        while (aborted && busy != nullptr) {
+            busy = _output->oldestBusyPacket(true);
+        }
+        size_t release_cnt = busy_count + new_cnt;
+        if (busy != nullptr) {
+            const size_t busy_index = size_t(busy - _buffer->base());
+            release_cnt = std::min(release_cnt, (busy_index + _buffer->count() - pkt_first) % _buffer->count());
+        }
+        busy_count = busy_count + new_cnt - release_cnt;
+
         // Pass free buffers to input processor.
         // Do not transmit bitrate or input end to next (since next is input processor).
-        aborted = !passPackets(pkt_cnt, 0, false, aborted);
+        aborted = !passPackets(release_cnt, 0, false, aborted);
 
     } while (!aborted);
 
@@ -177,4 +198,8 @@ void ts::tsp::OutputExecutor::main()
     _output->stop();
 
     debug(u"output thread %s after %'d packets (%'d output)", {aborted ? u"aborted" : u"terminated", totalPacketsInThread(), output_packets});
+    _completed = true;
+
+    // Notify the application that the TS processing is completed.
+    signalPluginEvent(TSProcessor::COMPLETED_EVENT);
 }
@@ -71,8 +71,15 @@ namespace ts {
             // Overridden methods.
             virtual size_t pluginIndex() const override;
 
+            //!
+            //! Check if the output thread has completed its processing.
+            //! @return True when the output thread has stopped the output plugin.
+            //!
+            bool isCompleted() const { return _completed; }
+
         private:
             OutputPlugin* _output;
+            volatile bool _completed;
 
             // Inherited from Thread
             virtual void main() override;
@@ -31,6 +31,7 @@
 #include "tsPluginRepository.h"
 #include "tsGuardCondition.h"
 #include "tsGuardMutex.h"
+#include "tsjsonObject.h"
 TSDUCK_SOURCE;
 
 
@@ -56,9 +57,20 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _pkt_first(0),
     _pkt_cnt(0),
     _input_end(false),
-    _bitrate(0),
+    _bitrate(BitRate(0)),
+    _sleeping(false),
     _restart(false),
-    _restart_data()
+    _restart_data(),
+    _stats_clock(),
+    _stats_origin(),
+    _stats_started(false),
+    _stats_active(0),
+    _stats_packets(0),
+    _stats_total(0),
+    _stats_elapsed(0),
+    _stats_process(),
+    _stats_wait(),
+    _stats_buffer()
 {
     // Preset common default options.
     if (plugin() != nullptr) {
@@ -115,6 +127,11 @@ bool ts::tsp::PluginExecutor::isRealTime() const
     return plugin() != nullptr && plugin()->isRealTime();
 }
 
+size_t ts::tsp::PluginExecutor::threadCount() const
+{
+    return 1 + (plugin() == nullptr ? 0 : plugin()->threadCount());
+}
+
 
 //----------------------------------------------------------------------------
 // Set the initial state of the buffer.
@@ -152,6 +169,13 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", {count, bitrate, input_end, aborted});
 
+    // Statistics: account the processing time of the passed packets.
+    statsProcessed();
+
+    if (_options.lock_free) {
+        return passPacketsLockFree(count, bitrate, input_end, aborted);
+    }
+
     // We access data under the protection of the global mutex.
     GuardMutex lock(_global_mutex);
 
@@ -189,6 +213,53 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 }
 
 
+//----------------------------------------------------------------------------
+// Lock-free version of passPackets().
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::passPacketsLockFree(size_t count, BitRate bitrate, bool input_end, bool aborted)
+{
+    // Update our buffer. Only this thread modifies _pkt_first.
+    _pkt_first = (_pkt_first + count) % _buffer->count();
+    _pkt_cnt -= count;
+
+    // Publish the packets to the next processor. The order of the atomic updates matters:
+    // the bitrate is published with the packets and the end of input is published after
+    // the last packets, so that waitWork() never sees the end of input before the last packets.
+    PluginExecutor* next = ringNext<PluginExecutor>();
+    next->_bitrate = bitrate;
+    next->_pkt_cnt += count;
+    if (input_end) {
+        next->_input_end = true;
+    }
+
+    // Wake the next processor only if it is parked on its condition. Because all atomic
+    // operations are sequentially consistent, either the next processor sees the new packets
+    // before parking or we see its _sleeping flag here. The condition is signaled under the
+    // protection of the global mutex to avoid a lost wake-up while the next processor checks
+    // its state before waiting.
+    if ((count > 0 || input_end) && next->_sleeping) {
+        GuardMutex lock(_global_mutex);
+        next->_to_do.signal();
+    }
+
+    // Force to abort our processor when the next one is aborting (see passPackets()).
+    if (plugin()->type() != PluginType::OUTPUT) {
+        aborted = aborted || next->_tsp_aborting;
+    }
+
+    // Propagate abort conditions backward. This is rare, always use the global mutex.
+    if (aborted) {
+        GuardMutex lock(_global_mutex);
+        _tsp_aborting = true;
+        ringPrevious<PluginExecutor>()->_to_do.signal();
+    }
+
+    // Return false when the current processor shall stop.
+    return !input_end && !aborted;
+}
+
+
 //----------------------------------------------------------------------------
 // Wait for packets to process or some error condition.
 //----------------------------------------------------------------------------
@@ -203,21 +274,55 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
         min_pkt_cnt = _buffer->count();
     }
 
-    // We access data under the protection of the global mutex.
-    GuardCondition lock(_global_mutex, _to_do);
-
-    PluginExecutor* next = ringNext<PluginExecutor>();
     timeout = false;
 
-    // Loop until enough packets are available (or some error condition).
-    while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
-        // If packet area for this processor is empty, wait for some packet.
-        // The mutex is implicitely released, we wait for the condition
-        // '_to_do' and, once we get it, implicitely relock the mutex.
-        // We loop on this until packets are actually available.
-        // If there is a timeout in the packet reception, call the plugin handler.
-        timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+    // Statistics: account the processing time of the previous packets.
+    const NanoSecond wait_start = statsProcessed();
+
+    if (_options.lock_free) {
+        // The global mutex is used only when the thread needs to sleep.
+        waitWorkLockFree(min_pkt_cnt, timeout);
+        getWork(min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout);
     }
+    else {
+        // We access data under the protection of the global mutex.
+        GuardCondition lock(_global_mutex, _to_do);
+
+        // Loop until enough packets are available (or some error condition).
+        while (!workAvailable(min_pkt_cnt) && !timeout) {
+            // If packet area for this processor is empty, wait for some packet.
+            // The mutex is implicitely released, we wait for the condition
+            // '_to_do' and, once we get it, implicitely relock the mutex.
+            // We loop on this until packets are actually available.
+            // If there is a timeout in the packet reception, call the plugin handler.
+            timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+        }
+
+        getWork(min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout);
+    }
+
+    // Statistics: waiting time and available packets.
+    _stats_clock.getSystemTime();
+    _stats_active = _stats_clock - _stats_origin;
+    _stats_wait.record(uint64_t(std::max<NanoSecond>(0, _stats_active - wait_start)));
+    _stats_buffer.record(_pkt_cnt);
+    _stats_elapsed = _stats_active;
+
+    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
+        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+}
+
+
+//----------------------------------------------------------------------------
+// Get the description of the work to do, after waiting in waitWork().
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::getWork(size_t min_pkt_cnt, size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted, bool timeout) const
+{
+    // Get a snapshot of the shared state. In lock-free mode, the end of input must be read
+    // before the packet count since the previous processor publishes them in reverse order.
+    const bool end = _input_end;
+    const size_t cnt = _pkt_cnt;
 
     // The number of returned packets is limited up to the wrap-up point of the circular buffer,
     // if allowed by the requested minimum number of packets.
@@ -227,24 +332,44 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     }
     else if (_pkt_first + min_pkt_cnt <= _buffer->count()) {
         // Return up to the wrap-up point. This will satisfy the requested minimum.
-        pkt_cnt = std::min(_pkt_cnt, _buffer->count() - _pkt_first);
+        pkt_cnt = std::min(cnt, _buffer->count() - _pkt_first);
     }
     else {
         // The requested minimum does not fit into a contiguous area.
-        pkt_cnt = _pkt_cnt;
+        pkt_cnt = cnt;
     }
 
     pkt_first = _pkt_first;
     bitrate = _bitrate;
-    input_end = _input_end && pkt_cnt == _pkt_cnt;
+    input_end = end && pkt_cnt == cnt;
 
     // Force to abort our processor when the next one is aborting.
     // Don't do that if current is output and next is input because
     // there is no propagation of packets from output back to input.
-    aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
+    aborted = plugin()->type() != PluginType::OUTPUT && ringNext<PluginExecutor>()->_tsp_aborting;
+}
 
-    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
-        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+
+//----------------------------------------------------------------------------
+// Lock-free version of the wait in waitWork().
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::waitWorkLockFree(size_t min_pkt_cnt, bool& timeout)
+{
+    // First, spin a bit, yielding the CPU, waiting for the previous processor.
+    for (size_t spin = 0; spin < _options.lock_free_spin && !workAvailable(min_pkt_cnt); ++spin) {
+        Thread::Yield();
+    }
+
+    // Then, park the thread on its condition. The global mutex is used only here.
+    if (!workAvailable(min_pkt_cnt)) {
+        GuardCondition lock(_global_mutex, _to_do);
+        _sleeping = true;
+        while (!workAvailable(min_pkt_cnt) && !timeout) {
+            timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+        }
+        _sleeping = false;
+    }
 }
 
 
@@ -395,3 +520,72 @@ bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
     debug(u"restarted plugin %s, status: %s", {pluginName(), success});
     return success;
 }
+
+
+//----------------------------------------------------------------------------
+// Account the processing time of the packets since the last mark.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::tsp::PluginExecutor::statsProcessed()
+{
+    // The time since the last mark (return from waitWork() or passPackets()) was spent processing
+    // packets. The clock is read only once or twice per group of packets, the cost is amortized.
+    _stats_clock.getSystemTime();
+    if (!_stats_started) {
+        _stats_origin = _stats_clock;
+        _stats_started = true;
+    }
+    const NanoSecond now = _stats_clock - _stats_origin;
+    const PacketCounter total = totalPacketsInThread();
+    if (total > _stats_packets) {
+        const PacketCounter count = total - _stats_packets;
+        _stats_process.record(uint64_t(std::max<NanoSecond>(0, now - _stats_active)) / count, count);
+        _stats_packets = total;
+        _stats_total = total;
+    }
+    _stats_active = now;
+    _stats_elapsed = now;
+    return now;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the execution statistics of the plugin thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Add the summary of a histogram in a JSON object.
+    void HistogramToJSON(ts::json::Value& obj, const ts::LatencyHistogram& histo)
+    {
+        obj.add(u"count", int64_t(histo.count()));
+        obj.add(u"min", int64_t(histo.minimum()));
+        obj.add(u"mean", int64_t(histo.mean()));
+        obj.add(u"p50", int64_t(histo.percentile(50.0)));
+        obj.add(u"p90", int64_t(histo.percentile(90.0)));
+        obj.add(u"p99", int64_t(histo.percentile(99.0)));
+        obj.add(u"p999", int64_t(histo.percentile(99.9)));
+        obj.add(u"max", int64_t(histo.maximum()));
+    }
+}
+
+void ts::tsp::PluginExecutor::getStatistics(json::Value& stats) const
+{
+    const PacketCounter packets = _stats_total;
+    const NanoSecond elapsed = _stats_elapsed;
+    const uint64_t busy = _stats_process.sum();
+    const uint64_t idle = _stats_wait.sum();
+
+    stats.add(u"index", int64_t(pluginIndex()));
+    stats.add(u"name", pluginName());
+    if (plugin() != nullptr) {
+        stats.add(u"type", PluginTypeNames.name(plugin()->type()));
+    }
+    stats.add(u"suspended", json::Bool(_suspended));
+    stats.add(u"packets", int64_t(packets));
+    stats.add(u"elapsed-ms", elapsed / NanoSecPerMilliSec);
+    stats.add(u"packets-per-second", elapsed <= 0 ? 0 : int64_t((double(packets) * NanoSecPerSec) / double(elapsed)));
+    stats.add(u"busy-percent", busy + idle == 0 ? 0 : int64_t((100 * busy) / (busy + idle)));
+    HistogramToJSON(stats.value(u"process-ns-per-packet", true), _stats_process);
+    HistogramToJSON(stats.value(u"wait-ns", true), _stats_wait);
+    HistogramToJSON(stats.value(u"buffer-packets", true), _stats_buffer);
+}
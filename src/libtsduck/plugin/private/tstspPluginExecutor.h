@@ -38,6 +38,9 @@
 #include "tsTSProcessorArgs.h"
 #include "tsPluginEventHandlerRegistry.h"
 #include "tsPlugin.h"
+#include "tsLatencyHistogram.h"
+#include "tsMonotonic.h"
+#include "tsjson.h"
 #include "tsUserInterrupt.h"
 #include "tsCondition.h"
 #include "tsMutex.h"
@@ -112,6 +115,13 @@ namespace ts {
             //!
             bool isRealTime() const;
 
+            //!
+            //! Get the number of threads which are used by this plugin executor.
+            //! This includes the thread of the executor and the internal threads of the plugin.
+            //! @return The number of threads which are used by this plugin executor.
+            //!
+            virtual size_t threadCount() const;
+
             //!
             //! Set the plugin in suspended more or resume it.
             //! When suspended, a plugin no longer processes packets.
@@ -143,6 +153,49 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Get the execution statistics of the plugin thread.
+            //! The statistics are collected in waitWork() and passPackets(): the time which is spent
+            //! outside waitWork() is the processing time of the packets, the time which is spent inside
+            //! is the time waiting for packets (or free space in the buffer for the input plugin).
+            //! This method can be called from any thread.
+            //! @param [in,out] stats JSON object receiving the statistics.
+            //!
+            void getStatistics(json::Value& stats) const;
+
+            //!
+            //! Get the total number of packets which went through the plugin thread.
+            //! This method can be called from any thread.
+            //! @return The total number of packets at the last call to waitWork() or passPackets().
+            //!
+            PacketCounter statisticsPackets() const { return _stats_total; }
+
+            //!
+            //! Get the running time of the plugin thread.
+            //! This method can be called from any thread.
+            //! @return The number of nanoseconds between the first and last calls to waitWork() or passPackets().
+            //!
+            NanoSecond statisticsElapsed() const { return _stats_elapsed; }
+
+            //!
+            //! Get the histogram of processing time per packet.
+            //! @return A constant reference to the histogram of processing time per packet in nanoseconds.
+            //!
+            const LatencyHistogram& processTimeHistogram() const { return _stats_process; }
+
+            //!
+            //! Get the histogram of waiting time in waitWork().
+            //! @return A constant reference to the histogram of waiting time per call in nanoseconds.
+            //!
+            const LatencyHistogram& waitTimeHistogram() const { return _stats_wait; }
+
+            //!
+            //! Get the histogram of buffer occupancy.
+            //! @return A constant reference to the histogram of the number of packets which are
+            //! available to the plugin (free space for the input plugin) when waitWork() returns.
+            //!
+            const LatencyHistogram& bufferHistogram() const { return _stats_buffer; }
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -152,6 +205,14 @@ namespace ts {
             PacketMetadataBuffer* _metadata;  //!< Description of shared packet metadata buffer.
             volatile bool         _suspended; //!< The plugin is suspended / resumed.
 
+            //!
+            //! Get the current number of packets in the area of this plugin, without waiting.
+            //! For the input plugin, this is the free space in the global packet buffer.
+            //! The value may increase concurrently when the previous plugin passes packets.
+            //! @return The current number of packets in the area of this plugin.
+            //!
+            size_t areaPackets() const { return _pkt_cnt; }
+
             //!
             //! Pass processed packets to the next packet processor.
             //!
@@ -222,13 +283,44 @@ namespace ts {
             // The following private data must be accessed exclusively under the protection of the global mutex.
             // Implementation details: see the file src/docs/developing-plugins.dox.
             // [*] After initialization, these fields are read/written only in passPackets() and waitWork().
-            Condition      _to_do;         // Notify processor to do something.
-            size_t         _pkt_first;     // Starting index of packets area [*]
-            size_t         _pkt_cnt;       // Size of packets area [*]
-            bool           _input_end;     // No more packet after current ones [*]
-            BitRate        _bitrate;       // Input bitrate (set by previous plugin) [*]
-            bool           _restart;       // Restart the plugin asap using _restart_data
-            RestartDataPtr _restart_data;  // How to restart the plugin
+            // [+] In lock-free mode, these fields are accessed without the global mutex, hence the atomics.
+            Condition            _to_do;         // Notify processor to do something.
+            size_t               _pkt_first;     // Starting index of packets area [*] (modified by this thread only)
+            std::atomic<size_t>  _pkt_cnt;       // Size of packets area [*] [+]
+            std::atomic<bool>    _input_end;     // No more packet after current ones [*] [+]
+            std::atomic<BitRate> _bitrate;       // Input bitrate (set by previous plugin) [*] [+]
+            std::atomic<bool>    _sleeping;      // Lock-free mode: the thread is about to wait or waits on _to_do [+]
+            bool                 _restart;       // Restart the plugin asap using _restart_data
+            RestartDataPtr       _restart_data;  // How to restart the plugin
+
+            // Execution statistics, collected in waitWork() and passPackets() by the plugin thread only.
+            // The histograms and atomic fields can be read from any thread.
+            Monotonic                  _stats_clock;    // Clock reader.
+            Monotonic                  _stats_origin;   // Time of first call to waitWork().
+            bool                       _stats_started;  // First call to waitWork() done.
+            NanoSecond                 _stats_active;   // Time of last processing mark, relative to origin.
+            PacketCounter              _stats_packets;  // Total packets in thread at last processing mark.
+            std::atomic<PacketCounter> _stats_total;    // Same as _stats_packets, for other threads.
+            std::atomic<NanoSecond>    _stats_elapsed;  // Same as _stats_active, for other threads.
+            LatencyHistogram           _stats_process;  // Processing time per packet in nanoseconds.
+            LatencyHistogram           _stats_wait;     // Waiting time per call to waitWork() in nanoseconds.
+            LatencyHistogram           _stats_buffer;   // Available packets when waitWork() returns.
+
+            // Account the processing time of the packets since the last mark, return the current time.
+            NanoSecond statsProcessed();
+
+            // Lock-free versions of passPackets() and waitWork(), when TSProcessorArgs::lock_free is set.
+            bool passPacketsLockFree(size_t count, BitRate bitrate, bool input_end, bool aborted);
+            void waitWorkLockFree(size_t min_pkt_cnt, bool& timeout);
+
+            // Get the description of the work to do, after waiting in waitWork().
+            void getWork(size_t min_pkt_cnt, size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted, bool timeout) const;
+
+            // Check if waitWork() can return without waiting.
+            bool workAvailable(size_t min_pkt_cnt) const
+            {
+                return _pkt_cnt >= min_pkt_cnt || _input_end || ringNext<PluginExecutor>()->_tsp_aborting;
+            }
 
             // Description of a restart operation.
             class RestartData
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tstspProcessorExecutor.h"
+#include "tsPluginRepository.h"
 TSDUCK_SOURCE;
 
 
@@ -44,7 +45,8 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(const TSProcessorArgs& options,
 
     PluginExecutor(options, handlers, PluginType::PROCESSOR, options.plugins[plugin_index], attributes, global_mutex, report),
     _processor(dynamic_cast<ProcessorPlugin*>(PluginThread::plugin())),
-    _plugin_index(1 + plugin_index) // include first input plugin in the count
+    _plugin_index(1 + plugin_index), // include first input plugin in the count
+    _shards()
 {
     if (options.log_plugin_index) {
         // Make sure that plugins display their index.
@@ -55,6 +57,7 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(const TSProcessorArgs& options,
 ts::tsp::ProcessorExecutor::~ProcessorExecutor()
 {
     waitForTermination();
+    deleteShards();
 }
 
 
@@ -68,6 +71,20 @@ size_t ts::tsp::ProcessorExecutor::pluginIndex() const
 }
 
 
+//----------------------------------------------------------------------------
+// Number of threads of this plugin executor, including the PID shards.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::ProcessorExecutor::threadCount() const
+{
+    // Each PID shard is a thread with its own instance of the plugin. Use the same
+    // conditions as main(), the shards may be not yet created by the executor thread.
+    const bool sharded = _options.pid_shards > 1 && _processor->getPacketWindowSize() == 0 && _processor->isPIDShardable();
+    const size_t shards = sharded ? _options.pid_shards : 1;
+    return shards * PluginExecutor::threadCount();
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processor plugin thread
 //----------------------------------------------------------------------------
@@ -90,8 +107,16 @@ void ts::tsp::ProcessorExecutor::main()
         window_size = _processor->getPacketWindowSize();
     }
 
-    // Perform the complete packet processing in individual-packet or packet-window mode.
-    if (window_size == 0) {
+    // Check if the plugin shall be run in several PID shards.
+    if (window_size == 0 && _options.pid_shards > 1 && _processor->isPIDShardable()) {
+        createShards();
+    }
+
+    // Perform the complete packet processing in individual-packet, PID-shard or packet-window mode.
+    if (!_shards.empty()) {
+        processShardedPackets();
+    }
+    else if (window_size == 0) {
         processIndividualPackets();
     }
     else {
@@ -100,10 +125,82 @@ void ts::tsp::ProcessorExecutor::main()
 
     // Close the packet processor.
     debug(u"stopping the plugin");
+    deleteShards();
     _processor->stop();
 }
 
 
+//----------------------------------------------------------------------------
+// Create the PID shards.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::createShards()
+{
+    deleteShards();
+
+    // The first shard uses the main plugin instance and runs in the plugin executor thread.
+    _shards.push_back(new ProcessorShard(_processor, false));
+
+    // Other shards use their own plugin instance with the same command line options.
+    PluginRepository::ProcessorPluginFactory allocator = PluginRepository::Instance()->getProcessor(pluginName(), *this);
+    UStringVector args;
+    _processor->getCommandArgs(args);
+
+    while (allocator != nullptr && _shards.size() < _options.pid_shards) {
+        ProcessorPlugin* shlib = allocator(this);
+        if (shlib == nullptr) {
+            break;
+        }
+        shlib->resetContext(_options.duck_args);
+        shlib->setShell(_processor->getShell());
+        shlib->setMaxSeverity(maxSeverity());
+        shlib->setFlags(shlib->getFlags() | Args::NO_HELP | Args::NO_EXIT_ON_ERROR);
+        ProcessorShard* shard = new ProcessorShard(shlib, true);
+        if (!shlib->analyze(pluginName(), args, false) || !shlib->getOptions() || !shlib->start()) {
+            delete shard;
+            break;
+        }
+        ThreadAttributes attr;
+        getAttributes(attr);
+        attr.setStackSize(STACK_SIZE_OVERHEAD + shlib->stackUsage());
+        if (!shard->setAttributes(attr) || !shard->start()) {
+            shlib->stop();
+            delete shard;
+            break;
+        }
+        _shards.push_back(shard);
+    }
+
+    if (_shards.size() < _options.pid_shards) {
+        warning(u"could create only %d PID shards out of %d", {_shards.size(), _options.pid_shards});
+    }
+    if (_shards.size() < 2) {
+        // Only the main plugin instance, no need for sharding.
+        deleteShards();
+    }
+    else {
+        verbose(u"processing packets in %d PID shards", {_shards.size()});
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Delete the PID shards.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::deleteShards()
+{
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        // Stop additional plugin instances only, the main one is stopped by the executor.
+        if (i > 0) {
+            _shards[i]->plugin()->stop();
+        }
+        delete _shards[i];
+    }
+    _shards.clear();
+}
+
+
 //----------------------------------------------------------------------------
 // Process packets one by one.
 //----------------------------------------------------------------------------
@@ -427,3 +524,141 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
     debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
           {input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets});
 }
+
+
+//----------------------------------------------------------------------------
+// Process packets in several PID shards in parallel.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::processShardedPackets()
+{
+    TSPacketMetadata::LabelSet only_labels(_processor->getOnlyLabelOption());
+    PacketCounter passed_packets = 0;
+    PacketCounter dropped_packets = 0;
+    PacketCounter nullified_packets = 0;
+    BitRate output_bitrate = _tsp_bitrate;
+    bool bitrate_never_modified = true;
+    bool input_end = false;
+    bool aborted = false;
+    bool restarted = false;
+
+    do {
+        // Wait for packets to process
+        size_t pkt_first = 0;
+        size_t pkt_cnt = 0;
+        bool timeout = false;
+        waitWork(1, pkt_first, pkt_cnt, _tsp_bitrate, input_end, aborted, timeout);
+
+        // If bitrate was never modified by the plugin, always copy the input bitrate as output bitrate.
+        // Otherwise, keep previous output bitrate, as modified by the plugin.
+        if (bitrate_never_modified) {
+            output_bitrate = _tsp_bitrate;
+        }
+
+        // Process restart requests.
+        if (!processPendingRestart(restarted)) {
+            timeout = true; // restart error
+        }
+        else if (restarted) {
+            // Plugin was restarted, need to recheck --only-label and restart all other shards with the new options.
+            // If the plugin is no longer shardable, we continue with the main plugin instance as unique shard.
+            only_labels = _processor->getOnlyLabelOption();
+            if (_options.pid_shards > 1 && _processor->isPIDShardable()) {
+                createShards();
+            }
+            else {
+                deleteShards();
+            }
+            if (_shards.empty()) {
+                _shards.push_back(new ProcessorShard(_processor, false));
+            }
+        }
+
+        // In case of abort on timeout, notify previous and next plugin, then exit.
+        if (timeout) {
+            passPackets(0, output_bitrate, true, true);
+            break;
+        }
+
+        // If next processor has aborted, abort as well.
+        // We call passPacket to inform our predecessor that we aborted.
+        if (aborted && !input_end) {
+            passPackets(0, output_bitrate, true, true);
+            break;
+        }
+
+        // Exit thread if no more packet to process.
+        // We call passPackets to inform our successor of end of input.
+        if (pkt_cnt == 0 && input_end) {
+            passPackets(0, output_bitrate, true, false);
+            break;
+        }
+
+        // Do not process too many packets at a time before notifying the next processor.
+        if (_options.max_flush_pkt > 0 && pkt_cnt > _options.max_flush_pkt) {
+            pkt_cnt = _options.max_flush_pkt;
+            input_end = false;
+        }
+
+        // When the plugin is suspended, simply pass the packets to the next plugin.
+        if (_suspended) {
+            addNonPluginPackets(pkt_cnt);
+            aborted = !passPackets(pkt_cnt, output_bitrate, input_end, aborted);
+            continue;
+        }
+
+        // Dispatch the packets to the shards. This is done here, before starting the shards,
+        // because a plugin may modify the PID of a packet while another shard looks for its PID.
+        TSPacket* const pkt_base = _buffer->base() + pkt_first;
+        TSPacketMetadata* const data_base = _metadata->base() + pkt_first;
+        for (auto it = _shards.begin(); it != _shards.end(); ++it) {
+            (*it)->clearWork(pkt_base, data_base);
+        }
+        for (size_t i = 0; i < pkt_cnt; ++i) {
+            if (pkt_base[i].b[0] == 0 || (only_labels.any() && !data_base[i].hasAnyLabel(only_labels))) {
+                // The packet has already been dropped by a previous packet processor or is excluded by --only-label.
+                addNonPluginPackets(1);
+            }
+            else {
+                _shards[pkt_base[i].getPID() % _shards.size()]->addPacket(i);
+            }
+        }
+
+        // Process the packets in all shards. The first shard executes in this thread.
+        for (size_t i = 1; i < _shards.size(); ++i) {
+            _shards[i]->startProcess();
+        }
+        _shards[0]->process();
+        for (size_t i = 1; i < _shards.size(); ++i) {
+            _shards[i]->waitProcess();
+        }
+
+        // Collect the results of all shards.
+        size_t end_index = NPOS;
+        for (auto it = _shards.begin(); it != _shards.end(); ++it) {
+            const ProcessorShard& shard(**it);
+            end_index = std::min(end_index, shard.endIndex());
+            addPluginPackets(shard.pluginPackets);
+            passed_packets += shard.passedPackets;
+            dropped_packets += shard.droppedPackets;
+            nullified_packets += shard.nullifiedPackets;
+            if (shard.newBitrate != 0) {
+                bitrate_never_modified = false;
+                output_bitrate = shard.newBitrate;
+            }
+        }
+
+        // If the plugin requested termination in a shard, do not pass the packets after that one.
+        if (end_index < pkt_cnt) {
+            debug(u"plugin requests termination");
+            input_end = aborted = true;
+            pkt_cnt = end_index;
+        }
+
+        aborted = !passPackets(pkt_cnt, output_bitrate, input_end, aborted);
+
+    } while (!input_end && !aborted);
+
+    debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
+          {input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets});
+}
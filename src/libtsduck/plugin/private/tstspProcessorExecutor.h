@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tstspPluginExecutor.h"
+#include "tstspProcessorShard.h"
 #include "tsProcessorPlugin.h"
 
 namespace ts {
@@ -70,17 +71,24 @@ namespace ts {
 
             // Overridden methods.
             virtual size_t pluginIndex() const override;
+            virtual size_t threadCount() const override;
 
         private:
-            ProcessorPlugin* _processor;
-            const size_t     _plugin_index;
+            ProcessorPlugin*             _processor;
+            const size_t                 _plugin_index;
+            std::vector<ProcessorShard*> _shards;  // PID shards, the first one uses _processor, empty if not sharded.
 
             // Inherited from Thread
             virtual void main() override;
 
-            // Process packets one by one or using packet windows.
+            // Process packets one by one, using packet windows or using PID shards.
             void processIndividualPackets();
             void processPacketWindows(size_t window_size);
+            void processShardedPackets();
+
+            // Create or delete the PID shards.
+            void createShards();
+            void deleteShards();
         };
     }
 }
@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspProcessorShard.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::tsp::ProcessorShard::ProcessorShard(ProcessorPlugin* plugin, bool owner) :
+    Thread(),
+    pluginPackets(0),
+    passedPackets(0),
+    droppedPackets(0),
+    nullifiedPackets(0),
+    newBitrate(0),
+    _plugin(plugin),
+    _owner(owner),
+    _packets(nullptr),
+    _metadata(nullptr),
+    _indexes(),
+    _end_index(NPOS),
+    _mutex(),
+    _work_to_do(),
+    _work_done(),
+    _pending(false),
+    _terminate(false)
+{
+}
+
+ts::tsp::ProcessorShard::~ProcessorShard()
+{
+    // Terminate the shard thread, if started.
+    {
+        GuardCondition lock(_mutex, _work_to_do);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+
+    if (_owner && _plugin != nullptr) {
+        delete _plugin;
+    }
+    _plugin = nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the list of packets to process.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorShard::clearWork(TSPacket* packets, TSPacketMetadata* metadata)
+{
+    _packets = packets;
+    _metadata = metadata;
+    _indexes.clear();
+    _end_index = NPOS;
+    pluginPackets = passedPackets = droppedPackets = nullifiedPackets = 0;
+    newBitrate = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Process all packets of this shard in the context of the calling thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorShard::process()
+{
+    for (auto it = _indexes.begin(); it != _indexes.end(); ++it) {
+
+        TSPacket* const pkt = _packets + *it;
+        TSPacketMetadata* const pkt_data = _metadata + *it;
+
+        // Apply the processing routine to the packet
+        const bool was_null = pkt->getPID() == PID_NULL;
+        pkt_data->setFlush(false);
+        pkt_data->setBitrateChanged(false);
+        const ProcessorPlugin::Status status = _plugin->processPacket(*pkt, *pkt_data);
+        pluginPackets++;
+
+        // Use the returned status
+        switch (status) {
+            case ProcessorPlugin::TSP_OK:
+                // Normal case, pass packet
+                passedPackets++;
+                break;
+            case ProcessorPlugin::TSP_NULL:
+                // Replace the packet with a complete null packet
+                *pkt = NullPacket;
+                break;
+            case ProcessorPlugin::TSP_DROP:
+                // Drop this packet.
+                pkt->b[0] = 0;
+                droppedPackets++;
+                break;
+            case ProcessorPlugin::TSP_END:
+                // Stop processing this shard. The plugin executor will stop after this packet.
+                pluginPackets--;
+                _end_index = *it;
+                return;
+            default:
+                // Invalid status, report error and accept packet.
+                _plugin->error(u"invalid packet processing status %d", {status});
+                break;
+        }
+
+        // Detect if the packet was nullified by the plugin, either by returning TSP_NULL or by overwriting the packet.
+        if (!was_null && pkt->getPID() == PID_NULL) {
+            pkt_data->setNullified(true);
+            nullifiedPackets++;
+        }
+
+        // If the packet processor has signaled a new bitrate, get it.
+        if (pkt_data->getBitrateChanged()) {
+            const BitRate bitrate = _plugin->getBitrate();
+            if (bitrate != 0) {
+                newBitrate = bitrate;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Asynchronous processing in the shard thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorShard::startProcess()
+{
+    GuardCondition lock(_mutex, _work_to_do);
+    _pending = true;
+    lock.signal();
+}
+
+void ts::tsp::ProcessorShard::waitProcess()
+{
+    GuardCondition lock(_mutex, _work_done);
+    while (_pending) {
+        lock.waitCondition();
+    }
+}
+
+void ts::tsp::ProcessorShard::main()
+{
+    for (;;) {
+        // Wait for something to do.
+        {
+            GuardCondition lock(_mutex, _work_to_do);
+            while (!_pending && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_terminate) {
+                break;
+            }
+        }
+
+        // Process the packets outside the mutex.
+        process();
+
+        // Signal the end of processing to the plugin executor.
+        GuardCondition lock(_mutex, _work_done);
+        _pending = false;
+        lock.signal();
+    }
+}
@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Execution context of a PID shard of a packet processor plugin
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsProcessorPlugin.h"
+#include "tsCondition.h"
+#include "tsMutex.h"
+#include "tsThread.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Execution context of a PID shard of a PID-shardable tsp packet processor plugin.
+        //!
+        //! When a packet processor plugin is PID-shardable (see ProcessorPlugin::isPIDShardable()),
+        //! tsp may run several instances of it. Each instance processes a disjoint subset of PID's
+        //! in the same area of the global packet buffer. Each shard executes in its own thread,
+        //! except the first one which is executed in the thread of the plugin executor.
+        //!
+        //! This class is internal to the TSDuck library and cannot be called by applications.
+        //! @ingroup plugin
+        //!
+        class ProcessorShard: public Thread
+        {
+            TS_NOBUILD_NOCOPY(ProcessorShard);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] plugin The plugin instance which processes the packets of this shard.
+            //! @param [in] owner If true, the plugin instance is owned and deleted by this object.
+            //!
+            ProcessorShard(ProcessorPlugin* plugin, bool owner);
+
+            //!
+            //! Destructor.
+            //! The shard thread is terminated and the plugin instance is deleted if owned by this object.
+            //!
+            virtual ~ProcessorShard() override;
+
+            //!
+            //! Get the plugin instance of this shard.
+            //! @return The plugin instance of this shard.
+            //!
+            ProcessorPlugin* plugin() const { return _plugin; }
+
+            //!
+            //! Clear the list of packets to process.
+            //! @param [in] packets Address of first packet of the area to process.
+            //! @param [in] metadata Address of first packet metadata of the area to process.
+            //!
+            void clearWork(TSPacket* packets, TSPacketMetadata* metadata);
+
+            //!
+            //! Add a packet to process in this shard.
+            //! @param [in] index Index of the packet, relative to @a packets in clearWork().
+            //!
+            void addPacket(size_t index) { _indexes.push_back(index); }
+
+            //!
+            //! Process all packets of this shard in the context of the calling thread.
+            //!
+            void process();
+
+            //!
+            //! Start processing all packets of this shard in the context of the shard thread.
+            //!
+            void startProcess();
+
+            //!
+            //! Wait for the completion of the processing which was started by startProcess().
+            //!
+            void waitProcess();
+
+            //!
+            //! Index of the first packet for which the plugin returned TSP_END.
+            //! @return Index of the packet, relative to @a packets in clearWork(), or NPOS if there is none.
+            //!
+            size_t endIndex() const { return _end_index; }
+
+            PacketCounter pluginPackets;     //!< Number of packets which were processed by the plugin.
+            PacketCounter passedPackets;     //!< Number of packets which were passed.
+            PacketCounter droppedPackets;    //!< Number of packets which were dropped.
+            PacketCounter nullifiedPackets;  //!< Number of packets which were nullified.
+            BitRate       newBitrate;        //!< New bitrate which was signaled by the plugin (zero if none).
+
+        private:
+            ProcessorPlugin*    _plugin;      // Plugin instance.
+            const bool          _owner;       // The plugin instance is owned by this object.
+            TSPacket*           _packets;     // Base of packet area.
+            TSPacketMetadata*   _metadata;    // Base of packet metadata area.
+            std::vector<size_t> _indexes;     // Indexes of packets to process.
+            size_t              _end_index;   // Index of first packet with TSP_END.
+            Mutex               _mutex;       // Protect the following fields.
+            Condition           _work_to_do;  // Signaled by the plugin executor when there is some work.
+            Condition           _work_done;   // Signaled by the shard thread when the work is done.
+            bool                _pending;     // A processing is pending.
+            bool                _terminate;   // The shard thread shall terminate.
+
+            // Inherited from Thread.
+            virtual void main() override;
+        };
+    }
+}
@@ -0,0 +1,175 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspStatisticsReporter.h"
+#include "tsjsonObject.h"
+#include "tsGuardMutex.h"
+#include "tsGuardCondition.h"
+#include "tsTextFormatter.h"
+#include "tsTime.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::StatisticsReporter::StatisticsReporter(const TSProcessorArgs& options, Report& log, PluginExecutor* input) :
+    Thread(ThreadAttributes().setStackSize(128 * 1024)),
+    _options(options),
+    _log(log, u"statistics: "),
+    _input(input),
+    _mutex(),
+    _wake_up(),
+    _started(false),
+    _terminate(false),
+    _file()
+{
+}
+
+ts::tsp::StatisticsReporter::~StatisticsReporter()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Start/stop the periodic reports.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::StatisticsReporter::open()
+{
+    if (_options.stats_interval <= 0 || _input == nullptr || _started) {
+        return true;
+    }
+    if (!_options.stats_file.empty()) {
+        _file.open(_options.stats_file.toUTF8().c_str(), std::ios::out | std::ios::app);
+        if (!_file) {
+            _log.error(u"cannot create %s", {_options.stats_file});
+            return false;
+        }
+    }
+    _started = start();
+    return _started;
+}
+
+void ts::tsp::StatisticsReporter::close()
+{
+    if (_started) {
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            _terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+        _started = false;
+    }
+    if (_file.is_open()) {
+        _file.close();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a JSON description of the execution statistics of all plugins.
+//----------------------------------------------------------------------------
+
+void ts::tsp::StatisticsReporter::BuildJSON(PluginExecutor* input, json::Value& root)
+{
+    root.add(u"time", Time::CurrentLocalTime().format(Time::DATETIME));
+    json::Value& plugins(root.value(u"plugins", true, json::Type::Array));
+    PluginExecutor* proc = input;
+    do {
+        json::ValuePtr stats(new json::Object);
+        proc->getStatistics(*stats);
+        plugins.set(stats);
+    } while ((proc = proc->ringNext<PluginExecutor>()) != input);
+}
+
+
+//----------------------------------------------------------------------------
+// Statistics thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::StatisticsReporter::main()
+{
+    _log.debug(u"statistics thread started");
+
+    // Packet counts and time at previous report, for the rates on the last interval.
+    std::vector<PacketCounter> previous_packets;
+    std::vector<NanoSecond> previous_elapsed;
+
+    for (;;) {
+        // Wait for the next report time or termination.
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            if (!_terminate) {
+                lock.waitCondition(_options.stats_interval);
+            }
+            if (_terminate) {
+                break;
+            }
+        }
+
+        // Build the statistics of all plugins.
+        json::Object root;
+        BuildJSON(_input, root);
+
+        // Add packet rates on the last interval.
+        json::Value& plugins(root.value(u"plugins"));
+        previous_packets.resize(plugins.size(), 0);
+        previous_elapsed.resize(plugins.size(), 0);
+        size_t index = 0;
+        PluginExecutor* proc = _input;
+        do {
+            const PacketCounter packets = proc->statisticsPackets();
+            const NanoSecond elapsed = proc->statisticsElapsed();
+            const NanoSecond duration = elapsed - previous_elapsed[index];
+            const PacketCounter count = packets - std::min(packets, previous_packets[index]);
+            plugins.at(index).add(u"interval-packets-per-second", duration <= 0 ? 0 : int64_t((double(count) * NanoSecPerSec) / double(duration)));
+            previous_packets[index] = packets;
+            previous_elapsed[index] = elapsed;
+            ++index;
+        } while ((proc = proc->ringNext<PluginExecutor>()) != _input && index < plugins.size());
+
+        // Format the JSON object on one line.
+        TextFormatter text(_log);
+        text.setString();
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+        root.print(text);
+        if (_file.is_open()) {
+            _file << text.toString() << std::endl;
+        }
+        else {
+            _log.info(text.toString());
+        }
+    }
+
+    _log.debug(u"statistics thread completed");
+}
@@ -52,7 +52,11 @@ ts::tsswitch::Core::Core(const InputSwitcherArgs& opt, const PluginEventHandlerR
     _curCycle(0),
     _terminate(false),
     _actions(),
-    _events()
+    _events(),
+    _nextPlugin(NPOS),
+    _switchStart(),
+    _maxLatency(0),
+    _splicer()
 {
     // Load all input plugins, analyze their options.
     for (size_t i = 0; i < _inputs.size(); ++i) {
@@ -199,7 +203,21 @@ void ts::tsswitch::Core::setInputLocked(size_t index, bool abortCurrent)
     if (index >= _inputs.size()) {
         _log.warning(u"invalid input index %d", {index});
     }
-    else if (index != _curPlugin) {
+    else if (index == _curPlugin) {
+        // Cancel any pending switch to another input.
+        _nextPlugin = NPOS;
+    }
+    else if (_opt.hotStandby) {
+        // With --hot-standby, all inputs are running. The actual switch is done by the output
+        // thread at the next random access point. See getOutputArea() and cutToNextInput().
+        if (index != _nextPlugin) {
+            _log.debug(u"switch input %d to %d on next random access point", {_curPlugin, index});
+            _nextPlugin = index;
+            _switchStart.getSystemTime();
+            _gotInput.signal();
+        }
+    }
+    else {
         _log.debug(u"switch input %d to %d", {_curPlugin, index});
 
         // The processing depends on the switching mode.
@@ -412,6 +430,7 @@ void ts::tsswitch::Core::execute(const Action& event)
             case SET_CURRENT: {
                 _eventDispatcher.signalNewInput(_curPlugin, action.index);
                 _curPlugin = action.index;
+                _nextPlugin = NPOS;
                 break;
             }
             case WAIT_STARTED:
@@ -459,19 +478,62 @@ bool ts::tsswitch::Core::getOutputArea(size_t& pluginIndex, TSPacket*& first, TS
         else {
             _inputs[_curPlugin]->getOutputArea(first, data, count);
         }
+        // With --hot-standby and a pending switch, output the current input up to its next random access point.
+        MilliSecond timeout = Infinite;
+        if (!_terminate && _nextPlugin != NPOS) {
+            const size_t rap = _inputs[_curPlugin]->firstRandomAccess(first, count);
+            const MilliSecond elapsed = (Monotonic(true) - _switchStart) / NanoSecPerMilliSec;
+            if ((rap == 0 && count > 0) || elapsed >= _opt.switchTimeout) {
+                // Release the output area of the current input and switch now.
+                _inputs[_curPlugin]->freeOutput(0);
+                cutToNextInput(rap == 0 && count > 0);
+                continue;
+            }
+            count = rap;
+            timeout = _opt.switchTimeout - elapsed;
+        }
         // Return when there is something to output in current plugin or the application terminates.
         if (count > 0 || _terminate) {
             // Tell the output plugin which input plugin is used.
             pluginIndex = _curPlugin;
+            if (_opt.hotStandby && !_terminate) {
+                _splicer.feedPackets(first, count);
+            }
             // Return false when the application terminates.
             return !_terminate;
         }
         // Otherwise, sleep on _gotInput condition.
-        lock.waitCondition();
+        lock.waitCondition(timeout);
     }
 }
 
 
+//----------------------------------------------------------------------------
+// With --hot-standby, actually switch to the next input plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsswitch::Core::cutToNextInput(bool onRandomAccess)
+{
+    const size_t next = _nextPlugin;
+    const NanoSecond latency = Monotonic(true) - _switchStart;
+    _maxLatency = std::max(_maxLatency, latency);
+
+    // Same actions as --fast-switch, without waiting.
+    enqueue(Action(SUSPEND_TIMEOUT));
+    enqueue(Action(NOTIF_CURRENT, _curPlugin, false));
+    enqueue(Action(SET_CURRENT, next));
+    enqueue(Action(NOTIF_CURRENT, next, true));
+    enqueue(Action(RESTART_TIMEOUT));
+    execute();
+
+    // Continuity counters of the new input continue the previous ones, PCR discontinuities are signaled.
+    _splicer.splice();
+
+    _log.verbose(u"switched to input %d %s in %'d microseconds (max: %'d)",
+                 {next, onRandomAccess ? u"on random access point" : u"on timeout", latency / NanoSecPerMicroSec, _maxLatency / NanoSecPerMicroSec});
+}
+
+
 //----------------------------------------------------------------------------
 // Report output packets (called by output plugin).
 //----------------------------------------------------------------------------
@@ -529,7 +591,11 @@ bool ts::tsswitch::Core::inputReceived(size_t pluginIndex)
 
     // If input is detected on the primary input and the current plugin is not this one
     // after executing all actions, then automatically switch to it.
-    if (pluginIndex == _opt.primaryInput && _curPlugin != _opt.primaryInput) {
+    if (pluginIndex == _opt.primaryInput && _curPlugin != _opt.primaryInput && _opt.hotStandby) {
+        // With --hot-standby, switch on the next random access point.
+        setInputLocked(_opt.primaryInput, false);
+    }
+    else if (pluginIndex == _opt.primaryInput && _curPlugin != _opt.primaryInput) {
         // Remove all pending actions.
         _actions.clear();
         // Define a new set of actions.
@@ -40,6 +40,8 @@
 #include "tsMutex.h"
 #include "tsCondition.h"
 #include "tsWatchDog.h"
+#include "tsContinuitySplicer.h"
+#include "tsMonotonic.h"
 
 namespace ts {
     //!
@@ -204,6 +206,10 @@ namespace ts {
             volatile bool   _terminate;        // Terminate complete processing.
             ActionQueue     _actions;          // Sequential queue list of actions to execute.
             ActionSet       _events;           // Pending events, waiting to be cleared.
+            size_t          _nextPlugin;       // With --hot-standby, next input plugin, waiting for a random access point (NPOS if none).
+            Monotonic       _switchStart;      // With --hot-standby, time of the switch request.
+            NanoSecond      _maxLatency;       // With --hot-standby, maximum switch latency.
+            ContinuitySplicer _splicer;        // With --hot-standby, keep continuity counters continuous across switches.
 
             // Names of actions for debug messages.
             static const Enumeration _actionNames;
@@ -211,6 +217,9 @@ namespace ts {
             // Change input plugin with mutex already held.
             void setInputLocked(size_t index, bool abortCurrent);
 
+            // With --hot-standby, actually switch to _nextPlugin (with mutex already held).
+            void cutToNextInput(bool onRandomAccess);
+
             // Enqueue an action (with mutex already held).
             void enqueue(const Action& action, bool highPriority = false);
 
@@ -59,7 +59,8 @@ ts::tsswitch::InputExecutor::InputExecutor(const InputSwitcherArgs& opt,
     _terminated(false),
     _outFirst(0),
     _outCount(0),
-    _start_time(true) // initialized with current system time
+    _start_time(true), // initialized with current system time
+    _rap()
 {
     // Make sure that the input plugins display their index.
     setLogName(UString::Format(u"%s[%d]", {pluginName(), _pluginIndex}));
@@ -177,6 +178,18 @@ void ts::tsswitch::InputExecutor::freeOutput(size_t count)
 }
 
 
+//----------------------------------------------------------------------------
+// Locate the first random access point in an output area.
+// Called from the output plugin with --hot-standby.
+//----------------------------------------------------------------------------
+
+size_t ts::tsswitch::InputExecutor::firstRandomAccess(const TSPacket* first, size_t count)
+{
+    GuardMutex lock(_mutex);
+    return _rap.firstRandomAccess(first, count);
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked in the context of the plugin thread.
 //----------------------------------------------------------------------------
@@ -195,6 +208,7 @@ void ts::tsswitch::InputExecutor::main()
             // Reset input buffer.
             _outFirst = 0;
             _outCount = 0;
+            _rap.reset();
             // Wait for start or terminate.
             while (!_startRequest && !_terminated) {
                 lock.waitCondition();
@@ -289,6 +303,21 @@ void ts::tsswitch::InputExecutor::main()
             {
                 GuardMutex lock(_mutex);
                 _outCount += inCount;
+
+                // With --hot-standby, a standby input keeps only the packets after its last random access point.
+                // Thus, when switching to this input, the output starts on a random access point.
+                if (_opt.hotStandby) {
+                    if (_rap.feedPackets(&_buffer[inFirst], inCount)) {
+                        verbose(u"switching on random access points of PCR PID 0x%X (%<d)", {_rap.referencePID()});
+                    }
+                    if (!_isCurrent && !_outputInUse) {
+                        const size_t rap = _rap.lastRandomAccess(&_buffer[inFirst], inCount);
+                        if (rap != NPOS) {
+                            _outFirst = inFirst + rap;
+                            _outCount = inCount - rap;
+                        }
+                    }
+                }
             }
             _core.inputReceived(_pluginIndex);
         }
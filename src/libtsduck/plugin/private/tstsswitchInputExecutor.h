@@ -39,6 +39,7 @@
 #include "tsMutex.h"
 #include "tsCondition.h"
 #include "tsMonotonic.h"
+#include "tsRandomAccessScanner.h"
 
 namespace ts {
     namespace tsswitch {
@@ -120,6 +121,16 @@ namespace ts {
             //!
             void freeOutput(size_t count);
 
+            //!
+            //! Locate the first random access point in an output area of this input plugin.
+            //! Only the random access points on the reference PID of the stream are used.
+            //! @param [in] first Address of first packet in the area.
+            //! @param [in] count Number of packets in the area.
+            //! @return Index of the first random access point or @a count if there is none.
+            //! @see RandomAccessScanner
+            //!
+            size_t firstRandomAccess(const TSPacket* first, size_t count);
+
             // Implementation of TSP.
             virtual size_t pluginIndex() const override;
 
@@ -138,6 +149,7 @@ namespace ts {
             size_t                   _outFirst;      // Index of first packet to output in _buffer.
             size_t                   _outCount;      // Number of packets to output, not always contiguous, may wrap up.
             Monotonic                _start_time;    // Creation time in a monotonic clock.
+            RandomAccessScanner      _rap;           // With --hot-standby, locate random access points.
 
             // Implementation of Thread.
             virtual void main() override;
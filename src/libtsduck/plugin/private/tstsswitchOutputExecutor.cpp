@@ -82,8 +82,10 @@ void ts::tsswitch::OutputExecutor::main()
         log(2, u"got %d packets from plugin %d, terminate: %s", {count, pluginIndex, _terminate});
         if (!_terminate && count > 0) {
 
-            // Output the packets.
+            // Output the packets. Wait until the plugin no longer uses them (asynchronous transmission).
             const bool success = _output->send(first, metadata, count);
+            while (_output->oldestBusyPacket(true) != nullptr) {
+            }
 
             // Signal to the input plugin that the buffer can be reused..
             _core.outputSent(pluginIndex, count);
@@ -43,9 +43,12 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
                                                              const UString& syntax,
                                                              const UString& system_time_name,
                                                              const UString& system_time_description,
-                                                             bool real_time) :
+                                                             bool real_time,
+                                                             size_t max_datagrams) :
     InputPlugin(tsp_, description, syntax),
     _real_time(real_time),
+    _buffer_size(std::max(buffer_size, 7 * PKT_SIZE)),
+    _max_datagrams(std::max<size_t>(max_datagrams, 1)),
     _eval_time(0),
     _display_time(0),
     _time_priority_enum(),
@@ -58,11 +61,15 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
     _packets_0(0),
     _start_1(Time::Epoch),
     _packets_1(0),
+    _dgram_count(0),
+    _dgram_next(0),
     _inbuf_count(0),
     _inbuf_next(0),
     _mdata_next(0),
-    _inbuf(std::max(buffer_size, 7 * PKT_SIZE)),
-    _mdata(_inbuf.size() / PKT_SIZE)
+    _inbuf(_buffer_size * _max_datagrams),
+    _mdata(_buffer_size / PKT_SIZE),
+    _dgram_sizes(_max_datagrams),
+    _dgram_timestamps(_max_datagrams)
 {
     if (_real_time) {
         option(u"display-interval", 'd', POSITIVE);
@@ -136,7 +143,7 @@ bool ts::AbstractDatagramInputPlugin::getOptions()
 bool ts::AbstractDatagramInputPlugin::start()
 {
     // Initialize working data.
-    _inbuf_count = _inbuf_next = _mdata_next = 0;
+    _dgram_count = _dgram_next = _inbuf_count = _inbuf_next = _mdata_next = 0;
     _start = _start_0 = _start_1 = _next_display = Time::Epoch;
     _packets = _packets_0 = _packets_1 = 0;
     return true;
@@ -163,88 +170,66 @@ ts::BitRate ts::AbstractDatagramInputPlugin::getBitrate()
 
 
 //----------------------------------------------------------------------------
-// Input method
+// Default implementation of receiveDatagrams(): one datagram at a time.
 //----------------------------------------------------------------------------
 
-size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+bool ts::AbstractDatagramInputPlugin::receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], MicroSecond timestamps[])
 {
-    MicroSecond timestamp = -1;
-
-    // Check if we receive new packets or process remain of previous buffer.
-    bool new_packets = false;
-
-    // If there is no remaining packet in the input buffer, wait for a datagram message.
-    // Loop until we get some TS packets.
-    while (_inbuf_count == 0) {
+    ret_count = 0;
+    if (max_count == 0 || !receiveDatagram(buffer, buffer_size, ret_sizes[0], timestamps[0])) {
+        return false;
+    }
+    ret_count = 1;
+    return true;
+}
 
-        // Wait for a datagram message
-        size_t insize = 0;
-        if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize, timestamp)) {
-            return 0;
-        }
 
-        // Look for TS packets in the UDP message.
-        new_packets = TSPacket::Locate(_inbuf.data(), insize, _inbuf_next, _inbuf_count);
-
-        if (new_packets) {
-
-            // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
-            // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
-            const bool rtp = _inbuf_next >= RTP_HEADER_SIZE && (_inbuf[1] & 0x7F) == RTP_PT_MP2T;
-            const uint32_t rtp_timestamp = rtp ? GetUInt32(_inbuf.data() + 4) : 0;
-
-            // Use RTP time stamp if there is one and RTP is the preferred choice.
-            bool use_rtp = false;
-            bool use_kernel = false;
-            switch (_time_priority) {
-                case RTP_SYSTEM_TSP:
-                    use_rtp = rtp;
-                    use_kernel = !rtp && timestamp >= 0;
-                    break;
-                case SYSTEM_RTP_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = !use_kernel && rtp;
-                    break;
-                case RTP_TSP:
-                    use_rtp = rtp;
-                    use_kernel = false;
-                    break;
-                case SYSTEM_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = false;
-                    break;
-                case TSP_ONLY:
-                default:
-                    use_rtp = false;
-                    use_kernel = false;
-                    break;
-            }
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
 
-            // Build time stamps in packet metadata.
-            _mdata_next = 0;
-            for (size_t i = 0; i < _inbuf_count; ++i) {
-                if (use_rtp) {
-                    // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
-                    _mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
-                }
-                else if (use_kernel) {
-                    // IP time stamp unit is microseconds.
-                    _mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
+size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    size_t pkt_cnt = 0;    // Number of returned packets.
+    size_t new_count = 0;  // Number of packets in newly processed datagrams.
+
+    // Return TS packets from as many received datagrams as possible.
+    while (pkt_cnt < max_packets) {
+
+        // If there is no remaining packet in the current datagram, process the next one.
+        if (_inbuf_count == 0) {
+            if (_dgram_next < _dgram_count) {
+                // Look for TS packets in the next received datagram.
+                if (locatePackets(_dgram_next++)) {
+                    new_count += _inbuf_count;
                 }
-                else {
-                    _mdata[i].clearInputTimeStamp();
+            }
+            else if (pkt_cnt > 0) {
+                // No more received datagram, do not wait for new ones when some packets are available.
+                break;
+            }
+            else {
+                // Wait for new datagram messages.
+                _dgram_count = _dgram_next = 0;
+                if (!receiveDatagrams(_inbuf.data(), _buffer_size, _max_datagrams, _dgram_count, _dgram_sizes.data(), _dgram_timestamps.data())) {
+                    return 0;
                 }
             }
-
-            break; // found packets.
+            continue;
         }
 
-        // No TS packet found in UDP message, wait for another one.
-        tsp->debug(u"no TS packet in message, %s bytes", {insize});
+        // Return packets from the current datagram.
+        const size_t count = std::min(_inbuf_count, max_packets - pkt_cnt);
+        TSPacket::Copy(buffer + pkt_cnt, _inbuf.data() + _inbuf_next, count);
+        TSPacketMetadata::Copy(pkt_data + pkt_cnt, &_mdata[_mdata_next], count);
+        _inbuf_count -= count;
+        _inbuf_next += count * PKT_SIZE;
+        _mdata_next += count;
+        pkt_cnt += count;
     }
 
     // If new packets were received, we may need to re-evaluate the real-time input bitrate.
-    if (new_packets && _real_time && _eval_time > 0) {
+    if (new_count > 0 && _real_time && _eval_time > 0) {
 
         const Time now(Time::CurrentUTC());
 
@@ -257,9 +242,9 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
 
         // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
+        _packets += new_count;
+        _packets_0 += new_count;
+        _packets_1 += new_count;
 
         // Detect new evaluation period
         if (now >= _start_1 + _eval_time) {
@@ -283,13 +268,77 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
     }
 
-    // Return packets from the input buffer
-    size_t pkt_cnt = std::min(_inbuf_count, max_packets);
-    TSPacket::Copy(buffer, _inbuf.data() + _inbuf_next, pkt_cnt);
-    TSPacketMetadata::Copy(pkt_data, &_mdata[_mdata_next], pkt_cnt);
-    _inbuf_count -= pkt_cnt;
-    _inbuf_next += pkt_cnt * PKT_SIZE;
-    _mdata_next += pkt_cnt;
-
     return pkt_cnt;
 }
+
+
+//----------------------------------------------------------------------------
+// Locate the TS packets in a received datagram.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramInputPlugin::locatePackets(size_t index)
+{
+    const uint8_t* const data = _inbuf.data() + index * _buffer_size;
+    const size_t insize = _dgram_sizes[index];
+    const MicroSecond timestamp = _dgram_timestamps[index];
+
+    // Look for TS packets in the UDP message.
+    size_t start = 0;
+    if (!TSPacket::Locate(data, insize, start, _inbuf_count)) {
+        // No TS packet found in UDP message, wait for another one.
+        _inbuf_count = 0;
+        tsp->debug(u"no TS packet in message, %s bytes", {insize});
+        return false;
+    }
+    _inbuf_next = index * _buffer_size + start;
+
+    // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
+    // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
+    const bool rtp = start >= RTP_HEADER_SIZE && (data[1] & 0x7F) == RTP_PT_MP2T;
+    const uint32_t rtp_timestamp = rtp ? GetUInt32(data + 4) : 0;
+
+    // Use RTP time stamp if there is one and RTP is the preferred choice.
+    bool use_rtp = false;
+    bool use_kernel = false;
+    switch (_time_priority) {
+        case RTP_SYSTEM_TSP:
+            use_rtp = rtp;
+            use_kernel = !rtp && timestamp >= 0;
+            break;
+        case SYSTEM_RTP_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = !use_kernel && rtp;
+            break;
+        case RTP_TSP:
+            use_rtp = rtp;
+            use_kernel = false;
+            break;
+        case SYSTEM_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = false;
+            break;
+        case TSP_ONLY:
+        default:
+            use_rtp = false;
+            use_kernel = false;
+            break;
+    }
+
+    // Build time stamps in packet metadata.
+    _mdata_next = 0;
+    for (size_t i = 0; i < _inbuf_count; ++i) {
+        if (use_rtp) {
+            // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
+            _mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
+        }
+        else if (use_kernel) {
+            // IP time stamp unit is microseconds.
+            _mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
+        }
+        else {
+            _mdata[i].clearInputTimeStamp();
+        }
+    }
+
+    return true;
+}
@@ -70,6 +70,8 @@ namespace ts {
         //! @param [in] system_time_description Description of @a system_time_name for help text.
         //! @param [in] real_time If true, the reception occurs in real-time, typically from
         //! the network. When false, the "reception" can be reading a capture file.
+        //! @param [in] max_datagrams Maximum number of datagrams to receive at once.
+        //! When greater than 1, the subclass should override receiveDatagrams().
         //!
         AbstractDatagramInputPlugin(TSP* tsp,
                                     size_t buffer_size,
@@ -77,7 +79,8 @@ namespace ts {
                                     const UString& syntax,
                                     const UString& system_time_name,
                                     const UString& system_time_description,
-                                    bool real_time);
+                                    bool real_time,
+                                    size_t max_datagrams = 1);
 
         //!
         //! Receive a datagram message.
@@ -90,12 +93,31 @@ namespace ts {
         //!
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) = 0;
 
+        //!
+        //! Receive several datagram messages at once.
+        //! Wait for at least one datagram, then return all immediately available datagrams.
+        //! The default implementation receives one datagram using receiveDatagram().
+        //! Subclasses which can receive several datagrams in one operation should override it.
+        //! @param [out] buffer Address of the buffer for the received messages. The message
+        //! of index @a i is stored at address @a buffer + @a i * @a buffer_size.
+        //! @param [in] buffer_size Size in bytes of the reception buffer of each message.
+        //! @param [in] max_count Maximum number of messages to receive.
+        //! @param [out] ret_count Number of received messages.
+        //! @param [out] ret_sizes Array of @a max_count elements receiving the size in bytes of each message.
+        //! @param [out] timestamps Array of @a max_count elements receiving the receive timestamp
+        //! of each message in micro-seconds or -1 if not available.
+        //! @return True on success, false on error.
+        //!
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], MicroSecond timestamps[]);
+
     private:
         // Order of priority for input timestamps. SYSTEM means lower layer from subclass (UDP, SRT, etc).
         enum TimePriority {RTP_SYSTEM_TSP, SYSTEM_RTP_TSP, RTP_TSP, SYSTEM_TSP, TSP_ONLY};
 
         // Configuration and command line options.
         bool          _real_time;             // Real-time reception.
+        size_t        _buffer_size;           // Size of the buffer of each datagram.
+        size_t        _max_datagrams;         // Maximum number of datagrams to receive at once.
         MilliSecond   _eval_time;             // Bitrate evaluation interval in milli-seconds
         MilliSecond   _display_time;          // Bitrate display interval in milli-seconds
         Enumeration   _time_priority_enum;    // Enumeration values for _time_priority
@@ -110,10 +132,17 @@ namespace ts {
         PacketCounter _packets_0;             // Number of received packets since _start_0
         Time          _start_1;               // Start of previous bitrate evaluation period
         PacketCounter _packets_1;             // Number of received packets since _start_1
-        size_t        _inbuf_count;           // Number of remaining TS packets in inbuf
+        size_t        _dgram_count;           // Number of received datagrams in _inbuf
+        size_t        _dgram_next;            // Index of next datagram to process in _inbuf
+        size_t        _inbuf_count;           // Number of remaining TS packets in current datagram
         size_t        _inbuf_next;            // Byte index in _inbuf of next TS packet to return
         size_t        _mdata_next;            // Index in _mdata of next TS packet metadata to return
-        ByteBlock     _inbuf;                 // Input buffer
-        TSPacketMetadataVector _mdata;        // Metadata for packets in _inbuf
+        ByteBlock     _inbuf;                 // Input buffer, _max_datagrams buffers of _buffer_size bytes
+        TSPacketMetadataVector   _mdata;      // Metadata for packets in current datagram
+        std::vector<size_t>      _dgram_sizes;       // Size of received datagrams
+        std::vector<MicroSecond> _dgram_timestamps;  // Receive timestamps of received datagrams
+
+        // Locate the TS packets in a received datagram. Return false if there is none.
+        bool locatePackets(size_t index);
     };
 }
@@ -35,6 +35,7 @@ TSDUCK_SOURCE;
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::AbstractDatagramOutputPlugin::DEFAULT_PACKET_BURST;
 constexpr size_t ts::AbstractDatagramOutputPlugin::MAX_PACKET_BURST;
+constexpr size_t ts::AbstractDatagramOutputPlugin::MAX_DATAGRAM_BATCH;
 #endif
 
 
@@ -63,7 +64,12 @@ ts::AbstractDatagramOutputPlugin::AbstractDatagramOutputPlugin(TSP* tsp_, const
     _rtp_pcr_offset(0),
     _pkt_count(0),
     _out_count(0),
-    _out_buffer()
+    _out_buffer(),
+    _dgram_count(0),
+    _dgram_addresses(MAX_DATAGRAM_BATCH),
+    _dgram_sizes(MAX_DATAGRAM_BATCH),
+    _rtp_buffers(MAX_DATAGRAM_BATCH),
+    _busy_packets()
 {
     option(u"enforce-burst", 'e');
     help(u"enforce-burst",
@@ -167,6 +173,8 @@ bool ts::AbstractDatagramOutputPlugin::start()
     _last_rtp_pcr_pkt = 0;
     _rtp_pcr_offset = 0;
     _pkt_count = 0;
+    _dgram_count = 0;
+    _busy_packets.clear();
 
     return true;
 }
@@ -181,7 +189,7 @@ bool ts::AbstractDatagramOutputPlugin::stop()
     // Flush incomplete datagram, if any.
     bool success = true;
     if (_out_count > 0) {
-        success = sendPackets(_out_buffer.data(), _out_count);
+        success = queuePackets(_out_buffer.data(), _out_count) && flushDatagrams();
         _out_count = 0;
     }
     return success;
@@ -212,8 +220,9 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
         _out_count += count;
 
         // Send the output buffer when full.
+        // The output buffer is not modified until the pending batch is sent.
         if (_out_count == _pkt_burst) {
-            if (!sendPackets(_out_buffer.data(), _out_count)) {
+            if (!queuePackets(_out_buffer.data(), _out_count)) {
                 return false;
             }
             _out_count = 0;
@@ -223,18 +232,25 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
     // Send subsequent packets from the global buffer.
     while (packet_count >= min_burst) {
         size_t count = std::min(packet_count, _pkt_burst);
-        if (!sendPackets(pkt, count)) {
+        if (!queuePackets(pkt, count)) {
             return false;
         }
         pkt += count;
         packet_count -= count;
     }
 
+    // Send all pending datagrams before returning the packet buffer to the caller.
+    if (!flushDatagrams()) {
+        return false;
+    }
+
     // If remaining packets are present, save them in output buffer.
+    // The previous content of the output buffer may be still in transmission.
     if (packet_count > 0) {
         assert(_enforce_burst);
         assert(_out_count == 0);
         assert(packet_count < _pkt_burst);
+        datagramsCompleted(_out_buffer.data(), _out_buffer.size() * PKT_SIZE, true);
         TSPacket::Copy(_out_buffer.data(), pkt, packet_count);
         _out_count = packet_count;
     }
@@ -243,12 +259,81 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
 
 
 //----------------------------------------------------------------------------
-// Send contiguous packets in one single datagram.
+// Default implementation of sendDatagrams(): one datagram at a time.
 //----------------------------------------------------------------------------
 
-bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t packet_count)
+bool ts::AbstractDatagramOutputPlugin::sendDatagrams(const void* const addresses[], const size_t sizes[], size_t count)
 {
-    bool status = true;
+    for (size_t i = 0; i < count; ++i) {
+        if (!sendDatagram(addresses[i], sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send all datagrams in the pending batch.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramOutputPlugin::flushDatagrams()
+{
+    const bool status = _dgram_count == 0 || sendDatagrams(_dgram_addresses.data(), _dgram_sizes.data(), _dgram_count);
+
+    // Keep track of the datagrams which were directly sent from the caller's packet buffer.
+    if (status && !_use_rtp) {
+        const TSPacket* const out_begin = _out_buffer.data();
+        const TSPacket* const out_end = out_begin + _out_buffer.size();
+        for (size_t i = 0; i < _dgram_count; ++i) {
+            const TSPacket* const pkt = reinterpret_cast<const TSPacket*>(_dgram_addresses[i]);
+            if (pkt < out_begin || pkt >= out_end) {
+                _busy_packets.push_back(std::make_pair(pkt, _dgram_sizes[i] / PKT_SIZE));
+            }
+        }
+    }
+
+    _dgram_count = 0;
+    return status;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the oldest packet which is still in use after send() returned.
+//----------------------------------------------------------------------------
+
+const ts::TSPacket* ts::AbstractDatagramOutputPlugin::oldestBusyPacket(bool wait)
+{
+    // Only wait for the oldest datagram, just check the next ones.
+    while (!_busy_packets.empty() && datagramsCompleted(_busy_packets.front().first, _busy_packets.front().second * PKT_SIZE, wait)) {
+        _busy_packets.pop_front();
+        wait = false;
+    }
+    return _busy_packets.empty() ? nullptr : _busy_packets.front().first;
+}
+
+
+//----------------------------------------------------------------------------
+// Default implementation of datagramsCompleted(): synchronous transmission.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramOutputPlugin::datagramsCompleted(const void*, size_t, bool)
+{
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Add contiguous packets in one single datagram in the pending batch.
+// The packets must remain unmodified until the batch is sent.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramOutputPlugin::queuePackets(const TSPacket* pkt, size_t packet_count)
+{
+    // Send the pending batch when full.
+    if (_dgram_count >= _dgram_addresses.size() && !flushDatagrams()) {
+        return false;
+    }
 
     if (_use_rtp) {
         // RTP datagram are relatively trivial to build, except the time stamp.
@@ -261,7 +346,12 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
         // But never jump back in RTP timestamps, only increase "more slowly" when adjusting.
 
         // Build an RTP datagram. Use a simple RTP header without options nor extensions.
-        ByteBlock buffer(RTP_HEADER_SIZE + packet_count * PKT_SIZE);
+        // The previous content of the buffer may be still in transmission.
+        ByteBlock& buffer(_rtp_buffers[_dgram_count]);
+        if (!buffer.empty()) {
+            datagramsCompleted(buffer.data(), buffer.size(), true);
+        }
+        buffer.resize(RTP_HEADER_SIZE + packet_count * PKT_SIZE);
 
         // Build the RTP header, except the timestamp.
         buffer[0] = 0x80;             // Version = 2, P = 0, X = 0, CC = 0
@@ -336,17 +426,20 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
         _last_rtp_pcr = rtp_pcr;
         _last_rtp_pcr_pkt = _pkt_count;
 
-        // Copy the TS packets after the RTP header and send the packets.
+        // Copy the TS packets after the RTP header.
         ::memcpy(buffer.data() + RTP_HEADER_SIZE, pkt, packet_count * PKT_SIZE);
-        status = sendDatagram(buffer.data(), buffer.size());
+        _dgram_addresses[_dgram_count] = buffer.data();
+        _dgram_sizes[_dgram_count] = buffer.size();
     }
     else {
         // No RTP, send TS packets directly as datagram.
-        status = sendDatagram(pkt, packet_count * PKT_SIZE);
+        _dgram_addresses[_dgram_count] = pkt;
+        _dgram_sizes[_dgram_count] = packet_count * PKT_SIZE;
     }
+    _dgram_count++;
 
     // Count packets datagram per datagram.
     _pkt_count += packet_count;
 
-    return status;
+    return true;
 }
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsOutputPlugin.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -49,6 +50,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
+        virtual const TSPacket* oldestBusyPacket(bool wait) override;
 
         //!
         //! Default number of TS packets in a UDP datagram.
@@ -64,6 +66,13 @@ namespace ts {
         //!
         static constexpr size_t MAX_PACKET_BURST = 128;
 
+        //!
+        //! Maximum number of datagrams which are sent at once.
+        //! All complete datagrams from one call to send() are sent together,
+        //! in batches of at most this number of datagrams.
+        //!
+        static constexpr size_t MAX_DATAGRAM_BATCH = 64;
+
     protected:
         //!
         //! Options which alter the behavior of the output plugin.
@@ -92,6 +101,28 @@ namespace ts {
         //!
         virtual bool sendDatagram(const void* address, size_t size) = 0;
 
+        //!
+        //! Send several datagram messages.
+        //! The default implementation sends the datagrams one by one using sendDatagram().
+        //! Subclasses which can send several datagrams in one operation should override it.
+        //! @param [in] addresses Array of @a count addresses of datagrams.
+        //! @param [in] sizes Array of @a count sizes in bytes of datagrams.
+        //! @param [in] count Number of datagrams to send.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendDatagrams(const void* const addresses[], const size_t sizes[], size_t count);
+
+        //!
+        //! Check or wait for the completion of the asynchronous transmission of datagrams.
+        //! Subclasses which use the memory of the datagrams after sendDatagrams() returned
+        //! (zero-copy transmission) should override it. The default implementation returns true.
+        //! @param [in] address Address of a memory area containing datagrams which were sent.
+        //! @param [in] size Size in bytes of the memory area.
+        //! @param [in] wait If true, wait for the completion of all transmissions in the memory area.
+        //! @return True if the memory area is no longer in use.
+        //!
+        virtual bool datagramsCompleted(const void* address, size_t size, bool wait);
+
     private:
         // Configuration and command line options.
         const Options  _flags;              // Configuration flags.
@@ -116,8 +147,16 @@ namespace ts {
         PacketCounter  _pkt_count;          // Total packet counter for output packets
         size_t         _out_count;          // Number of packets in _out_buffer
         TSPacketVector _out_buffer;         // Buffered packets for output with --enforce-burst
+        size_t         _dgram_count;        // Number of datagrams in pending batch
+        std::vector<const void*> _dgram_addresses;  // Addresses of datagrams in pending batch
+        std::vector<size_t>      _dgram_sizes;      // Sizes of datagrams in pending batch
+        std::vector<ByteBlock>   _rtp_buffers;      // RTP datagrams in pending batch
+        std::deque<std::pair<const TSPacket*, size_t>> _busy_packets; // Sent datagrams from the caller's packet buffer, may be still in use.
+
+        // Add a datagram of TS packets in the pending batch.
+        bool queuePackets(const TSPacket* packet, size_t count);
 
-        // Send a buffer of TS packets.
-        bool sendPackets(const TSPacket* packet, size_t count);
+        // Send all datagrams in the pending batch.
+        bool flushDatagrams();
     };
 }
@@ -57,6 +57,12 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     _mutex(),
     _ecm_to_do(),
     _ecm_thread(this),
+    _packet_window(0),
+    _batch(),
+    _batch_scrambling(nullptr),
+    _batch_first(0),
+    _win_index(0),
+    _win_end(0),
     _stop_thread(false)
 {
     // We need to define character sets to specify service names.
@@ -195,6 +201,12 @@ bool ts::AbstractDescrambler::start()
         return false;
     }
 
+    // Only DVB-CSA2 (the default) takes advantage of processing packets in batches.
+    _packet_window = _scrambling.scramblingType() == SCRAMBLING_DVB_CSA2 ? _scrambling.packetWindow() : 0;
+    _batch.clear();
+    _batch.reserve(_packet_window);
+    _batch_scrambling = nullptr;
+
     // In asynchronous mode, create a thread for ECM processing
     if (_need_ecm && !_synchronous) {
         _stop_thread = false;
@@ -271,6 +283,11 @@ void ts::AbstractDescrambler::handlePMT(const PMT& pmt, PID)
         }
     }
 
+    // Packets which were collected so far use the previous scrambling type.
+    if (!flushBatch()) {
+        _abort = true;
+    }
+
     // Set global scrambling type from scrambling descriptor, if not specified on the command line.
     _scrambling.setScramblingType(scrambling_type, false);
     tsp->verbose(u"using scrambling mode: %s", {NameFromSection(u"ScramblingMode", _scrambling.scramblingType())});
@@ -520,7 +537,7 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     // If there is a user-specified list of PID's, we don't manage a service
     // and there is nothing else to do.
     if (_pids.any()) {
-        return !_pids.test(pid) || _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return !_pids.test(pid) || descramble(_scrambling, pkt) ? TSP_OK : TSP_END;
     }
 
     // Filter sections to locate the service and grab ECM's.
@@ -542,7 +559,7 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
     // Without ECM's, we descramble using fixed control words.
     if (!_need_ecm) {
-        return _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return descramble(_scrambling, pkt) ? TSP_OK : TSP_END;
     }
 
     // Get PID context. If the PID is not known as a scrambled PID,
@@ -571,7 +588,11 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     // Flags new_cw_even/odd are "write-protected, read-volatile", no mutex needed.
     if ((scv == SC_EVEN_KEY && pecm->new_cw_even) || (scv == SC_ODD_KEY && pecm->new_cw_odd)) {
 
-        // A new CW was deciphered.
+        // A new CW was deciphered. Packets which were collected so far use the previous CW.
+        if (!flushBatch()) {
+            return TSP_END;
+        }
+
         // In asynchronous mode, the CW are accessed under mutex protection.
         if (!_synchronous) {
             _mutex.acquire();
@@ -595,5 +616,95 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     }
 
     // Descramble the packet payload.
-    return pecm->scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+    return descramble(pecm->scrambling, pkt) ? TSP_OK : TSP_END;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the preferred packet window size.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::getPacketWindowSize()
+{
+    return _packet_window;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::processPacketWindow(TSPacketWindow& win)
+{
+    // Process all packets one by one, except the actual descrambling which is
+    // collected in a batch. The batch is descrambled at each control word change
+    // and at the end of the window.
+    _batch.clear();
+    _win_end = win.size();
+    for (_win_index = 0; _win_index < _win_end; ++_win_index) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* pkt_data = nullptr;
+        if (win.get(_win_index, pkt, pkt_data)) {
+            switch (processPacket(*pkt, *pkt_data)) {
+                case TSP_OK:
+                    break;
+                case TSP_NULL:
+                    win.nullify(_win_index);
+                    break;
+                case TSP_DROP:
+                    win.drop(_win_index);
+                    break;
+                case TSP_END:
+                default:
+                    _win_end = _win_index;
+                    break;
+            }
+        }
+    }
+
+    // Descramble the last batch. In case of error, _win_end is before the first packet of the batch.
+    flushBatch();
+    return _win_end;
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble a packet, now or later in a batch, in packet window mode.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::descramble(TSScrambling& scrambling, TSPacket& pkt)
+{
+    if (_packet_window == 0) {
+        return scrambling.decrypt(pkt);
+    }
+    if (_batch_scrambling != &scrambling && !flushBatch()) {
+        return false;
+    }
+    if (_batch.empty()) {
+        _batch_scrambling = &scrambling;
+        _batch_first = _win_index;
+    }
+    _batch.push_back(&pkt);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble the packets which were collected in the packet window.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::flushBatch()
+{
+    bool ok = true;
+    if (!_batch.empty()) {
+        assert(_batch_scrambling != nullptr);
+        ok = _batch_scrambling->decrypt(_batch.data(), _batch.size());
+        if (!ok) {
+            // Terminate before the first packet of the batch.
+            _win_end = std::min(_win_end, _batch_first);
+        }
+        _batch.clear();
+    }
+    _batch_scrambling = nullptr;
+    return ok;
 }
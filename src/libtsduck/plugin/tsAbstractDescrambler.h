@@ -61,7 +61,9 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     protected:
         //!
@@ -259,6 +261,12 @@ namespace ts {
         // Analyze a list of descriptors from the PMT, looking for ECM PID's
         void analyzeDescriptors(const DescriptorList& dlist, std::set<PID>& ecm_pids, uint8_t& scrambling);
 
+        // Descramble a packet, now or later in a batch, in packet window mode.
+        bool descramble(TSScrambling& scrambling, TSPacket& pkt);
+
+        // Descramble the packets in _batch.
+        bool flushBatch();
+
         // Abstract descrambler private data.
         bool               _use_service;       // Descramble a service (ie. not a specific list of PID's).
         bool               _need_ecm;          // We need to get control words from ECM's.
@@ -275,6 +283,12 @@ namespace ts {
         Mutex              _mutex;             // Exclusive access to protected areas
         Condition          _ecm_to_do;         // Notify thread to process ECM.
         ECMThread          _ecm_thread;        // Thread which deciphers ECM's.
+        size_t             _packet_window;     // Number of packets to process at once, zero means one by one.
+        std::vector<TSPacket*> _batch;         // Packets to descramble in the current window.
+        TSScrambling*      _batch_scrambling;  // Descrambling engine for the packets in _batch.
+        size_t             _batch_first;       // Index in window of first packet in _batch.
+        size_t             _win_index;         // Index in window of current packet.
+        size_t             _win_end;           // Index in window where processing ends.
         // -- start of protected area --
         bool               _stop_thread;       // Terminate ECM processing thread
         // -- end of protected area --
@@ -59,7 +59,9 @@ ts::AbstractTablePlugin::AbstractTablePlugin(TSP* tsp_,
     _new_version(0),
     _demux(duck, this),
     _pzer(duck, pid),
-    _patch_xml(duck)
+    _patch_xml(duck),
+    _table_cache(),
+    _cache_hits(0)
 {
     _patch_xml.defineArgs(*this);
 
@@ -97,6 +99,15 @@ ts::AbstractTablePlugin::AbstractTablePlugin(TSP* tsp_,
 }
 
 
+ts::AbstractTablePlugin::CachedTable::CachedTable() :
+    input(),
+    output(),
+    is_target(false),
+    same_version(false)
+{
+}
+
+
 //----------------------------------------------------------------------------
 // Get options method
 //----------------------------------------------------------------------------
@@ -134,6 +145,7 @@ void ts::AbstractTablePlugin::setPID(PID pid)
         _demux.addPID(_pid);
         _pzer.reset();
         _pzer.setPID(_pid);
+        _table_cache.clear();
     }
 }
 
@@ -153,6 +165,8 @@ bool ts::AbstractTablePlugin::start()
     // Reset other states
     _found_pid = _found_table = false;
     _pkt_create = _pkt_insert = tsp->pluginPackets();
+    _table_cache.clear();
+    _cache_hits = 0;
 
     // Load XML patch files.
     return _patch_xml.loadPatchFiles();
@@ -170,6 +184,27 @@ void ts::AbstractTablePlugin::handleTable(SectionDemux& demux, const BinaryTable
         return;
     }
 
+    // When the table has the same content as the previous instance with the same table id,
+    // reuse the previous modified table without deserializing and reserializing it again.
+    const uint64_t key = (uint64_t(intable.sourcePID()) << 32) | (uint64_t(intable.tableId()) << 16) | intable.tableIdExtension();
+    const auto cached = _table_cache.find(key);
+    if (cached != _table_cache.end() && SameContent(cached->second.input, intable)) {
+        CachedTable& entry(cached->second);
+        _cache_hits++;
+        tsp->debug(u"%s version %d unchanged, reusing modified table (%'d reused tables)", {_table_name, intable.version(), _cache_hits});
+        if (entry.output.isValid()) {
+            // The reinserted table is a copy since reinsertTable() may modify the version in place.
+            BinaryTable table(entry.output, ShareMode::COPY);
+            if (entry.same_version && table.version() != intable.version()) {
+                table.setVersion(intable.version());
+            }
+            modifiedTableReused(table, entry.is_target);
+            reinsertTable(table, entry.is_target);
+        }
+        entry.input = intable;
+        return;
+    }
+
     // Build a modifiable version of the table.
     BinaryTable table(intable, ShareMode::SHARE);
 
@@ -183,6 +218,18 @@ void ts::AbstractTablePlugin::handleTable(SectionDemux& demux, const BinaryTable
     bool reinsert = true;
     modifyTable(table, is_target, reinsert);
 
+    // Keep the modified table for the next instances with the same content.
+    CachedTable& entry(_table_cache[key]);
+    entry.input = intable;
+    entry.is_target = is_target;
+    entry.same_version = table.version() == intable.version();
+    if (reinsert) {
+        entry.output.copy(table);
+    }
+    else {
+        entry.output.clear();
+    }
+
     // Place modified table in the packetizer.
     if (reinsert) {
         reinsertTable(table, is_target);
@@ -190,12 +237,58 @@ void ts::AbstractTablePlugin::handleTable(SectionDemux& demux, const BinaryTable
 }
 
 
+//----------------------------------------------------------------------------
+// Check if two tables have the same content, except the version and CRC32.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractTablePlugin::SameContent(const BinaryTable& table1, const BinaryTable& table2)
+{
+    if (!table1.isValid() || !table2.isValid() || table1.sectionCount() != table2.sectionCount()) {
+        return false;
+    }
+    for (size_t si = 0; si < table1.sectionCount(); ++si) {
+        const SectionPtr sect1(table1.sectionAt(si));
+        const SectionPtr sect2(table2.sectionAt(si));
+        if (sect1.isNull() || sect2.isNull() || sect1->size() != sect2->size() || sect1->isLongSection() != sect2->isLongSection()) {
+            return false;
+        }
+        const uint8_t* data1 = sect1->content();
+        const uint8_t* data2 = sect2->content();
+        const size_t size = sect1->size();
+        if (!sect1->isLongSection()) {
+            if (std::memcmp(data1, data2, size) != 0) {
+                return false;
+            }
+        }
+        else if (std::memcmp(data1, data2, 5) != 0 ||
+                 (data1[5] & ~0x3E) != (data2[5] & ~0x3E) ||
+                 std::memcmp(data1 + 6, data2 + 6, size - 6 - SECTION_CRC32_SIZE) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Default implementation of modifiedTableReused(): nothing to do.
+//----------------------------------------------------------------------------
+
+void ts::AbstractTablePlugin::modifiedTableReused(const BinaryTable& table, bool is_target)
+{
+}
+
+
 //----------------------------------------------------------------------------
 // Called by the subclass when some external event forces an update of the table.
 //----------------------------------------------------------------------------
 
 void ts::AbstractTablePlugin::forceTableUpdate(BinaryTable& table)
 {
+    // The way the tables are modified has changed.
+    _table_cache.clear();
+
     // Common processing of target table.
     reinsertTable(table, true);
 
@@ -113,6 +113,23 @@ namespace ts {
         //!
         void forceTableUpdate(BinaryTable& table);
 
+        //!
+        //! Called when a table is identical to a previous one, except maybe its version.
+        //! The previous modified table is reused and modifyTable() is not called.
+        //! The default implementation does nothing. Subclasses which keep a state
+        //! from modifyTable() can update it here.
+        //! @param [in] table The reused modified table, with the version of the new input table.
+        //! @param [in] is_target Indicate that @a table is the one we are looking for.
+        //!
+        virtual void modifiedTableReused(const BinaryTable& table, bool is_target);
+
+        //!
+        //! Discard all previously modified tables.
+        //! Must be called by subclasses when some external event changes the way the tables are modified.
+        //! The next instance of each table is passed to modifyTable().
+        //!
+        void clearTableCache() { _table_cache.clear(); }
+
         //!
         //! Set the error flag to terminate the processing asap.
         //! @param [in] on Error state (true by default).
@@ -129,6 +146,16 @@ namespace ts {
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
 
     private:
+        // Previous input table and its modified version, for one table id on one PID.
+        struct CachedTable
+        {
+            CachedTable();
+            BinaryTable input;           // Last input table.
+            BinaryTable output;          // Corresponding modified table, empty if not reinserted.
+            bool        is_target;       // Output of modifyTable().
+            bool        same_version;    // Modified table has the version of the input table.
+        };
+
         bool              _abort;            // Error, abort as soon as possible.
         UString           _table_name;       // Table name, informational only.
         BitRate           _default_bitrate;  // Default bitrate of new PID.
@@ -146,8 +173,13 @@ namespace ts {
         SectionDemux      _demux;            // Section demux.
         CyclingPacketizer _pzer;             // Packetizer for modified tables.
         TablePatchXML     _patch_xml;        // Table patcher using XML patch files.
+        std::map<uint64_t, CachedTable> _table_cache; // Last modified tables, indexed by PID and table id.
+        PacketCounter     _cache_hits;       // Number of tables which were reused from the cache.
 
         // Reinsert a table in the target PID.
         void reinsertTable(BinaryTable& table, bool is_target_table);
+
+        // Check if two tables have the same content, except the version and CRC32.
+        static bool SameContent(const BinaryTable& table1, const BinaryTable& table2);
     };
 }
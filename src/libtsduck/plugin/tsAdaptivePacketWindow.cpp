@@ -0,0 +1,93 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAdaptivePacketWindow.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr ts::NanoSecond ts::AdaptivePacketWindow::DEFAULT_PERIOD;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::AdaptivePacketWindow::AdaptivePacketWindow(size_t min_size, size_t max_size, NanoSecond period) :
+    _period(period),
+    _min_size(0),
+    _max_size(0),
+    _size(0),
+    _peak(0),
+    _start()
+{
+    reset(min_size, max_size, Monotonic(true));
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the window to its minimum size.
+//----------------------------------------------------------------------------
+
+void ts::AdaptivePacketWindow::reset(size_t min_size, size_t max_size, const Monotonic& now)
+{
+    _max_size = std::max<size_t>(1, max_size);
+    _min_size = std::max<size_t>(1, std::min(min_size, _max_size));
+    _size = _min_size;
+    _peak = 0;
+    _start = now;
+}
+
+
+//----------------------------------------------------------------------------
+// Adapt the window after a production cycle.
+//----------------------------------------------------------------------------
+
+bool ts::AdaptivePacketWindow::update(size_t lag, bool blocked, NanoSecond wait_time, NanoSecond produce_time, const Monotonic& now)
+{
+    const size_t previous = _size;
+    _peak = std::max(_peak, lag);
+
+    if (blocked && wait_time > produce_time && _size < _max_size) {
+        // The producer waited for the consumer longer than it took to produce the packets:
+        // the consumer is slower than the producer, grow the window to absorb the burst.
+        _size = std::min(2 * _size, _max_size);
+        _peak = lag;
+        _start = now;
+    }
+    else if (now - _start >= _period) {
+        // End of an observation period. When the lag remained low, shrink the window to reduce the latency.
+        if (_peak < _size / 4 && _size > _min_size) {
+            _size = std::max(_size / 2, _min_size);
+        }
+        _peak = lag;
+        _start = now;
+    }
+    return _size != previous;
+}
@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Window of packets in a packet buffer, adapted to the lag of its consumer.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMonotonic.h"
+
+namespace ts {
+    //!
+    //! Window of packets in a packet buffer, adapted to the lag of its consumer.
+    //! @ingroup plugin
+    //!
+    //! The window is the maximum number of packets which a producer may have queued in
+    //! a packet buffer and which are not yet released by the consumer. It starts at a
+    //! minimum size. When the producer is blocked on a full window and waited longer
+    //! than it took to produce the packets, the consumer is slower than the producer
+    //! and the window is doubled, up to the buffer size, to absorb the burst. When the
+    //! lag of the consumer remains below a quarter of the window during one observation
+    //! period, the window is halved, down to its minimum size, to reduce the latency.
+    //!
+    //! This class is used by tsp with option --adaptive-buffer.
+    //!
+    class TSDUCKDLL AdaptivePacketWindow
+    {
+    public:
+        //!
+        //! Default duration of an observation period before shrinking the window.
+        //!
+        static constexpr NanoSecond DEFAULT_PERIOD = NanoSecPerSec;
+
+        //!
+        //! Constructor.
+        //! @param [in] min_size Initial and minimum size of the window in packets.
+        //! @param [in] max_size Maximum size of the window in packets, typically the buffer size.
+        //! @param [in] period Duration of an observation period before shrinking the window.
+        //!
+        AdaptivePacketWindow(size_t min_size = 1, size_t max_size = 1, NanoSecond period = DEFAULT_PERIOD);
+
+        //!
+        //! Reset the window to its minimum size.
+        //! @param [in] min_size Initial and minimum size of the window in packets.
+        //! The minimum size is always at least 1 and at most @a max_size.
+        //! @param [in] max_size Maximum size of the window in packets, typically the buffer size.
+        //! @param [in] now Current monotonic time, start of the first observation period.
+        //!
+        void reset(size_t min_size, size_t max_size, const Monotonic& now);
+
+        //!
+        //! Get the current size of the window.
+        //! @return The current size of the window in packets.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the minimum size of the window.
+        //! @return The minimum size of the window in packets.
+        //!
+        size_t minSize() const { return _min_size; }
+
+        //!
+        //! Get the maximum size of the window.
+        //! @return The maximum size of the window in packets.
+        //!
+        size_t maxSize() const { return _max_size; }
+
+        //!
+        //! Check if the window is full.
+        //! @param [in] lag Number of packets which are queued and not yet released by the consumer.
+        //! @return True if the window is full.
+        //!
+        bool isFull(size_t lag) const { return lag >= _size; }
+
+        //!
+        //! Get the number of packets which can be added in the window.
+        //! @param [in] lag Number of packets which are queued and not yet released by the consumer.
+        //! @return The number of free packets in the window.
+        //!
+        size_t freeSize(size_t lag) const { return lag < _size ? _size - lag : 0; }
+
+        //!
+        //! Adapt the window after a production cycle.
+        //! @param [in] lag Number of packets which are queued and not yet released by the consumer.
+        //! @param [in] blocked True if the window was full at the beginning of the cycle.
+        //! @param [in] wait_time Time the producer waited for the consumer during the cycle.
+        //! @param [in] produce_time Time the producer spent to produce the packets during the cycle.
+        //! @param [in] now Current monotonic time.
+        //! @return True if the size of the window changed.
+        //!
+        bool update(size_t lag, bool blocked, NanoSecond wait_time, NanoSecond produce_time, const Monotonic& now);
+
+    private:
+        NanoSecond _period;     // Duration of an observation period.
+        size_t     _min_size;   // Minimum size of the window.
+        size_t     _max_size;   // Maximum size of the window.
+        size_t     _size;       // Current size of the window.
+        size_t     _peak;       // Peak lag during the current observation period.
+        Monotonic  _start;      // Start of the current observation period.
+    };
+}
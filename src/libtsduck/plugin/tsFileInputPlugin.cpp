@@ -55,6 +55,7 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
     _start_offset(0),
     _base_label(0),
     _file_format(TSPacketFormat::AUTODETECT),
+    _read_mode(TSFile::READ_SYSCALL),
     _filenames(),
     _start_stuffing(),
     _stop_stuffing(),
@@ -127,6 +128,15 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
          u"Start reading each file at the specified TS packet (default: 0). "
          u"This option is allowed only if all input files are regular files.");
 
+    option(u"read-mode", 0, TSFile::ReadModeEnum);
+    help(u"read-mode", u"name",
+         u"Specify the method to read regular files. "
+         u"The default is \"read\", the standard read system calls. "
+         u"With \"mmap\", the files are mapped in memory by successive windows for sequential access (UNIX only). "
+         u"With \"io-uring\", several large read requests are permanently outstanding (Linux only). "
+         u"These methods may be faster on very large files. "
+         u"Other files, such as pipes or the standard input, are always read using the standard method.");
+
     option(u"repeat", 'r', POSITIVE);
     help(u"repeat",
          u"Repeat the playout of each file the specified number of times (default: only once). "
@@ -149,6 +159,7 @@ bool ts::FileInputPlugin::getOptions()
     getIntValue(_interleave_chunk, u"interleave", 1);
     getIntValue(_base_label, u"label-base", TSPacketMetadata::LABEL_MAX + 1);
     getIntValue(_file_format, u"format", TSPacketFormat::AUTODETECT);
+    getIntValue(_read_mode, u"read-mode", TSFile::READ_SYSCALL);
     getIntValues(_start_stuffing, u"add-start-stuffing");
     getIntValues(_stop_stuffing, u"add-stop-stuffing");
 
@@ -195,8 +206,9 @@ bool ts::FileInputPlugin::openFile(size_t name_index, size_t file_index)
         tsp->verbose(u"reading file %s", {name.empty() ? u"'stdin'" : name});
     }
 
-    // Preset artificial stuffing.
+    // Preset artificial stuffing and read method.
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
+    _files[file_index].setReadMode(_read_mode);
 
     // Actually open the file.
     return _files[file_index].openRead(name, _repeat_count, _start_offset, *tsp, _file_format);
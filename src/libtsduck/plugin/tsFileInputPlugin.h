@@ -75,6 +75,7 @@ namespace ts {
         uint64_t       _start_offset;
         size_t         _base_label;
         TSPacketFormat _file_format;
+        TSFile::ReadMode _read_mode;
         UStringVector  _filenames;
         std::vector<size_t>  _start_stuffing;
         std::vector<size_t>  _stop_stuffing;
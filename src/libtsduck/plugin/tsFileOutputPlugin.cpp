@@ -58,6 +58,9 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     _max_size(0),
     _max_duration(0),
     _multiple_files(false),
+    _wb_size(0),
+    _direct_io(false),
+    _preallocate(0),
     _file(),
     _name_gen(),
     _current_size(0),
@@ -84,9 +87,20 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
          u"Specify the format of the created file. "
          u"By default, the format is a standard TS file.");
 
+    option(u"direct-io");
+    help(u"direct-io",
+         u"Write the file using direct I/O, bypassing the system page cache, when the file system supports it "
+         u"(Linux only). This option implies --write-behind.");
+
     option(u"keep", 'k');
     help(u"keep", u"Keep existing file (abort if the specified file already exists). By default, existing files are overwritten.");
 
+    option(u"preallocate", 0, POSITIVE);
+    help(u"preallocate", u"bytes",
+         u"Preallocate the disk space of the file by chunks of the specified size in bytes, "
+         u"reducing the fragmentation of the file on disk (Linux only). "
+         u"This option implies --write-behind.");
+
     option(u"reopen-on-error", 'r');
     help(u"reopen-on-error",
          u"In case of write error, close the file and try to reopen it several times. "
@@ -123,6 +137,14 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
          u"Then, the integer part is incremented. "
          u"Example: if the specified file name is foo-027.ts, the various files are named foo-027.ts, foo-028.ts, etc.\n\n"
          u"The options --max-duration and --max-size are mutually exclusive.");
+
+    option(u"write-behind", 0, POSITIVE, 0, 1, 0, 0, true);
+    help(u"write-behind", u"bytes",
+         u"Write the file in the background, using a dedicated thread and an in-memory buffer of the specified size in bytes. "
+         u"The packet processing is no longer blocked when the system flushes its page cache. "
+         u"On Linux, the written data are also progressively removed from the page cache. "
+         u"This option applies to regular files only (not the standard output or pipes, UNIX only). "
+         u"The default buffer size is " + UString::Decimal(TSFile::DEFAULT_WRITE_BEHIND_SIZE) + u" bytes.");
 }
 
 
@@ -142,6 +164,9 @@ bool ts::FileOutputPlugin::getOptions()
     getIntValue(_max_size, u"max-size", 0);
     getIntValue(_max_duration, u"max-duration", 0);
     _multiple_files = _max_size > 0 || _max_duration > 0;
+    _direct_io = present(u"direct-io");
+    getIntValue(_preallocate, u"preallocate", 0);
+    getIntValue(_wb_size, u"write-behind", _direct_io || _preallocate > 0 || present(u"write-behind") ? TSFile::DEFAULT_WRITE_BEHIND_SIZE : 0);
 
     _flags = TSFile::WRITE | TSFile::SHARED;
     if (present(u"append")) {
@@ -178,6 +203,7 @@ bool ts::FileOutputPlugin::start()
     }
 
     _file.setStuffing(_start_stuffing, _stop_stuffing);
+    _file.setWriteBehind(_wb_size, _direct_io, _preallocate);
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
     return openAndRetry(false, retry_allowed);
 }
@@ -76,6 +76,9 @@ namespace ts {
         uint64_t          _max_size;
         Second            _max_duration;
         bool              _multiple_files;
+        size_t            _wb_size;
+        bool              _direct_io;
+        uint64_t          _preallocate;
 
         // Working data:
         TSFile            _file;
@@ -38,6 +38,10 @@ TS_REGISTER_INPUT_PLUGIN(u"ip", ts::IPInputPlugin);
 // A dummy storage value to force inclusion of this module when using the static library.
 const int ts::IPInputPlugin::REFERENCE = 0;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::IPInputPlugin::DATAGRAM_BATCH;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Input constructor
@@ -46,8 +50,10 @@ const int ts::IPInputPlugin::REFERENCE = 0;
 ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
     AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE, u"Receive TS packets from UDP/IP, multicast or unicast", u"[options] [address:]port",
                                 u"kernel", u"A kernel-provided time-stamp for the packet, when available (Linux only)",
-                                true), // real-time network reception
-    _sock(*tsp_)
+                                true,  // real-time network reception
+                                DATAGRAM_BATCH),
+    _sock(*tsp_),
+    _msgs(DATAGRAM_BATCH)
 {
     // Add UDP receiver common options.
     _sock.defineArgs(*this);
@@ -122,3 +128,30 @@ bool ts::IPInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, siz
     SocketAddress destination;
     return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *tsp, &timestamp);
 }
+
+
+//----------------------------------------------------------------------------
+// Batched datagram reception method.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], MicroSecond timestamps[])
+{
+    // Describe the datagram buffers.
+    max_count = std::min(max_count, _msgs.size());
+    for (size_t i = 0; i < max_count; ++i) {
+        _msgs[i].data = buffer + i * buffer_size;
+        _msgs[i].max_size = buffer_size;
+    }
+
+    if (!_sock.receiveBatch(_msgs.data(), max_count, ret_count, tsp, *tsp)) {
+        return false;
+    }
+
+    // All buffers have the same size, each received message remains in its own buffer.
+    for (size_t i = 0; i < ret_count; ++i) {
+        assert(_msgs[i].data == buffer + i * buffer_size);
+        ret_sizes[i] = _msgs[i].size;
+        timestamps[i] = _msgs[i].timestamp;
+    }
+    return true;
+}
@@ -58,6 +58,11 @@ namespace ts {
         virtual bool abortInput() override;
         virtual bool setReceiveTimeout(MilliSecond timeout) override;
 
+        //!
+        //! Maximum number of UDP datagrams which are received at once.
+        //!
+        static constexpr size_t DATAGRAM_BATCH = 16;
+
         //! @cond nodoxygen
         // A dummy storage value to force inclusion of this module when using the static library.
         static const int REFERENCE;
@@ -66,8 +71,10 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramInputPlugin.
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], MicroSecond timestamps[]) override;
 
     private:
         UDPReceiver _sock; // Incoming socket with associated command line options.
+        std::vector<UDPSocket::Datagram> _msgs;  // Descriptions of datagrams in batched receive.
     };
 }
@@ -50,6 +50,8 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
     _ttl(0),
     _tos(-1),
     _force_mc_local(false),
+    _gso(false),
+    _zero_copy(false),
     _sock(false, *tsp_)
 {
     option(u"", 0, STRING, 1, 1);
@@ -69,6 +71,15 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
          u"declared, this option may transport multicast IP packets in unicast Ethernet frames "
          u"to the gateway, preventing multicast reception on the local network (seen on Linux).");
 
+    option(u"gso");
+    help(u"gso",
+         u"Use UDP segmentation offload (GSO) when sending datagrams. "
+         u"Consecutive datagrams are passed to the kernel in one single large buffer "
+         u"and the kernel or the network interface splits it into individual datagrams. "
+         u"This reduces the CPU load with high bitrates. "
+         u"If the network interface does not support it, datagrams are individually sent. "
+         u"This option is currently supported on Linux only.");
+
     option(u"local-address", 'l', STRING);
     help(u"local-address",
          u"When the destination is a multicast address, specify the IP address "
@@ -85,6 +96,15 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
          u"Specifies the TOS (Type-Of-Service) socket option. Setting this value "
          u"may depend on the user's privilege or operating system configuration.");
 
+    option(u"zero-copy");
+    help(u"zero-copy",
+         u"Send datagrams without copying them in the kernel. "
+         u"The network interface directly reads the TS packets from the tsp buffer. "
+         u"These packets are not reused by tsp until their transmission is completed. "
+         u"With --rtp, the datagrams are built in a separate buffer and zero-copy is less efficient. "
+         u"This option implies --gso. It is useful with very high bitrates only. "
+         u"This option is currently supported on Linux only.");
+
     option(u"ttl", 't', INTEGER, 0, 1, 1, 255);
     help(u"ttl",
          u"Specifies the TTL (Time-To-Live) socket option. The actual option "
@@ -121,6 +141,8 @@ bool ts::IPOutputPlugin::getOptions()
     getIntValue(_ttl, u"ttl", 0);
     getIntValue(_tos, u"tos", -1);
     _force_mc_local = present(u"force-local-multicast-outgoing");
+    _zero_copy = present(u"zero-copy");
+    _gso = _zero_copy || present(u"gso");
 
     return success;
 }
@@ -144,7 +166,9 @@ bool ts::IPOutputPlugin::start()
         !_sock.setDefaultDestination(_destination, *tsp) ||
         (_force_mc_local && _destination.isMulticast() && _local_addr.hasAddress() && !_sock.setOutgoingMulticast(_local_addr, *tsp)) ||
         (_tos >= 0 && !_sock.setTOS(_tos, *tsp)) ||
-        (_ttl > 0 && !_sock.setTTL(_ttl, *tsp)))
+        (_ttl > 0 && !_sock.setTTL(_ttl, *tsp)) ||
+        (_gso && !_sock.setSendSegmentation(true, *tsp)) ||
+        (_zero_copy && !_sock.setZeroCopy(true, *tsp)))
     {
         _sock.close(*tsp);
         return false;
@@ -174,3 +198,33 @@ bool ts::IPOutputPlugin::sendDatagram(const void* address, size_t size)
 {
     return _sock.send(address, size, *tsp);
 }
+
+
+//----------------------------------------------------------------------------
+// Implementation of AbstractDatagramOutputPlugin: send several datagrams.
+//----------------------------------------------------------------------------
+
+bool ts::IPOutputPlugin::sendDatagrams(const void* const addresses[], const size_t sizes[], size_t count)
+{
+    return _sock.sendBatch(addresses, sizes, count, *tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of AbstractDatagramOutputPlugin: check zero-copy completion.
+//----------------------------------------------------------------------------
+
+bool ts::IPOutputPlugin::datagramsCompleted(const void* address, size_t size, bool wait)
+{
+    if (!_zero_copy) {
+        return true;
+    }
+    else if (wait) {
+        // In case of error, the memory area is considered as released anyway.
+        _sock.waitZeroCopy(address, size, *tsp);
+        return true;
+    }
+    else {
+        return !_sock.zeroCopyBusy(address, size, *tsp);
+    }
+}
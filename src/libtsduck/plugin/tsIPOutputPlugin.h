@@ -65,6 +65,8 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramOutputPlugin
         virtual bool sendDatagram(const void* address, size_t size) override;
+        virtual bool sendDatagrams(const void* const addresses[], const size_t sizes[], size_t count) override;
+        virtual bool datagramsCompleted(const void* address, size_t size, bool wait) override;
 
     private:
         SocketAddress _destination;     // Destination address/port.
@@ -73,6 +75,8 @@ namespace ts {
         int           _ttl;             // Time to live option.
         int           _tos;             // Type of service option.
         bool          _force_mc_local;  // Force multicast outgoing local interface
+        bool          _gso;             // Use UDP segmentation offload.
+        bool          _zero_copy;       // Use zero-copy transmission.
         UDPSocket     _sock;            // Outgoing socket
     };
 }
@@ -39,6 +39,7 @@ constexpr size_t ts::InputSwitcherArgs::MIN_OUTPUT_PACKETS;
 constexpr size_t ts::InputSwitcherArgs::DEFAULT_BUFFERED_PACKETS;
 constexpr size_t ts::InputSwitcherArgs::MIN_BUFFERED_PACKETS;
 constexpr ts::MilliSecond ts::InputSwitcherArgs::DEFAULT_RECEIVE_TIMEOUT;
+constexpr ts::MilliSecond ts::InputSwitcherArgs::DEFAULT_SWITCH_TIMEOUT;
 #endif
 
 
@@ -50,6 +51,7 @@ ts::InputSwitcherArgs::InputSwitcherArgs() :
     appName(),
     fastSwitch(false),
     delayedSwitch(false),
+    hotStandby(false),
     terminate(false),
     reusePort(false),
     firstInput(0),
@@ -66,6 +68,7 @@ ts::InputSwitcherArgs::InputSwitcherArgs() :
     remoteServer(),
     allowedRemote(),
     receiveTimeout(0),
+    switchTimeout(DEFAULT_SWITCH_TIMEOUT),
     inputs(),
     output()
 {
@@ -93,6 +96,12 @@ void ts::InputSwitcherArgs::enforceDefaults()
     bufferedPackets = std::max(bufferedPackets, MIN_BUFFERED_PACKETS);
     maxInputPackets = std::max(maxInputPackets, MIN_INPUT_PACKETS);
     maxOutputPackets = std::max(maxOutputPackets, MIN_OUTPUT_PACKETS);
+
+    // The hot standby mode is built on top of the fast switch mode.
+    if (hotStandby) {
+        fastSwitch = true;
+        delayedSwitch = false;
+    }
 }
 
 
@@ -170,6 +179,22 @@ void ts::InputSwitcherArgs::defineArgs(Args& args) const
               u"Specify the index of the first input plugin to start. "
               u"By default, the first plugin (index 0) is used.");
 
+    args.option(u"hot-standby");
+    args.help(u"hot-standby",
+              u"Perform seamless input switching. As with --fast-switch, all input plugins are started at once. "
+              u"Each standby input keeps a look-ahead buffer which starts at its last random access point "
+              u"(packet with the random_access_indicator set in its adaptation field). "
+              u"Only the random access points on the first PID carrying a PCR in each input are used, "
+              u"usually the video PID. On a multi-program transport stream, only the service which uses "
+              u"this PCR PID is switched on a random access point. The PCR PID of each input is displayed in "
+              u"verbose mode. "
+              u"When switching, the current input is cut just before its next random access point and the "
+              u"output continues at the last random access point of the next input. After the switch, the "
+              u"continuity counters of each PID are shifted to continue the previous input and the PCR "
+              u"discontinuity is signaled in the first PCR of each PID. Without switch, the packets are not "
+              u"modified. The switch latency is bounded by --switch-timeout. "
+              u"Implies --fast-switch.");
+
     args.option(u"infinite", 'i');
     args.help(u"infinite", u"Infinitely repeat the cycle through all input plugins in sequence.");
 
@@ -214,6 +239,12 @@ void ts::InputSwitcherArgs::defineArgs(Args& args) const
               u"If an optional address is specified, it must be a local IP address of the system. "
               u"By default, there is no remote control.");
 
+    args.option(u"switch-timeout", 0, Args::POSITIVE);
+    args.help(u"switch-timeout", u"milliseconds",
+              u"With --hot-standby, specify the maximum time to wait for a random access point in the current "
+              u"input before switching anyway. "
+              u"The default is " + UString::Decimal(DEFAULT_SWITCH_TIMEOUT) + u" ms.");
+
     args.option(u"terminate", 't');
     args.help(u"terminate", u"Terminate execution when the current input plugin terminates.");
 
@@ -232,6 +263,8 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
     appName = args.appName();
     fastSwitch = args.present(u"fast-switch");
     delayedSwitch = args.present(u"delayed-switch");
+    hotStandby = args.present(u"hot-standby");
+    args.getIntValue(switchTimeout, u"switch-timeout", DEFAULT_SWITCH_TIMEOUT);
     terminate = args.present(u"terminate");
     args.getIntValue(cycleCount, u"cycle", args.present(u"infinite") ? 0 : 1);
     args.getIntValue(bufferedPackets, u"buffer-packets", DEFAULT_BUFFERED_PACKETS);
@@ -256,6 +289,9 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
     if (fastSwitch && delayedSwitch) {
         args.error(u"options --delayed-switch and --fast-switch are mutually exclusive");
     }
+    if (hotStandby && delayedSwitch) {
+        args.error(u"options --delayed-switch and --hot-standby are mutually exclusive");
+    }
 
     // Resolve network names. The resolve() method reports error and set the args error state.
     if (!remoteName.empty() && remoteServer.resolve(remoteName, args) && !remoteServer.hasPort()) {
@@ -48,6 +48,7 @@ namespace ts {
         UString             appName;           //!< Application name, for help messages.
         bool                fastSwitch;        //!< Fast switch between input plugins.
         bool                delayedSwitch;     //!< Delayed switch between input plugins.
+        bool                hotStandby;        //!< Switch on random access points with all inputs running (implies fastSwitch).
         bool                terminate;         //!< Terminate when one input plugin completes.
         bool                reusePort;         //!< Reuse-port socket option.
         size_t              firstInput;        //!< Index of first input plugin.
@@ -64,6 +65,7 @@ namespace ts {
         SocketAddress       remoteServer;      //!< UDP server address for remote control.
         IPAddressSet        allowedRemote;     //!< Set of allowed remotes.
         MilliSecond         receiveTimeout;    //!< Receive timeout before switch (0=none).
+        MilliSecond         switchTimeout;     //!< With hotStandby, maximum time to wait for a random access point.
         PluginOptionsVector inputs;            //!< Input plugins descriptions.
         PluginOptions       output;            //!< Output plugin description.
 
@@ -74,6 +76,7 @@ namespace ts {
         static constexpr size_t      DEFAULT_BUFFERED_PACKETS = 512;   //!< Default input size buffer in packets.
         static constexpr size_t      MIN_BUFFERED_PACKETS = 16;        //!< Minimum input size buffer in packets.
         static constexpr MilliSecond DEFAULT_RECEIVE_TIMEOUT = 2000;   //!< Default received timeout with --primary-input.
+        static constexpr MilliSecond DEFAULT_SWITCH_TIMEOUT = 500;     //!< Default maximum switch time with --hot-standby.
 
         //!
         //! Constructor.
@@ -49,3 +49,8 @@ ts::PluginType ts::OutputPlugin::type() const
 {
     return PluginType::OUTPUT;
 }
+
+const ts::TSPacket* ts::OutputPlugin::oldestBusyPacket(bool)
+{
+    return nullptr;
+}
@@ -64,6 +64,21 @@ namespace ts {
         //!
         virtual bool send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count) = 0;
 
+        //!
+        //! Get the oldest packet which is still in use by the plugin after send() returned.
+        //!
+        //! Some output plugins transmit packets asynchronously, directly from the buffer which was
+        //! passed to send() (zero-copy). The main application shall not reuse the buffer, starting
+        //! at the returned packet, as long as packets are in use. All packets which were passed to
+        //! send() before the returned one are released.
+        //!
+        //! The default implementation returns a null pointer: all packets are released when send() returns.
+        //!
+        //! @param [in] wait If true, wait for the release of the oldest packet in use before returning.
+        //! @return Address of the oldest packet which is still in use or a null pointer if none.
+        //!
+        virtual const TSPacket* oldestBusyPacket(bool wait);
+
         // Implementation of inherited interface.
         virtual PluginType type() const override;
 
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketReserve.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and reset.
+//----------------------------------------------------------------------------
+
+ts::PacketReserve::PacketReserve(size_t capacity, bool drop_null_first) :
+    _drop_null_first(drop_null_first),
+    _packets(capacity),
+    _metadata(capacity),
+    _count(0),
+    _dropped(0)
+{
+}
+
+void ts::PacketReserve::reset(size_t capacity, bool drop_null_first)
+{
+    _drop_null_first = drop_null_first;
+    _packets.resize(capacity);
+    _metadata.resize(capacity);
+    _count = 0;
+    _dropped = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Make room for new packets, dropping packets if necessary.
+//----------------------------------------------------------------------------
+
+size_t ts::PacketReserve::makeRoom(size_t count)
+{
+    const size_t capacity = _packets.size();
+    count = std::min(count, capacity);
+    if (_count + count <= capacity) {
+        return 0;
+    }
+
+    size_t drop = _count + count - capacity;
+    size_t dropped = 0;
+
+    // Remove the oldest null packets first.
+    if (_drop_null_first) {
+        size_t kept = 0;
+        for (size_t n = 0; n < _count; ++n) {
+            if (dropped < drop && _packets[n].getPID() == PID_NULL) {
+                dropped++;
+            }
+            else {
+                if (kept < n) {
+                    _packets[kept] = _packets[n];
+                    _metadata[kept] = _metadata[n];
+                }
+                kept++;
+            }
+        }
+        _count = kept;
+        drop -= dropped;
+    }
+
+    // Then remove the oldest packets.
+    removeFirst(drop);
+    dropped += drop;
+    _dropped += dropped;
+    return dropped;
+}
+
+
+//----------------------------------------------------------------------------
+// Declare that packets were written at the end of the reserve.
+//----------------------------------------------------------------------------
+
+void ts::PacketReserve::commit(size_t count)
+{
+    assert(_count + count <= _packets.size());
+    _count += count;
+}
+
+
+//----------------------------------------------------------------------------
+// Move the oldest packets out of the reserve.
+//----------------------------------------------------------------------------
+
+size_t ts::PacketReserve::flush(TSPacket* packets, TSPacketMetadata* metadata, size_t max_packets)
+{
+    const size_t count = std::min(max_packets, _count);
+    std::copy(_packets.begin(), _packets.begin() + count, packets);
+    std::copy(_metadata.begin(), _metadata.begin() + count, metadata);
+    removeFirst(count);
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove the first packets of the reserve.
+//----------------------------------------------------------------------------
+
+void ts::PacketReserve::removeFirst(size_t count)
+{
+    if (count > 0) {
+        std::copy(_packets.begin() + count, _packets.begin() + _count, _packets.begin());
+        std::copy(_metadata.begin() + count, _metadata.begin() + _count, _metadata.begin());
+        _count -= count;
+    }
+}
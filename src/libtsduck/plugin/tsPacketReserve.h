@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Reserve of TS packets with a drop policy when it is full.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+
+namespace ts {
+    //!
+    //! Reserve of TS packets with a drop policy when it is full.
+    //! @ingroup plugin
+    //!
+    //! A reserve is a FIFO of TS packets and their metadata. A producer which can't
+    //! pass its packets to the consumer continues to produce packets in the reserve.
+    //! When the reserve is full, packets are dropped to make room for new packets:
+    //! either the oldest ones or the null packets first, then the oldest ones.
+    //!
+    //! This class is used by tsp with option --back-pressure.
+    //!
+    class TSDUCKDLL PacketReserve
+    {
+        TS_NOCOPY(PacketReserve);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] capacity Maximum number of packets in the reserve.
+        //! @param [in] drop_null_first When packets must be dropped, drop the null packets first.
+        //!
+        PacketReserve(size_t capacity = 0, bool drop_null_first = false);
+
+        //!
+        //! Reset the reserve, dropping all packets.
+        //! @param [in] capacity Maximum number of packets in the reserve.
+        //! @param [in] drop_null_first When packets must be dropped, drop the null packets first.
+        //!
+        void reset(size_t capacity, bool drop_null_first);
+
+        //!
+        //! Get the maximum number of packets in the reserve.
+        //! @return The maximum number of packets in the reserve.
+        //!
+        size_t capacity() const { return _packets.size(); }
+
+        //!
+        //! Get the number of packets in the reserve.
+        //! @return The number of packets in the reserve.
+        //!
+        size_t count() const { return _count; }
+
+        //!
+        //! Check if the reserve is empty.
+        //! @return True if the reserve is empty.
+        //!
+        bool empty() const { return _count == 0; }
+
+        //!
+        //! Get the total number of dropped packets since the last reset.
+        //! @return The total number of dropped packets.
+        //!
+        PacketCounter droppedCount() const { return _dropped; }
+
+        //!
+        //! Make room for new packets at the end of the reserve, dropping packets if necessary.
+        //! @param [in] count Number of packets to make room for. Limited to the capacity.
+        //! @return The number of dropped packets.
+        //!
+        size_t makeRoom(size_t count);
+
+        //!
+        //! Address of the first free packet at the end of the reserve.
+        //! @return The address of the first free packet. There are capacity() - count() free packets.
+        //!
+        TSPacket* freePackets() { return _packets.data() + _count; }
+
+        //!
+        //! Address of the metadata of the first free packet at the end of the reserve.
+        //! @return The address of the metadata of the first free packet.
+        //!
+        TSPacketMetadata* freeMetadata() { return _metadata.data() + _count; }
+
+        //!
+        //! Declare that packets were written at the end of the reserve.
+        //! @param [in] count Number of packets which were written in freePackets() and freeMetadata().
+        //!
+        void commit(size_t count);
+
+        //!
+        //! Move the oldest packets out of the reserve.
+        //! @param [out] packets Address of the returned packets.
+        //! @param [out] metadata Address of the returned metadata.
+        //! @param [in] max_packets Maximum number of packets to return.
+        //! @return The number of returned packets.
+        //!
+        size_t flush(TSPacket* packets, TSPacketMetadata* metadata, size_t max_packets);
+
+    private:
+        bool                   _drop_null_first;
+        TSPacketVector         _packets;
+        TSPacketMetadataVector _metadata;
+        size_t                 _count;
+        PacketCounter          _dropped;
+
+        // Remove the first packets of the reserve.
+        void removeFirst(size_t count);
+    };
+}
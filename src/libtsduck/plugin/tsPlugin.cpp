@@ -81,6 +81,11 @@ size_t ts::Plugin::stackUsage() const
     return DEFAULT_STACK_USAGE;
 }
 
+size_t ts::Plugin::threadCount() const
+{
+    return 0;
+}
+
 bool ts::Plugin::getOptions()
 {
     return true;
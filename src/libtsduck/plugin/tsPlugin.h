@@ -84,6 +84,17 @@ namespace ts {
         //!
         virtual size_t stackUsage() const;
 
+        //!
+        //! Get the number of internal threads which are created by the plugin.
+        //! The plugin itself is executed in a thread of the application. Some plugins
+        //! create additional threads, for instance to receive commands or data from
+        //! the network. This information is used by applications which control the
+        //! total number of threads, such as tspfarm.
+        //! If the method is not implemented by a subclass, the default value is zero.
+        //! @return The number of internal threads of the plugin, after start().
+        //!
+        virtual size_t threadCount() const;
+
         //!
         //! The main application invokes getOptions() only once, at application startup.
         //! Optionally implemented by subclasses to analyze the command line options.
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPluginMetrics.h"
+#include "tsGuardMutex.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PluginMetrics::PluginMetrics() :
+    _mutex(),
+    _metrics()
+{
+}
+
+ts::PluginMetrics::Metric::Metric(const UString& n, Type t, const UString& h) :
+    name(n),
+    type(t),
+    help(h),
+    value(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get or create a metric.
+//----------------------------------------------------------------------------
+
+ts::PluginMetrics::Metric& ts::PluginMetrics::metric(const UString& name, Type type, const UString& help)
+{
+    GuardMutex lock(_mutex);
+    for (auto& it : _metrics) {
+        if (it.name == name) {
+            return it;
+        }
+    }
+    // Elements of a list are never moved, the reference remains valid.
+    _metrics.emplace_back(name, type, help);
+    return _metrics.back();
+}
+
+
+//----------------------------------------------------------------------------
+// Get a snapshot of all metrics.
+//----------------------------------------------------------------------------
+
+void ts::PluginMetrics::getSamples(SampleList& samples) const
+{
+    samples.clear();
+    GuardMutex lock(_mutex);
+    for (const auto& it : _metrics) {
+        samples.push_back({it.name, it.type, it.help, it.value.load(std::memory_order_relaxed)});
+    }
+}
@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Metrics which are published by a plugin.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+#include "tsMutex.h"
+
+namespace ts {
+    //!
+    //! Metrics which are published by a plugin.
+    //! @ingroup plugin
+    //!
+    //! A plugin can publish integer metrics such as error counters or measured values.
+    //! These metrics are exported by the application which runs the plugin, for instance
+    //! in OpenMetrics format by the tsp control server.
+    //!
+    //! A metric is created once, typically in the start() method of the plugin. The returned
+    //! reference remains valid as long as the plugin exists. The value of the metric is then
+    //! updated without lock from the plugin thread. The registry itself is protected by a mutex
+    //! which is only used when a metric is created and when the list of metrics is read.
+    //!
+    class TSDUCKDLL PluginMetrics
+    {
+        TS_NOCOPY(PluginMetrics);
+    public:
+        //!
+        //! Type of metric, as defined by OpenMetrics.
+        //!
+        enum class Type {
+            COUNTER,  //!< Monotonic counter, such as a number of errors.
+            GAUGE,    //!< Value which can go up and down.
+        };
+
+        //!
+        //! One metric.
+        //!
+        class TSDUCKDLL Metric
+        {
+            TS_NOBUILD_NOCOPY(Metric);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] name Name of the metric.
+            //! @param [in] type Type of the metric.
+            //! @param [in] help Description of the metric.
+            //!
+            Metric(const UString& name, Type type, const UString& help);
+
+            const UString        name;   //!< Name of the metric.
+            const Type           type;   //!< Type of the metric.
+            const UString        help;   //!< Description of the metric.
+            std::atomic<int64_t> value;  //!< Current value of the metric.
+
+            //!
+            //! Set the value of the metric.
+            //! @param [in] v New value.
+            //!
+            void set(int64_t v) { value.store(v, std::memory_order_relaxed); }
+
+            //!
+            //! Increment the value of the metric (single writer thread).
+            //! @param [in] v Value to add.
+            //!
+            void add(int64_t v = 1) { value.store(value.load(std::memory_order_relaxed) + v, std::memory_order_relaxed); }
+        };
+
+        //!
+        //! Snapshot of the value of a metric.
+        //!
+        struct TSDUCKDLL Sample
+        {
+            UString name;   //!< Name of the metric.
+            Type    type;   //!< Type of the metric.
+            UString help;   //!< Description of the metric.
+            int64_t value;  //!< Value of the metric.
+        };
+
+        //!
+        //! List of snapshots of metrics.
+        //!
+        typedef std::list<Sample> SampleList;
+
+        //!
+        //! Constructor.
+        //!
+        PluginMetrics();
+
+        //!
+        //! Get or create a metric.
+        //! @param [in] name Name of the metric. Use lowercase letters, digits and underscores only.
+        //! In OpenMetrics format, the name is prefixed with the name of the application and plugin.
+        //! By convention, the unit, if any, should be a suffix, for instance "jitter_nanoseconds".
+        //! @param [in] type Type of the metric. Ignored if the metric already exists.
+        //! @param [in] help Description of the metric. Ignored if the metric already exists.
+        //! @return A reference to the metric. The reference remains valid during the life of this object.
+        //!
+        Metric& metric(const UString& name, Type type, const UString& help = UString());
+
+        //!
+        //! Get a snapshot of all metrics.
+        //! @param [out] samples Receive a snapshot of all metrics, in order of creation.
+        //!
+        void getSamples(SampleList& samples) const;
+
+    private:
+        mutable Mutex     _mutex;
+        std::list<Metric> _metrics;
+    };
+}
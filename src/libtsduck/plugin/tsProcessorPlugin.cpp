@@ -74,6 +74,11 @@ size_t ts::ProcessorPlugin::getPacketWindowSize()
     return 0;
 }
 
+bool ts::ProcessorPlugin::isPIDShardable()
+{
+    return false;
+}
+
 ts::ProcessorPlugin::Status ts::ProcessorPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
     return TSP_OK;
@@ -153,6 +153,25 @@ namespace ts {
         //!
         virtual size_t processPacketWindow(TSPacketWindow& win);
 
+        //!
+        //! Check if the plugin is PID-shardable.
+        //!
+        //! A plugin is PID-shardable when the processing of a packet depends only on the
+        //! previous packets of the same PID, never on packets from other PID's. In that case,
+        //! when the @c tsp option -\-pid-shards is used, the application may run several
+        //! instances of the plugin in parallel threads, each one processing a disjoint subset
+        //! of PID's in the same area of the global packet buffer. The order of packets is
+        //! preserved. All instances are created with the same command line options.
+        //!
+        //! Sharding is applied only in the "packet method", never in the "packet window method".
+        //! In each instance, the packet counters from the @c tsp object are approximate only.
+        //!
+        //! This method is called once by the application after start() but before processing any packet.
+        //! @return True if the plugin is PID-shardable. If this method is not overriden, the default
+        //! implementation returns false.
+        //!
+        virtual bool isPIDShardable();
+
         //!
         //! Get the content of the --only-label options.
         //! The value of the option is fetched each time this method is called.
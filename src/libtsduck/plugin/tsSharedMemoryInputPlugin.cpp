@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryInputPlugin.h"
+#include "tsPluginRepository.h"
+TSDUCK_SOURCE;
+
+TS_REGISTER_INPUT_PLUGIN(u"shm", ts::SharedMemoryInputPlugin);
+
+// A dummy storage value to force inclusion of this module when using the static library.
+const int ts::SharedMemoryInputPlugin::REFERENCE = 0;
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryInputPlugin::SharedMemoryInputPlugin(TSP* tsp_) :
+    InputPlugin(tsp_, u"Receive TS packets from another process through shared memory", u"[options] name"),
+    _name(),
+    _wait(0),
+    _ring()
+{
+    setIntro(u"The packets and their metadata are read from a ring in shared memory "
+             u"which is written by another tsp process using the output plugin 'shm' with the same name. "
+             u"The input starts with the packets which are written after the plugin starts. "
+             u"The input terminates when the writer terminates. "
+             u"This plugin is not supported on Windows.");
+
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"Name of the shared memory object, as specified in the writer.");
+
+    option(u"wait", 'w', UNSIGNED);
+    help(u"wait", u"milliseconds",
+         u"Maximum time to wait for the writer to create the shared memory object. "
+         u"By default, wait forever.");
+}
+
+
+//----------------------------------------------------------------------------
+// Input methods
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getIntValue(_wait, u"wait", Infinite);
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::start()
+{
+    return _ring.attach(_name, _wait, *tsp);
+}
+
+bool ts::SharedMemoryInputPlugin::stop()
+{
+    if (_ring.lostPackets() > 0) {
+        tsp->warning(u"%'d packets lost from shared memory ring %s", {_ring.lostPackets(), _name});
+    }
+    return _ring.close(*tsp);
+}
+
+ts::BitRate ts::SharedMemoryInputPlugin::getBitrate()
+{
+    return _ring.getBitrate();
+}
+
+bool ts::SharedMemoryInputPlugin::setReceiveTimeout(MilliSecond timeout)
+{
+    _ring.setReceiveTimeout(timeout);
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::abortInput()
+{
+    _ring.abort();
+    return true;
+}
+
+size_t ts::SharedMemoryInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    return _ring.read(buffer, pkt_data, max_packets, *tsp, tsp);
+}
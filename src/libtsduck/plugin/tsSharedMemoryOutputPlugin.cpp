@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryOutputPlugin.h"
+#include "tsPluginRepository.h"
+TSDUCK_SOURCE;
+
+TS_REGISTER_OUTPUT_PLUGIN(u"shm", ts::SharedMemoryOutputPlugin);
+
+// A dummy storage value to force inclusion of this module when using the static library.
+const int ts::SharedMemoryOutputPlugin::REFERENCE = 0;
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryOutputPlugin::SharedMemoryOutputPlugin(TSP* tsp_) :
+    OutputPlugin(tsp_, u"Send TS packets to other processes through shared memory", u"[options] name"),
+    _name(),
+    _size(0),
+    _max_readers(0),
+    _drop(false),
+    _reader_timeout(0),
+    _wait_readers(0),
+    _ring()
+{
+    setIntro(u"The packets and their metadata are written into a ring in shared memory. "
+             u"Any number of tsp processes can read them using the input plugin 'shm' with the same name. "
+             u"Each reader receives the packets which are written after it starts. "
+             u"This plugin is not supported on Windows.");
+
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"Name of the shared memory object. The same name shall be used by the readers.");
+
+    option(u"drop", 'd');
+    help(u"drop",
+         u"Never wait for slow readers. When the ring is full, the oldest packets are overwritten "
+         u"and the readers which did not read them lose packets. "
+         u"By default, the output waits for the slowest reader.");
+
+    option(u"max-readers", 'm', INTEGER, 0, 1, 1, TSPacketSharedRing::MAX_READERS);
+    help(u"max-readers",
+         u"Maximum number of simultaneous readers. "
+         u"The default is " + UString::Decimal(TSPacketSharedRing::DEFAULT_MAX_READERS) + u".");
+
+    option(u"reader-timeout", 't', UNSIGNED);
+    help(u"reader-timeout", u"milliseconds",
+         u"When the output waits for a reader which does not progress during this time, "
+         u"the reader is evicted. The evicted reader reports lost packets and resynchronizes. "
+         u"Zero means never evict a reader. "
+         u"The default is " + UString::Decimal(TSPacketSharedRing::DEFAULT_READER_TIMEOUT) + u" ms.");
+
+    option(u"size", 's', POSITIVE);
+    help(u"size", u"packets",
+         u"Size of the ring in packets. "
+         u"The default is " + UString::Decimal(TSPacketSharedRing::DEFAULT_SIZE) + u" packets.");
+
+    option(u"wait-readers", 'w', INTEGER, 0, 1, 1, TSPacketSharedRing::MAX_READERS);
+    help(u"wait-readers",
+         u"Wait until the specified number of readers are attached before sending the first packet. "
+         u"By default, the packets are sent immediately, even without reader.");
+}
+
+
+//----------------------------------------------------------------------------
+// Output methods
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryOutputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getIntValue(_size, u"size", TSPacketSharedRing::DEFAULT_SIZE);
+    getIntValue(_max_readers, u"max-readers", TSPacketSharedRing::DEFAULT_MAX_READERS);
+    getIntValue(_reader_timeout, u"reader-timeout", TSPacketSharedRing::DEFAULT_READER_TIMEOUT);
+    getIntValue(_wait_readers, u"wait-readers", 0);
+    _drop = present(u"drop");
+    if (_wait_readers > _max_readers) {
+        tsp->error(u"--wait-readers cannot be greater than --max-readers");
+        return false;
+    }
+    return true;
+}
+
+bool ts::SharedMemoryOutputPlugin::start()
+{
+    _ring.setBackPressure(_drop, _reader_timeout);
+    if (!_ring.create(_name, _size, _max_readers, *tsp)) {
+        return false;
+    }
+    if (_wait_readers > 0) {
+        tsp->verbose(u"waiting for %d readers", {_wait_readers});
+        if (!_ring.waitReaders(_wait_readers, Infinite, *tsp, tsp)) {
+            _ring.close(*tsp);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::SharedMemoryOutputPlugin::stop()
+{
+    return _ring.close(*tsp);
+}
+
+bool ts::SharedMemoryOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
+{
+    _ring.setBitrate(tsp->bitrate());
+    return _ring.write(buffer, pkt_data, packet_count, *tsp, tsp);
+}
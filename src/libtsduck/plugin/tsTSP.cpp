@@ -42,7 +42,8 @@ ts::TSP::TSP(int max_severity) :
     _tsp_timeout(Infinite),
     _tsp_aborting(false),
     _total_packets(0),
-    _plugin_packets(0)
+    _plugin_packets(0),
+    _metrics()
 {
 }
 
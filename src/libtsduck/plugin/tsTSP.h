@@ -36,6 +36,7 @@
 #include "tsReport.h"
 #include "tsAbortInterface.h"
 #include "tsTS.h"
+#include "tsPluginMetrics.h"
 
 namespace ts {
 
@@ -129,6 +130,21 @@ namespace ts {
         //!
         PacketCounter totalPacketsInThread() const { return _total_packets; }
 
+        //!
+        //! Access the metrics which are published by the plugin.
+        //! The metrics survive a restart of the plugin: when the plugin registers
+        //! a metric with the same name again, the same metric is returned.
+        //! @return A reference to the registry of metrics of the plugin.
+        //! @see PluginMetrics
+        //!
+        PluginMetrics& metrics() { return _metrics; }
+
+        //!
+        //! Access the metrics which are published by the plugin.
+        //! @return A constant reference to the registry of metrics of the plugin.
+        //!
+        const PluginMetrics& metrics() const { return _metrics; }
+
         //!
         //! Check if the current plugin environment should use defaults for real-time.
         //! @return True if the current plugin environment should use defaults for real-time.
@@ -238,6 +254,7 @@ namespace ts {
     private:
         PacketCounter _total_packets;   // Total processed packets in the plugin thread.
         PacketCounter _plugin_packets;  // Total processed packets in the plugin object.
+        PluginMetrics _metrics;         // Metrics which are published by the plugin.
 
         // A dirty hack for the default implementation of ts::ProcessorPlugin::processPacketWindow().
         friend class ProcessorPlugin;
@@ -38,6 +38,10 @@ const ts::Enumeration ts::TSPControlCommand::ControlCommandEnum({
     {u"suspend", ts::TSPControlCommand::ControlCommand::CMD_SUSPEND},
     {u"resume",  ts::TSPControlCommand::ControlCommand::CMD_RESUME},
     {u"restart", ts::TSPControlCommand::ControlCommand::CMD_RESTART},
+    {u"stats",   ts::TSPControlCommand::ControlCommand::CMD_STATS},
+    {u"chains",  ts::TSPControlCommand::ControlCommand::CMD_CHAINS},
+    {u"start",   ts::TSPControlCommand::ControlCommand::CMD_START},
+    {u"stop",    ts::TSPControlCommand::ControlCommand::CMD_STOP},
 });
 
 
@@ -87,6 +91,27 @@ ts::TSPControlCommand::TSPControlCommand() :
     arg->help(u"same",
               u"Restart the plugin with the same options and parameters. "
               u"By default, when no plugin options are specified, restart with no option at all.");
+
+    arg = newCommand(CMD_STATS, u"Display execution statistics of all plugins", u"[options]", Args::NO_VERBOSE);
+    arg->setIntro(u"For each plugin, display the number of processed packets, the packet rate, "
+                  u"the percentage of time spent processing packets instead of waiting for them "
+                  u"and the distributions of the processing time per packet, of the waiting time "
+                  u"and of the number of packets which are available in the buffer. "
+                  u"In a chain of plugins, the bottleneck is usually the plugin which is busy "
+                  u"close to 100% of the time, with a full buffer before it.");
+    arg->option(u"json", 'j');
+    arg->help(u"json", u"Report the statistics in JSON format.");
+
+    arg = newCommand(CMD_CHAINS, u"List all processing chains in a tspfarm process", u"[options]", Args::NO_VERBOSE);
+
+    arg = newCommand(CMD_START, u"Start a processing chain in a tspfarm process", u"[options] chain-name", Args::NO_VERBOSE);
+    arg->option(u"", 0, Args::STRING, 1, 1);
+    arg->help(u"", u"Name of the processing chain to start. "
+                   u"Use the command " + ControlCommandEnum.name(CMD_CHAINS) + u" to list all processing chains.");
+
+    arg = newCommand(CMD_STOP, u"Stop a processing chain in a tspfarm process", u"[options] chain-name", Args::NO_VERBOSE);
+    arg->option(u"", 0, Args::STRING, 1, 1);
+    arg->help(u"", u"Name of the processing chain to stop.");
 }
 
 
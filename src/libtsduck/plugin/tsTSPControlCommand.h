@@ -63,6 +63,10 @@ namespace ts {
             CMD_SUSPEND,  //!< Suspend a plugin.
             CMD_RESUME,   //!< Resume a suspended plugin.
             CMD_RESTART,  //!< Restart a plugin with different parameters.
+            CMD_STATS,    //!< Display execution statistics of all plugins.
+            CMD_CHAINS,   //!< List all processing chains (tspfarm only).
+            CMD_START,    //!< Start a processing chain (tspfarm only).
+            CMD_STOP,     //!< Stop a processing chain (tspfarm only).
         };
 
         //!
@@ -32,10 +32,16 @@
 #include "tstspOutputExecutor.h"
 #include "tstspProcessorExecutor.h"
 #include "tstspControlServer.h"
+#include "tstspStatisticsReporter.h"
 #include "tsMonotonic.h"
 #include "tsGuardMutex.h"
+#include "tsSysUtils.h"
+#include <thread>
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint32_t ts::TSProcessor::COMPLETED_EVENT;
+#endif
 
 //----------------------------------------------------------------------------
 // Constructor and destructor.
@@ -50,6 +56,7 @@ ts::TSProcessor::TSProcessor(Report& report) :
     _input(nullptr),
     _output(nullptr),
     _control(nullptr),
+    _stats(nullptr),
     _packet_buffer(nullptr),
     _metadata_buffer(nullptr)
 {
@@ -68,13 +75,17 @@ ts::TSProcessor::~TSProcessor()
 
 void ts::TSProcessor::cleanupInternal()
 {
-    // Terminate and delete the control server.
-    // This must be done first since the control server accesses the plugin executors.
+    // Terminate and delete the control server and the statistics thread.
+    // This must be done first since they access the plugin executors.
     if (_control != nullptr) {
         // Deleting the object terminates the server thread.
         delete _control;
         _control = nullptr;
     }
+    if (_stats != nullptr) {
+        delete _stats;
+        _stats = nullptr;
+    }
 
     // Abort and wait for threads to terminate
     tsp::PluginExecutor* proc = _input;
@@ -134,6 +145,37 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // Clear errors on the report, used to check further initialisation errors.
         _report.resetErrors();
 
+        // Placement of the plugin threads (--numa-node, --cpu, --pin-threads).
+        // The list of CPU's is either explicit or the CPU's of the NUMA node.
+        std::set<size_t> node_cpus(_args.cpus);
+        if (_args.numa_node >= 0) {
+            if (!GetNUMANodeCPUs(size_t(_args.numa_node), node_cpus)) {
+                _report.error(u"NUMA node %d not found (%d nodes on this system)", {_args.numa_node, NUMANodeCount()});
+                return false;
+            }
+            if (!_args.cpus.empty()) {
+                node_cpus = _args.cpus;
+            }
+        }
+        if (_args.pin_threads && node_cpus.empty()) {
+            for (size_t cpu = 0; cpu < size_t(std::thread::hardware_concurrency()); ++cpu) {
+                node_cpus.insert(cpu);
+            }
+        }
+        const std::vector<size_t> cpu_list(node_cpus.begin(), node_cpus.end());
+
+        // Build the thread attributes of the plugin at a given index in the chain (input is zero).
+        const auto placement = [this, &node_cpus, &cpu_list](ThreadAttributes attr, size_t index) -> ThreadAttributes {
+            attr.setNUMANode(_args.numa_node);
+            if (_args.pin_threads && !cpu_list.empty()) {
+                attr.setCPUAffinity(std::set<size_t>({cpu_list[index % cpu_list.size()]}));
+            }
+            else {
+                attr.setCPUAffinity(node_cpus);
+            }
+            return attr;
+        };
+
         // Load all plugins and analyze their command line arguments.
         // The first plugin is always the input and the last one is the output.
         // The input thread has the highest priority to be always ready to load
@@ -141,10 +183,10 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // plugin has a hight priority to make room in the buffer, but not as
         // high as the input which must remain the top-most priority?
 
-        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), _mutex, &_report);
+        _input = new tsp::InputExecutor(_args, *this, _args.input, placement(ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), 0), _mutex, &_report);
         CheckNonNull(_input);
 
-        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _mutex, &_report);
+        _output = new tsp::OutputExecutor(_args, *this, _args.output, placement(ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _args.plugins.size() + 1), _mutex, &_report);
         CheckNonNull(_output);
 
         _output->ringInsertAfter(_input);
@@ -153,7 +195,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         bool realtime = _args.realtime == Tristate::TRUE || _input->isRealTime() || _output->isRealTime();
 
         for (size_t i = 0; i < _args.plugins.size(); ++i) {
-            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes(), _mutex, &_report);
+            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, placement(ThreadAttributes(), i + 1), _mutex, &_report);
             CheckNonNull(p);
             p->ringInsertBefore(_output);
             realtime = realtime || p->isRealTime();
@@ -189,17 +231,26 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
         // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE, _args.huge_pages, _args.numa_node);
         CheckNonNull(_packet_buffer);
         if (!_packet_buffer->isLocked()) {
             _report.verbose(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                             {_packet_buffer->lockErrorCode(), ts::SysErrorCodeMessage(_packet_buffer->lockErrorCode())});
         }
-        _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE});
+        if (_args.huge_pages && !_packet_buffer->isHugePages()) {
+            _report.verbose(u"tsp: buffer not allocated in huge pages");
+        }
+        if (_args.numa_node >= 0 && !_packet_buffer->isNUMABound()) {
+            _report.verbose(u"tsp: buffer failed to bind to NUMA node %d", {_args.numa_node});
+        }
+        _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes, huge pages: %s, NUMA node: %s",
+                      {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE,
+                       UString::YesNo(_packet_buffer->isHugePages()),
+                       _packet_buffer->isNUMABound() ? UString::Decimal(_args.numa_node) : UString(u"none")});
 
         // Buffer for the packet metadata.
         // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
+        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count(), _args.huge_pages, _args.numa_node);
         CheckNonNull(_metadata_buffer);
 
         // End of locked section.
@@ -242,6 +293,11 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
     CheckNonNull(_control);
     _control->open();
 
+    // Create the thread for periodic statistics, if requested. Errors are not fatal either.
+    _stats = new tsp::StatisticsReporter(_args, _report, _input);
+    CheckNonNull(_stats);
+    _stats->open();
+
     return true;
 }
 
@@ -257,6 +313,41 @@ bool ts::TSProcessor::isStarted()
 }
 
 
+//----------------------------------------------------------------------------
+// Check if the TS processing is completed.
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessor::isCompleted()
+{
+    GuardMutex lock(_mutex);
+    return _output != nullptr && _output->isCompleted();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of threads which are used by the TS processing.
+//----------------------------------------------------------------------------
+
+size_t ts::TSProcessor::threadCount()
+{
+    GuardMutex lock(_mutex);
+    size_t count = 0;
+    if (_input != nullptr && !_terminating) {
+        const tsp::PluginExecutor* proc = _input;
+        do {
+            count += proc->threadCount();
+        } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
+        if (_args.control_port != 0) {
+            count++;
+        }
+        if (_args.stats_interval > 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
 //----------------------------------------------------------------------------
 // Abort the processing.
 //----------------------------------------------------------------------------
@@ -292,8 +383,9 @@ void ts::TSProcessor::waitForTermination()
             proc->waitForTermination();
         } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
 
-        // Make sure the control server thread is terminated before deleting plugins.
+        // Make sure the control server and statistics threads are terminated before deleting plugins.
         _control->close();
+        _stats->close();
 
         // Deallocate all plugins and plugin executor
         cleanupInternal();
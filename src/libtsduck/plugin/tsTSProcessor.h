@@ -46,6 +46,7 @@ namespace ts {
         class InputExecutor;
         class OutputExecutor;
         class ControlServer;
+        class StatisticsReporter;
     }
     //! @endcond
 
@@ -59,6 +60,14 @@ namespace ts {
     {
         TS_NOBUILD_NOCOPY(TSProcessor);
     public:
+        //!
+        //! Code of the plugin event which is signaled when the TS processing is completed.
+        //! The event is signaled by the output plugin executor, after stopping the output plugin.
+        //! An application may register an event handler on this code to be notified of the
+        //! completion, instead of periodically polling isCompleted(). There is no plugin data.
+        //!
+        static constexpr uint32_t COMPLETED_EVENT = 0x54535043;  // "TSPC"
+
         //!
         //! Constructor.
         //! @param [in,out] report Where to report errors, logs, etc.
@@ -93,6 +102,23 @@ namespace ts {
         //!
         bool isStarted();
 
+        //!
+        //! Check if the TS processing is completed.
+        //! The processing is completed when the output plugin is stopped, either because
+        //! the input plugin reached its end or because the processing was aborted.
+        //! The method waitForTermination() shall still be called to release the resources.
+        //! @return True if the processing was started and is completed.
+        //!
+        bool isCompleted();
+
+        //!
+        //! Get the number of threads which are used by the TS processing.
+        //! This includes the plugin executor threads, the PID shards of packet processing plugins,
+        //! the internal threads of the plugins, the control server and the statistics reporter.
+        //! @return The number of threads which are used by the TS processing, zero if not started.
+        //!
+        size_t threadCount();
+
         //!
         //! Abort the processing.
         //! The method can be invoked from any thread, including an interrupt handler for instance.
@@ -116,6 +142,7 @@ namespace ts {
         tsp::InputExecutor*   _input;            // Input processor execution thread.
         tsp::OutputExecutor*  _output;           // Output processor execution thread.
         tsp::ControlServer*   _control;          // TSP control command server thread.
+        tsp::StatisticsReporter* _stats;         // Periodic report of plugin statistics.
         PacketBuffer*         _packet_buffer;    // Global TS packet buffer.
         PacketMetadataBuffer* _metadata_buffer;  // Global packet metabata buffer.
 
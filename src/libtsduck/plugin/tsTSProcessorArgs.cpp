@@ -35,6 +35,9 @@ TSDUCK_SOURCE;
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::TSProcessorArgs::DEFAULT_BUFFER_SIZE;
 constexpr size_t ts::TSProcessorArgs::MIN_BUFFER_SIZE;
+constexpr size_t ts::TSProcessorArgs::DEFAULT_LOCK_FREE_SPIN;
+constexpr size_t ts::TSProcessorArgs::DEFAULT_ADAPTIVE_MIN_PKT;
+constexpr size_t ts::TSProcessorArgs::DEFAULT_RESERVE_PKT;
 #endif
 
 #define DEF_BITRATE_INTERVAL               5  // seconds
@@ -45,6 +48,12 @@ constexpr size_t ts::TSProcessorArgs::MIN_BUFFER_SIZE;
 #define DEF_MAX_INPUT_PKT_RT            1000  // packets
 #define DEF_CONTROL_TIMEOUT             5000  // milliseconds
 
+const ts::TypedEnumeration<ts::TSProcessorArgs::BackPressure> ts::TSProcessorArgs::BackPressureEnum({
+    {u"block",           ts::TSProcessorArgs::BackPressure::BLOCK},
+    {u"drop-oldest",     ts::TSProcessorArgs::BackPressure::DROP_OLDEST},
+    {u"drop-null-first", ts::TSProcessorArgs::BackPressure::DROP_NULL_FIRST},
+});
+
 
 //----------------------------------------------------------------------------
 // Constructor.
@@ -58,6 +67,17 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     max_flush_pkt(0),
     max_input_pkt(0),
     max_output_pkt(NPOS), // unlimited
+    adaptive_buffer(false),
+    adaptive_min_pkt(DEFAULT_ADAPTIVE_MIN_PKT),
+    back_pressure(BackPressure::BLOCK),
+    reserve_pkt(DEFAULT_RESERVE_PKT),
+    huge_pages(false),
+    numa_node(-1),
+    cpus(),
+    pin_threads(false),
+    lock_free(false),
+    lock_free_spin(DEFAULT_LOCK_FREE_SPIN),
+    pid_shards(1),
     init_input_pkt(0),
     instuff_nullpkt(0),
     instuff_inpkt(0),
@@ -73,6 +93,8 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     control_reuse(false),
     control_sources(),
     control_timeout(DEF_CONTROL_TIMEOUT),
+    stats_interval(0),
+    stats_file(),
     duck_args(),
     input(),
     plugins(),
@@ -87,6 +109,22 @@ ts::TSProcessorArgs::TSProcessorArgs() :
 
 void ts::TSProcessorArgs::defineArgs(Args& args) const
 {
+    args.option(u"adaptive-buffer");
+    args.help(u"adaptive-buffer",
+              u"Adapt the used part of the global packet buffer to the lag between the input plugin "
+              u"and the output plugin. The buffer is still allocated with the size of --buffer-size-mb "
+              u"but the input plugin starts with a small window, see --adaptive-buffer-min. "
+              u"When the window is full and the input plugin waits for the output plugin longer than it takes "
+              u"to read the packets, the window is doubled, up to the full buffer, to absorb the burst. "
+              u"It is halved when the lag of the output remains below a quarter of the window during one second. "
+              u"This keeps a low end-to-end latency in steady state.");
+
+    args.option(u"adaptive-buffer-min", 0, Args::POSITIVE);
+    args.help(u"adaptive-buffer-min", u"packets",
+              u"With --adaptive-buffer, specify the initial and minimum size of the window in the buffer, "
+              u"in packets. This is also the default initial load of the buffer. "
+              u"The default is " + UString::Decimal(DEFAULT_ADAPTIVE_MIN_PKT) + u" packets.");
+
     args.option(u"add-input-stuffing", 'a', Args::STRING);
     args.help(u"add-input-stuffing", u"nullpkt/inpkt",
               u"Specify that <nullpkt> null TS packets must be automatically inserted "
@@ -107,6 +145,17 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"Specify that <count> null TS packets must be automatically inserted "
               u"at the end of the processing, after what comes from the input plugin.");
 
+    args.option(u"back-pressure", 0, BackPressureEnum);
+    args.help(u"back-pressure",
+              u"Specify what to do when the packet buffer is full and the input plugin cannot store new packets. "
+              u"With --adaptive-buffer, the buffer is full when the current window is full. "
+              u"With 'block' (the default), tsp stops reading the input plugin until some space is available. "
+              u"With live inputs, this may create losses in the input device or network. "
+              u"With 'drop-oldest', tsp continues to read the input plugin in a reserve of packets, see --reserve-packets, "
+              u"and drops the oldest packets of the reserve when it is full, keeping the most recent ones. "
+              u"With 'drop-null-first', the null packets of the reserve are dropped first, then the oldest packets. "
+              u"With --adaptive-buffer, dropping packets is also a sign of burst and the window is doubled.");
+
     args.option<BitRate>(u"bitrate", 'b');
     args.help(u"bitrate",
               u"Specify the input bitrate, in bits/seconds. By default, the input "
@@ -155,6 +204,20 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"Specify the reception timeout in milliseconds for control commands. "
               u"The default timeout is " TS_STRINGIFY(DEF_CONTROL_TIMEOUT) u" ms.");
 
+    args.option(u"cpu", 0, Args::UNSIGNED, 0, Args::UNLIMITED_COUNT);
+    args.help(u"cpu", u"cpu1[-cpu2]",
+              u"Run the plugin threads on the specified CPU's only. "
+              u"Several --cpu options may be specified. "
+              u"By default, the plugin threads run on all CPU's or on the CPU's of the node which is specified with --numa-node. "
+              u"This option is currently implemented on Linux only.");
+
+    args.option(u"huge-pages");
+    args.help(u"huge-pages",
+              u"Allocate the global packet buffer in huge memory pages, to reduce the TLB misses. "
+              u"Explicit huge pages are used when the administrator has reserved some (see /proc/sys/vm/nr_hugepages). "
+              u"Otherwise, transparent huge pages are requested. "
+              u"This option is currently implemented on Linux only.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -175,6 +238,20 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"a valid bitrate value from the beginning. "
               u"The default initial load is half the size of the global buffer.");
 
+    args.option(u"lock-free");
+    args.help(u"lock-free",
+              u"Pass packets between plugins without using the global synchronization mutex. "
+              u"Each plugin thread publishes its area of the packet buffer using atomic operations "
+              u"and, when there is nothing to do, spins a few times before sleeping. "
+              u"This reduces the contention between plugin threads when the chain of plugins "
+              u"is long and the bitrate is high.");
+
+    args.option(u"lock-free-spin", 0, Args::UNSIGNED);
+    args.help(u"lock-free-spin", u"count",
+              u"With --lock-free, specify how many times a plugin thread yields the CPU, "
+              u"checking for new packets, before sleeping. "
+              u"The default is " + UString::Decimal(DEFAULT_LOCK_FREE_SPIN) + u".");
+
     args.option(u"log-plugin-index");
     args.help(u"log-plugin-index",
               u"In log messages, add the plugin index to the plugin name. "
@@ -209,6 +286,27 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"This option is useful only when an output plugin or device has problems with large output requests. "
               u"This option forces multiple smaller send operations.");
 
+    args.option(u"numa-node", 0, Args::UNSIGNED);
+    args.help(u"numa-node",
+              u"Allocate the global packet buffer on the specified NUMA node and run the plugin threads on the CPU's of this node. "
+              u"On multi-socket servers, this avoids the traffic between the nodes when the plugin threads access the buffer. "
+              u"This option is currently implemented on Linux only.");
+
+    args.option(u"pid-shards", 0, Args::INTEGER, 0, 1, 1, 64);
+    args.help(u"pid-shards", u"count",
+              u"Run that number of instances of each PID-shardable packet processor plugin in parallel threads. "
+              u"Each instance processes a disjoint subset of PID's. A plugin is PID-shardable when its processing "
+              u"of a PID does not depend on other PID's. This is typically the case of some scrambling plugins "
+              u"with explicit lists of PID's. Other plugins are not affected by this option. "
+              u"The default is 1 (no parallel processing).");
+
+    args.option(u"pin-threads");
+    args.help(u"pin-threads",
+              u"Pin each plugin thread on one CPU. The CPU's of --cpu or --numa-node (or all CPU's) are allocated in "
+              u"the order of the plugin chain, starting with the input plugin. When there are more plugins than CPU's, "
+              u"the CPU's are reused from the first one. By default, the plugin threads can move between CPU's. "
+              u"This option is currently implemented on Linux only.");
+
     args.option(u"realtime", 'r', Args::TRISTATE, 0, 1, -255, 256, true);
     args.help(u"realtime",
               u"Specifies if tsp and all plugins should use default values for real-time "
@@ -218,6 +316,24 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"are enforced. The explicit values 'no', 'false', 'off' are used to enforce "
               u"the offline defaults and the explicit values 'yes', 'true', 'on' are used "
               u"to enforce the real-time defaults.");
+
+    args.option(u"reserve-packets", 0, Args::POSITIVE);
+    args.help(u"reserve-packets", u"count",
+              u"With --back-pressure drop-oldest or drop-null-first, specify the size in packets of the reserve "
+              u"where the input plugin continues to read when the packet buffer is full. "
+              u"The default is " + UString::Decimal(DEFAULT_RESERVE_PKT) + u" packets.");
+
+    args.option(u"statistics-file", 0, Args::STRING);
+    args.help(u"statistics-file", u"filename",
+              u"With --statistics-interval, append the statistics to the specified file, "
+              u"one JSON object per line. By default, each JSON object is logged as one line.");
+
+    args.option(u"statistics-interval", 0, Args::POSITIVE);
+    args.help(u"statistics-interval", u"seconds",
+              u"Periodically report the execution statistics of all plugins in JSON format. "
+              u"This is the same information as returned by the control command 'stats --json'. "
+              u"For each plugin, this includes the packet rate, the percentage of busy time and "
+              u"the distributions of processing time per packet, waiting time and buffer occupancy.");
 }
 
 
@@ -235,6 +351,17 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(max_flush_pkt, u"max-flushed-packets", 0);
     args.getIntValue(max_input_pkt, u"max-input-packets", 0);
     args.getIntValue(max_output_pkt, u"max-output-packets", NPOS); // unlimited by default
+    adaptive_buffer = args.present(u"adaptive-buffer");
+    args.getIntValue(adaptive_min_pkt, u"adaptive-buffer-min", DEFAULT_ADAPTIVE_MIN_PKT);
+    args.getIntValue(back_pressure, u"back-pressure", BackPressure::BLOCK);
+    args.getIntValue(reserve_pkt, u"reserve-packets", DEFAULT_RESERVE_PKT);
+    huge_pages = args.present(u"huge-pages");
+    args.getIntValue(numa_node, u"numa-node", -1);
+    args.getIntValues(cpus, u"cpu");
+    pin_threads = args.present(u"pin-threads");
+    lock_free = args.present(u"lock-free");
+    args.getIntValue(lock_free_spin, u"lock-free-spin", DEFAULT_LOCK_FREE_SPIN);
+    args.getIntValue(pid_shards, u"pid-shards", 1);
     args.getIntValue(init_input_pkt, u"initial-input-packets", 0);
     args.getIntValue(instuff_start, u"add-start-stuffing", 0);
     args.getIntValue(instuff_stop, u"add-stop-stuffing", 0);
@@ -244,6 +371,8 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(control_port, u"control-port", 0);
     args.getIntValue(control_timeout, u"control-timeout", DEF_CONTROL_TIMEOUT);
     control_reuse = args.present(u"control-reuse-port");
+    stats_interval = MilliSecPerSec * args.intValue<MilliSecond>(u"statistics-interval", 0);
+    args.getValue(stats_file, u"statistics-file");
 
     // Convert MB in MiB for buffer size for compatibility with original versions.
     ts_buffer_size = size_t((uint64_t(ts_buffer_size) * 1024 * 1024) / 1000000);
@@ -37,6 +37,7 @@
 #include "tsPluginOptions.h"
 #include "tsDuckContext.h"
 #include "tsIPAddress.h"
+#include "tsTypedEnumeration.h"
 
 namespace ts {
     //!
@@ -46,6 +47,20 @@ namespace ts {
     class TSDUCKDLL TSProcessorArgs: public ArgsSupplierInterface
     {
     public:
+        //!
+        //! Policy of the input plugin when the global TS packet buffer is full.
+        //!
+        enum class BackPressure {
+            BLOCK,            //!< Wait for free space in the buffer, do not read from the input plugin.
+            DROP_OLDEST,      //!< Continue to read from the input plugin in a reserve, drop the oldest packets of the reserve.
+            DROP_NULL_FIRST,  //!< Same as DROP_OLDEST but drop the null packets of the reserve first.
+        };
+
+        //!
+        //! Enumeration description of BackPressure.
+        //!
+        static const TypedEnumeration<BackPressure> BackPressureEnum;
+
         UString         app_name;         //!< Application name, for help messages.
         bool            ignore_jt;        //!< Ignore "joint termination" options in plugins.
         bool            log_plugin_index; //!< Log plugin index with plugin name.
@@ -53,6 +68,17 @@ namespace ts {
         size_t          max_flush_pkt;    //!< Max processed packets before flush.
         size_t          max_input_pkt;    //!< Max packets per input operation.
         size_t          max_output_pkt;   //!< Max packets per outsput operation.
+        bool            adaptive_buffer;  //!< Adapt the used part of the global TS packet buffer to the lag between plugins.
+        size_t          adaptive_min_pkt; //!< With adaptive_buffer, minimum and initial number of packets in the used part of the buffer.
+        BackPressure    back_pressure;    //!< Policy of the input plugin when the global TS packet buffer is full.
+        size_t          reserve_pkt;      //!< With back_pressure other than BLOCK, size in packets of the input reserve.
+        bool            huge_pages;       //!< Allocate the global TS packet buffer in huge memory pages.
+        int             numa_node;        //!< NUMA node for the global TS packet buffer and the plugin threads (negative means none).
+        std::set<size_t> cpus;            //!< CPU's on which plugin threads run (empty means all CPU's or all CPU's of numa_node).
+        bool            pin_threads;      //!< Pin each plugin thread on one CPU, in the order of the plugin chain.
+        bool            lock_free;        //!< Pass packets between plugin executors without the global mutex.
+        size_t          lock_free_spin;   //!< In lock-free mode, number of spin iterations before sleeping.
+        size_t          pid_shards;       //!< Number of parallel instances of PID-shardable packet processor plugins.
         size_t          init_input_pkt;   //!< Initial number of input packets to read before starting the processing (zero means default).
         size_t          instuff_nullpkt;  //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
         size_t          instuff_inpkt;    //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
@@ -68,6 +94,8 @@ namespace ts {
         bool            control_reuse;    //!< Set the 'reuse port' socket option on the control TCP server port.
         IPAddressVector control_sources;  //!< Remote IP addresses which are allowed to send control commands.
         MilliSecond     control_timeout;  //!< Reception timeout in milliseconds for control commands.
+        MilliSecond     stats_interval;   //!< Interval in milliseconds between periodic dumps of plugin statistics (zero means none).
+        UString         stats_file;       //!< Output file for periodic dumps of plugin statistics (empty means log).
         DuckContext::SavedArgs duck_args; //!< Default TSDuck context options for all plugins. Each plugin can override them in its context.
         PluginOptions          input;     //!< Input plugin description.
         PluginOptionsVector    plugins;   //!< Packet processor plugins descriptions.
@@ -75,6 +103,9 @@ namespace ts {
 
         static constexpr size_t DEFAULT_BUFFER_SIZE = 16 * 1000000;  //!< Default size in bytes of global TS buffer.
         static constexpr size_t MIN_BUFFER_SIZE = 18800;             //!< Minimum size in bytes of global TS buffer.
+        static constexpr size_t DEFAULT_LOCK_FREE_SPIN = 100;        //!< Default number of spin iterations in lock-free mode.
+        static constexpr size_t DEFAULT_ADAPTIVE_MIN_PKT = 2000;     //!< Default minimum number of packets in adaptive buffer mode.
+        static constexpr size_t DEFAULT_RESERVE_PKT = 1000;          //!< Default number of packets in the input reserve with back-pressure drop policies.
 
         //!
         //! Constructor.
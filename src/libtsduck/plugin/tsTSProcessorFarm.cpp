@@ -0,0 +1,406 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSProcessorFarm.h"
+#include "tstspFarmControlServer.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
+TSDUCK_SOURCE;
+
+const ts::TypedEnumeration<ts::TSProcessorFarm::ChainState> ts::TSProcessorFarm::ChainStateEnum({
+    {u"stopped", ts::TSProcessorFarm::ChainState::STOPPED},
+    {u"pending", ts::TSProcessorFarm::ChainState::PENDING},
+    {u"running", ts::TSProcessorFarm::ChainState::RUNNING},
+});
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::TSProcessorFarm::TSProcessorFarm(Report& report) :
+    Thread(),
+    PluginEventHandlerInterface(),
+    _report(report),
+    _mutex(),
+    _wakeup(),
+    _args(),
+    _started(false),
+    _terminate(false),
+    _threads(0),
+    _chains(),
+    _control(nullptr)
+{
+}
+
+ts::TSProcessorFarm::~TSProcessorFarm()
+{
+    // Stop all chains and wait for the termination of the management thread.
+    abort();
+    waitForTermination();
+    if (_control != nullptr) {
+        delete _control;
+        _control = nullptr;
+    }
+}
+
+ts::TSProcessorFarm::Chain::Chain(const UString& name_, const TSProcessorArgs& args_, Report& report_) :
+    name(name_),
+    args(args_),
+    report(report_, name_ + u": "),
+    tsp(nullptr),
+    state(ChainState::STOPPED),
+    stop(false),
+    threads(EstimateThreads(args_)),
+    starts(0)
+{
+}
+
+ts::TSProcessorFarm::Chain::~Chain()
+{
+    // The destructor of the TS processor waits for its termination.
+    if (tsp != nullptr) {
+        tsp->abort();
+        delete tsp;
+        tsp = nullptr;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Estimate the number of threads of a chain before starting it.
+//----------------------------------------------------------------------------
+
+size_t ts::TSProcessorFarm::EstimateThreads(const TSProcessorArgs& args)
+{
+    // Input and output executors, all packet processing plugins in all PID shards.
+    // The input watchdog and the internal threads of the plugins are known after start only.
+    size_t count = 2 + args.plugins.size() * std::max<size_t>(1, args.pid_shards);
+    if (args.control_port != 0) {
+        count++;  // Control server.
+    }
+    if (args.stats_interval > 0) {
+        count++;  // Statistics reporter.
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Add a processing chain in the farm.
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessorFarm::addChain(const UString& name, const TSProcessorArgs& args, bool autostart)
+{
+    GuardCondition lock(_mutex, _wakeup);
+    if (name.empty() || _chains.find(name) != _chains.end()) {
+        _report.error(u"invalid or duplicate chain name \"%s\"", {name});
+        return false;
+    }
+    ChainPtr chain(new Chain(name, args, _report));
+    CheckNonNull(chain.pointer());
+    if (autostart) {
+        chain->state = ChainState::PENDING;
+        lock.signal();
+    }
+    _chains[name] = chain;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start the farm.
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessorFarm::start(const TSProcessorFarmArgs& args)
+{
+    GuardMutex lock(_mutex);
+
+    if (_started) {
+        _report.error(u"tspfarm already started");
+        return false;
+    }
+    _args = args;
+
+    // Chains which will never fit in the thread budget are not started.
+    for (auto it = _chains.begin(); it != _chains.end(); ++it) {
+        Chain& chain(*it->second);
+        if (chain.state == ChainState::PENDING && _args.thread_budget > 0 && chain.threads > _args.thread_budget) {
+            _report.error(u"chain %s needs %d threads, more than the thread budget %d, not started", {chain.name, chain.threads, _args.thread_budget});
+            chain.state = ChainState::STOPPED;
+        }
+    }
+
+    // Start the control server. Since the chains are managed through the control
+    // server, failing to open it is a fatal error, unlike in tsp.
+    _control = new tsp::FarmControlServer(_args, _report, *this);
+    CheckNonNull(_control);
+    if (!_control->open()) {
+        delete _control;
+        _control = nullptr;
+        return false;
+    }
+
+    // Start the management thread.
+    _started = Thread::start();
+    return _started;
+}
+
+
+//----------------------------------------------------------------------------
+// Request the start or stop of a processing chain.
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessorFarm::startChain(const UString& name, Report& report)
+{
+    GuardCondition lock(_mutex, _wakeup);
+
+    const auto it = _chains.find(name);
+    if (it == _chains.end()) {
+        report.error(u"unknown chain %s", {name});
+        return false;
+    }
+
+    Chain& chain(*it->second);
+    if (chain.state != ChainState::STOPPED) {
+        report.error(u"chain %s is already %s", {name, ChainStateEnum.name(chain.state)});
+        return false;
+    }
+    else if (_args.thread_budget > 0 && chain.threads > _args.thread_budget) {
+        report.error(u"chain %s needs %d threads, more than the thread budget %d", {name, chain.threads, _args.thread_budget});
+        return false;
+    }
+    else {
+        chain.state = ChainState::PENDING;
+        chain.stop = false;
+        lock.signal();
+        return true;
+    }
+}
+
+bool ts::TSProcessorFarm::stopChain(const UString& name, Report& report)
+{
+    GuardCondition lock(_mutex, _wakeup);
+
+    const auto it = _chains.find(name);
+    if (it == _chains.end()) {
+        report.error(u"unknown chain %s", {name});
+        return false;
+    }
+
+    Chain& chain(*it->second);
+    switch (chain.state) {
+        case ChainState::STOPPED:
+            report.error(u"chain %s is not running", {name});
+            return false;
+        case ChainState::PENDING:
+            // Not yet started, simply forget the start request.
+            chain.state = ChainState::STOPPED;
+            return true;
+        case ChainState::RUNNING:
+        default:
+            // The management thread will abort the chain.
+            chain.stop = true;
+            lock.signal();
+            return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the status of all processing chains.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessorFarm::getChains(ChainStatusVector& chains)
+{
+    GuardMutex lock(_mutex);
+    chains.clear();
+    chains.reserve(_chains.size());
+    for (auto it = _chains.begin(); it != _chains.end(); ++it) {
+        ChainStatus status;
+        status.name = it->second->name;
+        status.state = it->second->state;
+        status.threads = it->second->threads;
+        status.starts = it->second->starts;
+        chains.push_back(status);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Stop all chains and terminate the farm.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessorFarm::abort()
+{
+    GuardCondition lock(_mutex, _wakeup);
+    _terminate = true;
+    lock.signal();
+}
+
+void ts::TSProcessorFarm::waitForTermination()
+{
+    if (_started) {
+        Thread::waitForTermination();
+        if (_control != nullptr) {
+            _control->close();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the context of the output thread of a chain when it completes.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessorFarm::handlePluginEvent(const PluginEventContext&)
+{
+    // The management thread checks which chain is completed.
+    GuardCondition lock(_mutex, _wakeup);
+    lock.signal();
+}
+
+
+//----------------------------------------------------------------------------
+// Management thread: start and stop the processing chains.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessorFarm::main()
+{
+    _report.debug(u"tspfarm management thread started");
+
+    for (;;) {
+        std::vector<ChainPtr> to_stop;   // Running chains to terminate.
+        std::vector<ChainPtr> to_start;  // Pending chains to start.
+
+        // Under the protection of the mutex, decide what to do.
+        // Starting and stopping a chain may take time and is done outside the mutex.
+        {
+            GuardCondition lock(_mutex, _wakeup);
+
+            bool running = false;
+            bool pending = false;
+            for (auto it = _chains.begin(); it != _chains.end(); ++it) {
+                Chain& chain(*it->second);
+                if (chain.state == ChainState::RUNNING) {
+                    running = true;
+                    if (_terminate || chain.stop || chain.tsp->isCompleted()) {
+                        to_stop.push_back(it->second);
+                    }
+                }
+                else if (chain.state == ChainState::PENDING) {
+                    if (_terminate) {
+                        chain.state = ChainState::STOPPED;
+                    }
+                    else if (_args.thread_budget == 0 || (to_start.empty() && _threads + chain.threads <= _args.thread_budget)) {
+                        // With a thread budget, the chains are started one at a time. The actual number of
+                        // threads of a started chain is known before deciding to start the next one.
+                        // Reserve the threads now, the chain is considered as running.
+                        _threads += chain.threads;
+                        chain.state = ChainState::RUNNING;
+                        to_start.push_back(it->second);
+                    }
+                    else {
+                        pending = true;
+                    }
+                }
+            }
+
+            // Without control port, there is no way to restart a chain: exit when all are done.
+            if (!running && !pending && to_start.empty() && (_terminate || _args.control_port == 0)) {
+                _terminate = true;
+                break;
+            }
+
+            // Wait when there is nothing to do now. The completion of a running chain is signaled
+            // by its completion event. Since the completion is checked above under the mutex and
+            // the event handler signals under the same mutex, no completion can be missed.
+            if (to_stop.empty() && to_start.empty()) {
+                lock.waitCondition();
+                continue;
+            }
+        }
+
+        // Terminate the completed or stopped chains.
+        for (auto it = to_stop.begin(); it != to_stop.end(); ++it) {
+            Chain& chain(**it);
+            if (!chain.tsp->isCompleted()) {
+                chain.report.verbose(u"stopping chain");
+                chain.tsp->abort();
+            }
+            chain.tsp->waitForTermination();
+            delete chain.tsp;
+
+            GuardMutex lock(_mutex);
+            chain.tsp = nullptr;
+            chain.state = ChainState::STOPPED;
+            chain.stop = false;
+            _threads -= chain.threads;
+            _report.verbose(u"chain %s terminated", {chain.name});
+        }
+
+        // Start the chains which fit in the thread budget.
+        for (auto it = to_start.begin(); it != to_start.end(); ++it) {
+            Chain& chain(**it);
+            TSProcessor* tsp = new TSProcessor(chain.report);
+            CheckNonNull(tsp);
+            tsp->registerEventHandler(this, TSProcessor::COMPLETED_EVENT);
+            const bool ok = tsp->start(chain.args);
+            const size_t threads = ok ? tsp->threadCount() : 0;
+            if (!ok) {
+                delete tsp;
+                tsp = nullptr;
+            }
+
+            GuardMutex lock(_mutex);
+            if (ok) {
+                chain.tsp = tsp;
+                chain.starts++;
+                _report.verbose(u"chain %s started with %d threads", {chain.name, threads});
+                // Replace the estimated number of threads with the actual one.
+                // It is also used as estimate for the next starts of the chain.
+                if (threads > 0) {
+                    const bool over = threads > chain.threads;
+                    _threads = _threads - chain.threads + threads;
+                    chain.threads = threads;
+                    if (over && _args.thread_budget > 0 && _threads > _args.thread_budget) {
+                        _report.warning(u"chain %s uses more threads than estimated, %d threads in running chains, thread budget is %d", {chain.name, _threads, _args.thread_budget});
+                    }
+                }
+            }
+            else {
+                chain.state = ChainState::STOPPED;
+                _threads -= chain.threads;
+                _report.error(u"chain %s failed to start", {chain.name});
+            }
+        }
+    }
+
+    _report.debug(u"tspfarm management thread terminated");
+}
@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Farm of transport stream processors in one process (tspfarm).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSProcessor.h"
+#include "tsTSProcessorFarmArgs.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsReportWithPrefix.h"
+#include "tsCondition.h"
+#include "tsTypedEnumeration.h"
+#include "tsSafePtr.h"
+#include "tsThread.h"
+
+namespace ts {
+
+    namespace tsp {
+        class FarmControlServer;
+    }
+
+    //!
+    //! Farm of independent transport stream processors in one process.
+    //! @ingroup plugin
+    //!
+    //! Each processing chain is a TSProcessor with its own options and plugins.
+    //! Running all chains in the same process shares the logger, the plugin
+    //! shared libraries and all read-only singletons (names, PSI repository,
+    //! XML models) which are otherwise loaded once per tsp process.
+    //!
+    //! The chains are started and stopped individually, either from the
+    //! application or using control commands on the farm's control port.
+    //!
+    //! The chains do not share a pool of worker threads, each chain runs its own threads.
+    //! Instead, the farm implements an admission control on the total number of threads
+    //! in running chains (see TSProcessorFarmArgs::thread_budget). A chain which would
+    //! exceed the budget remains pending until enough other chains terminate.
+    //!
+    class TSDUCKDLL TSProcessorFarm : private Thread, private PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(TSProcessorFarm);
+    public:
+        //!
+        //! State of a processing chain.
+        //!
+        enum class ChainState {
+            STOPPED,  //!< Not running, never started, terminated or stopped.
+            PENDING,  //!< Start requested, waiting for enough thread budget to be available.
+            RUNNING,  //!< TS processing in progress.
+        };
+
+        //!
+        //! Enumeration description of ChainState.
+        //!
+        static const TypedEnumeration<ChainState> ChainStateEnum;
+
+        //!
+        //! Status of a processing chain.
+        //!
+        class TSDUCKDLL ChainStatus
+        {
+        public:
+            UString    name;     //!< Chain name.
+            ChainState state;    //!< Current state.
+            size_t     threads;  //!< Number of threads when running, estimated before the first start.
+            size_t     starts;   //!< Number of times the chain was started.
+            //!
+            //! Constructor.
+            //!
+            ChainStatus() : name(), state(ChainState::STOPPED), threads(0), starts(0) {}
+        };
+
+        //!
+        //! List of status of processing chains.
+        //!
+        typedef std::vector<ChainStatus> ChainStatusVector;
+
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report errors, logs, etc. It is shared by all chains
+        //! and used concurrently by all plugin threads. It must be thread-safe and should be
+        //! asynchronous (see for instance class AsyncReport).
+        //!
+        explicit TSProcessorFarm(Report& report);
+
+        //!
+        //! Destructor.
+        //! All chains are stopped.
+        //!
+        virtual ~TSProcessorFarm() override;
+
+        //!
+        //! Add a processing chain in the farm.
+        //! @param [in] name Chain name, must be unique in the farm.
+        //! @param [in] args Arguments and options of the chain, as in a tsp command.
+        //! @param [in] autostart If true, the chain is started as soon as the farm is started.
+        //! @return True on success, false if the name is already used.
+        //!
+        bool addChain(const UString& name, const TSProcessorArgs& args, bool autostart = true);
+
+        //!
+        //! Start the farm.
+        //! The chains which were added with @a autostart are started.
+        //! @param [in] args Arguments and options of the farm.
+        //! @return True on success, false on failure to start.
+        //!
+        bool start(const TSProcessorFarmArgs& args);
+
+        //!
+        //! Request the start of a processing chain.
+        //! The chain is actually started asynchronously, when enough threads are available.
+        //! @param [in] name Chain name.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false if the chain does not exist or is already started.
+        //!
+        bool startChain(const UString& name, Report& report);
+
+        //!
+        //! Request the termination of a processing chain.
+        //! The chain is actually stopped asynchronously.
+        //! @param [in] name Chain name.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false if the chain does not exist or is already stopped.
+        //!
+        bool stopChain(const UString& name, Report& report);
+
+        //!
+        //! Get the status of all processing chains.
+        //! @param [out] chains Status of all chains, sorted by name.
+        //!
+        void getChains(ChainStatusVector& chains);
+
+        //!
+        //! Stop all chains and terminate the farm.
+        //! The method can be invoked from any thread, including an interrupt handler for instance.
+        //!
+        void abort();
+
+        //!
+        //! Suspend the calling thread until the farm is terminated.
+        //! Without control port, the farm terminates when no chain is running or pending.
+        //! With a control port, the farm terminates on abort() or "exit" command.
+        //!
+        void waitForTermination();
+
+    private:
+        // Description of a processing chain.
+        class Chain
+        {
+            TS_NOBUILD_NOCOPY(Chain);
+        public:
+            Chain(const UString& name, const TSProcessorArgs& args, Report& report);
+            ~Chain();
+
+            const UString    name;     // Chain name.
+            TSProcessorArgs  args;     // Processing options.
+            ReportWithPrefix report;   // Log messages are prefixed by the chain name.
+            TSProcessor*     tsp;      // TS processor, non-null while running.
+            ChainState       state;    // Current state.
+            bool             stop;     // Stop was requested while running.
+            size_t           threads;  // Number of threads, estimated until started, then actual.
+            size_t           starts;   // Number of starts.
+        };
+        typedef SafePtr<Chain, NullMutex> ChainPtr;
+        typedef std::map<UString, ChainPtr> ChainMap;
+
+        Report&                 _report;      // Common log object.
+        Mutex                   _mutex;       // Protect all fields below.
+        Condition               _wakeup;      // Signaled when the management thread has something to do.
+        TSProcessorFarmArgs     _args;        // Farm options.
+        bool                    _started;     // The farm is started.
+        bool                    _terminate;   // Terminate the farm.
+        size_t                  _threads;     // Number of threads in running chains.
+        ChainMap                _chains;      // All processing chains, indexed by name.
+        tsp::FarmControlServer* _control;     // Control command server.
+
+        // Implementation of Thread: the management thread starts and stops the chains.
+        virtual void main() override;
+
+        // Implementation of PluginEventHandlerInterface: wake up the management thread when a chain completes.
+        virtual void handlePluginEvent(const PluginEventContext& context) override;
+
+        // Estimate the number of threads of a chain before starting it.
+        static size_t EstimateThreads(const TSProcessorArgs& args);
+    };
+}
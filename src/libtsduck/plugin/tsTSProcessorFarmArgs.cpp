@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSProcessorFarmArgs.h"
+#include "tsArgs.h"
+TSDUCK_SOURCE;
+
+#define DEF_CONTROL_TIMEOUT  5000  // milliseconds
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSProcessorFarmArgs::TSProcessorFarmArgs() :
+    thread_budget(0),
+    control_port(0),
+    control_local(),
+    control_reuse(false),
+    control_sources(),
+    control_timeout(DEF_CONTROL_TIMEOUT)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Define command line options in an Args.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessorFarmArgs::defineArgs(Args& args) const
+{
+    args.option(u"control-port", 0, Args::UINT16);
+    args.help(u"control-port",
+              u"Specify the TCP port on which tspfarm listens for control commands (start, stop, chains, exit). "
+              u"When a control port is specified, tspfarm does not exit when all chains are stopped "
+              u"since they can be started again. Each chain can also use its own --control-port "
+              u"option to receive tsp control commands for its plugins. "
+              u"If unspecified, no control commands are expected and tspfarm exits when all chains are terminated.");
+
+    args.option(u"control-local", 0, Args::STRING);
+    args.help(u"control-local", u"address",
+              u"Specify the IP address of the local interface on which to listen for control commands. "
+              u"It can be also a host name that translates to a local address. "
+              u"By default, listen on all local interfaces.");
+
+    args.option(u"control-reuse-port");
+    args.help(u"control-reuse-port",
+              u"Set the 'reuse port' socket option on the control TCP server port.");
+
+    args.option(u"control-source", 0, Args::STRING);
+    args.help(u"control-source", u"address",
+              u"Specify a remote IP address which is allowed to send control commands. "
+              u"By default, as a security precaution, only the local host is allowed to connect. "
+              u"Several --control-source options are allowed.");
+
+    args.option(u"control-timeout", 0, Args::UNSIGNED);
+    args.help(u"control-timeout", u"milliseconds",
+              u"Specify the reception timeout in milliseconds for control commands. "
+              u"The default timeout is " TS_STRINGIFY(DEF_CONTROL_TIMEOUT) u" ms.");
+
+    args.option(u"thread-budget", 0, Args::POSITIVE);
+    args.help(u"thread-budget", u"count",
+              u"Admission control on the total number of threads in all running chains. "
+              u"The chains do not share a pool of threads, each chain runs its own threads "
+              u"(one per plugin and per PID shard, the internal threads of the plugins, "
+              u"the control server and the statistics reporter). "
+              u"A chain is started only when its threads fit in the remaining budget. "
+              u"Otherwise, it remains pending until enough running chains terminate or are stopped. "
+              u"Before the first start of a chain, its number of threads is estimated from its options. "
+              u"After each start, the actual number of threads of the chain is used. "
+              u"By default, there is no limit.");
+}
+
+
+//----------------------------------------------------------------------------
+// Load arguments from command line.
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessorFarmArgs::loadArgs(DuckContext& duck, Args& args)
+{
+    args.getIntValue(thread_budget, u"thread-budget", 0);
+    args.getIntValue(control_port, u"control-port", 0);
+    args.getIntValue(control_timeout, u"control-timeout", DEF_CONTROL_TIMEOUT);
+    control_reuse = args.present(u"control-reuse-port");
+
+    // Get and resolve optional local address.
+    if (!args.present(u"control-local")) {
+        control_local.clear();
+    }
+    else {
+        control_local.resolve(args.value(u"control-local"), args);
+    }
+
+    // Get and resolve optional allowed remote addresses.
+    control_sources.clear();
+    if (!args.present(u"control-source")) {
+        // By default, the local host is the only allowed address.
+        control_sources.push_back(IPAddress::LocalHost);
+    }
+    else {
+        for (size_t i = 0; i < args.count(u"control-source"); ++i) {
+            IPAddress addr;
+            if (addr.resolve(args.value(u"control-source", u"", i), args)) {
+                control_sources.push_back(addr);
+            }
+        }
+    }
+
+    return args.valid();
+}
@@ -0,0 +1,64 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Options of a farm of transport stream processors (tspfarm).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsArgsSupplierInterface.h"
+#include "tsIPAddress.h"
+
+namespace ts {
+    //!
+    //! Options of a farm of transport stream processors and their command line options.
+    //! The options of each processing chain are described by a TSProcessorArgs.
+    //! @ingroup plugin
+    //!
+    class TSDUCKDLL TSProcessorFarmArgs: public ArgsSupplierInterface
+    {
+    public:
+        size_t          thread_budget;    //!< Admission limit on the number of threads in all running chains (zero means unlimited).
+        uint16_t        control_port;     //!< TCP server port for control commands.
+        IPAddress       control_local;    //!< Local interface on which to listen for control commands.
+        bool            control_reuse;    //!< Set the 'reuse port' socket option on the control TCP server port.
+        IPAddressVector control_sources;  //!< Remote IP addresses which are allowed to send control commands.
+        MilliSecond     control_timeout;  //!< Reception timeout in milliseconds for control commands.
+
+        //!
+        //! Constructor.
+        //!
+        TSProcessorFarmArgs();
+
+        // Implementation of ArgsSupplierInterface.
+        virtual void defineArgs(Args& args) const override;
+        virtual bool loadArgs(DuckContext& duck, Args& args) override;
+    };
+}
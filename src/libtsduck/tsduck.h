@@ -64,6 +64,7 @@
 #include "tsAC3Attributes.h"
 #include "tsAccessUnitIterator.h"
 #include "tsAdaptationFieldDataDescriptor.h"
+#include "tsAdaptivePacketWindow.h"
 #include "tsAES.h"
 #include "tsAFExtensionsDescriptor.h"
 #include "tsAIT.h"
@@ -165,6 +166,7 @@
 #include "tsContentIdentifierDescriptor.h"
 #include "tsContentLabellingDescriptor.h"
 #include "tsContinuityAnalyzer.h"
+#include "tsContinuitySplicer.h"
 #include "tsCopyrightDescriptor.h"
 #include "tsCountryAvailabilityDescriptor.h"
 #include "tsCPDescriptor.h"
@@ -283,6 +285,7 @@
 #include "tsFilePacketPlugin.h"
 #include "tsFileUtils.h"
 #include "tsFixedPoint.h"
+#include "tsFlatPIDMap.h"
 #include "tsFlexMuxTimingDescriptor.h"
 #include "tsFMCDescriptor.h"
 #include "tsForkInputPlugin.h"
@@ -367,6 +370,7 @@
 #include "tsjsonTrue.h"
 #include "tsjsonValue.h"
 #include "tsKeyTable.h"
+#include "tsLatencyHistogram.h"
 #include "tsLDT.h"
 #include "tsLegacyBandWidth.h"
 #include "tsLinkageDescriptor.h"
@@ -442,6 +446,7 @@
 #include "tsPacketEncapsulation.h"
 #include "tsPacketInsertionController.h"
 #include "tsPacketizer.h"
+#include "tsPacketReserve.h"
 #include "tsPagerArgs.h"
 #include "tsParentalRatingDescriptor.h"
 #include "tsPartialReceptionDescriptor.h"
@@ -470,6 +475,7 @@
 #include "tsPluginEventData.h"
 #include "tsPluginEventHandlerInterface.h"
 #include "tsPluginEventHandlerRegistry.h"
+#include "tsPluginMetrics.h"
 #include "tsPluginOptions.h"
 #include "tsPluginRepository.h"
 #include "tsPluginThread.h"
@@ -489,6 +495,7 @@
 #include "tsPSIPlugin.h"
 #include "tsPSIRepository.h"
 #include "tsPushInputPlugin.h"
+#include "tsRandomAccessScanner.h"
 #include "tsRandomGenerator.h"
 #include "tsRedistributionControlDescriptor.h"
 #include "tsReferenceDescriptor.h"
@@ -520,6 +527,8 @@
 #include "tsSectionFileArgs.h"
 #include "tsSectionHandlerInterface.h"
 #include "tsSectionProviderInterface.h"
+#include "tsSectionView.h"
+#include "tsSectionViewHandlerInterface.h"
 #include "tsSelectionInformationTable.h"
 #include "tsSeriesDescriptor.h"
 #include "tsService.h"
@@ -537,6 +546,8 @@
 #include "tsSHA256.h"
 #include "tsSHA512.h"
 #include "tsSharedLibrary.h"
+#include "tsSharedMemoryInputPlugin.h"
+#include "tsSharedMemoryOutputPlugin.h"
 #include "tsSHDeliverySystemDescriptor.h"
 #include "tsShortEventDescriptor.h"
 #include "tsShortNodeInformationDescriptor.h"
@@ -670,6 +681,8 @@
 #include "tsTSAnalyzer.h"
 #include "tsTSAnalyzerOptions.h"
 #include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerSnapshot.h"
+#include "tsTSAnalyzerSnapshotHandlerInterface.h"
 #include "tsTSDT.h"
 #include "tsTSFile.h"
 #include "tsTSFileInputBuffered.h"
@@ -679,13 +692,17 @@
 #include "tsTSP.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketFormat.h"
+#include "tsTSPacketHeaderScan.h"
 #include "tsTSPacketMetadata.h"
 #include "tsTSPacketQueue.h"
+#include "tsTSPacketSharedRing.h"
 #include "tsTSPacketStream.h"
 #include "tsTSPacketWindow.h"
 #include "tsTSPControlCommand.h"
 #include "tsTSProcessor.h"
 #include "tsTSProcessorArgs.h"
+#include "tsTSProcessorFarm.h"
+#include "tsTSProcessorFarmArgs.h"
 #include "tsTSScanner.h"
 #include "tsTSScrambling.h"
 #include "tsTSSpeedMetrics.h"
@@ -64,6 +64,7 @@ namespace ts {
         AESPlugin(TSP*);
         virtual bool getOptions() override;
         virtual bool start() override;
+        virtual bool isPIDShardable() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -288,6 +289,16 @@ bool ts::AESPlugin::start()
 }
 
 
+//----------------------------------------------------------------------------
+// With explicit PID's (no service), the processing of each PID is independent.
+//----------------------------------------------------------------------------
+
+bool ts::AESPlugin::isPIDShardable()
+{
+    return !_service_arg.hasId() && !_service_arg.hasName();
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked by the demux when a complete table is available.
 //----------------------------------------------------------------------------
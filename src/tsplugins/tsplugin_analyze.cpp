@@ -34,6 +34,7 @@
 
 #include "tsPluginRepository.h"
 #include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerSnapshot.h"
 #include "tsTSSpeedMetrics.h"
 #include "tsFileNameGenerator.h"
 #include "tsFileUtils.h"
@@ -45,7 +46,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class AnalyzePlugin: public ProcessorPlugin
+    class AnalyzePlugin: public ProcessorPlugin, private TSAnalyzerSnapshotHandlerInterface
     {
         TS_NOBUILD_NOCOPY(AnalyzePlugin);
     public:
@@ -54,6 +55,7 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t threadCount() const override {return _analyzer.analysisThreads() + (_background ? 1 : 0);}
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -61,6 +63,7 @@ namespace ts {
         UString           _output_name;
         NanoSecond        _output_interval;
         bool              _multiple_output;
+        bool              _incremental;
         TSAnalyzerOptions _analyzer_options;
 
         // Working data:
@@ -70,10 +73,17 @@ namespace ts {
         NanoSecond        _next_report;
         TSAnalyzerReport  _analyzer;
         FileNameGenerator _name_gen;
+        TSAnalyzerSnapshot _snapshot;
+        uint64_t          _snapshot_seq;
+        bool              _background;    // Incremental reports are built in a background thread.
+        volatile bool     _output_error;  // Output error in the background thread.
 
         bool openOutput();
         void closeOutput();
         bool produceReport();
+
+        // Implementation of TSAnalyzerSnapshotHandlerInterface (in the background thread).
+        virtual void handleSnapshot(TSAnalyzerSnapshot& snapshot) override;
     };
 }
 
@@ -89,13 +99,18 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _output_name(),
     _output_interval(0),
     _multiple_output(false),
+    _incremental(false),
     _analyzer_options(),
     _output_stream(),
     _output(nullptr),
     _metrics(),
     _next_report(0),
     _analyzer(duck),
-    _name_gen()
+    _name_gen(),
+    _snapshot(),
+    _snapshot_seq(0),
+    _background(false),
+    _output_error(false)
 {
     // Define all standard analysis options.
     duck.defineArgsForStandards(*this);
@@ -111,6 +126,18 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
          u"After outputting a file, the analysis context is reset, "
          u"ie. each output file contains a fully independent analysis.");
 
+    option(u"incremental");
+    help(u"incremental",
+         u"When used with --interval, the analysis context is not reset after each report. "
+         u"Each report contains the cumulated analysis since the beginning. "
+         u"With --json or --json-line on the standard output, only the first report is a "
+         u"complete JSON object. Each subsequent report is a JSON patch (RFC 6902), a JSON "
+         u"array of operations which transforms the previous report into the new one. "
+         u"On long-running analyses, this is much smaller than the complete report. "
+         u"With --output-file, each file always contains a complete report. "
+         u"With --json or --json-line, the reports are built in a separate thread "
+         u"which does not slow down the packet processing.");
+
     option(u"multiple-files", 'm');
     help(u"multiple-files",
          u"When used with --interval and --output-file, create a new file for each "
@@ -136,6 +163,7 @@ bool ts::AnalyzePlugin::getOptions()
     _output_name = value(u"output-file");
     _output_interval = NanoSecPerSec * intValue<Second>(u"interval", 0);
     _multiple_output = present(u"multiple-files");
+    _incremental = present(u"incremental");
     return true;
 }
 
@@ -153,6 +181,17 @@ bool ts::AnalyzePlugin::start()
     // For production of multiple reports at regular intervals.
     _metrics.start();
     _next_report = _output_interval;
+    _snapshot.reset();
+    _snapshot_seq = 0;
+    _output_error = false;
+
+    // With incremental JSON reports at regular intervals, build and output the reports in a
+    // background thread. The packet processing thread only passes the packets.
+    _background = _incremental && _analyzer_options.json.json && _output_interval > 0;
+    if (_background && !_snapshot.startBackground(_analyzer, _analyzer_options, _analyzer_options.title, this)) {
+        tsp->error(u"cannot start the background analysis thread");
+        return false;
+    }
 
     // Create the output file. Note that this file is used only in the stop
     // method and could be created there. However, if the file cannot be
@@ -224,13 +263,40 @@ bool ts::AnalyzePlugin::produceReport()
 }
 
 
+//----------------------------------------------------------------------------
+// Output a snapshot, in the background thread.
+//----------------------------------------------------------------------------
+
+void ts::AnalyzePlugin::handleSnapshot(TSAnalyzerSnapshot& snapshot)
+{
+    if (!openOutput()) {
+        _output_error = true;
+    }
+    else {
+        // Patches are output on the standard output only. Each file gets a complete report.
+        if (!_output_name.empty()) {
+            _snapshot_seq = 0;
+        }
+        snapshot.report(_analyzer_options.json, *_output, _snapshot_seq, *tsp);
+        closeOutput();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Stop method
 //----------------------------------------------------------------------------
 
 bool ts::AnalyzePlugin::stop()
 {
-    produceReport();
+    if (_background) {
+        // Publish the final report and wait for the background thread to output it.
+        _snapshot.requestPublish(tsp->bitrate());
+        _snapshot.stopBackground();
+    }
+    else {
+        produceReport();
+    }
     return true;
 }
 
@@ -242,16 +308,30 @@ bool ts::AnalyzePlugin::stop()
 ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
     // Feed the analyzer with one packet
-    _analyzer.feedPacket (pkt);
+    if (_background) {
+        _snapshot.feedPacket(pkt);
+    }
+    else {
+        _analyzer.feedPacket(pkt);
+    }
 
     // With --interval, check if it is time to produce a report
     if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
         // Time to produce a report.
-        if (!produceReport()) {
+        if (_background) {
+            // The report is built and output in the background thread.
+            _snapshot.requestPublish(tsp->bitrate());
+            if (_output_error) {
+                return TSP_END;
+            }
+        }
+        else if (!produceReport()) {
             return TSP_END;
         }
-        // Reset analysis context.
-        _analyzer.reset();
+        // Reset analysis context, unless reports are cumulative.
+        if (!_incremental) {
+            _analyzer.reset();
+        }
         // Compute next report time.
         _next_report += _output_interval;
     }
@@ -58,6 +58,7 @@ namespace ts {
         int                _log_level;    // Log level for discontinuity messages
         PIDSet             _pids;         // PID values to check or fix
         ContinuityAnalyzer _cc_analyzer;  // Continuity counters analyzer
+        PluginMetrics::Metric& _cc_errors; // Exported count of discontinuities
     };
 }
 
@@ -74,7 +75,8 @@ ts::ContinuityPlugin::ContinuityPlugin(TSP* tsp_) :
     _fix(),
     _log_level(Severity::Info),
     _pids(),
-    _cc_analyzer(NoPID, tsp)
+    _cc_analyzer(NoPID, tsp),
+    _cc_errors(tsp->metrics().metric(u"cc_errors", PluginMetrics::Type::COUNTER, u"Number of continuity counter errors"))
 {
     option(u"fix", 'f');
     help(u"fix",
@@ -130,6 +132,7 @@ bool ts::ContinuityPlugin::start()
     _cc_analyzer.setMessagePrefix(_tag);
     _cc_analyzer.setMessageSeverity(_log_level);
     _cc_analyzer.setFix(_fix);
+    _cc_errors.set(0);
     return true;
 }
 
@@ -141,5 +144,6 @@ bool ts::ContinuityPlugin::start()
 ts::ProcessorPlugin::Status ts::ContinuityPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
     _cc_analyzer.feedPacket(pkt);
+    _cc_errors.set(int64_t(_cc_analyzer.errorCount()));
     return TSP_OK;
 }
@@ -33,6 +33,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsPluginRepository.h"
+#include "tsTSPacketHeaderScan.h"
 #include "tsTime.h"
 #include "tsMemory.h"
 TSDUCK_SOURCE;
@@ -52,6 +53,8 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -80,6 +83,10 @@ namespace ts {
         std::ofstream  _outfile;            // User-specified output file
         IntervalReport _last_report;        // Last report content
         PacketCounter  _counters[PID_MAX];  // Packet counter per PID
+        TSPacketHeaderScan _scan;           // Header fields of packets in a packet window
+
+        // Size of packet windows when packets are only counted.
+        static constexpr size_t WINDOW_SIZE = 64;
 
         // Report a line
         void report(const UChar* fmt, const std::initializer_list<ArgMixIn> args);
@@ -105,7 +112,8 @@ ts::CountPlugin::CountPlugin(TSP* tsp_) :
     _report_interval(0),
     _outfile(),
     _last_report(),
-    _counters()
+    _counters(),
+    _scan()
 {
     option(u"all", 'a');
     help(u"all",
@@ -259,6 +267,29 @@ void ts::CountPlugin::report(const UChar* fmt, const std::initializer_list<ArgMi
 }
 
 
+//----------------------------------------------------------------------------
+// Packet window processing, when packets are only counted.
+//----------------------------------------------------------------------------
+
+size_t ts::CountPlugin::getPacketWindowSize()
+{
+    // Reporting all packets or at regular intervals needs each packet index.
+    return _report_all || _report_interval > 0 ? 0 : WINDOW_SIZE;
+}
+
+size_t ts::CountPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    _scan.scan(win);
+    const PID* pids = _scan.pids();
+    for (size_t i = 0; i < _scan.size(); ++i) {
+        if (_scan.isValid(i) && _pids.test(pids[i]) != _negate) {
+            _counters[pids[i]]++;
+        }
+    }
+    return win.size();
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
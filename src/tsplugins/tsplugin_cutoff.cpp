@@ -59,6 +59,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual bool isRealTime() override {return true;}
+        virtual size_t threadCount() const override {return 1;}
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
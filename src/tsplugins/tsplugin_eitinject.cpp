@@ -105,6 +105,7 @@ namespace ts {
         MilliSecond   _poll_interval;
         MilliSecond   _min_stable_delay;
         int           _ts_id;
+        size_t        _max_threads;
         EITRepetitionProfile _eit_profile;
 
         // Working data.
@@ -149,6 +150,7 @@ ts::EITInjectPlugin::EITInjectPlugin(TSP* tsp_) :
     _poll_interval(0),
     _min_stable_delay(0),
     _ts_id(-1),
+    _max_threads(1),
     _eit_profile(),
     _file_listener(this),
     _eit_gen(duck, PID_EIT),
@@ -270,6 +272,12 @@ ts::EITInjectPlugin::EITInjectPlugin(TSP* tsp_) :
          u"By default, use the cycle profile for satellite and cable networks. "
          u"See also options --cycle-* and --prime-days to modify individual values.");
 
+    option(u"threads", 0, POSITIVE);
+    help(u"threads",
+         u"Maximum number of threads to regenerate the EIT schedule when many services need it at "
+         u"the same time, typically at midnight. The generated EIT sections do not depend on the "
+         u"number of threads. The default is 1 (regeneration in the plugin thread only).");
+
     option(u"time", 0, STRING);
     help(u"time",
          u"Specify the UTC date & time reference for the first packet in the stream. "
@@ -306,6 +314,7 @@ bool ts::EITInjectPlugin::getOptions()
     getIntValue(_poll_interval, u"poll-interval", DEFAULT_POLL_INTERVAL);
     getIntValue(_min_stable_delay, u"min-stable-delay", DEFAULT_MIN_STABLE_DELAY);
     getIntValue(_ts_id, u"ts-id", -1);
+    getIntValue(_max_threads, u"threads", 1);
     _delete_files = present(u"delete-files");
     _wait_first_batch = present(u"wait-first-batch");
 
@@ -381,6 +390,7 @@ bool ts::EITInjectPlugin::start()
     _eit_gen.setOptions(_eit_options);
     _eit_gen.setProfile(_eit_profile);
     _eit_gen.setMaxBitRate(_eit_bitrate);
+    _eit_gen.setMaxThreads(_max_threads);
     if (_ts_id >= 0) {
         _eit_gen.setTransportStreamId(uint16_t(_ts_id));
     }
@@ -65,6 +65,7 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t threadCount() const override {return 1;}
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
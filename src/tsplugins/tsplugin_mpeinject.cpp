@@ -61,6 +61,7 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool stop() override;
         virtual bool isRealTime() override {return true;}
+        virtual size_t threadCount() const override {return 1;}
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
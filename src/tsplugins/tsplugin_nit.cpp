@@ -60,6 +60,7 @@ namespace ts {
         // Implementation of AbstractTablePlugin.
         virtual void createNewTable(BinaryTable& table) override;
         virtual void modifyTable(BinaryTable& table, bool& is_target, bool& reinsert) override;
+        virtual void modifiedTableReused(const BinaryTable& table, bool is_target) override;
 
     protected:
         // Implementation of TableHandlerInterface.
@@ -426,6 +427,11 @@ void ts::NITPlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
             }
         }
 
+        // The collected services are used in the modified NIT.
+        if (modified) {
+            clearTableCache();
+        }
+
         if (modified && _last_nit.isValid()) {
             // The global service list has been modified and a valid NIT was already found.
             updateServiceList(_last_nit);
@@ -534,6 +540,19 @@ void ts::NITPlugin::modifyTable(BinaryTable& table, bool& is_target, bool& reins
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked by the superclass when a previously modified NIT is reused.
+//----------------------------------------------------------------------------
+
+void ts::NITPlugin::modifiedTableReused(const BinaryTable& table, bool is_target)
+{
+    // Keep track of the version of the last valid NIT, the content is unchanged.
+    if (is_target) {
+        _last_nit.version = table.version();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  This method processes a NIT descriptor list
 //----------------------------------------------------------------------------
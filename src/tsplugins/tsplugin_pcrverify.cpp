@@ -79,6 +79,12 @@ namespace ts {
         PacketCounter            _nb_pcr_unchecked;  // Number of unchecked PCR (no previous ref)
         std::map<PID,PIDContext> _stats;             // Per-PID statistics
 
+        // Exported metrics.
+        PluginMetrics::Metric& _metric_ok;
+        PluginMetrics::Metric& _metric_nok;
+        PluginMetrics::Metric& _metric_unchecked;
+        PluginMetrics::Metric& _metric_jitter;
+
         // PCR units per micro-second.
         static constexpr int64_t PCR_PER_MICRO_SEC = int64_t(SYSTEM_CLOCK_FREQ) / MicroSecPerSec;
         static constexpr int64_t DEFAULT_JITTER_MAX_US = 1000; // 1000 us = 1 ms
@@ -128,7 +134,11 @@ ts::PCRVerifyPlugin::PCRVerifyPlugin(TSP* tsp_) :
     _nb_pcr_ok(0),
     _nb_pcr_nok(0),
     _nb_pcr_unchecked(0),
-    _stats()
+    _stats(),
+    _metric_ok(tsp->metrics().metric(u"pcr_ok", PluginMetrics::Type::COUNTER, u"Number of PCR without excessive jitter")),
+    _metric_nok(tsp->metrics().metric(u"pcr_jitter_errors", PluginMetrics::Type::COUNTER, u"Number of PCR with excessive jitter")),
+    _metric_unchecked(tsp->metrics().metric(u"pcr_unchecked", PluginMetrics::Type::COUNTER, u"Number of unchecked PCR")),
+    _metric_jitter(tsp->metrics().metric(u"pcr_jitter_nanoseconds", PluginMetrics::Type::GAUGE, u"Absolute jitter of the last checked PCR"))
 {
     option(u"absolute", 'a');
     help(u"absolute",
@@ -213,6 +223,10 @@ bool ts::PCRVerifyPlugin::start()
     _nb_pcr_nok = 0;
     _nb_pcr_unchecked = 0;
     _stats.clear();
+    _metric_ok.set(0);
+    _metric_nok.set(0);
+    _metric_unchecked.set(0);
+    _metric_jitter.set(0);
     return true;
 }
 
@@ -306,6 +320,9 @@ ts::ProcessorPlugin::Status ts::PCRVerifyPlugin::processPacket(TSPacket& pkt, TS
 
             // Absolute value of PCR jitter:
             const int64_t ajit = jitter >= 0 ? jitter : -jitter;
+            if (ajit <= _jitter_unreal) {
+                _metric_jitter.set((ajit * NanoSecPerSec) / SYSTEM_CLOCK_FREQ);
+            }
             if (ajit <= _jitter_max) {
                 _nb_pcr_ok++;
             }
@@ -330,6 +347,11 @@ ts::ProcessorPlugin::Status ts::PCRVerifyPlugin::processPacket(TSPacket& pkt, TS
 
         // Remember PCR position
         pc = next_pc;
+
+        // Publish updated counters.
+        _metric_ok.set(int64_t(_nb_pcr_ok));
+        _metric_nok.set(int64_t(_nb_pcr_nok));
+        _metric_unchecked.set(int64_t(_nb_pcr_unchecked));
     }
 
     return TSP_OK;
@@ -103,7 +103,9 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // Description of a crypto-period.
@@ -195,6 +197,11 @@ namespace ts {
         size_t            _current_ecm;         // Index to current ECM (ECM being broadcast)
         TSScrambling      _scrambling;          // Scrambler
         CyclingPacketizer _pzer_pmt;            // Packetizer for modified PMT
+        size_t            _packet_window;       // Number of packets to process at once, zero means one by one.
+        std::vector<TSPacket*> _batch;          // Packets to scramble in the current window.
+        size_t            _batch_first;         // Index in window of first packet in _batch.
+        size_t            _win_index;           // Index in window of current packet.
+        size_t            _win_end;             // Index in window where processing ends.
 
         // Return current/next CryptoPeriod for CW or ECM
         CryptoPeriod& currentCW()  { return _cp[_current_cw]; }
@@ -202,6 +209,9 @@ namespace ts {
         CryptoPeriod& currentECM() { return _cp[_current_ecm]; }
         CryptoPeriod& nextECM()    { return _cp[(_current_ecm + 1) & 0x01]; }
 
+        // Scramble the packets in _batch with the current control word.
+        bool flushBatch();
+
         // Perform CW and ECM transition
         bool changeCW();
         void changeECM();
@@ -264,7 +274,12 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     _current_cw(0),
     _current_ecm(0),
     _scrambling(*tsp),
-    _pzer_pmt(duck)
+    _pzer_pmt(duck),
+    _packet_window(0),
+    _batch(),
+    _batch_first(0),
+    _win_index(0),
+    _win_end(0)
 {
     // We need to define character sets to specify service names.
     duck.defineArgsForCharset(*this);
@@ -436,6 +451,11 @@ bool ts::ScramblerPlugin::start()
         return false;
     }
 
+    // Only DVB-CSA2 takes advantage of processing packets in batches.
+    _packet_window = _scrambling.scramblingType() == SCRAMBLING_DVB_CSA2 ? _scrambling.packetWindow() : 0;
+    _batch.clear();
+    _batch.reserve(_packet_window);
+
     // Initialize ECMG.
     if (_need_ecm) {
         if (!_ecmg_args.ecmg_address.hasAddress()) {
@@ -683,6 +703,11 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
 
 bool ts::ScramblerPlugin::changeCW()
 {
+    // Packets which were collected so far use the previous control word.
+    if (!flushBatch()) {
+        return false;
+    }
+
     if (_scrambling.hasFixedCW()) {
         // A list of fixed CW was loaded from a file.
 
@@ -848,8 +873,14 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
         _partial_clear = _partial_scrambling - 1;
     }
 
-    // Scramble the packet payload.
-    if (!_scrambling.encrypt(pkt)) {
+    // Scramble the packet payload, now or later in a batch, in packet window mode.
+    if (_packet_window > 0) {
+        if (_batch.empty()) {
+            _batch_first = _win_index;
+        }
+        _batch.push_back(&pkt);
+    }
+    else if (!_scrambling.encrypt(pkt)) {
         return TSP_END;
     }
     _scrambled_count++;
@@ -858,6 +889,73 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
 }
 
 
+//----------------------------------------------------------------------------
+// Get the preferred packet window size.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::getPacketWindowSize()
+{
+    return _packet_window;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Process all packets one by one, except the actual scrambling which is
+    // collected in a batch. The batch is scrambled at each control word change
+    // and at the end of the window.
+    _batch.clear();
+    _win_end = win.size();
+    for (_win_index = 0; _win_index < _win_end; ++_win_index) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* pkt_data = nullptr;
+        if (win.get(_win_index, pkt, pkt_data)) {
+            switch (processPacket(*pkt, *pkt_data)) {
+                case TSP_OK:
+                    break;
+                case TSP_NULL:
+                    win.nullify(_win_index);
+                    break;
+                case TSP_DROP:
+                    win.drop(_win_index);
+                    break;
+                case TSP_END:
+                default:
+                    _win_end = _win_index;
+                    break;
+            }
+        }
+    }
+
+    // Scramble the last batch. In case of error, _win_end is before the first unscrambled packet.
+    flushBatch();
+    return _win_end;
+}
+
+
+//----------------------------------------------------------------------------
+// Scramble the packets which were collected in the packet window.
+//----------------------------------------------------------------------------
+
+bool ts::ScramblerPlugin::flushBatch()
+{
+    bool ok = true;
+    if (!_batch.empty()) {
+        ok = _scrambling.encrypt(_batch.data(), _batch.size());
+        if (!ok) {
+            // Terminate before the first packet of the batch, do not let clear packets pass.
+            _win_end = std::min(_win_end, _batch_first);
+        }
+        _batch.clear();
+    }
+    return ok;
+}
+
+
 //----------------------------------------------------------------------------
 // CryptoPeriod default constructor.
 //----------------------------------------------------------------------------
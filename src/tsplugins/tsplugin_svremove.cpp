@@ -131,6 +131,11 @@ ts::SVRemovePlugin::SVRemovePlugin (TSP* tsp_) :
          u"Otherwise, it is interpreted as a service name, as specified in the SDT. "
          u"The name is not case sensitive and blanks are ignored.");
 
+    option(u"eit-spill-directory", 0, STRING);
+    help(u"eit-spill-directory", u"path",
+         u"When too many EIT sections are buffered (huge EPG), store the sections in excess "
+         u"in a temporary file in the specified directory instead of dropping them.");
+
     option(u"ignore-absent", 'a');
     help(u"ignore-absent",
          u"Ignore service if not present in the transport stream. By default, tsp "
@@ -185,6 +190,7 @@ bool ts::SVRemovePlugin::start()
 
     // Initialize the EIT processing.
     _eit_process.reset();
+    _eit_process.setSpillDirectory(value(u"eit-spill-directory"));
 
     // Build a list of referenced PID's (except those in the removed service).
     // Prevent predefined PID's from being removed.
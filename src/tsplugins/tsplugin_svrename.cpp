@@ -127,6 +127,11 @@ ts::SVRenamePlugin::SVRenamePlugin(TSP* tsp_) :
     option(u"free-ca-mode", 'f', INTEGER, 0, 1, 0, 1);
     help(u"free-ca-mode", u"Specify a new free_CA_mode to set in the SDT (0 or 1).");
 
+    option(u"eit-spill-directory", 0, STRING);
+    help(u"eit-spill-directory", u"path",
+         u"When too many EIT sections are buffered (huge EPG), store the sections in excess "
+         u"in a temporary file in the specified directory instead of dropping them.");
+
     option(u"id", 'i', UINT16);
     help(u"id", u"Specify a new service id value.");
 
@@ -202,6 +207,7 @@ bool ts::SVRenamePlugin::start()
 
     // Initialize the EIT processing.
     _eit_process.reset();
+    _eit_process.setSpillDirectory(value(u"eit-spill-directory"));
 
     // No need to modify EIT's if there is no new service id.
     if (!_new_service.hasId()) {
@@ -134,6 +134,11 @@ ts::TimeRefPlugin::TimeRefPlugin(TSP* tsp_) :
         u"Same as --eit but update the date field only in the event start dates in EIT's. "
         u"The hour, minute and second fields of the event start dates are left unchanged.");
 
+    option(u"eit-spill-directory", 0, STRING);
+    help(u"eit-spill-directory", u"path",
+         u"When too many EIT sections are buffered (huge EPG), store the sections in excess "
+         u"in a temporary file in the specified directory instead of dropping them.");
+
     option(u"local-time-offset", 'l', INTEGER, 0, 1, -720, 720);
     help(u"local-time-offset", u"minutes",
          u"Specify a new local time offset in minutes to set in the TOT. "
@@ -264,6 +269,7 @@ bool ts::TimeRefPlugin::start()
     _timeref = _startref;
     _timeref_pkt = 0;
     _eit_processor.reset();
+    _eit_processor.setSpillDirectory(value(u"eit-spill-directory"));
     _eit_active = _update_eit && _add_milliseconds != 0;
     if (_eit_active) {
         _eit_processor.addStartTimeOffet(_add_milliseconds, _eit_date_only);
@@ -131,6 +131,11 @@ ts::TSRenamePlugin::TSRenamePlugin(TSP* tsp_) :
          u"Add a new entry for the renamed TS in the NIT and keep the previous "
          u"entry. By default, the TS entry is renamed.");
 
+    option(u"eit-spill-directory", 0, STRING);
+    help(u"eit-spill-directory", u"path",
+         u"When too many EIT sections are buffered (huge EPG), store the sections in excess "
+         u"in a temporary file in the specified directory instead of dropping them.");
+
     option(u"ignore-bat");
     help(u"ignore-bat", u"Do not modify the BAT.");
 
@@ -171,6 +176,7 @@ bool ts::TSRenamePlugin::start()
 
     // Initialize the EIT processing.
     _eit_process.reset();
+    _eit_process.setSpillDirectory(value(u"eit-spill-directory"));
 
     // No need to modify EIT's if there is no new TS id and no new net id.
     if (!_set_ts_id && !_set_onet_id) {
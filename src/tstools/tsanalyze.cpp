@@ -56,6 +56,7 @@ namespace {
         ts::BitRate           bitrate;   // Expected bitrate (188-byte packets)
         ts::UString           infile;    // Input file name
         ts::TSPacketFormat    format;    // Input file format.
+        ts::TSFile::ReadMode  read_mode; // Input file read method.
         ts::TSAnalyzerOptions analysis;  // Analysis options.
         ts::PagerArgs         pager;     // Output paging options.
     };
@@ -67,6 +68,7 @@ Options::Options(int argc, char *argv[]) :
     bitrate(0),
     infile(),
     format(ts::TSPacketFormat::AUTODETECT),
+    read_mode(ts::TSFile::READ_SYSCALL),
     analysis(),
     pager(true, true)
 {
@@ -95,6 +97,14 @@ Options::Options(int argc, char *argv[]) :
          u"(for instance when the first time-stamp of an M2TS file starts with 0x47). "
          u"Using this option forces a specific format.");
 
+    option(u"read-mode", 0, ts::TSFile::ReadModeEnum);
+    help(u"read-mode", u"name",
+         u"Specify the method to read the input file. "
+         u"The default is \"read\", the standard read system calls. "
+         u"With \"mmap\", the file is mapped in memory by successive windows for sequential access (UNIX only). "
+         u"With \"io-uring\", several large read requests are permanently outstanding (Linux only). "
+         u"These methods may be faster on very large files.");
+
     analyze(argc, argv);
 
     // Define all standard analysis options.
@@ -105,6 +115,7 @@ Options::Options(int argc, char *argv[]) :
     getValue(infile, u"");
     getFixedValue(bitrate, u"bitrate");
     getIntValue(format, u"format", ts::TSPacketFormat::AUTODETECT);
+    getIntValue(read_mode, u"read-mode", ts::TSFile::READ_SYSCALL);
 
     exitOnError();
 }
@@ -125,14 +136,18 @@ int MainCode(int argc, char *argv[])
 
     // Open the TS file.
     ts::TSFile file;
+    file.setReadMode(opt.read_mode);
     if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
         return EXIT_FAILURE;
     }
 
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        analyzer.feedPacket(pkt);
+    // Analyze all packets in the file, read by chunks of packets.
+    ts::TSPacketVector buffer(1024);
+    size_t count = 0;
+    while ((count = file.readPackets(buffer.data(), nullptr, buffer.size(), opt)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            analyzer.feedPacket(buffer[i]);
+        }
     }
     file.close(opt);
 
@@ -60,6 +60,7 @@ namespace {
 
         ts::DuckContext      duck;
         ts::TSPacketFormat   format;
+        ts::TSFile::ReadMode read_mode;
         ts::UString          filename1;
         ts::UString          filename2;
         uint64_t             byte_offset;
@@ -83,6 +84,7 @@ Options::Options(int argc, char *argv[]) :
     Args(u"Compare two transport stream files", u"[options] filename-1 filename-2"),
     duck(this),
     format(ts::TSPacketFormat::AUTODETECT),
+    read_mode(ts::TSFile::READ_SYSCALL),
     filename1(),
     filename2(),
     byte_offset(0),
@@ -149,6 +151,14 @@ Options::Options(int argc, char *argv[]) :
          u"Do not output any message. The process simply terminates with a success "
          u"status if the files are identical and a failure status if they differ.");
 
+    option(u"read-mode", 0, ts::TSFile::ReadModeEnum);
+    help(u"read-mode", u"name",
+         u"Specify the method to read the input files. "
+         u"The default is \"read\", the standard read system calls. "
+         u"With \"mmap\", the files are mapped in memory by successive windows for sequential access (UNIX only). "
+         u"With \"io-uring\", several large read requests are permanently outstanding (Linux only). "
+         u"These methods may be faster on very large files.");
+
     option(u"subset", 's');
     help(u"subset",
          u"Specifies that the second file is a subset of the first one. This means "
@@ -173,6 +183,7 @@ Options::Options(int argc, char *argv[]) :
     getValue(filename2, u"", u"", 1);
 
     getIntValue(format, u"format", ts::TSPacketFormat::AUTODETECT);
+    getIntValue(read_mode, u"read-mode", ts::TSFile::READ_SYSCALL);
     getIntValue(buffered_packets, u"buffered-packets", DEFAULT_BUFFERED_PACKETS);
     byte_offset = intValue<uint64_t>(u"byte-offset", intValue<uint64_t>(u"packet-offset", 0) * ts::PKT_SIZE);
     getIntValue(threshold_diff, u"threshold-diff", 0);
@@ -331,6 +342,8 @@ int MainCode(int argc, char *argv[])
     ts::TSFileInputBuffered file2(opt.buffered_packets);
 
     // Open files
+    file1.setReadMode(opt.read_mode);
+    file2.setReadMode(opt.read_mode);
     file1.openRead(opt.filename1, 1, opt.byte_offset, opt, opt.format);
     file2.openRead(opt.filename2, 1, opt.byte_offset, opt, opt.format);
     opt.exitOnError();
@@ -0,0 +1,261 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Farm of transport stream processors in one process.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMain.h"
+#include "tsTSProcessorFarm.h"
+#include "tsArgsWithPlugins.h"
+#include "tsDuckContext.h"
+#include "tsPluginRepository.h"
+#include "tsAsyncReport.h"
+#include "tsUserInterrupt.h"
+TSDUCK_SOURCE;
+TS_MAIN(MainCode);
+
+// With static link, enforce a reference to MPEG/DVB structures.
+#if defined(TSDUCK_STATIC_LIBRARY)
+#include "tsStaticReferencesDVB.h"
+const ts::StaticReferencesDVB dependenciesForStaticLib;
+#endif
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+namespace {
+    class FarmOptions: public ts::Args
+    {
+        TS_NOBUILD_NOCOPY(FarmOptions);
+    public:
+        FarmOptions(int argc, char *argv[]);
+
+        // Option values
+        ts::UString             config_file;  // Configuration file with all chains.
+        bool                    manual_start; // Do not start the chains, wait for control commands.
+        ts::DuckContext         duck;         // TSDuck context
+        ts::AsyncReportArgs     log_args;     // Asynchronous logger arguments.
+        ts::TSProcessorFarmArgs farm_args;    // Farm arguments.
+    };
+}
+
+FarmOptions::FarmOptions(int argc, char *argv[]) :
+    ts::Args(u"Run many transport stream processors in one process", u"[options] config-file"),
+    config_file(),
+    manual_start(false),
+    duck(this),
+    log_args(),
+    farm_args()
+{
+    log_args.defineArgs(*this);
+    farm_args.defineArgs(*this);
+
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"filename",
+         u"Configuration file describing all processing chains. "
+         u"Each line describes one chain using the syntax 'name: tsp-options -I ... -P ... -O ...', "
+         u"i.e. a chain name, a colon and the parameters of an equivalent tsp command. "
+         u"A line ending with a backslash continues on the next line. "
+         u"Empty lines and lines starting with '#' are ignored.");
+
+    option(u"manual-start");
+    help(u"manual-start",
+         u"Do not start the processing chains when tspfarm starts. "
+         u"Each chain shall be started using the control command 'start'. "
+         u"This option requires --control-port.");
+
+    // Analyze the command.
+    analyze(argc, argv);
+
+    // Load option values.
+    getValue(config_file, u"");
+    manual_start = present(u"manual-start");
+    log_args.loadArgs(duck, *this);
+    farm_args.loadArgs(duck, *this);
+
+    if (manual_start && farm_args.control_port == 0) {
+        error(u"--manual-start requires --control-port");
+    }
+
+    // Final checking
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  Command line options of one processing chain.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ChainOptions: public ts::ArgsWithPlugins
+    {
+        TS_NOBUILD_NOCOPY(ChainOptions);
+    public:
+        ChainOptions(const ts::UString& name, const ts::UStringVector& args);
+
+        ts::DuckContext     duck;      // TSDuck context
+        ts::TSProcessorArgs tsp_args;  // TS processing arguments.
+    };
+}
+
+ChainOptions::ChainOptions(const ts::UString& name, const ts::UStringVector& args) :
+    ts::ArgsWithPlugins(0, 1, 0, UNLIMITED_COUNT, 0, 1),
+    duck(this),
+    tsp_args()
+{
+    setDescription(u"Processing chain " + name);
+    tsp_args.defineArgs(*this);
+    if (analyze(name, args)) {
+        tsp_args.loadArgs(duck, *this);
+    }
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  Load the processing chains from the configuration file.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool LoadChains(ts::TSProcessorFarm& farm, FarmOptions& opt)
+    {
+        ts::UStringList lines;
+        if (!ts::UString::Load(lines, opt.config_file)) {
+            opt.error(u"error loading %s", {opt.config_file});
+            return false;
+        }
+
+        size_t count = 0;
+        ts::UString line;
+        for (auto it = lines.begin(); it != lines.end(); ++it) {
+            // Accumulate continuation lines.
+            line.append(*it);
+            line.trim();
+            if (line.endWith(u"\\")) {
+                line.pop_back();
+                line.append(u" ");
+                continue;
+            }
+            if (!line.empty() && !line.startWith(u"#")) {
+                // Line format: "name: tsp-options ..."
+                const size_t colon = line.find(u':');
+                const ts::UString name(colon == ts::NPOS ? ts::UString() : line.substr(0, colon).toTrimmed());
+                if (name.empty() || name.find(u' ') != ts::NPOS) {
+                    opt.error(u"invalid line in %s: %s", {opt.config_file, line});
+                    return false;
+                }
+                ts::UStringVector args;
+                line.substr(colon + 1).fromQuotedLine(args);
+                ChainOptions chain(name, args);
+                if (!farm.addChain(name, chain.tsp_args, !opt.manual_start)) {
+                    return false;
+                }
+                count++;
+            }
+            line.clear();
+        }
+
+        opt.verbose(u"loaded %d processing chains from %s", {count, opt.config_file});
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Interrupt handler
+//----------------------------------------------------------------------------
+
+class FarmInterruptHandler: public ts::InterruptHandler
+{
+    TS_NOBUILD_NOCOPY(FarmInterruptHandler);
+public:
+    FarmInterruptHandler(ts::AsyncReport* report, ts::TSProcessorFarm* farm);
+    virtual void handleInterrupt() override;
+private:
+    ts::AsyncReport*      _report;
+    ts::TSProcessorFarm* _farm;
+};
+
+FarmInterruptHandler::FarmInterruptHandler(ts::AsyncReport* report, ts::TSProcessorFarm* farm) :
+    _report(report),
+    _farm(farm)
+{
+}
+
+void FarmInterruptHandler::handleInterrupt()
+{
+    _report->info(u"tspfarm: user interrupt, terminating...");
+    _farm->abort();
+}
+
+
+//----------------------------------------------------------------------------
+//  Program main code.
+//----------------------------------------------------------------------------
+
+int MainCode(int argc, char *argv[])
+{
+    // Internal sanity check about TS packets.
+    ts::TSPacket::SanityCheck();
+
+    // Get command line options.
+    FarmOptions opt(argc, argv);
+    CERR.setMaxSeverity(opt.maxSeverity());
+
+    // If plugins were statically linked, disallow the dynamic loading of plugins.
+#if defined(TSDUCK_STATIC_PLUGINS)
+    ts::PluginRepository::Instance()->setSharedLibraryAllowed(false);
+#endif
+
+    // Prevent from being killed when writing on broken pipes.
+    ts::IgnorePipeSignal();
+
+    // Create an asynchronous error logger, shared by all chains.
+    ts::AsyncReport report(opt.maxSeverity(), opt.log_args);
+
+    // All processing chains are running in this object.
+    ts::TSProcessorFarm farm(report);
+    if (!LoadChains(farm, opt)) {
+        return EXIT_FAILURE;
+    }
+
+    // Use a Ctrl+C interrupt handler
+    FarmInterruptHandler interrupt_handler(&report, &farm);
+    ts::UserInterrupt interrupt_manager(&interrupt_handler, true, true);
+
+    // Start the farm and wait for its termination.
+    if (!farm.start(opt.farm_args)) {
+        return EXIT_FAILURE;
+    }
+    farm.waitForTermination();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,357 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for the table cache of class ts::AbstractTablePlugin.
+//  The nit plugin is loaded from its shared library. Like the plugin
+//  repository tests, this test suite is not used with the static library.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractTablePlugin.h"
+#include "tsPluginRepository.h"
+#include "tsOneShotPacketizer.h"
+#include "tsServiceListDescriptor.h"
+#include "tsPAT.h"
+#include "tsSDT.h"
+#include "tsNIT.h"
+#include "tsNullReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class AbstractTablePluginTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testCache();
+    void testNIT();
+
+    TSUNIT_TEST_BEGIN(AbstractTablePluginTest);
+    TSUNIT_TEST(testCache);
+    TSUNIT_TEST(testNIT);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(AbstractTablePluginTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void AbstractTablePluginTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void AbstractTablePluginTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Minimal plugin execution context, without tsp.
+    class TestTSP: public ts::TSP
+    {
+        TS_NOCOPY(TestTSP);
+    public:
+        TestTSP() : TSP(ts::Severity::Info), _plugin(nullptr) {}
+        void setPlugin(ts::ProcessorPlugin* plugin) { _plugin = plugin; }
+
+        // Process one packet in the plugin, return the modified packet.
+        ts::TSPacket process(const ts::TSPacket& pkt)
+        {
+            ts::TSPacket out(pkt);
+            ts::TSPacketMetadata mdata;
+            TSUNIT_ASSERT(_plugin->processPacket(out, mdata) == ts::ProcessorPlugin::TSP_OK);
+            addPluginPackets(1);
+            return out;
+        }
+
+        // Implementation of TSP.
+        virtual ts::Plugin* plugin() const override { return _plugin; }
+        virtual ts::UString pluginName() const override { return u"test"; }
+        virtual size_t pluginIndex() const override { return 0; }
+        virtual size_t pluginCount() const override { return 1; }
+        virtual void signalPluginEvent(uint32_t, ts::Object*) const override {}
+        virtual void useJointTermination(bool) override {}
+        virtual void jointTerminate() override {}
+        virtual bool useJointTermination() const override { return false; }
+        virtual bool thisJointTerminated() const override { return false; }
+
+    protected:
+        virtual void writeLog(int, const ts::UString&) override {}
+
+    private:
+        ts::ProcessorPlugin* _plugin;
+    };
+
+    // A PAT plugin which adds one service and counts the calls to modifyTable().
+    class PATTestPlugin: public ts::AbstractTablePlugin
+    {
+        TS_NOBUILD_NOCOPY(PATTestPlugin);
+    public:
+        size_t modified;  // Number of calls to modifyTable().
+        size_t reused;    // Number of calls to modifiedTableReused().
+
+        explicit PATTestPlugin(ts::TSP* t) :
+            AbstractTablePlugin(t, u"Test PAT plugin", u"[options]", u"PAT", ts::PID_PAT),
+            modified(0),
+            reused(0),
+            _demux(nullptr)
+        {
+        }
+
+        // Pass a table to the superclass as if it was received again from the input PID.
+        void passTable(const ts::BinaryTable& table)
+        {
+            TSUNIT_ASSERT(_demux != nullptr);
+            AbstractTablePlugin::handleTable(*_demux, table);
+        }
+
+        // Simulate an external event which changes the way the tables are modified.
+        void clearCache() { clearTableCache(); }
+
+    protected:
+        virtual void modifyTable(ts::BinaryTable& table, bool& is_target, bool& reinsert) override
+        {
+            modified++;
+            ts::PAT pat(duck, table);
+            TSUNIT_ASSERT(pat.isValid());
+            pat.pmts[0x0100] = 0x1000;
+            pat.serialize(duck, table);
+        }
+
+        virtual void createNewTable(ts::BinaryTable& table) override
+        {
+            ts::PAT().serialize(duck, table);
+        }
+
+        virtual void modifiedTableReused(const ts::BinaryTable&, bool is_target) override
+        {
+            TSUNIT_ASSERT(is_target);
+            reused++;
+        }
+
+        // Remember the demux of the superclass.
+        virtual void handleTable(ts::SectionDemux& demux, const ts::BinaryTable& table) override
+        {
+            _demux = &demux;
+            AbstractTablePlugin::handleTable(demux, table);
+        }
+
+    private:
+        ts::SectionDemux* _demux;
+    };
+
+    // Send a table through a plugin, return the table in the last output packet.
+    // All tables in these tests fit in one packet. The packetizer keeps the continuity counters.
+    ts::BinaryTable Process(TestTSP& tsp, ts::DuckContext& duck, ts::OneShotPacketizer& pzer, const ts::AbstractTable& table)
+    {
+        pzer.removeAll();
+        pzer.addTable(duck, table);
+        ts::TSPacketVector packets;
+        pzer.getPackets(packets);
+        TSUNIT_EQUAL(1, packets.size());
+
+        const ts::TSPacket out(tsp.process(packets[0]));
+        TSUNIT_ASSERT(out.getPUSI());
+        const uint8_t* data = out.getPayload() + 1 + out.getPayload()[0];
+        const size_t size = 3 + (ts::GetUInt16(data + 1) & 0x0FFF);
+        TSUNIT_ASSERT(data + size <= out.b + ts::PKT_SIZE);
+
+        ts::BinaryTable bin;
+        TSUNIT_ASSERT(bin.addSection(new ts::Section(data, size, out.getPID(), ts::CRC32::CHECK)));
+        TSUNIT_ASSERT(bin.isValid());
+        return bin;
+    }
+
+    // Check if the NIT contains a service in a service list descriptor of a TS.
+    bool HasService(ts::DuckContext& duck, const ts::NIT& nit, const ts::TransportStreamId& tsid, uint16_t service_id)
+    {
+        const auto it = nit.transports.find(tsid);
+        if (it == nit.transports.end()) {
+            return false;
+        }
+        const size_t index = it->second.descs.search(ts::DID_SERVICE_LIST);
+        if (index >= it->second.descs.size()) {
+            return false;
+        }
+        const ts::ServiceListDescriptor sld(duck, *it->second.descs[index]);
+        return sld.isValid() && sld.hasService(service_id);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Reuse and invalidation of modified tables in the superclass.
+void AbstractTablePluginTest::testCache()
+{
+    ts::DuckContext duck;
+    TestTSP tsp;
+    PATTestPlugin plugin(&tsp);
+    tsp.setPlugin(&plugin);
+    TSUNIT_ASSERT(plugin.analyze(u"test", ts::UStringVector(), false));
+    TSUNIT_ASSERT(plugin.getOptions());
+    TSUNIT_ASSERT(plugin.start());
+
+    ts::OneShotPacketizer pzer(duck, ts::PID_PAT);
+    ts::PAT pat(1, true, 10);
+    pat.pmts[0x0001] = 0x0200;
+
+    // First table: modified.
+    ts::PAT out(duck, Process(tsp, duck, pzer, pat));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_EQUAL(1, plugin.modified);
+    TSUNIT_EQUAL(0, plugin.reused);
+    TSUNIT_EQUAL(1, out.version);
+    TSUNIT_EQUAL(2, out.pmts.size());
+    TSUNIT_EQUAL(0x1000, out.pmts[0x0100]);
+
+    // Identical repetition: the cached modified table is reused.
+    ts::BinaryTable bin;
+    pat.serialize(duck, bin);
+    bin.setSourcePID(ts::PID_PAT);
+    plugin.passTable(bin);
+    TSUNIT_EQUAL(1, plugin.modified);
+    TSUNIT_EQUAL(1, plugin.reused);
+    out.deserialize(duck, Process(tsp, duck, pzer, pat));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_EQUAL(1, out.version);
+    TSUNIT_EQUAL(2, out.pmts.size());
+
+    // Same content with another version: reused with the new version.
+    pat.version = 2;
+    out.deserialize(duck, Process(tsp, duck, pzer, pat));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_EQUAL(1, plugin.modified);
+    TSUNIT_EQUAL(2, plugin.reused);
+    TSUNIT_EQUAL(2, out.version);
+    TSUNIT_EQUAL(2, out.pmts.size());
+
+    // Modified content: the cache is not used.
+    pat.version = 3;
+    pat.pmts[0x0002] = 0x0300;
+    out.deserialize(duck, Process(tsp, duck, pzer, pat));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_EQUAL(2, plugin.modified);
+    TSUNIT_EQUAL(2, plugin.reused);
+    TSUNIT_EQUAL(3, out.version);
+    TSUNIT_EQUAL(3, out.pmts.size());
+    TSUNIT_EQUAL(0x1000, out.pmts[0x0100]);
+
+    // After clearing the cache, an identical table is modified again.
+    plugin.clearCache();
+    pat.serialize(duck, bin);
+    bin.setSourcePID(ts::PID_PAT);
+    plugin.passTable(bin);
+    TSUNIT_EQUAL(3, plugin.modified);
+    TSUNIT_EQUAL(2, plugin.reused);
+
+    TSUNIT_ASSERT(plugin.stop());
+}
+
+// The nit plugin invalidates its modified NIT when the PAT or SDT change.
+void AbstractTablePluginTest::testNIT()
+{
+    ts::PluginRepository::ProcessorPluginFactory factory = ts::PluginRepository::Instance()->getProcessor(u"nit", NULLREP);
+    TSUNIT_ASSERT(factory != nullptr);
+
+    ts::DuckContext duck;
+    TestTSP tsp;
+    ts::ProcessorPlugin* plugin = factory(&tsp);
+    TSUNIT_ASSERT(plugin != nullptr);
+    tsp.setPlugin(plugin);
+    TSUNIT_ASSERT(plugin->analyze(u"nit", {u"--build-service-list-descriptors", u"--default-service-type", u"0x19"}, false));
+    TSUNIT_ASSERT(plugin->getOptions());
+    TSUNIT_ASSERT(plugin->start());
+
+    const ts::TransportStreamId tsid(10, 20);
+    ts::OneShotPacketizer pat_pzer(duck, ts::PID_PAT);
+    ts::OneShotPacketizer sdt_pzer(duck, ts::PID_SDT);
+    ts::OneShotPacketizer nit_pzer(duck, ts::PID_NIT);
+
+    // SDT and PAT with one service.
+    ts::SDT sdt(true, 0, true, tsid.transport_stream_id, tsid.original_network_id);
+    sdt.services[0x0100].setName(duck, u"first", 0x01);
+    Process(tsp, duck, sdt_pzer, sdt);
+    ts::PAT pat(0, true, tsid.transport_stream_id);
+    pat.pmts[0x0100] = 0x1000;
+    Process(tsp, duck, pat_pzer, pat);
+
+    // First NIT: the service list descriptor is built.
+    ts::NIT nit(true, 0, true, 1);
+    nit.transports[tsid];
+    ts::NIT out(duck, Process(tsp, duck, nit_pzer, nit));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_ASSERT(HasService(duck, out, tsid, 0x0100));
+    TSUNIT_ASSERT(!HasService(duck, out, tsid, 0x0200));
+
+    // New service in the SDT.
+    sdt.version = 1;
+    sdt.services[0x0200].setName(duck, u"second", 0x01);
+    Process(tsp, duck, sdt_pzer, sdt);
+
+    // New NIT version with the same content: the previous modified NIT is not reused.
+    nit.version = 1;
+    out.deserialize(duck, Process(tsp, duck, nit_pzer, nit));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_ASSERT(HasService(duck, out, tsid, 0x0100));
+    TSUNIT_ASSERT(HasService(duck, out, tsid, 0x0200));
+    TSUNIT_ASSERT(!HasService(duck, out, tsid, 0x0300));
+
+    // New service in the PAT only.
+    pat.version = 1;
+    pat.pmts[0x0300] = 0x3000;
+    Process(tsp, duck, pat_pzer, pat);
+
+    nit.version = 2;
+    out.deserialize(duck, Process(tsp, duck, nit_pzer, nit));
+    TSUNIT_ASSERT(out.isValid());
+    TSUNIT_ASSERT(HasService(duck, out, tsid, 0x0100));
+    TSUNIT_ASSERT(HasService(duck, out, tsid, 0x0200));
+    TSUNIT_ASSERT(HasService(duck, out, tsid, 0x0300));
+
+    TSUNIT_ASSERT(plugin->stop());
+    delete plugin;
+}
@@ -0,0 +1,168 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::AdaptivePacketWindow
+//
+//----------------------------------------------------------------------------
+
+#include "tsAdaptivePacketWindow.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class AdaptivePacketWindowTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testReset();
+    void testGrow();
+    void testShrink();
+
+    TSUNIT_TEST_BEGIN(AdaptivePacketWindowTest);
+    TSUNIT_TEST(testReset);
+    TSUNIT_TEST(testGrow);
+    TSUNIT_TEST(testShrink);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(AdaptivePacketWindowTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void AdaptivePacketWindowTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void AdaptivePacketWindowTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void AdaptivePacketWindowTest::testReset()
+{
+    ts::AdaptivePacketWindow win(100, 1000);
+    TSUNIT_EQUAL(100, win.size());
+    TSUNIT_EQUAL(100, win.minSize());
+    TSUNIT_EQUAL(1000, win.maxSize());
+
+    TSUNIT_ASSERT(!win.isFull(99));
+    TSUNIT_ASSERT(win.isFull(100));
+    TSUNIT_ASSERT(win.isFull(150));
+    TSUNIT_EQUAL(30, win.freeSize(70));
+    TSUNIT_EQUAL(0, win.freeSize(100));
+    TSUNIT_EQUAL(0, win.freeSize(150));
+
+    // Minimum size is limited by the maximum size and is at least 1.
+    win.reset(2000, 1000, ts::Monotonic(true));
+    TSUNIT_EQUAL(1000, win.size());
+    TSUNIT_EQUAL(1000, win.minSize());
+
+    win.reset(0, 1000, ts::Monotonic(true));
+    TSUNIT_EQUAL(1, win.size());
+    TSUNIT_EQUAL(1, win.minSize());
+}
+
+void AdaptivePacketWindowTest::testGrow()
+{
+    ts::Monotonic now(true);
+    ts::AdaptivePacketWindow win;
+    win.reset(100, 1000, now);
+
+    // Not blocked, or waited less than the production time: no change.
+    now += ts::NanoSecPerMilliSec;
+    TSUNIT_ASSERT(!win.update(100, false, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(100, win.size());
+    TSUNIT_ASSERT(!win.update(100, true, ts::NanoSecPerMilliSec, 10 * ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(100, win.size());
+
+    // Blocked and waited longer than the production time: doubled, up to the maximum.
+    TSUNIT_ASSERT(win.update(100, true, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(200, win.size());
+    TSUNIT_ASSERT(win.update(200, true, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(400, win.size());
+    TSUNIT_ASSERT(win.update(400, true, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(800, win.size());
+    TSUNIT_ASSERT(win.update(800, true, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(1000, win.size());
+    TSUNIT_ASSERT(!win.update(1000, true, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(1000, win.size());
+}
+
+void AdaptivePacketWindowTest::testShrink()
+{
+    ts::Monotonic now(true);
+    ts::AdaptivePacketWindow win(100, 1000, ts::NanoSecPerSec);
+    win.reset(100, 1000, now);
+
+    // Grow the window to 800 packets, starting a new observation period.
+    for (size_t lag = 100; lag < 800; lag *= 2) {
+        TSUNIT_ASSERT(win.update(lag, true, 10 * ts::NanoSecPerMilliSec, ts::NanoSecPerMilliSec, now));
+    }
+    TSUNIT_EQUAL(800, win.size());
+
+    // A lag of 300 packets is above a quarter of the window: no shrink at end of period.
+    now += 500 * ts::NanoSecPerMilliSec;
+    TSUNIT_ASSERT(!win.update(300, false, 0, ts::NanoSecPerMilliSec, now));
+    now += 500 * ts::NanoSecPerMilliSec;
+    TSUNIT_ASSERT(!win.update(10, false, 0, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(800, win.size());
+
+    // Low lag during one period: halved. Not before the end of the period.
+    now += 500 * ts::NanoSecPerMilliSec;
+    TSUNIT_ASSERT(!win.update(10, false, 0, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(800, win.size());
+    now += 500 * ts::NanoSecPerMilliSec;
+    TSUNIT_ASSERT(win.update(10, false, 0, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(400, win.size());
+
+    // Continue to shrink down to the minimum size.
+    now += ts::NanoSecPerSec;
+    TSUNIT_ASSERT(win.update(10, false, 0, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(200, win.size());
+    now += ts::NanoSecPerSec;
+    TSUNIT_ASSERT(win.update(10, false, 0, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(100, win.size());
+    now += ts::NanoSecPerSec;
+    TSUNIT_ASSERT(!win.update(10, false, 0, ts::NanoSecPerMilliSec, now));
+    TSUNIT_EQUAL(100, win.size());
+}
@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsBuffer.h"
+#include "tsMonotonic.h"
 #include "tsunit.h"
 
 
@@ -55,6 +56,10 @@ public:
     void testReadBitLittleEndian();
     void testReadBitsBigEndian();
     void testReadBitsLittleEndian();
+    void testBitsBigEndianOffsets();
+    void testPutBitsBigEndianOffsets();
+    void testBitsBigEndianErrors();
+    void testBitsBenchmark();
     void testGetUInt8();
     void testGetUInt16BE();
     void testGetUInt16LE();
@@ -111,6 +116,10 @@ public:
     TSUNIT_TEST(testReadBitLittleEndian);
     TSUNIT_TEST(testReadBitsBigEndian);
     TSUNIT_TEST(testReadBitLittleEndian);
+    TSUNIT_TEST(testBitsBigEndianOffsets);
+    TSUNIT_TEST(testPutBitsBigEndianOffsets);
+    TSUNIT_TEST(testBitsBigEndianErrors);
+    TSUNIT_TEST(testBitsBenchmark);
     TSUNIT_TEST(testGetUInt8);
     TSUNIT_TEST(testGetUInt16BE);
     TSUNIT_TEST(testGetUInt16LE);
@@ -922,6 +931,167 @@ void BufferTest::testReadBitsLittleEndian()
     TSUNIT_EQUAL(27, b.currentReadBitOffset());
 }
 
+namespace {
+    // Pseudo-random bytes, reproducible from one run to another.
+    void RandomBytes(uint8_t* data, size_t size, uint32_t seed)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            seed = seed * 1103515245 + 12345;
+            data[i] = uint8_t(seed >> 16);
+        }
+    }
+
+    // Reference bit field access, one bit at a time, big endian.
+    uint64_t RefGetBits(const uint8_t* data, size_t offset, size_t bits)
+    {
+        uint64_t val = 0;
+        for (size_t i = offset; i < offset + bits; ++i) {
+            val = (val << 1) | ((data[i / 8] >> (7 - i % 8)) & 1);
+        }
+        return val;
+    }
+
+    void RefPutBits(uint8_t* data, size_t offset, uint64_t value, size_t bits)
+    {
+        for (size_t i = offset; i < offset + bits; ++i) {
+            const uint8_t mask = uint8_t(0x80 >> (i % 8));
+            if (((value >> (bits - 1 - (i - offset))) & 1) != 0) {
+                data[i / 8] |= mask;
+            }
+            else {
+                data[i / 8] &= ~mask;
+            }
+        }
+    }
+}
+
+void BufferTest::testBitsBigEndianOffsets()
+{
+    // Compare getBits() with a bit-by-bit reference at all bit offsets, for all sizes,
+    // including fields which end close to the end of the buffer.
+    uint8_t data[40];
+    RandomBytes(data, sizeof(data), 0x12345678);
+
+    for (size_t offset = 0; offset < 8 * sizeof(data); ++offset) {
+        for (size_t bits = 1; bits <= 64 && offset + bits <= 8 * sizeof(data); ++bits) {
+            ts::Buffer b(static_cast<const uint8_t*>(data), sizeof(data));
+            TSUNIT_ASSERT(b.readSeek(offset / 8, offset % 8));
+            TSUNIT_EQUAL(RefGetBits(data, offset, bits), b.getBits<uint64_t>(bits));
+            TSUNIT_EQUAL(offset + bits, b.currentReadBitOffset());
+            TSUNIT_ASSERT(!b.readError());
+        }
+    }
+
+    // Narrower integer types keep the least significant bits, as before.
+    ts::Buffer b(static_cast<const uint8_t*>(data), sizeof(data));
+    TSUNIT_ASSERT(b.readSeek(1, 3));
+    TSUNIT_EQUAL(uint8_t(RefGetBits(data, 11, 12)), b.getBits<uint8_t>(12));
+    TSUNIT_EQUAL(23, b.currentReadBitOffset());
+}
+
+void BufferTest::testPutBitsBigEndianOffsets()
+{
+    // Compare putBits() with a bit-by-bit reference. The surrounding bits must be preserved.
+    uint8_t background[40];
+    uint8_t values[8];
+    RandomBytes(background, sizeof(background), 0x87654321);
+    RandomBytes(values, sizeof(values), 0x13579BDF);
+    const uint64_t value = ts::GetUInt64BE(values);
+
+    for (size_t offset = 0; offset < 8 * sizeof(background); ++offset) {
+        for (size_t bits = 1; bits <= 64 && offset + bits <= 8 * sizeof(background); ++bits) {
+            uint8_t ref[sizeof(background)];
+            uint8_t data[sizeof(background)];
+            ::memcpy(ref, background, sizeof(background));
+            ::memcpy(data, background, sizeof(background));
+            RefPutBits(ref, offset, value, bits);
+
+            ts::Buffer b(data, sizeof(data));
+            TSUNIT_ASSERT(b.writeSeek(offset / 8, offset % 8));
+            TSUNIT_ASSERT(b.putBits(value, bits));
+            TSUNIT_EQUAL(offset + bits, b.currentWriteBitOffset());
+            TSUNIT_ASSERT(!b.writeError());
+            TSUNIT_EQUAL(0, ::memcmp(ref, data, sizeof(data)));
+        }
+    }
+}
+
+void BufferTest::testBitsBigEndianErrors()
+{
+    uint8_t data[10];
+    RandomBytes(data, sizeof(data), 0x2468ACE0);
+
+    // Reading beyond the end: no data is returned, the position is unchanged.
+    ts::Buffer rb(static_cast<const uint8_t*>(data), sizeof(data));
+    TSUNIT_ASSERT(rb.readSeek(2, 5));
+    TSUNIT_EQUAL(0, rb.getBits<uint64_t>(60));
+    TSUNIT_ASSERT(rb.readError());
+    TSUNIT_EQUAL(21, rb.currentReadBitOffset());
+    rb.clearError();
+    TSUNIT_EQUAL(RefGetBits(data, 21, 59), rb.getBits<uint64_t>(59));
+    TSUNIT_ASSERT(!rb.readError());
+    TSUNIT_ASSERT(rb.endOfRead());
+
+    // Writing beyond the end: nothing is written, the position is unchanged.
+    uint8_t copy[sizeof(data)];
+    ::memcpy(copy, data, sizeof(data));
+    ts::Buffer wb(copy, sizeof(copy));
+    TSUNIT_ASSERT(wb.writeSeek(2, 5));
+    TSUNIT_ASSERT(!wb.putBits(TS_UCONST64(0xFFFFFFFFFFFFFFFF), 60));
+    TSUNIT_ASSERT(wb.writeError());
+    TSUNIT_EQUAL(21, wb.currentWriteBitOffset());
+    TSUNIT_EQUAL(0, ::memcmp(data, copy, sizeof(data)));
+
+    // Read-only buffer.
+    ts::Buffer ro(static_cast<const uint8_t*>(data), sizeof(data));
+    TSUNIT_ASSERT(!ro.putBits(1, 3));
+    TSUNIT_ASSERT(ro.writeError());
+}
+
+void BufferTest::testBitsBenchmark()
+{
+    // Microbenchmark, results are displayed in debug mode only.
+    // Typical sequence of bit fields in a section header (3+1+12, 2+5+1, etc.)
+    static const size_t fields[] = {8, 1, 1, 2, 12, 16, 2, 5, 1, 8, 8, 3, 13, 4, 12, 3, 13, 4, 12, 32};
+    uint8_t data[1024];
+    RandomBytes(data, sizeof(data), 0xCAFEDECA);
+    const size_t count = 2000;
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+
+    // Bit fields using getBits().
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < count; ++i) {
+        ts::Buffer b(static_cast<const uint8_t*>(data), sizeof(data));
+        while (b.remainingReadBits() >= 8 * 20) {
+            for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f) {
+                sum1 += b.getBits<uint32_t>(fields[f]);
+            }
+        }
+    }
+    const ts::NanoSecond fast_duration = ts::Monotonic(true) - start;
+
+    // Same bit fields using getBit() only.
+    start.getSystemTime();
+    for (size_t i = 0; i < count; ++i) {
+        ts::Buffer b(static_cast<const uint8_t*>(data), sizeof(data));
+        while (b.remainingReadBits() >= 8 * 20) {
+            for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f) {
+                uint32_t val = 0;
+                for (size_t n = fields[f]; n > 0; --n) {
+                    val = (val << 1) | b.getBit();
+                }
+                sum2 += val;
+            }
+        }
+    }
+    const ts::NanoSecond slow_duration = ts::Monotonic(true) - start;
+
+    TSUNIT_EQUAL(sum2, sum1);
+    debug() << "BufferTest::testBitsBenchmark: getBits(): " << (fast_duration / ts::NanoSecPerMilliSec) << " ms, "
+            << "getBit(): " << (slow_duration / ts::NanoSecPerMilliSec) << " ms" << std::endl;
+}
+
 void BufferTest::testGetUInt8()
 {
     ts::Buffer b(_bytes1, sizeof(_bytes1));
@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for CRC32 class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32.h"
+#include "tsByteBlock.h"
+#include "tsMonotonic.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class CRC32Test: public tsunit::Test
+{
+public:
+    CRC32Test();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testReference();
+    void testIncremental();
+    void testEngines();
+    void testBenchmark();
+
+    TSUNIT_TEST_BEGIN(CRC32Test);
+    TSUNIT_TEST(testReference);
+    TSUNIT_TEST(testIncremental);
+    TSUNIT_TEST(testEngines);
+    TSUNIT_TEST(testBenchmark);
+    TSUNIT_TEST_END();
+
+private:
+    ts::ByteBlock _data;
+};
+
+TSUNIT_REGISTER(CRC32Test);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+CRC32Test::CRC32Test() :
+    _data()
+{
+}
+
+// Test suite initialization method.
+void CRC32Test::beforeTest()
+{
+    // Deterministic pseudo-random data (linear congruential generator).
+    _data.resize(8192);
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < _data.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        _data[i] = uint8_t(seed >> 16);
+    }
+}
+
+// Test suite cleanup method.
+void CRC32Test::afterTest()
+{
+}
+
+namespace {
+    // Names of engines for debug messages.
+    const char* EngineName(ts::CRC32::Engine engine)
+    {
+        switch (engine) {
+            case ts::CRC32::BYTEWISE: return "bytewise";
+            case ts::CRC32::SLICE8: return "slice-by-8";
+            case ts::CRC32::CLMUL: return "clmul";
+            case ts::CRC32::AUTO: return "auto";
+            default: return "unknown";
+        }
+    }
+    const ts::CRC32::Engine AllEngines[] = {ts::CRC32::BYTEWISE, ts::CRC32::SLICE8, ts::CRC32::CLMUL, ts::CRC32::AUTO};
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void CRC32Test::testReference()
+{
+    // Well-known check value of CRC-32/MPEG-2.
+    static const char check[] = "123456789";
+    TSUNIT_EQUAL(0x0376E6E7, ts::CRC32(check, 9).value());
+    TSUNIT_EQUAL(0xFFFFFFFF, ts::CRC32(check, 0).value());
+
+    // A PAT section: the CRC32 of a complete section, including its CRC32, is zero.
+    static const uint8_t pat[] = {
+        0x00, 0xB0, 0x11, 0x00, 0x01, 0xC1, 0x00, 0x00, 0x00, 0x00, 0xE0, 0x10,
+        0x00, 0x01, 0xE1, 0x00, 0x9E, 0xA6, 0x64, 0x96,
+    };
+    const uint32_t crc = ts::CRC32(pat, sizeof(pat) - 4).value();
+    TSUNIT_EQUAL(crc, ts::GetUInt32(pat + sizeof(pat) - 4));
+    for (auto engine : AllEngines) {
+        ts::CRC32 c;
+        c.add(pat, sizeof(pat), engine);
+        TSUNIT_EQUAL(0, c.value());
+    }
+}
+
+void CRC32Test::testIncremental()
+{
+    const ts::CRC32 ref(_data.data(), _data.size());
+
+    for (size_t split = 0; split < 300; split += 7) {
+        ts::CRC32 c;
+        c.add(_data.data(), split);
+        c.add(_data.data() + split, _data.size() - split);
+        TSUNIT_ASSERT(c == ref);
+    }
+
+    ts::CRC32 c;
+    c.add(_data.data(), 100);
+    c.reset();
+    c.add(_data.data(), _data.size());
+    TSUNIT_ASSERT(c == ref);
+}
+
+void CRC32Test::testEngines()
+{
+    TSUNIT_ASSERT(ts::CRC32::IsSupported(ts::CRC32::BYTEWISE));
+    TSUNIT_ASSERT(ts::CRC32::IsSupported(ts::CRC32::SLICE8));
+    TSUNIT_ASSERT(ts::CRC32::IsSupported(ts::CRC32::AUTO));
+    debug() << "CRC32Test: clmul engine supported: " << ts::UString::YesNo(ts::CRC32::IsSupported(ts::CRC32::CLMUL)) << std::endl;
+
+    // All sizes up to 600 bytes, on all alignments, then a few large ones.
+    std::vector<size_t> sizes;
+    for (size_t size = 0; size <= 600; ++size) {
+        sizes.push_back(size);
+    }
+    sizes.push_back(1021);
+    sizes.push_back(4096);
+    sizes.push_back(8000);
+
+    for (auto size : sizes) {
+        for (size_t offset = 0; offset < 8 && offset + size <= _data.size(); ++offset) {
+            ts::CRC32 ref;
+            ref.add(_data.data() + offset, size, ts::CRC32::BYTEWISE);
+            for (auto engine : AllEngines) {
+                ts::CRC32 c;
+                c.add(_data.data() + offset, size, engine);
+                if (c != ref) {
+                    debug() << "CRC32Test: engine " << EngineName(engine) << ", size " << size << ", offset " << offset << std::endl;
+                }
+                TSUNIT_EQUAL(ref.value(), c.value());
+            }
+        }
+    }
+}
+
+void CRC32Test::testBenchmark()
+{
+    // Microbenchmark, results are displayed in debug mode only.
+    static const size_t sizes[] = {188, 1024, 4096};
+
+    for (auto engine : AllEngines) {
+        if (!ts::CRC32::IsSupported(engine)) {
+            continue;
+        }
+        for (auto size : sizes) {
+            const size_t iterations = (4 * 1024 * 1024) / size;
+            ts::CRC32 c;
+            ts::Monotonic start(true);
+            for (size_t i = 0; i < iterations; ++i) {
+                c.add(_data.data(), size, engine);
+            }
+            const ts::NanoSecond duration = ts::Monotonic(true) - start;
+            debug() << "CRC32Test: " << EngineName(engine) << ", " << size << " bytes: ";
+            if (duration > 0) {
+                debug() << ((iterations * size * ts::NanoSecPerSec) / (uint64_t(duration) * 1024 * 1024)) << " MB/s" << std::endl;
+            }
+            else {
+                debug() << "too fast to measure" << std::endl;
+            }
+            // Same result whatever the engine.
+            ts::CRC32 ref;
+            for (size_t i = 0; i < iterations; ++i) {
+                ref.add(_data.data(), size, ts::CRC32::SLICE8);
+            }
+            TSUNIT_ASSERT(c == ref);
+        }
+    }
+}
@@ -0,0 +1,203 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::ContinuitySplicer
+//
+//----------------------------------------------------------------------------
+
+#include "tsContinuitySplicer.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class ContinuitySplicerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testNoSplice();
+    void testSplice();
+    void testNoPayload();
+
+    TSUNIT_TEST_BEGIN(ContinuitySplicerTest);
+    TSUNIT_TEST(testNoSplice);
+    TSUNIT_TEST(testSplice);
+    TSUNIT_TEST(testNoPayload);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(ContinuitySplicerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void ContinuitySplicerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void ContinuitySplicerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Build a packet.
+    ts::TSPacket Packet(ts::PID pid, uint8_t cc, bool pcr = false, bool discontinuity = false)
+    {
+        ts::TSPacket pkt;
+        pkt.init(pid, cc, cc);
+        if (pcr) {
+            TSUNIT_ASSERT(pkt.setPCR(uint64_t(cc) * 1000, true));
+        }
+        if (discontinuity) {
+            TSUNIT_ASSERT(pkt.setDiscontinuityIndicator(true));
+        }
+        return pkt;
+    }
+}
+
+void ContinuitySplicerTest::testNoSplice()
+{
+    // A stream with a duplicate packet, a discontinuity and PCR's.
+    ts::TSPacketVector ref;
+    ref.push_back(Packet(100, 0, true));
+    ref.push_back(Packet(100, 1));
+    ref.push_back(Packet(100, 1));                // duplicate packet
+    ref.push_back(Packet(200, 7));
+    ref.push_back(Packet(100, 9, true, true));    // signaled discontinuity
+    ref.push_back(Packet(100, 10));
+    ref.push_back(Packet(ts::PID_NULL, 3));
+
+    // Without splice, the packets pass through unchanged.
+    ts::TSPacketVector pkts(ref);
+    ts::ContinuitySplicer splicer;
+    splicer.feedPackets(pkts.data(), pkts.size());
+    TSUNIT_EQUAL(0, splicer.spliceCount());
+    TSUNIT_EQUAL(ref.size(), pkts.size());
+    for (size_t i = 0; i < ref.size(); ++i) {
+        TSUNIT_EQUAL(0, ::memcmp(ref[i].b, pkts[i].b, ts::PKT_SIZE));
+    }
+    TSUNIT_ASSERT(!pkts[0].getDiscontinuityIndicator());
+    TSUNIT_ASSERT(pkts[4].getDiscontinuityIndicator());
+}
+
+void ContinuitySplicerTest::testSplice()
+{
+    ts::ContinuitySplicer splicer;
+
+    // First stream.
+    ts::TSPacketVector first;
+    first.push_back(Packet(100, 4, true));
+    first.push_back(Packet(100, 5));
+    first.push_back(Packet(200, 12));
+    splicer.feedPackets(first.data(), first.size());
+    TSUNIT_EQUAL(4, first[0].getCC());
+    TSUNIT_ASSERT(!first[0].getDiscontinuityIndicator());
+
+    // Second stream: CC's continue the first stream, duplicates and discontinuities are preserved.
+    splicer.splice();
+    TSUNIT_EQUAL(1, splicer.spliceCount());
+    ts::TSPacketVector second;
+    second.push_back(Packet(100, 10));
+    second.push_back(Packet(200, 0));
+    second.push_back(Packet(100, 11, true));      // first PCR after splice
+    second.push_back(Packet(100, 11, true));      // duplicate packet
+    second.push_back(Packet(300, 5, true));       // new PID
+    second.push_back(Packet(100, 2, false, true)); // signaled discontinuity
+    second.push_back(Packet(100, 3, true));       // second PCR after splice
+    splicer.feedPackets(second.data(), second.size());
+
+    TSUNIT_EQUAL(6, second[0].getCC());
+    TSUNIT_EQUAL(13, second[1].getCC());
+    TSUNIT_EQUAL(7, second[2].getCC());
+    TSUNIT_EQUAL(7, second[3].getCC());
+    TSUNIT_EQUAL(5, second[4].getCC());
+    TSUNIT_EQUAL(14, second[5].getCC());
+    TSUNIT_EQUAL(15, second[6].getCC());
+
+    TSUNIT_ASSERT(!second[0].getDiscontinuityIndicator());
+    TSUNIT_ASSERT(second[2].getDiscontinuityIndicator());
+    TSUNIT_ASSERT(!second[3].getDiscontinuityIndicator());
+    TSUNIT_ASSERT(second[4].getDiscontinuityIndicator());
+    TSUNIT_ASSERT(second[5].getDiscontinuityIndicator());
+    TSUNIT_ASSERT(!second[6].getDiscontinuityIndicator());
+
+    // Third stream: continue the second one.
+    splicer.splice();
+    ts::TSPacketVector third;
+    third.push_back(Packet(100, 15, true));
+    third.push_back(Packet(300, 5));
+    splicer.feedPackets(third.data(), third.size());
+    TSUNIT_EQUAL(0, third[0].getCC());
+    TSUNIT_ASSERT(third[0].getDiscontinuityIndicator());
+    TSUNIT_EQUAL(6, third[1].getCC());
+
+    // After reset, packets are no longer modified.
+    splicer.reset();
+    TSUNIT_EQUAL(0, splicer.spliceCount());
+    ts::TSPacket pkt(Packet(100, 9, true));
+    splicer.feedPacket(pkt);
+    TSUNIT_EQUAL(9, pkt.getCC());
+    TSUNIT_ASSERT(!pkt.getDiscontinuityIndicator());
+}
+
+void ContinuitySplicerTest::testNoPayload()
+{
+    ts::ContinuitySplicer splicer;
+
+    ts::TSPacket pkt(Packet(100, 8));
+    splicer.feedPacket(pkt);
+    splicer.splice();
+
+    // A packet without payload does not increment the continuity counter.
+    pkt = Packet(100, 2, true);
+    TSUNIT_ASSERT(pkt.setPayloadSize(0, true));
+    pkt.b[3] &= ~0x10;
+    TSUNIT_ASSERT(!pkt.hasPayload());
+    splicer.feedPacket(pkt);
+    TSUNIT_EQUAL(8, pkt.getCC());
+    TSUNIT_ASSERT(pkt.getDiscontinuityIndicator());
+
+    // Next packet with payload, same offset.
+    pkt = Packet(100, 3);
+    splicer.feedPacket(pkt);
+    TSUNIT_EQUAL(9, pkt.getCC());
+}
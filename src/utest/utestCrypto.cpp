@@ -89,6 +89,7 @@ public:
     void testTDES();
     void testTDES_CBC();
     void testDVBCSA2();
+    void testDVBCSA2Batch();
     void testDVBCISSA();
     void testIDSA();
     void testSCTE52_2003();
@@ -111,6 +112,7 @@ public:
     TSUNIT_TEST(testTDES);
     TSUNIT_TEST(testTDES_CBC);
     TSUNIT_TEST(testDVBCSA2);
+    TSUNIT_TEST(testDVBCSA2Batch);
     TSUNIT_TEST(testDVBCISSA);
     TSUNIT_TEST(testIDSA);
     TSUNIT_TEST(testSCTE52_2003);
@@ -488,6 +490,69 @@ void CryptoTest::testDVBCSA2()
     }
 }
 
+void CryptoTest::testDVBCSA2Batch()
+{
+    ts::DVBCSA2 csa;
+    ts::DVBCSA2 ref;
+    ts::SystemRandomGenerator prng;
+
+    // Test vectors, replicated to fill batches of various sizes (scalar, 64-bit and wide words).
+    const size_t tv_count = sizeof(tv_dvb_csa2) / sizeof(tv_dvb_csa2[0]);
+    for (size_t tvi = 0; tvi < tv_count; ++tvi) {
+        const TV_DVB_CSA2* tv = tv_dvb_csa2 + tvi;
+        const ts::ByteBlock plain(tv->plain, tv->size);
+        const ts::ByteBlock cipher(tv->cipher, tv->size);
+        TSUNIT_ASSERT(csa.setKey(tv->key, sizeof(tv->key)));
+        for (size_t count : {3, 40, 64, 100, 300}) {
+            std::vector<ts::ByteBlock> data(count, plain);
+            std::vector<uint8_t*> addr(count);
+            std::vector<size_t> sizes(count, tv->size);
+            for (size_t i = 0; i < count; ++i) {
+                addr[i] = data[i].data();
+            }
+            TSUNIT_ASSERT(csa.encryptBatch(addr.data(), sizes.data(), count));
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_ASSERT(data[i] == cipher);
+            }
+            TSUNIT_ASSERT(csa.decryptBatch(addr.data(), sizes.data(), count));
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_ASSERT(data[i] == plain);
+            }
+        }
+    }
+
+    // Random payloads of all sizes, compared with the byte-oriented implementation.
+    const size_t count = 200;
+    ts::ByteBlock key(ts::DVBCSA2::KEY_SIZE);
+    std::vector<ts::ByteBlock> plain(count);
+    std::vector<ts::ByteBlock> data(count);
+    std::vector<uint8_t*> addr(count);
+    std::vector<size_t> sizes(count);
+
+    TSUNIT_ASSERT(prng.read(key.data(), key.size()));
+    TSUNIT_ASSERT(csa.setKey(key.data(), key.size()));
+    TSUNIT_ASSERT(ref.setKey(key.data(), key.size()));
+    for (size_t i = 0; i < count; ++i) {
+        plain[i].resize(1 + i % 184);
+        TSUNIT_ASSERT(prng.read(plain[i].data(), plain[i].size()));
+        data[i] = plain[i];
+        addr[i] = data[i].data();
+        sizes[i] = data[i].size();
+    }
+
+    TSUNIT_ASSERT(csa.encryptBatch(addr.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        ts::ByteBlock cipher(plain[i]);
+        TSUNIT_ASSERT(ref.encryptInPlace(cipher.data(), cipher.size()));
+        TSUNIT_ASSERT(data[i] == cipher);
+    }
+
+    TSUNIT_ASSERT(csa.decryptBatch(addr.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(data[i] == plain[i]);
+    }
+}
+
 void CryptoTest::testDVBCISSA()
 {
     ts::DVBCISSA cissa;
@@ -92,6 +92,7 @@ public:
     void testTDT();
     void testTOT();
     void testHEVC();
+    void testSectionRecycling();
 
     TSUNIT_TEST_BEGIN(DemuxTest);
     TSUNIT_TEST(testPAT);
@@ -105,6 +106,7 @@ public:
     TSUNIT_TEST(testTDT);
     TSUNIT_TEST(testTOT);
     TSUNIT_TEST(testHEVC);
+    TSUNIT_TEST(testSectionRecycling);
     TSUNIT_TEST_END();
 
 private:
@@ -489,3 +491,81 @@ void DemuxTest::testHEVC()
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+namespace {
+    // Collect everything from a SectionDemux.
+    class DemuxCollector:
+        public ts::TableHandlerInterface,
+        public ts::SectionHandlerInterface,
+        public ts::SectionViewHandlerInterface
+    {
+    public:
+        DemuxCollector() : tables(), sections(), views() {}
+        ts::BinaryTablePtrVector tables;
+        std::vector<ts::ByteBlock> sections;
+        std::vector<ts::ByteBlock> views;
+
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable& table) override
+        {
+            // Keep the sections of the demux.
+            tables.push_back(ts::BinaryTablePtr(new ts::BinaryTable(table, ts::ShareMode::SHARE)));
+        }
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            sections.push_back(ts::ByteBlock(section.content(), section.size()));
+        }
+        virtual void handleSectionView(ts::SectionDemux&, const ts::SectionView& section) override
+        {
+            TSUNIT_ASSERT(section.isValid());
+            views.push_back(ts::ByteBlock(section.content(), section.size()));
+        }
+    };
+}
+
+void DemuxTest::testSectionRecycling()
+{
+    ts::DuckContext duck;
+    DemuxCollector collector;
+    ts::SectionDemux demux(duck, &collector, &collector, ts::AllPIDs);
+    demux.setSectionViewHandler(&collector);
+
+    // Successive versions of a two-section PAT, each one repeated three times.
+    const size_t version_count = 40;
+    const size_t repeat_count = 3;
+    ts::OneShotPacketizer pzer(duck, ts::PID_PAT);
+    std::vector<ts::BinaryTable> ref_tables(version_count);
+    for (size_t version = 0; version < version_count; ++version) {
+        ts::PAT pat(uint8_t(version % 32), true, uint16_t(version));
+        for (uint16_t srv = 1; srv <= 300; ++srv) {
+            pat.pmts[srv] = ts::PID(1000 + srv + version);
+        }
+        pat.serialize(duck, ref_tables[version]);
+        TSUNIT_EQUAL(2, ref_tables[version].sectionCount());
+        for (size_t rep = 0; rep < repeat_count; ++rep) {
+            ts::TSPacketVector packets;
+            pzer.reset();
+            pzer.addTable(ref_tables[version]);
+            pzer.getPackets(packets);
+            for (const auto& pkt : packets) {
+                demux.feedPacket(pkt);
+            }
+        }
+    }
+
+    // All sections are reported to section handlers, each version is reported once as a table.
+    TSUNIT_EQUAL(2 * version_count * repeat_count, collector.sections.size());
+    TSUNIT_EQUAL(2 * version_count * repeat_count, collector.views.size());
+    TSUNIT_EQUAL(version_count, collector.tables.size());
+
+    for (size_t i = 0; i < collector.sections.size(); ++i) {
+        const ts::Section& ref(*ref_tables[i / (2 * repeat_count)].sectionAt(i % 2));
+        TSUNIT_ASSERT(collector.sections[i] == ts::ByteBlock(ref.content(), ref.size()));
+        TSUNIT_ASSERT(collector.views[i] == collector.sections[i]);
+    }
+
+    // The sections of the collected tables must not be altered by the recycling of sections in the demux.
+    for (size_t version = 0; version < version_count; ++version) {
+        TSUNIT_ASSERT(collector.tables[version]->isValid());
+        TSUNIT_ASSERT(*collector.tables[version] == ref_tables[version]);
+    }
+}
@@ -0,0 +1,324 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::DescriptorList
+//
+//----------------------------------------------------------------------------
+
+#include "tsDescriptorList.h"
+#include "tsDescriptor.h"
+#include "tsBinaryTable.h"
+#include "tsSection.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsNIT.h"
+#include "tsEIT.h"
+#include "tsShortEventDescriptor.h"
+#include "tsContentDescriptor.h"
+#include "tsDuckContext.h"
+#include "tsMonotonic.h"
+#include "tsunit.h"
+
+#include "tables/psi_pmt_planete_sections.h"
+#include "tables/psi_sdt_r3_sections.h"
+#include "tables/psi_nit_tntv23_sections.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class DescriptorListTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testSharedBlock();
+    void testTables();
+    void testBenchmark();
+
+    TSUNIT_TEST_BEGIN(DescriptorListTest);
+    TSUNIT_TEST(testSharedBlock);
+    TSUNIT_TEST(testTables);
+    TSUNIT_TEST(testBenchmark);
+    TSUNIT_TEST_END();
+
+private:
+    // Load a one-section table.
+    static void LoadTable(ts::BinaryTable& table, const uint8_t* data, size_t size, ts::PID pid);
+
+    // Build an EIT schedule with many events and descriptors.
+    static void BuildEIT(ts::DuckContext& duck, ts::BinaryTable& table);
+
+    // Check that a table can be serialized and deserialized again.
+    static void CheckRoundTrip(ts::DuckContext& duck, ts::AbstractTable& table, const ts::BinaryTable& original);
+};
+
+TSUNIT_REGISTER(DescriptorListTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void DescriptorListTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void DescriptorListTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void DescriptorListTest::LoadTable(ts::BinaryTable& table, const uint8_t* data, size_t size, ts::PID pid)
+{
+    table.clear();
+    TSUNIT_ASSERT(table.addSection(new ts::Section(data, size, pid, ts::CRC32::CHECK)));
+    TSUNIT_ASSERT(table.isValid());
+}
+
+void DescriptorListTest::BuildEIT(ts::DuckContext& duck, ts::BinaryTable& table)
+{
+    ts::EIT eit(true, false, 0, 0, true, 0x0101, 0x0001, 0x0002);
+    ts::Time start(2021, 1, 1, 0, 0);
+    for (uint16_t ev = 0; ev < 24; ++ev) {
+        ts::EIT::Event& event(eit.events.newEntry());
+        event.event_id = ev;
+        event.start_time = start + ev * ts::MilliSecPerHour;
+        event.duration = 3600;
+        event.descs.add(duck, ts::ShortEventDescriptor(u"eng", ts::UString::Format(u"Event %d", {ev}), u"Some event description, a few words long."));
+        ts::ContentDescriptor content;
+        content.entries.push_back(ts::ContentDescriptor::Entry(0x1234));
+        event.descs.add(duck, content);
+    }
+    eit.serialize(duck, table);
+    TSUNIT_ASSERT(table.isValid());
+}
+
+void DescriptorListTest::testSharedBlock()
+{
+    static const uint8_t data[] = {
+        0x52, 0x01, 0x29,                          // stream_identifier_descriptor
+        0x0A, 0x04, 'f', 'r', 'a', 0x00,           // ISO_639_language_descriptor
+        0x28, 0x04, 0x03, 0x00, 0x03, 0x00,        // AVC_video_descriptor
+    };
+
+    ts::DescriptorList dlist(nullptr);
+    TSUNIT_ASSERT(dlist.add(data, sizeof(data)));
+    TSUNIT_EQUAL(3, dlist.count());
+    TSUNIT_EQUAL(0x52, dlist[0]->tag());
+    TSUNIT_EQUAL(3, dlist[0]->size());
+    TSUNIT_EQUAL(0x0A, dlist[1]->tag());
+    TSUNIT_EQUAL(6, dlist[1]->size());
+    TSUNIT_EQUAL(4, dlist[1]->payloadSize());
+    TSUNIT_EQUAL(0, ::memcmp(dlist[1]->content(), data + 3, 6));
+    TSUNIT_EQUAL(0x28, dlist[2]->tag());
+    TSUNIT_EQUAL(6, dlist[2]->size());
+    TSUNIT_EQUAL(1, dlist.search(0x0A));
+
+    // The memory area is copied, not referenced.
+    TSUNIT_ASSERT(dlist[1]->content() != data + 3);
+
+    // Comparison with a standalone descriptor.
+    const ts::Descriptor lang(data + 3, 6);
+    TSUNIT_ASSERT(*dlist[1] == lang);
+    TSUNIT_ASSERT(*dlist[2] != lang);
+
+    // Duplication.
+    ts::Descriptor copy;
+    copy.copy(*dlist[1]);
+    TSUNIT_ASSERT(copy == lang);
+    TSUNIT_EQUAL(6, copy.size());
+    const ts::Descriptor copy2(*dlist[2], ts::ShareMode::COPY);
+    TSUNIT_EQUAL(6, copy2.size());
+    TSUNIT_EQUAL(0, ::memcmp(copy2.content(), data + 9, 6));
+
+    // In-place modification of a payload, same size.
+    dlist[1]->payload()[2] = 'e';
+    TSUNIT_EQUAL('e', dlist[1]->payload()[2]);
+    TSUNIT_EQUAL(0, ::memcmp(dlist[2]->content(), data + 9, 6));
+    TSUNIT_ASSERT(*dlist[1] != lang);
+    TSUNIT_ASSERT(copy == lang);
+
+    // Resize a payload, the other descriptors are unchanged.
+    dlist[1]->resizePayload(3);
+    TSUNIT_EQUAL(5, dlist[1]->size());
+    TSUNIT_EQUAL(3, dlist[1]->content()[1]);
+    TSUNIT_EQUAL(0, ::memcmp(dlist[1]->payload(), "fre", 3));
+    TSUNIT_EQUAL(3, dlist[0]->size());
+    TSUNIT_EQUAL(0x29, dlist[0]->payload()[0]);
+    TSUNIT_EQUAL(0, ::memcmp(dlist[2]->content(), data + 9, 6));
+
+    dlist[2]->replacePayload(dlist[2]->payload() + 1, 2);
+    TSUNIT_EQUAL(4, dlist[2]->size());
+    TSUNIT_EQUAL(0x00, dlist[2]->payload()[0]);
+    TSUNIT_EQUAL(0x03, dlist[2]->payload()[1]);
+    TSUNIT_EQUAL(0x52, dlist[0]->tag());
+
+    // Truncated descriptor loop.
+    ts::DescriptorList dlist2(nullptr);
+    TSUNIT_ASSERT(!dlist2.add(data, sizeof(data) - 1));
+    TSUNIT_EQUAL(2, dlist2.count());
+    TSUNIT_ASSERT(dlist2.add(data, 0));
+    TSUNIT_EQUAL(2, dlist2.count());
+}
+
+void DescriptorListTest::testTables()
+{
+    ts::DuckContext duck;
+    ts::BinaryTable bin, eit_bin;
+
+    LoadTable(bin, psi_pmt_planete_sections, sizeof(psi_pmt_planete_sections), ts::PID_NULL);
+    ts::PMT pmt(duck, bin);
+    TSUNIT_ASSERT(pmt.isValid());
+    TSUNIT_EQUAL(1, pmt.descs.count());
+    TSUNIT_EQUAL(0x09, pmt.descs[0]->tag());
+    TSUNIT_EQUAL(2, pmt.streams.size());
+    TSUNIT_EQUAL(3, pmt.streams[163].descs.count());
+    TSUNIT_EQUAL(1, pmt.streams[163].descs.search(0x28));
+    CheckRoundTrip(duck, pmt, bin);
+
+    LoadTable(bin, psi_sdt_r3_sections, sizeof(psi_sdt_r3_sections), ts::PID_SDT);
+    ts::SDT sdt(duck, bin);
+    TSUNIT_ASSERT(sdt.isValid());
+    CheckRoundTrip(duck, sdt, bin);
+
+    LoadTable(bin, psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections), ts::PID_NIT);
+    ts::NIT nit(duck, bin);
+    TSUNIT_ASSERT(nit.isValid());
+    CheckRoundTrip(duck, nit, bin);
+
+    BuildEIT(duck, eit_bin);
+    ts::EIT eit(duck, eit_bin);
+    TSUNIT_ASSERT(eit.isValid());
+    TSUNIT_EQUAL(24, eit.events.size());
+    CheckRoundTrip(duck, eit, eit_bin);
+}
+
+// Serialize a deserialized table. The content is identical, except the order of some entries.
+// Deserializing and serializing again must give the same binary table.
+void DescriptorListTest::CheckRoundTrip(ts::DuckContext& duck, ts::AbstractTable& table, const ts::BinaryTable& original)
+{
+    ts::BinaryTable bin1, bin2;
+    table.serialize(duck, bin1);
+    TSUNIT_ASSERT(bin1.isValid());
+    TSUNIT_EQUAL(original.totalSize(), bin1.totalSize());
+    table.deserialize(duck, bin1);
+    TSUNIT_ASSERT(table.isValid());
+    table.serialize(duck, bin2);
+    TSUNIT_ASSERT(bin1 == bin2);
+}
+
+namespace {
+    // Format a rate for the benchmark.
+    ts::UString Rate(size_t count, ts::NanoSecond duration)
+    {
+        return duration <= 0 ? ts::UString(u"too fast to measure") : ts::UString::Format(u"%'d/s", {(uint64_t(count) * ts::NanoSecPerSec) / uint64_t(duration)});
+    }
+}
+
+void DescriptorListTest::testBenchmark()
+{
+    // Microbenchmark, results are displayed in debug mode only.
+    ts::DuckContext duck;
+    ts::BinaryTable pmt_bin, sdt_bin, nit_bin, eit_bin;
+    LoadTable(pmt_bin, psi_pmt_planete_sections, sizeof(psi_pmt_planete_sections), ts::PID_NULL);
+    LoadTable(sdt_bin, psi_sdt_r3_sections, sizeof(psi_sdt_r3_sections), ts::PID_SDT);
+    LoadTable(nit_bin, psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections), ts::PID_NIT);
+    BuildEIT(duck, eit_bin);
+
+    const size_t count = 20000;
+    ts::PMT pmt;
+    ts::SDT sdt;
+    ts::NIT nit;
+    ts::EIT eit;
+
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < count; ++i) {
+        pmt.deserialize(duck, pmt_bin);
+    }
+    const ts::NanoSecond pmt_duration = ts::Monotonic(true) - start;
+    start.getSystemTime();
+    for (size_t i = 0; i < count; ++i) {
+        sdt.deserialize(duck, sdt_bin);
+    }
+    const ts::NanoSecond sdt_duration = ts::Monotonic(true) - start;
+    start.getSystemTime();
+    for (size_t i = 0; i < count; ++i) {
+        nit.deserialize(duck, nit_bin);
+    }
+    const ts::NanoSecond nit_duration = ts::Monotonic(true) - start;
+    start.getSystemTime();
+    for (size_t i = 0; i < count; ++i) {
+        eit.deserialize(duck, eit_bin);
+    }
+    const ts::NanoSecond eit_duration = ts::Monotonic(true) - start;
+
+    TSUNIT_ASSERT(pmt.isValid());
+    TSUNIT_ASSERT(sdt.isValid());
+    TSUNIT_ASSERT(nit.isValid());
+    TSUNIT_ASSERT(eit.isValid());
+
+    debug() << "DescriptorListTest::testBenchmark: PMT (" << pmt_bin.totalSize() << " bytes): " << Rate(count, pmt_duration) << std::endl
+            << "DescriptorListTest::testBenchmark: SDT (" << sdt_bin.totalSize() << " bytes): " << Rate(count, sdt_duration) << std::endl
+            << "DescriptorListTest::testBenchmark: NIT (" << nit_bin.totalSize() << " bytes): " << Rate(count, nit_duration) << std::endl
+            << "DescriptorListTest::testBenchmark: EIT (" << eit_bin.totalSize() << " bytes): " << Rate(count, eit_duration) << std::endl;
+
+    // Loading the descriptor loops of the NIT: one memory block per descriptor (before)
+    // and one memory block per descriptor loop (after).
+    const uint8_t* const loop = psi_nit_tntv23_sections + 10;
+    const size_t loop_size = ts::GetUInt16(psi_nit_tntv23_sections + 8) & 0x0FFF;
+    ts::DescriptorList dlist(nullptr);
+    start.getSystemTime();
+    for (size_t i = 0; i < count; ++i) {
+        dlist.clear();
+        for (size_t offset = 0; offset + 2 <= loop_size; offset += loop[offset + 1] + 2) {
+            dlist.add(ts::DescriptorPtr(new ts::Descriptor(loop + offset, loop[offset + 1] + 2)));
+        }
+    }
+    const ts::NanoSecond copy_duration = ts::Monotonic(true) - start;
+    const size_t dcount = dlist.count();
+    start.getSystemTime();
+    for (size_t i = 0; i < count; ++i) {
+        dlist.clear();
+        dlist.add(loop, loop_size);
+    }
+    const ts::NanoSecond shared_duration = ts::Monotonic(true) - start;
+    TSUNIT_EQUAL(dcount, dlist.count());
+
+    debug() << "DescriptorListTest::testBenchmark: " << dcount << " descriptors, one block per descriptor: " << Rate(count, copy_duration) << std::endl
+            << "DescriptorListTest::testBenchmark: " << dcount << " descriptors, one block per list: " << Rate(count, shared_duration) << std::endl;
+}
@@ -0,0 +1,367 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::EITGenerator
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITGenerator.h"
+#include "tsDuckContext.h"
+#include "tsEIT.h"
+#include "tsMJD.h"
+#include "tsBCD.h"
+#include "tsSection.h"
+#include "tsNullReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class EITGeneratorTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testModifiedSection();
+    void testMidnight();
+    void testThreads();
+    void testEmptyAfterMidnight();
+    void testLargeEvent();
+
+    TSUNIT_TEST_BEGIN(EITGeneratorTest);
+    TSUNIT_TEST(testModifiedSection);
+    TSUNIT_TEST(testMidnight);
+    TSUNIT_TEST(testThreads);
+    TSUNIT_TEST(testEmptyAfterMidnight);
+    TSUNIT_TEST(testLargeEvent);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(EITGeneratorTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void EITGeneratorTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void EITGeneratorTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Actual transport stream id in all tests.
+    constexpr uint16_t TS_ID = 1;
+
+    // Binary description of an event, as in an EIT section, with private descriptors.
+    // Each descriptor contains 'desc_size' times the 'tag' value.
+    ts::ByteBlock Event(uint16_t event_id, const ts::Time& start, ts::MilliSecond duration, uint8_t tag = 0, size_t desc_count = 1, size_t desc_size = 1)
+    {
+        const size_t loop_size = desc_count * (2 + desc_size);
+        ts::ByteBlock data(ts::EIT::EIT_EVENT_FIXED_SIZE + loop_size, tag);
+        uint8_t* p = data.data();
+        ts::PutUInt16(p, event_id);
+        TSUNIT_ASSERT(ts::EncodeMJD(start, p + 2, 5));
+        p[7] = ts::EncodeBCD(int(duration / ts::MilliSecPerHour));
+        p[8] = ts::EncodeBCD(int((duration / ts::MilliSecPerMin) % 60));
+        p[9] = ts::EncodeBCD(int((duration / ts::MilliSecPerSec) % 60));
+        ts::PutUInt16(p + 10, uint16_t(0x8000 | loop_size)); // running, descriptor loop length
+        for (size_t i = 0; i < desc_count; ++i) {
+            p[ts::EIT::EIT_EVENT_FIXED_SIZE + i * (2 + desc_size)] = 0x80;                  // private descriptor tag
+            p[ts::EIT::EIT_EVENT_FIXED_SIZE + i * (2 + desc_size) + 1] = uint8_t(desc_size); // descriptor length
+        }
+        return data;
+    }
+
+    // Load events in a service, one per hour.
+    void LoadEvents(ts::EITGenerator& gen, const ts::ServiceIdTriplet& srv, const ts::Time& start, size_t count, uint16_t first_id = 1)
+    {
+        ts::ByteBlock data;
+        for (size_t i = 0; i < count; ++i) {
+            data.append(Event(uint16_t(first_id + i), start + ts::MilliSecond(i) * ts::MilliSecPerHour, ts::MilliSecPerHour));
+        }
+        TSUNIT_ASSERT(gen.loadEvents(srv, data.data(), data.size()));
+    }
+
+    // Save the content of all EIT sections. The section objects are shared with the generator and may be modified later.
+    void SaveEITs(ts::EITGenerator& gen, std::vector<ts::ByteBlock>& contents)
+    {
+        ts::SectionPtrVector sections;
+        gen.saveEITs(sections);
+        contents.clear();
+        for (size_t i = 0; i < sections.size(); ++i) {
+            TSUNIT_ASSERT(!sections[i].isNull());
+            TSUNIT_ASSERT(sections[i]->isValid());
+            contents.push_back(ts::ByteBlock(sections[i]->content(), sections[i]->size()));
+            // The CRC32 must be valid in all sections, including untouched new sections.
+            const ts::Section check(contents.back(), ts::PID_NULL, ts::CRC32::CHECK);
+            TSUNIT_ASSERT(check.isValid());
+        }
+    }
+
+    // Check the table id and section number of all EIT schedule sections according to their first event.
+    // Return the number of non-empty EIT schedule sections.
+    size_t CheckScheduleNumbering(const std::vector<ts::ByteBlock>& contents, const ts::Time& now)
+    {
+        const ts::Time last_midnight(now.thisDay());
+        size_t count = 0;
+        for (size_t i = 0; i < contents.size(); ++i) {
+            const uint8_t* data = contents[i].data();
+            const ts::TID tid = data[0];
+            if (ts::EIT::IsSchedule(tid) && contents[i].size() > ts::LONG_SECTION_HEADER_SIZE + ts::EIT::EIT_PAYLOAD_FIXED_SIZE + ts::SECTION_CRC32_SIZE) {
+                ts::Time start;
+                TSUNIT_ASSERT(ts::DecodeMJD(data + ts::LONG_SECTION_HEADER_SIZE + ts::EIT::EIT_PAYLOAD_FIXED_SIZE + 2, 5, start));
+                const size_t segment = ts::EIT::TimeToSegment(last_midnight, start);
+                TSUNIT_EQUAL(ts::EIT::SegmentToTableId(true, segment), tid);
+                TSUNIT_EQUAL(ts::EIT::SegmentToSection(segment), data[6] & ~(ts::EIT::SECTIONS_PER_SEGMENT - 1));
+                count++;
+            }
+        }
+        return count;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Adding an event rebuilds only the section which contains it.
+void EITGeneratorTest::testModifiedSection()
+{
+    ts::DuckContext duck;
+    ts::EITGenerator gen(duck);
+    const ts::Time now(2021, 3, 10, 12, 0);
+    gen.setTransportStreamId(TS_ID);
+    gen.setCurrentTime(now);
+
+    const ts::ServiceIdTriplet srv1(1, TS_ID, 1);
+    const ts::ServiceIdTriplet srv2(2, TS_ID, 1);
+    LoadEvents(gen, srv1, now + ts::MilliSecPerDay, 48);
+    LoadEvents(gen, srv2, now + ts::MilliSecPerDay, 48);
+
+    std::vector<ts::ByteBlock> before;
+    SaveEITs(gen, before);
+    TSUNIT_ASSERT(!before.empty());
+    TSUNIT_EQUAL(32, CheckScheduleNumbering(before, now));
+
+    // Add an event in the middle of an existing segment of one service.
+    const ts::ByteBlock ev(Event(1000, now + ts::MilliSecPerDay + 10 * ts::MilliSecPerHour + 30 * ts::MilliSecPerMin, 15 * ts::MilliSecPerMin, 0x55));
+    TSUNIT_ASSERT(gen.loadEvents(srv1, ev.data(), ev.size()));
+
+    std::vector<ts::ByteBlock> after;
+    SaveEITs(gen, after);
+    TSUNIT_EQUAL(before.size(), after.size());
+    CheckScheduleNumbering(after, now);
+
+    // Exactly one section is different: the one with the new event.
+    size_t diff_count = 0;
+    for (size_t i = 0; i < before.size(); ++i) {
+        if (before[i] != after[i]) {
+            diff_count++;
+            TSUNIT_EQUAL(before[i].size() + ev.size(), after[i].size());
+            TSUNIT_EQUAL(1, ts::GetUInt16(after[i].data() + 3)); // service id
+            TSUNIT_ASSERT(ts::EIT::IsSchedule(after[i][0]));
+        }
+    }
+    TSUNIT_EQUAL(1, diff_count);
+
+    // Saving again without change returns the same sections.
+    std::vector<ts::ByteBlock> again;
+    SaveEITs(gen, again);
+    TSUNIT_ASSERT(after == again);
+}
+
+// After midnight, all EIT schedule sections are renumbered, including the table id.
+void EITGeneratorTest::testMidnight()
+{
+    ts::DuckContext duck;
+    ts::EITGenerator gen(duck);
+    const ts::Time now(2021, 3, 10, 22, 0);
+    gen.setTransportStreamId(TS_ID);
+    gen.setCurrentTime(now);
+
+    // Events from now to the 5th day, crossing the boundary between the first two EIT schedule table ids.
+    const ts::ServiceIdTriplet srv(1, TS_ID, 1);
+    LoadEvents(gen, srv, now, 5 * 24);
+
+    std::vector<ts::ByteBlock> before;
+    SaveEITs(gen, before);
+    const size_t count_before = CheckScheduleNumbering(before, now);
+    TSUNIT_ASSERT(count_before > 0);
+
+    // The same events are in different tables depending on the last midnight.
+    const ts::Time later(now + 3 * ts::MilliSecPerHour);
+    const ts::Time event(now + 3 * ts::MilliSecPerDay + 3 * ts::MilliSecPerHour);
+    TSUNIT_EQUAL(ts::TID_EIT_S_ACT_MIN + 1, ts::EIT::TimeToTableId(true, now.thisDay(), event));
+    TSUNIT_EQUAL(ts::TID_EIT_S_ACT_MIN, ts::EIT::TimeToTableId(true, later.thisDay(), event));
+
+    // Move after midnight. Events before that time are removed.
+    gen.setCurrentTime(later);
+    std::vector<ts::ByteBlock> after;
+    SaveEITs(gen, after);
+    const size_t count_after = CheckScheduleNumbering(after, later);
+    TSUNIT_ASSERT(count_after > 0);
+    TSUNIT_ASSERT(count_after < count_before);
+
+    // All sections must be consistent: last_section_number in the table, segment_last_section_number, last_table_id.
+    for (size_t i = 0; i < after.size(); ++i) {
+        const uint8_t* data = after[i].data();
+        if (ts::EIT::IsSchedule(data[0])) {
+            TSUNIT_ASSERT(data[6] <= data[7]);
+            TSUNIT_ASSERT(data[6] <= data[12]);
+            TSUNIT_ASSERT(data[12] <= data[7]);
+            TSUNIT_ASSERT(data[0] <= data[13]);
+        }
+    }
+}
+
+// The generated sections do not depend on the number of threads.
+void EITGeneratorTest::testThreads()
+{
+    ts::DuckContext duck;
+    ts::EITGenerator gen1(duck);
+    ts::EITGenerator gen4(duck);
+    gen1.setMaxThreads(1);
+    gen4.setMaxThreads(4);
+
+    const ts::Time now(2021, 3, 10, 12, 0);
+    gen1.setTransportStreamId(TS_ID);
+    gen4.setTransportStreamId(TS_ID);
+    gen1.setCurrentTime(now);
+    gen4.setCurrentTime(now);
+
+    // Enough services to use all threads.
+    const size_t srv_count = 4 * ts::EITGenerator::MIN_SERVICES_PER_THREAD;
+    for (uint16_t id = 1; id <= srv_count; ++id) {
+        const ts::ServiceIdTriplet srv(id, uint16_t(id % 2 == 0 ? TS_ID : TS_ID + 1), 1);
+        LoadEvents(gen1, srv, now + id * ts::MilliSecPerMin, 3 * 24);
+        LoadEvents(gen4, srv, now + id * ts::MilliSecPerMin, 3 * 24);
+    }
+
+    std::vector<ts::ByteBlock> sec1;
+    std::vector<ts::ByteBlock> sec4;
+    SaveEITs(gen1, sec1);
+    SaveEITs(gen4, sec4);
+    TSUNIT_ASSERT(!sec1.empty());
+    TSUNIT_ASSERT(sec1 == sec4);
+
+    // Same after midnight.
+    const ts::Time later(now + ts::MilliSecPerDay);
+    gen1.setCurrentTime(later);
+    gen4.setCurrentTime(later);
+    SaveEITs(gen1, sec1);
+    SaveEITs(gen4, sec4);
+    TSUNIT_ASSERT(!sec1.empty());
+    TSUNIT_ASSERT(sec1 == sec4);
+}
+
+// A service with no more event after midnight keeps one empty EIT schedule section.
+void EITGeneratorTest::testEmptyAfterMidnight()
+{
+    ts::DuckContext duck;
+    ts::EITGenerator gen(duck);
+    const ts::Time now(2021, 3, 10, 20, 0);
+    gen.setTransportStreamId(TS_ID);
+    gen.setCurrentTime(now);
+
+    const ts::ServiceIdTriplet srv(1, TS_ID, 1);
+    LoadEvents(gen, srv, now + ts::MilliSecPerHour, 1);
+
+    std::vector<ts::ByteBlock> before;
+    SaveEITs(gen, before);
+    TSUNIT_EQUAL(1, CheckScheduleNumbering(before, now));
+
+    // After midnight, the only event is obsolete. SaveEITs() checks the CRC32 of all sections.
+    const ts::Time later(now + 5 * ts::MilliSecPerHour);
+    gen.setCurrentTime(later);
+    std::vector<ts::ByteBlock> after;
+    SaveEITs(gen, after);
+    TSUNIT_EQUAL(0, CheckScheduleNumbering(after, later));
+
+    size_t count = 0;
+    for (size_t i = 0; i < after.size(); ++i) {
+        const uint8_t* data = after[i].data();
+        if (ts::EIT::IsSchedule(data[0])) {
+            count++;
+            TSUNIT_EQUAL(ts::TID_EIT_S_ACT_MIN, data[0]);
+            TSUNIT_EQUAL(0, data[6]);  // section_number
+            TSUNIT_EQUAL(0, data[7]);  // last_section_number
+            TSUNIT_EQUAL(0, data[12]); // segment_last_section_number
+            TSUNIT_EQUAL(ts::TID_EIT_S_ACT_MIN, data[13]); // last_table_id
+        }
+    }
+    TSUNIT_EQUAL(1, count);
+}
+
+// An event which is too large for an EIT section is ignored, the segment keeps one section.
+void EITGeneratorTest::testLargeEvent()
+{
+    ts::DuckContext duck(&NULLREP);
+    ts::EITGenerator gen(duck);
+    const ts::Time now(2021, 3, 10, 12, 0);
+    gen.setTransportStreamId(TS_ID);
+    gen.setCurrentTime(now);
+
+    // Two regular events for EIT present/following in the current segment.
+    const ts::ServiceIdTriplet srv(1, TS_ID, 1);
+    LoadEvents(gen, srv, now, 2);
+
+    // In the next segment, 16 descriptors of 255 bytes: larger than the maximum payload of an EIT section.
+    const ts::ByteBlock ev(Event(100, now + 4 * ts::MilliSecPerHour, ts::MilliSecPerHour, 0x55, 16, 253));
+    TSUNIT_ASSERT(ts::EIT::EIT_PAYLOAD_FIXED_SIZE + ev.size() > ts::MAX_PRIVATE_LONG_SECTION_PAYLOAD_SIZE);
+    TSUNIT_ASSERT(gen.loadEvents(srv, ev.data(), ev.size()));
+
+    std::vector<ts::ByteBlock> sections;
+    SaveEITs(gen, sections);
+    TSUNIT_EQUAL(1, CheckScheduleNumbering(sections, now));
+
+    size_t count = 0;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const uint8_t* data = sections[i].data();
+        if (ts::EIT::IsSchedule(data[0])) {
+            count++;
+            TSUNIT_EQUAL(data[6], data[12]); // one section in the segment
+        }
+    }
+    TSUNIT_EQUAL(6, count); // segments from midnight to the large event
+}
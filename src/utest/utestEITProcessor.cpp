@@ -0,0 +1,178 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::EITProcessor
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITProcessor.h"
+#include "tsOneShotPacketizer.h"
+#include "tsSectionDemux.h"
+#include "tsDuckContext.h"
+#include "tsFileUtils.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class EITProcessorTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testDropSections();
+    void testSpillSections();
+
+    TSUNIT_TEST_BEGIN(EITProcessorTest);
+    TSUNIT_TEST(testDropSections);
+    TSUNIT_TEST(testSpillSections);
+    TSUNIT_TEST_END();
+
+private:
+    // Number of small EIT sections after the big one.
+    static constexpr size_t SMALL_COUNT = 300;
+
+    // Run an EIT processor with a burst of sections, return the list of output table id extensions.
+    static void Run(std::vector<uint16_t>& tid_ext, const ts::UString& spill_dir, size_t& max_spilled);
+};
+
+TSUNIT_REGISTER(EITProcessorTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void EITProcessorTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void EITProcessorTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Collect the table id extensions of all sections.
+    class SectionCollector: public ts::SectionHandlerInterface
+    {
+    public:
+        SectionCollector(std::vector<uint16_t>& tid_ext) : _tid_ext(tid_ext) {}
+        virtual void handleSection(ts::SectionDemux& demux, const ts::Section& section) override
+        {
+            _tid_ext.push_back(section.tableIdExtension());
+        }
+    private:
+        std::vector<uint16_t>& _tid_ext;
+    };
+}
+
+// The input is one big EIT section on PID 0x12, followed by many small EIT sections on
+// PID 0x100. While the big section is packetized in the output PID, the small sections
+// accumulate in the EIT processor. Then, packets without section from PID 0x200 give
+// the EIT processor some room to output the buffered sections.
+void EITProcessorTest::Run(std::vector<uint16_t>& tid_ext, const ts::UString& spill_dir, size_t& max_spilled)
+{
+    ts::DuckContext duck;
+    ts::EITProcessor proc(duck);
+    proc.addInputPID(0x0100);
+    proc.addInputPID(0x0200);
+    proc.setMaxBufferedSections(ts::EITProcessor::MIN_BUFFERED_SECTIONS);
+    proc.setSpillDirectory(spill_dir);
+    max_spilled = 0;
+
+    ts::TSPacketVector input;
+    ts::TSPacketVector pkts;
+    uint8_t payload[4000];
+    ::memset(payload, 0, sizeof(payload));
+
+    ts::OneShotPacketizer big(duck, ts::PID_EIT);
+    big.addSection(new ts::Section(ts::TID_EIT_S_ACT_MIN, true, 0xFFFF, 0, true, 0, 0, payload, sizeof(payload)));
+    big.getPackets(pkts);
+    input.insert(input.end(), pkts.begin(), pkts.end());
+
+    ts::OneShotPacketizer small(duck, 0x0100);
+    for (size_t i = 0; i < SMALL_COUNT; ++i) {
+        small.addSection(new ts::Section(ts::TID_EIT_PF_ACT, true, uint16_t(i), 0, true, 0, 0, payload, 6));
+    }
+    small.getPackets(pkts);
+    input.insert(input.end(), pkts.begin(), pkts.end());
+
+    ts::TSPacket empty(ts::NullPacket);
+    empty.setPID(0x0200);
+    input.insert(input.end(), 100, empty);
+
+    tid_ext.clear();
+    SectionCollector collector(tid_ext);
+    ts::SectionDemux demux(duck, nullptr, &collector);
+    demux.addPID(ts::PID_EIT);
+
+    for (auto it = input.begin(); it != input.end(); ++it) {
+        proc.processPacket(*it);
+        max_spilled = std::max(max_spilled, proc.getCurrentSpilledSections());
+        TSUNIT_ASSERT(proc.getCurrentBufferedSections() <= ts::EITProcessor::MIN_BUFFERED_SECTIONS);
+        demux.feedPacket(*it);
+    }
+    TSUNIT_EQUAL(0, proc.getCurrentSpilledSections());
+}
+
+void EITProcessorTest::testDropSections()
+{
+    std::vector<uint16_t> tid_ext;
+    size_t max_spilled = 0;
+    Run(tid_ext, ts::UString(), max_spilled);
+    debug() << "EITProcessorTest::testDropSections: output sections: " << tid_ext.size() << std::endl;
+    TSUNIT_EQUAL(0, max_spilled);
+    TSUNIT_ASSERT(tid_ext.size() < SMALL_COUNT + 1);
+}
+
+void EITProcessorTest::testSpillSections()
+{
+    std::vector<uint16_t> tid_ext;
+    size_t max_spilled = 0;
+    Run(tid_ext, ts::TempDirectory(), max_spilled);
+    debug() << "EITProcessorTest::testSpillSections: max spilled sections: " << max_spilled << std::endl;
+    TSUNIT_ASSERT(max_spilled > 0);
+
+    // All sections must be present, in the same order.
+    TSUNIT_EQUAL(SMALL_COUNT + 1, tid_ext.size());
+    TSUNIT_EQUAL(0xFFFF, tid_ext[0]);
+    for (size_t i = 0; i < SMALL_COUNT; ++i) {
+        TSUNIT_EQUAL(i, tid_ext[i + 1]);
+    }
+}
@@ -0,0 +1,266 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for FlatPIDMap class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsFlatPIDMap.h"
+#include "tsContinuityAnalyzer.h"
+#include "tsSectionDemux.h"
+#include "tsDuckContext.h"
+#include "tsTSPacket.h"
+#include "tsMonotonic.h"
+#include "tsNullReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class FlatPIDMapTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testAccess();
+    void testIterator();
+    void testCopy();
+    void testBenchmark();
+
+    TSUNIT_TEST_BEGIN(FlatPIDMapTest);
+    TSUNIT_TEST(testAccess);
+    TSUNIT_TEST(testIterator);
+    TSUNIT_TEST(testCopy);
+    TSUNIT_TEST(testBenchmark);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(FlatPIDMapTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void FlatPIDMapTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void FlatPIDMapTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void FlatPIDMapTest::testAccess()
+{
+    ts::FlatPIDMap<int> map;
+    const ts::FlatPIDMap<int>& cmap(map);
+
+    TSUNIT_ASSERT(map.empty());
+    TSUNIT_EQUAL(0, map.size());
+    TSUNIT_ASSERT(map.begin() == map.end());
+    TSUNIT_ASSERT(map.find(100) == map.end());
+    TSUNIT_EQUAL(0, map.count(100));
+
+    map[100] = 1;
+    map[0] = 2;
+    map[ts::PID_NULL] = 3;
+    TSUNIT_EQUAL(3, map.size());
+    TSUNIT_EQUAL(1, map.count(100));
+    TSUNIT_EQUAL(1, map[100]);
+    TSUNIT_EQUAL(2, map[0]);
+    TSUNIT_EQUAL(3, map[ts::PID_NULL]);
+    TSUNIT_EQUAL(0, map[200]);
+    TSUNIT_EQUAL(4, map.size());
+
+    auto it = map.find(100);
+    TSUNIT_ASSERT(it != map.end());
+    TSUNIT_EQUAL(100, it->first);
+    TSUNIT_EQUAL(1, it->second);
+    it->second = 10;
+    TSUNIT_EQUAL(10, cmap.find(100)->second);
+    TSUNIT_ASSERT(cmap.find(101) == cmap.end());
+
+    TSUNIT_EQUAL(1, map.erase(100));
+    TSUNIT_EQUAL(0, map.erase(100));
+    TSUNIT_EQUAL(3, map.size());
+    TSUNIT_ASSERT(map.find(100) == map.end());
+
+    map.clear();
+    TSUNIT_ASSERT(map.empty());
+    TSUNIT_ASSERT(map.begin() == map.end());
+}
+
+void FlatPIDMapTest::testIterator()
+{
+    ts::FlatPIDMap<ts::UString> map;
+    map[ts::PID_NULL] = u"null";
+    map[ts::PID_PAT] = u"pat";
+    map[ts::PID_SDT] = u"sdt";
+    map[1000] = u"pmt";
+
+    // Increasing PID order, with iterator and const_iterator.
+    std::vector<ts::PID> pids;
+    for (ts::FlatPIDMap<ts::UString>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        pids.push_back(it->first);
+    }
+    TSUNIT_EQUAL(4, pids.size());
+    TSUNIT_EQUAL(ts::PID_PAT, pids[0]);
+    TSUNIT_EQUAL(ts::PID_SDT, pids[1]);
+    TSUNIT_EQUAL(1000, pids[2]);
+    TSUNIT_EQUAL(ts::PID_NULL, pids[3]);
+
+    ts::UString all;
+    for (const auto& it : map) {
+        all.append(it.second);
+    }
+    TSUNIT_EQUAL(u"patsdtpmtnull", all);
+
+    // Erase while iterating.
+    for (auto it = map.begin(); it != map.end(); ) {
+        if (it->first == ts::PID_SDT || it->first == ts::PID_NULL) {
+            it = map.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    TSUNIT_EQUAL(2, map.size());
+    TSUNIT_EQUAL(ts::PID_PAT, map.begin()->first);
+    TSUNIT_EQUAL(u"pmt", (++map.begin())->second);
+}
+
+void FlatPIDMapTest::testCopy()
+{
+    ts::FlatPIDMap<ts::UString> map1;
+    map1[10] = u"ten";
+    map1[20] = u"twenty";
+
+    ts::FlatPIDMap<ts::UString> map2(map1);
+    TSUNIT_EQUAL(2, map2.size());
+    TSUNIT_EQUAL(u"ten", map2[10]);
+    map2[10] = u"TEN";
+    TSUNIT_EQUAL(u"ten", map1[10]);
+
+    ts::FlatPIDMap<ts::UString> map3(std::move(map2));
+    TSUNIT_EQUAL(2, map3.size());
+    TSUNIT_EQUAL(u"TEN", map3[10]);
+
+    map3 = map1;
+    TSUNIT_EQUAL(u"ten", map3[10]);
+    TSUNIT_EQUAL(u"twenty", map3[20]);
+    TSUNIT_EQUAL(2, map3.size());
+}
+
+namespace {
+    // Display a number of packets per second.
+    ts::UString PacketsPerSecond(size_t count, ts::NanoSecond duration)
+    {
+        return duration <= 0 ? ts::UString(u"too fast to measure") : ts::UString::Format(u"%'d packets/s", {(uint64_t(count) * ts::NanoSecPerSec) / uint64_t(duration)});
+    }
+
+    // Per-PID context for the benchmark, similar to the context of ContinuityAnalyzer.
+    struct Context
+    {
+        Context() : count(0), cc(0) {}
+        size_t  count;
+        uint8_t cc;
+    };
+}
+
+void FlatPIDMapTest::testBenchmark()
+{
+    // Microbenchmark, results are displayed in debug mode only.
+    // A typical TS with 40 PID's, spread over the PID range.
+    const size_t pid_count = 40;
+    const size_t packet_count = 2000000;
+    std::vector<ts::PID> pids(packet_count);
+    for (size_t i = 0; i < packet_count; ++i) {
+        pids[i] = ts::PID(((i * 7) % pid_count) * 197 + 16);
+    }
+
+    // Per-packet context lookup, with std::map (before) and FlatPIDMap (after).
+    std::map<ts::PID, Context> tree;
+    ts::FlatPIDMap<Context> flat;
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < packet_count; ++i) {
+        Context& ctx(tree[pids[i]]);
+        ctx.count++;
+        ctx.cc = uint8_t(i & 0x0F);
+    }
+    const ts::NanoSecond tree_duration = ts::Monotonic(true) - start;
+    start.getSystemTime();
+    for (size_t i = 0; i < packet_count; ++i) {
+        Context& ctx(flat[pids[i]]);
+        ctx.count++;
+        ctx.cc = uint8_t(i & 0x0F);
+    }
+    const ts::NanoSecond flat_duration = ts::Monotonic(true) - start;
+    debug() << "FlatPIDMapTest: context lookup, std::map: " << PacketsPerSecond(packet_count, tree_duration) << std::endl;
+    debug() << "FlatPIDMapTest: context lookup, FlatPIDMap: " << PacketsPerSecond(packet_count, flat_duration) << std::endl;
+
+    TSUNIT_EQUAL(pid_count, tree.size());
+    TSUNIT_EQUAL(pid_count, flat.size());
+    for (const auto& it : tree) {
+        TSUNIT_EQUAL(it.second.count, flat[it.first].count);
+    }
+
+    // Complete classes which use FlatPIDMap for each packet.
+    std::vector<ts::TSPacket> packets(packet_count / 10);
+    std::vector<uint8_t> cc(ts::PID_MAX, 0);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i] = ts::NullPacket;
+        packets[i].setPID(pids[i]);
+        packets[i].setCC(cc[pids[i]]++ & 0x0F);
+    }
+
+    ts::ContinuityAnalyzer cc_analyzer(ts::AllPIDs, &NULLREP);
+    start.getSystemTime();
+    for (auto& pkt : packets) {
+        cc_analyzer.feedPacket(pkt);
+    }
+    debug() << "FlatPIDMapTest: ContinuityAnalyzer: " << PacketsPerSecond(packets.size(), ts::Monotonic(true) - start) << std::endl;
+
+    ts::DuckContext duck;
+    ts::SectionDemux demux(duck, nullptr, nullptr, ts::AllPIDs);
+    start.getSystemTime();
+    for (const auto& pkt : packets) {
+        demux.feedPacket(pkt);
+    }
+    debug() << "FlatPIDMapTest: SectionDemux: " << PacketsPerSecond(packets.size(), ts::Monotonic(true) - start) << std::endl;
+}
@@ -63,6 +63,7 @@ public:
     void testGitHub();
     void testFactory();
     void testQuery();
+    void testDiff();
     void testRunningDocumentEmpty();
     void testRunningDocument();
 
@@ -71,6 +72,7 @@ public:
     TSUNIT_TEST(testGitHub);
     TSUNIT_TEST(testFactory);
     TSUNIT_TEST(testQuery);
+    TSUNIT_TEST(testDiff);
     TSUNIT_TEST(testRunningDocumentEmpty);
     TSUNIT_TEST(testRunningDocument);
     TSUNIT_TEST_END();
@@ -730,6 +732,46 @@ void JsonTest::testQuery()
     debug() << "JsonTest::testQuery:" << std::endl << root.printed() << std::endl;
 }
 
+void JsonTest::testDiff()
+{
+    ts::json::ValuePtr from;
+    ts::json::ValuePtr to;
+    ts::json::ValuePtr expected;
+
+    TSUNIT_ASSERT(ts::json::Parse(from,
+        u"{\"a\": 1, \"b\": \"foo\", \"c\": {\"d\": true, \"e/f\": 2}, \"g\": [1, 2, 3], \"h\": [4, 5], \"x~\": null}", CERR));
+    TSUNIT_ASSERT(ts::json::Parse(to,
+        u"{\"a\": 1, \"b\": \"bar\", \"c\": {\"d\": false, \"e/f\": 2, \"i\": {}}, \"g\": [1, 7], \"h\": [4, 5, 6, 7], \"x~\": \"y\"}", CERR));
+    TSUNIT_ASSERT(ts::json::Parse(expected,
+        u"["
+        u"  {\"op\": \"replace\", \"path\": \"/b\", \"value\": \"bar\"},"
+        u"  {\"op\": \"replace\", \"path\": \"/c/d\", \"value\": false},"
+        u"  {\"op\": \"add\", \"path\": \"/c/i\", \"value\": {}},"
+        u"  {\"op\": \"replace\", \"path\": \"/g/1\", \"value\": 7},"
+        u"  {\"op\": \"remove\", \"path\": \"/g/2\"},"
+        u"  {\"op\": \"add\", \"path\": \"/h/-\", \"value\": 6},"
+        u"  {\"op\": \"add\", \"path\": \"/h/-\", \"value\": 7},"
+        u"  {\"op\": \"replace\", \"path\": \"/x~0\", \"value\": \"y\"}"
+        u"]", CERR));
+
+    const ts::json::ValuePtr patch(ts::json::Diff(*from, *to));
+    debug() << "JsonTest::testDiff:" << std::endl << patch->printed() << std::endl;
+    TSUNIT_ASSERT(patch->isArray());
+    TSUNIT_ASSERT(ts::json::Equal(*expected, *patch));
+
+    // Identical values, including a deep copy, produce an empty patch.
+    const ts::json::ValuePtr copy(ts::json::Clone(*to));
+    TSUNIT_ASSERT(ts::json::Equal(*to, *copy));
+    TSUNIT_ASSERT(!ts::json::Equal(*from, *copy));
+    TSUNIT_EQUAL(0, ts::json::Diff(*to, *copy)->size());
+
+    // Different types at the root replace the whole document.
+    const ts::json::ValuePtr root(ts::json::Diff(*from, ts::json::Array()));
+    TSUNIT_EQUAL(1, root->size());
+    TSUNIT_EQUAL(u"replace", root->at(0).value(u"op").toString());
+    TSUNIT_EQUAL(u"", root->at(0).value(u"path").toString());
+}
+
 void JsonTest::testRunningDocumentEmpty()
 {
     ts::json::RunningDocument doc(CERR);
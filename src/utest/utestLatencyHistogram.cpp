@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for LatencyHistogram class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsLatencyHistogram.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class LatencyHistogramTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testBuckets();
+    void testStatistics();
+
+    TSUNIT_TEST_BEGIN(LatencyHistogramTest);
+    TSUNIT_TEST(testBuckets);
+    TSUNIT_TEST(testStatistics);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(LatencyHistogramTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void LatencyHistogramTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void LatencyHistogramTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void LatencyHistogramTest::testBuckets()
+{
+    // Small values have their own bucket.
+    for (uint64_t value = 0; value < 32; ++value) {
+        TSUNIT_EQUAL(value, ts::LatencyHistogram::BucketIndex(value));
+        TSUNIT_EQUAL(value, ts::LatencyHistogram::BucketLowest(size_t(value)));
+        TSUNIT_EQUAL(value, ts::LatencyHistogram::BucketHighest(size_t(value)));
+    }
+
+    // Buckets are contiguous and each value is inside its bucket.
+    for (size_t index = 1; index < ts::LatencyHistogram::BUCKET_COUNT; ++index) {
+        TSUNIT_EQUAL(ts::LatencyHistogram::BucketHighest(index - 1) + 1, ts::LatencyHistogram::BucketLowest(index));
+        TSUNIT_EQUAL(index, ts::LatencyHistogram::BucketIndex(ts::LatencyHistogram::BucketLowest(index)));
+        TSUNIT_EQUAL(index, ts::LatencyHistogram::BucketIndex(ts::LatencyHistogram::BucketHighest(index)));
+    }
+    TSUNIT_EQUAL(ts::LatencyHistogram::MAX_VALUE, ts::LatencyHistogram::BucketHighest(ts::LatencyHistogram::BUCKET_COUNT - 1));
+
+    // Relative precision is better than 1/16.
+    for (size_t index = ts::LatencyHistogram::SUB_COUNT; index < ts::LatencyHistogram::BUCKET_COUNT; ++index) {
+        const uint64_t low = ts::LatencyHistogram::BucketLowest(index);
+        const uint64_t high = ts::LatencyHistogram::BucketHighest(index);
+        TSUNIT_ASSERT((high - low) * ts::LatencyHistogram::SUB_COUNT <= low);
+    }
+}
+
+void LatencyHistogramTest::testStatistics()
+{
+    ts::LatencyHistogram histo;
+    TSUNIT_EQUAL(0, histo.count());
+    TSUNIT_EQUAL(0, histo.minimum());
+    TSUNIT_EQUAL(0, histo.maximum());
+    TSUNIT_EQUAL(0, histo.mean());
+    TSUNIT_EQUAL(0, histo.percentile(50.0));
+
+    // 1000 values from 1 to 1000.
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histo.record(value);
+    }
+    TSUNIT_EQUAL(1000, histo.count());
+    TSUNIT_EQUAL(500500, histo.sum());
+    TSUNIT_EQUAL(1, histo.minimum());
+    TSUNIT_EQUAL(1000, histo.maximum());
+    TSUNIT_EQUAL(500, histo.mean());
+    TSUNIT_EQUAL(1, histo.percentile(0.0));
+    TSUNIT_EQUAL(1000, histo.percentile(100.0));
+
+    // Percentiles are accurate within the bucket precision.
+    const uint64_t p50 = histo.percentile(50.0);
+    const uint64_t p99 = histo.percentile(99.0);
+    debug() << "LatencyHistogramTest::testStatistics: p50 = " << p50 << ", p99 = " << p99 << std::endl;
+    TSUNIT_ASSERT(p50 >= 500 && p50 <= 500 + 500 / 16);
+    TSUNIT_ASSERT(p99 >= 990 && p99 <= 1000);
+
+    // Weighted values.
+    histo.record(100000, 1000);
+    TSUNIT_EQUAL(2000, histo.count());
+    TSUNIT_EQUAL(100000, histo.maximum());
+    TSUNIT_ASSERT(histo.percentile(75.0) >= 100000 - 100000 / 16);
+
+    // Out of range values are clamped.
+    histo.record(std::numeric_limits<uint64_t>::max());
+    TSUNIT_EQUAL(ts::LatencyHistogram::MAX_VALUE, histo.maximum());
+
+    histo.clear();
+    TSUNIT_EQUAL(0, histo.count());
+    TSUNIT_EQUAL(0, histo.maximum());
+}
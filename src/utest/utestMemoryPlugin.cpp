@@ -34,6 +34,7 @@
 #include "tsPluginEventHandlerInterface.h"
 #include "tsPluginEventData.h"
 #include "tsTSProcessor.h"
+#include "tsInputSwitcher.h"
 #include "tsAsyncReport.h"
 #include "tsunit.h"
 
@@ -49,9 +50,11 @@ public:
     virtual void afterTest() override;
 
     void testAll();
+    void testHotStandby();
 
     TSUNIT_TEST_BEGIN(MemoryPluginTest);
     TSUNIT_TEST(testAll);
+    TSUNIT_TEST(testHotStandby);
     TSUNIT_TEST_END();
 };
 
@@ -254,3 +257,44 @@ void MemoryPluginTest::testAll()
     TSUNIT_EQUAL(0, ::memcmp(&output_packets[0], REF_PACKETS, ts::PKT_SIZE * REF_PACKETS_COUNT));
     TSUNIT_EQUAL(u"", log_buffer);
 }
+
+void MemoryPluginTest::testHotStandby()
+{
+    // A stream with a duplicate packet, a signaled discontinuity and a random access point.
+    ts::TSPacketVector input_packets;
+    input_packets.push_back(REF_PACKETS[0]);
+    input_packets.push_back(REF_PACKETS[0]);
+    input_packets.push_back(REF_PACKETS[1]);
+    input_packets.back().setCC(1);
+    input_packets.push_back(REF_PACKETS[2]);
+    input_packets.back().setCC(9);
+    TSUNIT_ASSERT(input_packets.back().setDiscontinuityIndicator(true));
+    input_packets.push_back(REF_PACKETS[1]);
+    input_packets.back().setCC(10);
+    TSUNIT_ASSERT(input_packets.back().setPCR(27000000, true));
+    TSUNIT_ASSERT(input_packets.back().setRandomAccessIndicator(true));
+
+    ts::UString log_buffer;
+    TestReport log(log_buffer);
+
+    ts::TSPacketVector output_packets;
+    Input input(input_packets.data(), input_packets.size());
+    Output output(output_packets);
+
+    ts::InputSwitcherArgs opt;
+    opt.hotStandby = true;
+    opt.inputs.push_back(ts::PluginOptions(u"memory"));
+    opt.output.set(u"memory");
+
+    ts::InputSwitcher tsswitch(log);
+    tsswitch.registerEventHandler(&input, ts::PluginType::INPUT);
+    tsswitch.registerEventHandler(&output, ts::PluginType::OUTPUT);
+
+    TSUNIT_ASSERT(tsswitch.start(opt));
+    tsswitch.waitForTermination();
+
+    // Without input switch, the packets are not modified.
+    TSUNIT_EQUAL(input_packets.size(), output_packets.size());
+    TSUNIT_EQUAL(0, ::memcmp(output_packets.data(), input_packets.data(), ts::PKT_SIZE * input_packets.size()));
+    TSUNIT_EQUAL(u"", log_buffer);
+}
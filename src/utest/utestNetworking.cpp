@@ -70,6 +70,7 @@ public:
     void testIPv6SocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPSocketBatch();
     void testIPHeader();
 
     TSUNIT_TEST_BEGIN(NetworkingTest);
@@ -83,6 +84,7 @@ public:
     TSUNIT_TEST(testIPv6SocketAddress);
     TSUNIT_TEST(testTCPSocket);
     TSUNIT_TEST(testUDPSocket);
+    TSUNIT_TEST(testUDPSocketBatch);
     TSUNIT_TEST(testIPHeader);
     TSUNIT_TEST_END();
 
@@ -715,6 +717,94 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+// Test batched send and receive.
+void NetworkingTest::testUDPSocketBatch()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const size_t msgCount = 20;
+
+    // Create receiver socket.
+    ts::UDPSocket receiver(true);
+    TSUNIT_ASSERT(receiver.isOpen());
+    TSUNIT_ASSERT(receiver.reusePort(true, CERR));
+    TSUNIT_ASSERT(receiver.bind(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+
+    // Create sender socket.
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(sender.setDefaultDestination(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+    ts::SocketAddress senderAddress;
+    TSUNIT_ASSERT(sender.getLocalAddress(senderAddress, CERR));
+
+    // Send messages of distinct sizes and contents in one batch.
+    std::vector<ts::ByteBlock> messages(msgCount);
+    std::vector<const void*> data(msgCount);
+    std::vector<size_t> sizes(msgCount);
+    for (size_t i = 0; i < msgCount; ++i) {
+        messages[i].resize(10 + 50 * i, uint8_t(i));
+        data[i] = messages[i].data();
+        sizes[i] = messages[i].size();
+    }
+    TSUNIT_ASSERT(sender.sendBatch(data.data(), sizes.data(), msgCount, CERR));
+
+    // Receive all messages, in as many batches as necessary.
+    ts::ByteBlock buffer(msgCount * 2048);
+    std::vector<ts::UDPSocket::Datagram> msgs;
+    for (size_t i = 0; i < msgCount; ++i) {
+        msgs.push_back(ts::UDPSocket::Datagram(buffer.data() + i * 2048, 2048));
+    }
+    size_t received = 0;
+    while (received < msgCount) {
+        size_t count = 0;
+        TSUNIT_ASSERT(receiver.receiveBatch(msgs.data(), msgCount - received, count, nullptr, CERR));
+        TSUNIT_ASSERT(count > 0);
+        TSUNIT_ASSERT(count <= msgCount - received);
+        CERR.debug(u"UDPSocketTest: received %d messages in one batch", {count});
+        for (size_t i = 0; i < count; ++i) {
+            const ts::ByteBlock& ref(messages[received + i]);
+            TSUNIT_EQUAL(ref.size(), msgs[i].size);
+            TSUNIT_ASSERT(::memcmp(ref.data(), msgs[i].data, ref.size()) == 0);
+            TSUNIT_ASSERT(msgs[i].sender == senderAddress);
+            TSUNIT_ASSERT(!msgs[i].destination.hasAddress() || ts::IPAddress(msgs[i].destination) == ts::IPAddress::LocalHost);
+        }
+        received += count;
+    }
+
+    // Same with segmentation offload and zero-copy, when supported by the system.
+    // Messages of identical size, except the last one, are sent in one single buffer.
+    if (sender.setSendSegmentation(true, NULLREP)) {
+        const bool zeroCopy = sender.setZeroCopy(true, NULLREP);
+        CERR.debug(u"UDPSocketTest: testing segmentation offload, zero-copy: %s", {zeroCopy});
+        for (size_t i = 0; i < msgCount; ++i) {
+            messages[i].resize(i == msgCount - 1 ? 500 : 1316);
+            ::memset(messages[i].data(), int(i + 100), messages[i].size());
+            data[i] = messages[i].data();
+            sizes[i] = messages[i].size();
+        }
+        TSUNIT_ASSERT(sender.sendBatch(data.data(), sizes.data(), msgCount, CERR));
+        // With zero-copy, the transmission completes asynchronously. Without, it completes in sendBatch().
+        TSUNIT_ASSERT(sender.waitZeroCopy(messages[0].data(), messages[0].size(), CERR));
+        TSUNIT_ASSERT(!sender.zeroCopyBusy(messages[0].data(), messages[0].size(), CERR));
+        TSUNIT_ASSERT(sender.waitZeroCopy(CERR));
+        received = 0;
+        while (received < msgCount) {
+            size_t count = 0;
+            TSUNIT_ASSERT(receiver.receiveBatch(msgs.data(), msgCount - received, count, nullptr, CERR));
+            TSUNIT_ASSERT(count > 0);
+            for (size_t i = 0; i < count; ++i) {
+                const ts::ByteBlock& ref(messages[received + i]);
+                TSUNIT_EQUAL(ref.size(), msgs[i].size);
+                TSUNIT_ASSERT(::memcmp(ref.data(), msgs[i].data, ref.size()) == 0);
+                TSUNIT_ASSERT(msgs[i].sender == senderAddress);
+            }
+            received += count;
+        }
+    }
+}
+
 // Test IP header
 void NetworkingTest::testIPHeader()
 {
@@ -35,6 +35,9 @@
 #include "tsAbstractTable.h"
 #include "tsMGT.h"
 #include "tsLDT.h"
+#include "tsBinaryTable.h"
+#include "tsDuckContext.h"
+#include "tsMonotonic.h"
 #include "tsunit.h"
 
 
@@ -50,10 +53,12 @@ public:
 
     void testRegistrations();
     void testSharedTID();
+    void testBenchmark();
 
     TSUNIT_TEST_BEGIN(PSIRepositoryTest);
     TSUNIT_TEST(testRegistrations);
     TSUNIT_TEST(testSharedTID);
+    TSUNIT_TEST(testBenchmark);
     TSUNIT_TEST_END();
 };
 
@@ -139,3 +144,46 @@ void PSIRepositoryTest::testSharedTID()
     TSUNIT_ASSERT(ts::MGT::DisplaySection == ts::PSIRepository::Instance()->getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_PSIP));
     TSUNIT_ASSERT(ts::LDT::DisplaySection == ts::PSIRepository::Instance()->getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_LDT));
 }
+
+void PSIRepositoryTest::testBenchmark()
+{
+    // Microbenchmark on all registered tables, results are displayed in debug mode only.
+    // Each table is serialized and deserialized in its default state. This mostly
+    // exercises the section headers and fixed bit fields of each table.
+    ts::DuckContext duck;
+    ts::UStringList names;
+    ts::PSIRepository::Instance()->getRegisteredTableNames(names);
+
+    std::vector<ts::AbstractTablePtr> tables;
+    std::vector<ts::BinaryTablePtr> binaries;
+    for (const auto& name : names) {
+        ts::PSIRepository::TableFactory factory = ts::PSIRepository::Instance()->getTableFactory(name);
+        TSUNIT_ASSERT(factory != nullptr);
+        ts::AbstractTablePtr table(factory());
+        TSUNIT_ASSERT(!table.isNull());
+        ts::BinaryTablePtr bin(new ts::BinaryTable);
+        table->serialize(duck, *bin);
+        if (bin->isValid()) {
+            tables.push_back(table);
+            binaries.push_back(bin);
+        }
+    }
+    TSUNIT_ASSERT(!tables.empty());
+
+    const size_t count = 2000;
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t t = 0; t < tables.size(); ++t) {
+            tables[t]->deserialize(duck, *binaries[t]);
+            tables[t]->serialize(duck, *binaries[t]);
+        }
+    }
+    const ts::NanoSecond duration = ts::Monotonic(true) - start;
+
+    for (size_t t = 0; t < tables.size(); ++t) {
+        TSUNIT_ASSERT(tables[t]->isValid());
+        TSUNIT_ASSERT(binaries[t]->isValid());
+    }
+    debug() << "PSIRepositoryTest::testBenchmark: " << tables.size() << " tables, "
+            << (duration / ts::NanoSecond(count * tables.size())) << " ns per round trip" << std::endl;
+}
@@ -0,0 +1,200 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PacketReserve
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketReserve.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PacketReserveTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testDropOldest();
+    void testDropNullFirst();
+    void testFlush();
+
+    TSUNIT_TEST_BEGIN(PacketReserveTest);
+    TSUNIT_TEST(testDropOldest);
+    TSUNIT_TEST(testDropNullFirst);
+    TSUNIT_TEST(testFlush);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(PacketReserveTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PacketReserveTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void PacketReserveTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Write packets at the end of a reserve. Each packet is identified by its
+    // continuity counter and by a label in its metadata. A null PID is used
+    // for the indexes in the set of null packets.
+    void Append(ts::PacketReserve& reserve, size_t first, size_t count, std::initializer_list<size_t> nulls = {})
+    {
+        TSUNIT_ASSERT(reserve.count() + count <= reserve.capacity());
+        ts::TSPacket* pkt = reserve.freePackets();
+        ts::TSPacketMetadata* data = reserve.freeMetadata();
+        for (size_t i = 0; i < count; ++i) {
+            const size_t index = first + i;
+            const bool null = std::find(nulls.begin(), nulls.end(), index) != nulls.end();
+            pkt[i].init(null ? ts::PID(ts::PID_NULL) : ts::PID(100), uint8_t(index & ts::CC_MASK));
+            data[i].reset();
+            data[i].setLabel(index % ts::TSPacketMetadata::LABEL_COUNT);
+        }
+        reserve.commit(count);
+    }
+
+    // Move all packets out of a reserve and return their indexes.
+    std::vector<size_t> Content(ts::PacketReserve& reserve)
+    {
+        ts::TSPacketVector pkts(reserve.count());
+        ts::TSPacketMetadataVector data(reserve.count());
+        TSUNIT_EQUAL(pkts.size(), reserve.flush(pkts.data(), data.data(), pkts.size()));
+        TSUNIT_ASSERT(reserve.empty());
+
+        std::vector<size_t> indexes;
+        for (size_t i = 0; i < pkts.size(); ++i) {
+            const size_t index = pkts[i].getCC();
+            TSUNIT_ASSERT(data[i].hasLabel(index % ts::TSPacketMetadata::LABEL_COUNT));
+            indexes.push_back(index);
+        }
+        return indexes;
+    }
+}
+
+void PacketReserveTest::testDropOldest()
+{
+    ts::PacketReserve reserve(8, false);
+    TSUNIT_EQUAL(8, reserve.capacity());
+    TSUNIT_ASSERT(reserve.empty());
+
+    TSUNIT_EQUAL(0, reserve.makeRoom(4));
+    Append(reserve, 0, 4, {1, 2});
+    TSUNIT_EQUAL(0, reserve.makeRoom(4));
+    Append(reserve, 4, 4);
+    TSUNIT_EQUAL(8, reserve.count());
+    TSUNIT_EQUAL(0, reserve.droppedCount());
+
+    // The oldest packets are dropped, null or not.
+    TSUNIT_EQUAL(3, reserve.makeRoom(3));
+    TSUNIT_EQUAL(5, reserve.count());
+    TSUNIT_EQUAL(3, reserve.droppedCount());
+    Append(reserve, 8, 3);
+
+    const std::vector<size_t> expected({3, 4, 5, 6, 7, 8, 9, 10});
+    TSUNIT_ASSERT(Content(reserve) == expected);
+
+    // Making room for more than the capacity drops everything.
+    Append(reserve, 0, 5);
+    TSUNIT_EQUAL(5, reserve.makeRoom(100));
+    TSUNIT_ASSERT(reserve.empty());
+    TSUNIT_EQUAL(8, reserve.droppedCount());
+}
+
+void PacketReserveTest::testDropNullFirst()
+{
+    ts::PacketReserve reserve(8, true);
+    Append(reserve, 0, 8, {1, 3, 6});
+
+    // The three null packets are dropped first, then the oldest packet.
+    TSUNIT_EQUAL(4, reserve.makeRoom(4));
+    TSUNIT_EQUAL(4, reserve.count());
+    Append(reserve, 8, 4, {9});
+
+    std::vector<size_t> expected({2, 4, 5, 7, 8, 9, 10, 11});
+    TSUNIT_ASSERT(Content(reserve) == expected);
+
+    // Only the oldest null packets are dropped when there are enough of them.
+    Append(reserve, 0, 8, {2, 4, 5, 7});
+    TSUNIT_EQUAL(2, reserve.makeRoom(2));
+    expected = {0, 1, 3, 5, 6, 7};
+    TSUNIT_ASSERT(Content(reserve) == expected);
+    TSUNIT_EQUAL(6, reserve.droppedCount());
+
+    // Reset the reserve, with the other policy.
+    reserve.reset(4, false);
+    TSUNIT_EQUAL(4, reserve.capacity());
+    TSUNIT_EQUAL(0, reserve.droppedCount());
+    Append(reserve, 0, 4, {3});
+    TSUNIT_EQUAL(1, reserve.makeRoom(1));
+    expected = {1, 2, 3};
+    TSUNIT_ASSERT(Content(reserve) == expected);
+}
+
+void PacketReserveTest::testFlush()
+{
+    ts::PacketReserve reserve(10);
+    Append(reserve, 0, 6);
+
+    ts::TSPacket pkts[4];
+    ts::TSPacketMetadata data[4];
+
+    TSUNIT_EQUAL(4, reserve.flush(pkts, data, 4));
+    TSUNIT_EQUAL(2, reserve.count());
+    for (size_t i = 0; i < 4; ++i) {
+        TSUNIT_EQUAL(i, pkts[i].getCC());
+        TSUNIT_ASSERT(data[i].hasLabel(i));
+    }
+
+    // Packets which are appended after a flush come after the remaining ones.
+    Append(reserve, 6, 2);
+    TSUNIT_EQUAL(4, reserve.flush(pkts, data, 4));
+    TSUNIT_ASSERT(reserve.empty());
+    for (size_t i = 0; i < 4; ++i) {
+        TSUNIT_EQUAL(i + 4, pkts[i].getCC());
+    }
+    TSUNIT_EQUAL(0, reserve.flush(pkts, data, 4));
+}
@@ -0,0 +1,108 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for PluginMetrics class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPluginMetrics.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PluginMetricsTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testMetrics();
+
+    TSUNIT_TEST_BEGIN(PluginMetricsTest);
+    TSUNIT_TEST(testMetrics);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(PluginMetricsTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PluginMetricsTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void PluginMetricsTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PluginMetricsTest::testMetrics()
+{
+    ts::PluginMetrics metrics;
+    ts::PluginMetrics::SampleList samples;
+
+    metrics.getSamples(samples);
+    TSUNIT_ASSERT(samples.empty());
+
+    ts::PluginMetrics::Metric& errors(metrics.metric(u"errors", ts::PluginMetrics::Type::COUNTER, u"Number of errors"));
+    ts::PluginMetrics::Metric& level(metrics.metric(u"level", ts::PluginMetrics::Type::GAUGE));
+    errors.add();
+    errors.add(4);
+    level.set(-12);
+
+    // Same name, same metric, type and description unchanged.
+    ts::PluginMetrics::Metric& again(metrics.metric(u"errors", ts::PluginMetrics::Type::GAUGE, u"other"));
+    TSUNIT_ASSERT(&again == &errors);
+    again.add();
+
+    metrics.getSamples(samples);
+    TSUNIT_EQUAL(2, samples.size());
+    auto it = samples.begin();
+    TSUNIT_EQUAL(u"errors", it->name);
+    TSUNIT_ASSERT(it->type == ts::PluginMetrics::Type::COUNTER);
+    TSUNIT_EQUAL(u"Number of errors", it->help);
+    TSUNIT_EQUAL(6, it->value);
+    ++it;
+    TSUNIT_EQUAL(u"level", it->name);
+    TSUNIT_ASSERT(it->type == ts::PluginMetrics::Type::GAUGE);
+    TSUNIT_ASSERT(it->help.empty());
+    TSUNIT_EQUAL(-12, it->value);
+}
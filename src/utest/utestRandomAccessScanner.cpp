@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::RandomAccessScanner
+//
+//----------------------------------------------------------------------------
+
+#include "tsRandomAccessScanner.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class RandomAccessScannerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testScan();
+
+    TSUNIT_TEST_BEGIN(RandomAccessScannerTest);
+    TSUNIT_TEST(testScan);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(RandomAccessScannerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void RandomAccessScannerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void RandomAccessScannerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Build a packet.
+    ts::TSPacket Packet(ts::PID pid, bool pcr, bool rap)
+    {
+        ts::TSPacket pkt;
+        pkt.init(pid);
+        if (pcr) {
+            TSUNIT_ASSERT(pkt.setPCR(0, true));
+        }
+        if (rap) {
+            TSUNIT_ASSERT(pkt.setRandomAccessIndicator(true));
+        }
+        return pkt;
+    }
+}
+
+void RandomAccessScannerTest::testScan()
+{
+    // PID 200 is audio, PID 100 is video with PCR.
+    ts::TSPacketVector pkts;
+    pkts.push_back(Packet(100, false, true));  // 0: before the first PCR
+    pkts.push_back(Packet(200, false, true));  // 1: audio
+    pkts.push_back(Packet(100, true, false));  // 2: first PCR
+    pkts.push_back(Packet(200, false, true));  // 3: audio
+    pkts.push_back(Packet(100, true, true));   // 4: video random access point
+    pkts.push_back(Packet(300, true, true));   // 5: other PCR PID
+    pkts.push_back(Packet(100, false, true));  // 6: video random access point
+    pkts.push_back(Packet(200, false, true));  // 7: audio
+
+    ts::RandomAccessScanner scanner;
+    TSUNIT_EQUAL(ts::PID_NULL, scanner.referencePID());
+
+    // Before the first PCR, there is no random access point.
+    TSUNIT_ASSERT(!scanner.feedPackets(pkts.data(), 2));
+    TSUNIT_EQUAL(ts::PID_NULL, scanner.referencePID());
+    TSUNIT_EQUAL(2, scanner.firstRandomAccess(pkts.data(), 2));
+    TSUNIT_EQUAL(ts::NPOS, scanner.lastRandomAccess(pkts.data(), 2));
+
+    // The reference PID is found only once.
+    TSUNIT_ASSERT(scanner.feedPackets(pkts.data() + 2, pkts.size() - 2));
+    TSUNIT_EQUAL(100, scanner.referencePID());
+    TSUNIT_ASSERT(!scanner.feedPackets(pkts.data(), pkts.size()));
+    TSUNIT_EQUAL(100, scanner.referencePID());
+
+    // Random access points on other PID's are ignored.
+    TSUNIT_ASSERT(scanner.isRandomAccess(pkts[0]));
+    TSUNIT_ASSERT(!scanner.isRandomAccess(pkts[1]));
+    TSUNIT_ASSERT(!scanner.isRandomAccess(pkts[2]));
+    TSUNIT_ASSERT(!scanner.isRandomAccess(pkts[5]));
+    TSUNIT_EQUAL(0, scanner.firstRandomAccess(pkts.data(), pkts.size()));
+    TSUNIT_EQUAL(3, scanner.firstRandomAccess(pkts.data() + 1, pkts.size() - 1));
+    TSUNIT_EQUAL(6, scanner.lastRandomAccess(pkts.data(), pkts.size()));
+    TSUNIT_EQUAL(4, scanner.lastRandomAccess(pkts.data(), 6));
+    TSUNIT_EQUAL(1, scanner.firstRandomAccess(pkts.data() + 5, 3));
+    TSUNIT_EQUAL(2, scanner.firstRandomAccess(pkts.data() + 1, 2));
+
+    // After reset, no more reference PID.
+    scanner.reset();
+    TSUNIT_EQUAL(ts::PID_NULL, scanner.referencePID());
+    TSUNIT_EQUAL(ts::NPOS, scanner.lastRandomAccess(pkts.data(), pkts.size()));
+}
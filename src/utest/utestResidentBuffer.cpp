@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsResidentBuffer.h"
+#include "tsSysInfo.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 
 
@@ -46,9 +48,13 @@ public:
     virtual void afterTest() override;
 
     void testResidentBuffer();
+    void testHugePages();
+    void testNUMANode();
 
     TSUNIT_TEST_BEGIN(ResidentBufferTest);
     TSUNIT_TEST(testResidentBuffer);
+    TSUNIT_TEST(testHugePages);
+    TSUNIT_TEST(testNUMANode);
     TSUNIT_TEST_END();
 };
 
@@ -86,3 +92,54 @@ void ResidentBufferTest::testResidentBuffer()
     TSUNIT_ASSERT(buf.isLocked());
     TSUNIT_ASSERT(buf.count() >= buf_size);
 }
+
+void ResidentBufferTest::testHugePages()
+{
+    // Not a multiple of any page size.
+    const size_t buf_size = 3 * 1024 * 1024 + 5;
+    const size_t huge_page_size = ts::SysInfo::Instance()->hugeMemoryPageSize();
+
+    ts::ResidentBuffer<uint32_t> buf(buf_size, true);
+
+    debug() << "ResidentBufferTest: huge page size = " << huge_page_size << ", isHugePages() = " << buf.isHugePages()
+            << ", isLocked() = " << buf.isLocked() << ", count() = " << buf.count() << std::endl;
+
+    // Without huge pages in the system, fall back to normal pages.
+    if (huge_page_size == 0) {
+        TSUNIT_ASSERT(!buf.isHugePages());
+    }
+    TSUNIT_ASSERT(!buf.isNUMABound());
+    TSUNIT_ASSERT(buf.base() != nullptr);
+    TSUNIT_ASSERT(buf.count() >= buf_size);
+    TSUNIT_EQUAL(0, size_t(buf.base()) % ts::SysInfo::Instance()->memoryPageSize());
+
+    // The whole buffer must be usable, whatever the allocation method.
+    for (size_t i = 0; i < buf_size; ++i) {
+        buf.base()[i] = uint32_t(i);
+    }
+    TSUNIT_EQUAL(buf_size - 1, buf.base()[buf_size - 1]);
+}
+
+void ResidentBufferTest::testNUMANode()
+{
+    const size_t buf_size = 100000;
+
+    // Binding on an existing node, without and with huge pages.
+    for (int huge = 0; huge < 2; ++huge) {
+        ts::ResidentBuffer<uint8_t> buf(buf_size, huge != 0, 0);
+        debug() << "ResidentBufferTest: NUMA node 0, huge pages: " << huge << ", isNUMABound() = " << buf.isNUMABound() << std::endl;
+        TSUNIT_ASSERT(buf.base() != nullptr);
+        TSUNIT_ASSERT(buf.count() >= buf_size);
+        ::memset(buf.base(), 0x47, buf_size);
+        TSUNIT_EQUAL(0x47, buf.base()[buf_size - 1]);
+    }
+
+    // Binding on a non-existent node fails but the buffer is still usable.
+    const int node = int(ts::NUMANodeCount() + 100);
+    ts::ResidentBuffer<uint8_t> buf(buf_size, true, node);
+    TSUNIT_ASSERT(!buf.isNUMABound());
+    TSUNIT_ASSERT(buf.base() != nullptr);
+    TSUNIT_ASSERT(buf.count() >= buf_size);
+    ::memset(buf.base(), 0x47, buf_size);
+    TSUNIT_EQUAL(0x47, buf.base()[0]);
+}
@@ -114,6 +114,24 @@ void SectionTest::testBAT()
     TSUNIT_EQUAL(ts::TID_BAT, sec.tableId());
     TSUNIT_EQUAL(ts::PID_BAT, sec.sourcePID());
     TSUNIT_ASSERT(sec.isLongSection());
+
+    // Shared content is not overwritten.
+    ts::Section shared(sec, ts::ShareMode::SHARE);
+    sec.reload(psi_tot_tnt_sections, sizeof(psi_tot_tnt_sections), ts::PID_TOT, ts::CRC32::CHECK);
+    TSUNIT_ASSERT(sec.isValid());
+    TSUNIT_EQUAL(ts::TID_TOT, sec.tableId());
+    TSUNIT_ASSERT(shared.isValid());
+    TSUNIT_EQUAL(ts::TID_BAT, shared.tableId());
+    TSUNIT_EQUAL(sizeof(psi_bat_tvnum_sections), shared.size());
+
+    // Unshared content is reused.
+    const uint8_t* const content = sec.content();
+    sec.reload(psi_tot_tnt_sections, sizeof(psi_tot_tnt_sections), ts::PID_TDT, ts::CRC32::CHECK);
+    TSUNIT_ASSERT(sec.isValid());
+    TSUNIT_EQUAL(ts::TID_TOT, sec.tableId());
+    TSUNIT_EQUAL(ts::PID_TDT, sec.sourcePID());
+    TSUNIT_ASSERT(content == sec.content());
+    TSUNIT_EQUAL(0, ::memcmp(psi_tot_tnt_sections, sec.content(), sizeof(psi_tot_tnt_sections)));
 }
 
 void SectionTest::testNIT()
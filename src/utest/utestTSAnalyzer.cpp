@@ -0,0 +1,375 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerSnapshot.h"
+#include "tsDuckContext.h"
+#include "tsTSPacket.h"
+#include "tsjsonObject.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+#include "tables/psi_pat_r4_packets.h"
+#include "tables/psi_pmt_planete_packets.h"
+#include "tables/psi_sdt_r3_packets.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testThreads();
+    void testSnapshot();
+    void testBackground();
+
+    TSUNIT_TEST_BEGIN(TSAnalyzerTest);
+    TSUNIT_TEST(testThreads);
+    TSUNIT_TEST(testSnapshot);
+    TSUNIT_TEST(testBackground);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(TSAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSAnalyzerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TSAnalyzerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Build a synthetic transport stream with signalization, PCR, scrambling and discontinuities.
+    void BuildStream(ts::TSPacketVector& packets)
+    {
+        ts::TSPacketVector psi;
+        for (const uint8_t* p = psi_pat_r4_packets; p < psi_pat_r4_packets + sizeof(psi_pat_r4_packets); p += ts::PKT_SIZE) {
+            psi.push_back(*reinterpret_cast<const ts::TSPacket*>(p));
+        }
+        for (const uint8_t* p = psi_pmt_planete_packets; p < psi_pmt_planete_packets + sizeof(psi_pmt_planete_packets); p += ts::PKT_SIZE) {
+            psi.push_back(*reinterpret_cast<const ts::TSPacket*>(p));
+        }
+        for (const uint8_t* p = psi_sdt_r3_packets; p < psi_sdt_r3_packets + sizeof(psi_sdt_r3_packets); p += ts::PKT_SIZE) {
+            psi.push_back(*reinterpret_cast<const ts::TSPacket*>(p));
+        }
+
+        const size_t count = 50000;
+        std::vector<uint8_t> cc(ts::PID_MAX, 0);
+        packets.clear();
+        for (size_t i = 0; i < count; ++i) {
+            ts::TSPacket pkt;
+            if (i % 1000 < psi.size()) {
+                pkt = psi[i % 1000];
+            }
+            else {
+                const ts::PID pid = ts::PID(i % 7 == 0 ? 163 : 100 + (i * 13) % 40);
+                pkt = ts::NullPacket;
+                pkt.setPID(pid);
+                pkt.setPUSI(i % 11 == 0);
+                pkt.setScrambling(pid % 3 == 0 && (i / 500) % 2 == 0 ? ts::SC_EVEN_KEY : ts::SC_CLEAR);
+                if (pid == 163 && i % 35 == 0) {
+                    pkt.setPCR(uint64_t(i) * ts::PKT_SIZE_BITS * ts::SYSTEM_CLOCK_FREQ / 20000000, true);
+                }
+                // Some discontinuities and duplicated packets.
+                if (i % 997 == 0) {
+                    cc[pid] += 3;
+                }
+                else if (i % 1999 != 0) {
+                    cc[pid]++;
+                }
+                pkt.setCC(cc[pid] & ts::CC_MASK);
+            }
+            packets.push_back(pkt);
+        }
+    }
+
+    // Analyze the stream and return the full report.
+    ts::UString Analyze(const ts::TSPacketVector& packets, size_t threads, bool json)
+    {
+        ts::DuckContext duck;
+        ts::TSAnalyzerOptions opt;
+        opt.ts_analysis = opt.service_analysis = opt.pid_analysis = opt.table_analysis = opt.error_analysis = true;
+        opt.deterministic = true;
+        opt.json.json = json;
+        opt.analysis_threads = threads;
+
+        ts::TSAnalyzerReport analyzer(duck);
+        analyzer.setAnalysisOptions(opt);
+        for (size_t i = 0; i < packets.size(); ++i) {
+            analyzer.feedPacket(packets[i]);
+            // Intermediate reports must not break the analysis.
+            if (i == packets.size() / 2) {
+                analyzer.reportToString(opt);
+            }
+        }
+        return analyzer.reportToString(opt);
+    }
+}
+
+void TSAnalyzerTest::testThreads()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    const ts::UString ref_text(Analyze(packets, 0, false));
+    const ts::UString ref_json(Analyze(packets, 0, true));
+    debug() << "TSAnalyzerTest::testThreads: reference report:" << std::endl << ref_text << std::endl;
+
+    TSUNIT_ASSERT(ref_text.contain(u"TRANSPORT STREAM ANALYSIS REPORT"));
+    TSUNIT_EQUAL(ref_text, Analyze(packets, 1, false));
+    TSUNIT_EQUAL(ref_text, Analyze(packets, 2, false));
+    TSUNIT_EQUAL(ref_text, Analyze(packets, 4, false));
+    TSUNIT_EQUAL(ref_json, Analyze(packets, 3, true));
+}
+
+namespace {
+    // Apply a JSON patch, as produced by json::Diff(), on a document.
+    void ApplyPatch(ts::json::Value& doc, const ts::json::Value& patch)
+    {
+        for (size_t i = 0; i < patch.size(); ++i) {
+            const ts::json::Value& op(patch.at(i));
+            ts::UStringVector tokens;
+            op.value(u"path").toString().split(tokens, u'/', false, false);
+            TSUNIT_ASSERT(!tokens.empty() && tokens[0].empty());
+            // Navigate to the parent of the target.
+            ts::json::Value* parent = &doc;
+            for (size_t t = 1; t + 1 < tokens.size(); ++t) {
+                tokens[t].substitute(u"~1", u"/");
+                tokens[t].substitute(u"~0", u"~");
+                size_t index = 0;
+                parent = parent->isArray() && tokens[t].toInteger(index) ? &parent->at(index) : &parent->value(tokens[t]);
+            }
+            ts::UString last(tokens.back());
+            last.substitute(u"~1", u"/");
+            last.substitute(u"~0", u"~");
+            const ts::UString type(op.value(u"op").toString());
+            size_t index = 0;
+            if (parent->isArray()) {
+                if (type == u"remove" && last.toInteger(index)) {
+                    parent->erase(index);
+                }
+                else if (type == u"add" && last == u"-") {
+                    parent->set(ts::json::Clone(op.value(u"value")));
+                }
+                else if (type == u"replace" && last.toInteger(index)) {
+                    parent->set(ts::json::Clone(op.value(u"value")), index);
+                }
+                else {
+                    TSUNIT_FAIL("unexpected array operation");
+                }
+            }
+            else if (type == u"remove") {
+                parent->remove(last);
+            }
+            else {
+                parent->add(last, ts::json::Clone(op.value(u"value")));
+            }
+        }
+    }
+
+    // Report a snapshot and parse it back.
+    bool ReadSnapshot(const ts::TSAnalyzerSnapshot& snapshot, const ts::TSAnalyzerOptions& opt, uint64_t& sequence, ts::json::ValuePtr& value)
+    {
+        std::stringstream stm;
+        if (!snapshot.report(opt.json, stm, sequence)) {
+            return false;
+        }
+        TSUNIT_ASSERT(ts::json::Parse(value, ts::UString::FromUTF8(stm.str()), CERR));
+        return true;
+    }
+}
+
+void TSAnalyzerTest::testSnapshot()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    ts::DuckContext duck;
+    ts::TSAnalyzerOptions opt;
+    opt.ts_analysis = opt.service_analysis = opt.pid_analysis = opt.table_analysis = opt.error_analysis = true;
+    opt.deterministic = true;
+    opt.json.json = true;
+
+    ts::TSAnalyzerReport analyzer(duck);
+    analyzer.setAnalysisOptions(opt);
+    ts::TSAnalyzerSnapshot snapshot;
+
+    uint64_t seq = 0;
+    ts::json::ValuePtr full;
+    ts::json::ValuePtr patch;
+
+    // Nothing published yet.
+    TSUNIT_ASSERT(!ReadSnapshot(snapshot, opt, seq, full));
+    TSUNIT_EQUAL(0, seq);
+
+    // First snapshot: a complete report.
+    for (size_t i = 0; i < packets.size() / 2; ++i) {
+        analyzer.feedPacket(packets[i]);
+    }
+    TSUNIT_ASSERT(snapshot.publish(analyzer, opt));
+    TSUNIT_ASSERT(ReadSnapshot(snapshot, opt, seq, full));
+    TSUNIT_EQUAL(1, seq);
+    TSUNIT_ASSERT(full->isObject());
+    TSUNIT_ASSERT(!ReadSnapshot(snapshot, opt, seq, patch));
+
+    // Second snapshot: a patch which transforms the first report into the second one.
+    for (size_t i = packets.size() / 2; i < packets.size(); ++i) {
+        analyzer.feedPacket(packets[i]);
+    }
+    TSUNIT_ASSERT(snapshot.publish(analyzer, opt));
+    TSUNIT_ASSERT(ReadSnapshot(snapshot, opt, seq, patch));
+    TSUNIT_EQUAL(2, seq);
+    TSUNIT_ASSERT(patch->isArray());
+    TSUNIT_ASSERT(patch->size() > 0);
+    debug() << "TSAnalyzerTest::testSnapshot: patch:" << std::endl << patch->printed() << std::endl;
+
+    ts::json::Object expected;
+    analyzer.buildJSON(opt, expected);
+    TSUNIT_ASSERT(!ts::json::Equal(expected, *full));
+    ApplyPatch(*full, *patch);
+    TSUNIT_ASSERT(ts::json::Equal(expected, *full));
+
+    // A reader which missed a snapshot gets a complete report.
+    uint64_t late = 0;
+    ts::json::ValuePtr other;
+    TSUNIT_ASSERT(ReadSnapshot(snapshot, opt, late, other));
+    TSUNIT_EQUAL(2, late);
+    TSUNIT_ASSERT(ts::json::Equal(expected, *other));
+
+    // Without new packets, the next patch is empty. After reset, the next snapshot is complete.
+    TSUNIT_ASSERT(snapshot.publish(analyzer, opt));
+    TSUNIT_ASSERT(ReadSnapshot(snapshot, opt, seq, patch));
+    TSUNIT_ASSERT(patch->isArray());
+    TSUNIT_EQUAL(0, patch->size());
+    snapshot.reset();
+    TSUNIT_ASSERT(snapshot.publish(analyzer, opt));
+    TSUNIT_ASSERT(ReadSnapshot(snapshot, opt, seq, other));
+    TSUNIT_EQUAL(4, seq);
+    TSUNIT_ASSERT(other->isObject());
+}
+
+namespace {
+    // Collect the snapshots which are published by a background analysis.
+    class SnapshotCollector: public ts::TSAnalyzerSnapshotHandlerInterface
+    {
+    public:
+        SnapshotCollector(const ts::TSAnalyzerOptions& opt) : sequence(0), values(), _opt(opt) {}
+        uint64_t sequence;
+        std::vector<ts::json::ValuePtr> values;
+        virtual void handleSnapshot(ts::TSAnalyzerSnapshot& snapshot) override
+        {
+            ts::json::ValuePtr value;
+            TSUNIT_ASSERT(ReadSnapshot(snapshot, _opt, sequence, value));
+            values.push_back(value);
+        }
+    private:
+        const ts::TSAnalyzerOptions& _opt;
+    };
+}
+
+void TSAnalyzerTest::testBackground()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    ts::DuckContext duck;
+    ts::TSAnalyzerOptions opt;
+    opt.ts_analysis = opt.service_analysis = opt.pid_analysis = opt.table_analysis = opt.error_analysis = true;
+    opt.deterministic = true;
+    opt.json.json = true;
+
+    // Reference: synchronous analysis.
+    ts::TSAnalyzerReport ref_analyzer(duck);
+    ref_analyzer.setAnalysisOptions(opt);
+    ts::json::Object ref_half;
+    ts::json::Object ref_full;
+    for (size_t i = 0; i < packets.size() / 2; ++i) {
+        ref_analyzer.feedPacket(packets[i]);
+    }
+    ref_analyzer.buildJSON(opt, ref_half);
+    for (size_t i = packets.size() / 2; i < packets.size(); ++i) {
+        ref_analyzer.feedPacket(packets[i]);
+    }
+    ref_analyzer.buildJSON(opt, ref_full);
+
+    // Background analysis, same snapshots.
+    ts::TSAnalyzerReport analyzer(duck);
+    analyzer.setAnalysisOptions(opt);
+    ts::TSAnalyzerSnapshot snapshot;
+    SnapshotCollector collector(opt);
+
+    TSUNIT_ASSERT(snapshot.startBackground(analyzer, opt, ts::UString(), &collector));
+    TSUNIT_ASSERT(!snapshot.startBackground(analyzer, opt, ts::UString(), &collector));
+    for (size_t i = 0; i < packets.size() / 2; ++i) {
+        snapshot.feedPacket(packets[i]);
+    }
+    snapshot.requestPublish();
+    for (size_t i = packets.size() / 2; i < packets.size(); ++i) {
+        snapshot.feedPacket(packets[i]);
+    }
+    snapshot.requestPublish();
+    snapshot.stopBackground();
+
+    // All snapshots are published when the background analysis is stopped.
+    TSUNIT_EQUAL(2, collector.values.size());
+    TSUNIT_EQUAL(2, collector.sequence);
+    TSUNIT_ASSERT(collector.values[0]->isObject());
+    TSUNIT_ASSERT(collector.values[1]->isArray());
+    TSUNIT_ASSERT(ts::json::Equal(ref_half, *collector.values[0]));
+    ApplyPatch(*collector.values[0], *collector.values[1]);
+    TSUNIT_ASSERT(ts::json::Equal(ref_full, *collector.values[0]));
+
+    // After stopping the background analysis, the analyzer can be used synchronously.
+    ts::json::Object after;
+    analyzer.buildJSON(opt, after);
+    TSUNIT_ASSERT(ts::json::Equal(ref_full, after));
+}
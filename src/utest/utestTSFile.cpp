@@ -57,6 +57,9 @@ public:
     void testDuck();
     void testStuffingRead();
     void testStuffingWrite();
+    void testReadModes();
+    void testWriteBehind();
+    void testWriteBehindAbort();
 
     TSUNIT_TEST_BEGIN(TSFileTest);
     TSUNIT_TEST(testTS);
@@ -64,6 +67,9 @@ public:
     TSUNIT_TEST(testDuck);
     TSUNIT_TEST(testStuffingRead);
     TSUNIT_TEST(testStuffingWrite);
+    TSUNIT_TEST(testReadModes);
+    TSUNIT_TEST(testWriteBehind);
+    TSUNIT_TEST(testWriteBehindAbort);
     TSUNIT_TEST_END();
 
 private:
@@ -395,3 +401,137 @@ void TSFileTest::testStuffingWrite()
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+void TSFileTest::testReadModes()
+{
+    // M2TS file larger than several io_uring requests.
+    const size_t file_count = 10000;
+    const size_t skip_count = 10;
+    const size_t repeat_count = 3;
+
+    ts::TSFile file;
+    ts::TSPacket packet(ts::NullPacket);
+    ts::TSPacketMetadata mdata;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR, ts::TSPacketFormat::M2TS));
+    for (size_t i = 0; i < file_count; ++i) {
+        packet.setPID(ts::PID(i % 8000));
+        mdata.setInputTimeStamp(i, ts::SYSTEM_CLOCK_FREQ, ts::TimeSource::UNDEFINED);
+        TSUNIT_ASSERT(file.writePackets(&packet, &mdata, 1, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(file_count * (4 + ts::PKT_SIZE), ts::GetFileSize(_tempFileName));
+
+    for (int mode = ts::TSFile::READ_SYSCALL; mode <= ts::TSFile::READ_IO_URING; ++mode) {
+        debug() << "TSFileTest::testReadModes: mode " << ts::TSFile::ReadModeEnum.name(mode) << std::endl;
+
+        // Repeated read with start offset, by chunks which are not aligned on request boundaries.
+        file.setReadMode(ts::TSFile::ReadMode(mode));
+        TSUNIT_EQUAL(mode, file.readMode());
+        TSUNIT_ASSERT(file.openRead(_tempFileName, repeat_count, skip_count * (4 + ts::PKT_SIZE), CERR));
+        ts::TSPacketVector packets(777);
+        ts::TSPacketMetadataVector mdatas(packets.size());
+        size_t index = skip_count;
+        size_t count = 0;
+        while ((count = file.readPackets(packets.data(), mdatas.data(), packets.size(), CERR)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_EQUAL(index % 8000, packets[i].getPID());
+                TSUNIT_EQUAL(index, mdatas[i].getInputTimeStamp());
+                if (++index == file_count) {
+                    index = skip_count;
+                }
+            }
+        }
+        TSUNIT_EQUAL(ts::TSPacketFormat::M2TS, file.packetFormat());
+        TSUNIT_EQUAL(repeat_count * (file_count - skip_count), file.readPacketsCount());
+        TSUNIT_ASSERT(file.close(CERR));
+
+        // Rewindable mode with explicit seek.
+        TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR, ts::TSPacketFormat::M2TS));
+        TSUNIT_ASSERT(file.seek(9000, CERR));
+        TSUNIT_EQUAL(1, file.readPackets(&packet, &mdata, 1, CERR));
+        TSUNIT_EQUAL(1000, packet.getPID());
+        TSUNIT_ASSERT(file.seek(3, CERR));
+        TSUNIT_EQUAL(1, file.readPackets(&packet, &mdata, 1, CERR));
+        TSUNIT_EQUAL(3, packet.getPID());
+        TSUNIT_EQUAL(3, mdata.getInputTimeStamp());
+        TSUNIT_ASSERT(file.close(CERR));
+    }
+}
+
+void TSFileTest::testWriteBehind()
+{
+    // Several write-behind blocks, written by chunks which are not aligned on block boundaries.
+    const size_t file_count = 20000;
+    const size_t append_count = 1000;
+    const size_t stuffing_count = 5;
+
+    ts::TSFile file;
+    ts::TSPacket packet(ts::NullPacket);
+    file.setStuffing(stuffing_count, stuffing_count);
+    file.setWriteBehind(1024 * 1024, true, 3 * 1024 * 1024);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    ts::TSPacketVector packets(333);
+    size_t index = 0;
+    while (index < file_count) {
+        const size_t count = std::min(packets.size(), file_count - index);
+        for (size_t i = 0; i < count; ++i) {
+            packets[i] = ts::NullPacket;
+            packets[i].setPID(ts::PID(index++ % 8000));
+        }
+        TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, count, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL((file_count + 2 * stuffing_count) * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Append to the existing file, starting at an unaligned offset.
+    file.setStuffing(0, 0);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::APPEND, CERR));
+    for (size_t i = 0; i < append_count; ++i) {
+        packet.setPID(ts::PID(i % 8000));
+        TSUNIT_ASSERT(file.writePackets(&packet, nullptr, 1, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL((file_count + 2 * stuffing_count + append_count) * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Read back the complete file.
+    file.setWriteBehind(0);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 1, 0, CERR));
+    index = 0;
+    while (file.readPackets(&packet, nullptr, 1, CERR) == 1) {
+        if (index < stuffing_count || (index >= stuffing_count + file_count && index < 2 * stuffing_count + file_count)) {
+            TSUNIT_EQUAL(ts::PID_NULL, packet.getPID());
+        }
+        else if (index < stuffing_count + file_count) {
+            TSUNIT_EQUAL((index - stuffing_count) % 8000, packet.getPID());
+        }
+        else {
+            TSUNIT_EQUAL((index - 2 * stuffing_count - file_count) % 8000, packet.getPID());
+        }
+        index++;
+    }
+    TSUNIT_EQUAL(file_count + 2 * stuffing_count + append_count, index);
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+void TSFileTest::testWriteBehindAbort()
+{
+    // Abort while the write-behind thread is busy. The file descriptor is closed
+    // only after the last block is completely written, the pending data are lost.
+    const size_t block_size = 1024 * 1024;
+    const size_t packet_count = 8 * block_size / ts::PKT_SIZE;
+
+    ts::TSFile file;
+    file.setWriteBehind(2 * block_size, false, 0);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    ts::TSPacketVector packets(packet_count, ts::NullPacket);
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    file.abort();
+    TSUNIT_ASSERT(!file.writePackets(packets.data(), nullptr, 1, NULLREP));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    const int64_t size = ts::GetFileSize(_tempFileName);
+    debug() << "TSFileTest::testWriteBehindAbort: file size: " << size << std::endl;
+    TSUNIT_ASSERT(size >= 0);
+    TSUNIT_ASSERT(size <= int64_t(packet_count * ts::PKT_SIZE));
+    TSUNIT_EQUAL(0, size % int64_t(block_size));
+}
@@ -0,0 +1,251 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSPacketSharedRing
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketSharedRing.h"
+#include "tsSysUtils.h"
+#include "tsMemory.h"
+#include "tsNullReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSPacketSharedRingTest: public tsunit::Test
+{
+public:
+    TSPacketSharedRingTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testTransfer();
+    void testEviction();
+    void testDrop();
+
+    TSUNIT_TEST_BEGIN(TSPacketSharedRingTest);
+    TSUNIT_TEST(testTransfer);
+    TSUNIT_TEST(testEviction);
+    TSUNIT_TEST(testDrop);
+    TSUNIT_TEST_END();
+
+private:
+    ts::UString _name;
+};
+
+TSUNIT_REGISTER(TSPacketSharedRingTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+TSPacketSharedRingTest::TSPacketSharedRingTest() :
+    _name()
+{
+}
+
+// Test suite initialization method.
+void TSPacketSharedRingTest::beforeTest()
+{
+    _name.format(u"tsduck-utest-%d", {ts::CurrentProcessId()});
+}
+
+// Test suite cleanup method.
+void TSPacketSharedRingTest::afterTest()
+{
+}
+
+namespace {
+    // Build packets with a sequence number in the payload.
+    void BuildPackets(ts::TSPacket* packets, ts::TSPacketMetadata* mdata, size_t count, size_t first)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            packets[i].init(ts::PID(100));
+            ts::PutUInt32(packets[i].b + 4, uint32_t(first + i));
+            mdata[i].reset();
+            mdata[i].setLabel((first + i) % 8);
+        }
+    }
+    uint32_t Sequence(const ts::TSPacket& pkt)
+    {
+        return ts::GetUInt32(pkt.b + 4);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSPacketSharedRingTest::testTransfer()
+{
+    if (!ts::TSPacketSharedRing::IsSupported()) {
+        return;
+    }
+
+    ts::TSPacketSharedRing writer;
+    ts::TSPacketSharedRing reader1;
+    ts::TSPacketSharedRing reader2;
+
+    TSUNIT_ASSERT(writer.create(_name, 100, 4, CERR));
+    TSUNIT_ASSERT(writer.isWriter());
+    TSUNIT_EQUAL(100, writer.size());
+    TSUNIT_EQUAL(0, writer.readersCount());
+
+    // A second writer on the same name is rejected.
+    ts::TSPacketSharedRing other;
+    TSUNIT_ASSERT(!other.create(_name, 100, 4, NULLREP));
+
+    TSUNIT_ASSERT(reader1.attach(_name, 0, CERR));
+    TSUNIT_ASSERT(reader2.attach(_name, 0, CERR));
+    TSUNIT_ASSERT(!reader1.isWriter());
+    TSUNIT_EQUAL(100, reader1.size());
+    TSUNIT_EQUAL(2, writer.readersCount());
+
+    writer.setBitrate(1234567);
+    TSUNIT_EQUAL(1234567, reader1.getBitrate().toInt());
+
+    // Write 150 packets in two times, wrapping around the end of the ring.
+    ts::TSPacket packets[100];
+    ts::TSPacketMetadata mdata[100];
+    ts::TSPacket rpackets[100];
+    ts::TSPacketMetadata rmdata[100];
+    size_t next1 = 0;
+    size_t next2 = 0;
+
+    for (size_t round = 0; round < 2; ++round) {
+        BuildPackets(packets, mdata, 75, round * 75);
+        TSUNIT_ASSERT(writer.write(packets, mdata, 75, CERR));
+        for (size_t got = 0; got < 75; ) {
+            const size_t count = reader1.read(rpackets, rmdata, 100, CERR);
+            TSUNIT_ASSERT(count > 0);
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_EQUAL(next1, Sequence(rpackets[i]));
+                TSUNIT_ASSERT(rmdata[i].hasLabel(next1 % 8));
+                next1++;
+            }
+            got += count;
+        }
+        for (size_t got = 0; got < 75; ) {
+            const size_t count = reader2.read(rpackets, nullptr, 100, CERR);
+            TSUNIT_ASSERT(count > 0);
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_EQUAL(next2++, Sequence(rpackets[i]));
+            }
+            got += count;
+        }
+    }
+    TSUNIT_EQUAL(150, next1);
+    TSUNIT_EQUAL(150, next2);
+    TSUNIT_EQUAL(0, reader1.lostPackets());
+
+    // End of stream after the remaining packets.
+    BuildPackets(packets, mdata, 10, 150);
+    TSUNIT_ASSERT(writer.write(packets, mdata, 10, CERR));
+    TSUNIT_ASSERT(writer.close(CERR));
+    TSUNIT_EQUAL(10, reader1.read(rpackets, rmdata, 100, CERR));
+    TSUNIT_EQUAL(150, Sequence(rpackets[0]));
+    TSUNIT_EQUAL(0, reader1.read(rpackets, rmdata, 100, CERR));
+    TSUNIT_ASSERT(reader1.close(CERR));
+    TSUNIT_ASSERT(reader2.close(CERR));
+
+    // The ring no longer exists.
+    TSUNIT_ASSERT(!reader1.attach(_name, 0, NULLREP));
+}
+
+void TSPacketSharedRingTest::testEviction()
+{
+    if (!ts::TSPacketSharedRing::IsSupported()) {
+        return;
+    }
+
+    ts::TSPacketSharedRing writer;
+    ts::TSPacketSharedRing reader;
+    TSUNIT_ASSERT(writer.create(_name, 10, 4, CERR));
+    TSUNIT_ASSERT(reader.attach(_name, 0, CERR));
+    writer.setBackPressure(false, 50);
+
+    // The reader does not read, the writer blocks and evicts it.
+    ts::TSPacket packets[30];
+    ts::TSPacketMetadata mdata[30];
+    BuildPackets(packets, mdata, 30, 0);
+    TSUNIT_ASSERT(writer.write(packets, mdata, 30, NULLREP));
+    TSUNIT_EQUAL(0, writer.readersCount());
+
+    // The reader resynchronizes on the live point.
+    ts::TSPacket rpackets[30];
+    TSUNIT_ASSERT(writer.write(packets, mdata, 5, CERR));
+    reader.setReceiveTimeout(50);
+    TSUNIT_EQUAL(0, reader.read(rpackets, nullptr, 30, NULLREP));
+    TSUNIT_EQUAL(35, reader.lostPackets());
+    TSUNIT_EQUAL(1, writer.readersCount());
+    TSUNIT_ASSERT(writer.write(packets + 7, mdata + 7, 3, CERR));
+    TSUNIT_EQUAL(3, reader.read(rpackets, nullptr, 30, CERR));
+    TSUNIT_EQUAL(7, Sequence(rpackets[0]));
+
+    TSUNIT_ASSERT(reader.close(CERR));
+    TSUNIT_ASSERT(writer.close(CERR));
+}
+
+void TSPacketSharedRingTest::testDrop()
+{
+    if (!ts::TSPacketSharedRing::IsSupported()) {
+        return;
+    }
+
+    ts::TSPacketSharedRing writer;
+    ts::TSPacketSharedRing reader;
+    TSUNIT_ASSERT(writer.create(_name, 10, 4, CERR));
+    TSUNIT_ASSERT(reader.attach(_name, 0, CERR));
+    writer.setBackPressure(true);
+
+    // The writer never blocks, the reader is overrun and restarts on the oldest packet.
+    ts::TSPacket packets[25];
+    ts::TSPacketMetadata mdata[25];
+    BuildPackets(packets, mdata, 25, 0);
+    TSUNIT_ASSERT(writer.write(packets, mdata, 25, CERR));
+    TSUNIT_ASSERT(writer.close(CERR));
+
+    ts::TSPacket rpackets[25];
+    ts::TSPacketMetadata rmdata[25];
+    TSUNIT_EQUAL(5, reader.read(rpackets, rmdata, 25, NULLREP));
+    TSUNIT_EQUAL(15, Sequence(rpackets[0]));
+    TSUNIT_EQUAL(5, reader.read(rpackets, rmdata, 25, NULLREP));
+    TSUNIT_EQUAL(20, Sequence(rpackets[0]));
+    TSUNIT_EQUAL(0, reader.read(rpackets, rmdata, 25, NULLREP));
+    TSUNIT_EQUAL(15, reader.lostPackets());
+    TSUNIT_ASSERT(reader.close(CERR));
+}
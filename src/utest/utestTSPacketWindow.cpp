@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSPacketWindow.h"
+#include "tsTSPacketHeaderScan.h"
 #include "tsunit.h"
 
 
@@ -46,9 +47,11 @@ public:
     virtual void afterTest() override;
 
     void testAll();
+    void testHeaderScan();
 
     TSUNIT_TEST_BEGIN(TSPacketWindowTest);
     TSUNIT_TEST(testAll);
+    TSUNIT_TEST(testHeaderScan);
     TSUNIT_TEST_END();
 };
 
@@ -171,3 +174,87 @@ void TSPacketWindowTest::testAll()
     TSUNIT_EQUAL(map[7], win.packetIndexInBuffer(7, packets, 10));
     TSUNIT_EQUAL(ts::NPOS, win.packetIndexInBuffer(11, packets, 10));
 }
+
+void TSPacketWindowTest::testHeaderScan()
+{
+    // Physical buffer of packets with all combinations of header bits,
+    // more than one vectorized block, plus some trailing packets.
+    const size_t count = 1000;
+    ts::TSPacketVector packets(count);
+    for (size_t i = 0; i < count; ++i) {
+        packets[i] = ts::NullPacket;
+        ts::TSPacket& pkt(packets[i]);
+        pkt.b[0] = i % 97 == 5 ? 0x48 : ts::SYNC_BYTE;
+        pkt.b[1] = uint8_t(i * 37);
+        pkt.b[2] = uint8_t(i * 11 + 3);
+        pkt.b[3] = uint8_t(i * 13 + 7);
+        pkt.b[4] = uint8_t(i % 5 == 0 ? 0 : i % 183);
+        pkt.b[5] = uint8_t(i * 29);
+    }
+
+    // Check against the accessors of TSPacket.
+    ts::TSPacketHeaderScan scan;
+    scan.scan(packets.data(), count);
+    TSUNIT_EQUAL(count, scan.size());
+    for (size_t i = 0; i < count; ++i) {
+        const ts::TSPacket& pkt(packets[i]);
+        const uint8_t flags = scan.flags(i);
+        TSUNIT_EQUAL(pkt.getPID(), scan.pid(i));
+        TSUNIT_EQUAL(pkt.getPID(), scan.pids()[i]);
+        TSUNIT_EQUAL(pkt.getCC(), scan.cc(i));
+        TSUNIT_EQUAL(pkt.getScrambling(), scan.scrambling(i));
+        TSUNIT_EQUAL(pkt.hasValidSync(), scan.isValid(i));
+        TSUNIT_EQUAL(pkt.getPUSI(), (flags & ts::TSPacketHeaderScan::PUSI) != 0);
+        TSUNIT_EQUAL(pkt.getTEI(), (flags & ts::TSPacketHeaderScan::TEI) != 0);
+        TSUNIT_EQUAL(pkt.getPriority(), (flags & ts::TSPacketHeaderScan::PRIORITY) != 0);
+        TSUNIT_EQUAL(pkt.hasAF(), (flags & ts::TSPacketHeaderScan::HAS_AF) != 0);
+        TSUNIT_EQUAL(pkt.hasPayload(), (flags & ts::TSPacketHeaderScan::HAS_PAYLOAD) != 0);
+        TSUNIT_EQUAL(pkt.hasPCR(), (flags & ts::TSPacketHeaderScan::HAS_PCR) != 0);
+        TSUNIT_EQUAL(pkt.getDiscontinuityIndicator(), (flags & ts::TSPacketHeaderScan::DISCONTINUITY) != 0);
+    }
+
+    // Select by PID.
+    ts::PIDSet pids;
+    pids.set(packets[10].getPID());
+    pids.set(packets[500].getPID());
+    std::vector<size_t> indexes;
+    const size_t selected = scan.selectPIDs(indexes, pids);
+    TSUNIT_EQUAL(selected, indexes.size());
+    TSUNIT_ASSERT(selected >= 2);
+    for (auto i : indexes) {
+        TSUNIT_ASSERT(pids.test(packets[i].getPID()));
+        TSUNIT_ASSERT(packets[i].hasValidSync());
+    }
+    TSUNIT_EQUAL(count - selected - count / 97 - 1, scan.selectPIDs(indexes, pids, true));
+
+    // Select by flags.
+    scan.selectFlags(indexes, ts::TSPacketHeaderScan::HAS_PCR);
+    for (auto i : indexes) {
+        TSUNIT_ASSERT(packets[i].hasPCR());
+    }
+
+    // Packet window over non-contiguous segments with dropped packets.
+    std::vector<ts::TSPacketMetadata> mdata(count);
+    ts::TSPacketWindow win;
+    win.addPacketsReference(packets.data() + 500, mdata.data() + 500, 300);
+    win.addPacketsReference(packets.data() + 3, mdata.data() + 3, 17);
+    win.addPacketsReference(packets.data() + 100, mdata.data() + 100, 50);
+    win.drop(2);
+    win.drop(310);
+    scan.scan(win);
+    TSUNIT_EQUAL(367, scan.size());
+    for (size_t i = 0; i < win.size(); ++i) {
+        const ts::TSPacket* pkt = win.packet(i);
+        if (pkt == nullptr) {
+            TSUNIT_ASSERT(!scan.isValid(i));
+        }
+        else {
+            TSUNIT_EQUAL(pkt->getPID(), scan.pid(i));
+            TSUNIT_EQUAL(pkt->getCC(), scan.cc(i));
+            TSUNIT_EQUAL(pkt->hasValidSync(), scan.isValid(i));
+            TSUNIT_EQUAL(pkt->hasPCR(), (scan.flags(i) & ts::TSPacketHeaderScan::HAS_PCR) != 0);
+        }
+    }
+    TSUNIT_ASSERT(!scan.isValid(2));
+    TSUNIT_ASSERT(!scan.isValid(310));
+}
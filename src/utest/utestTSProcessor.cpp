@@ -48,9 +48,13 @@ public:
     virtual void afterTest() override;
 
     void testProcessing();
+    void testLockFree();
+    void testPIDShards();
 
     TSUNIT_TEST_BEGIN(TSProcessorTest);
     TSUNIT_TEST(testProcessing);
+    TSUNIT_TEST(testLockFree);
+    TSUNIT_TEST(testPIDShards);
     TSUNIT_TEST_END();
 };
 
@@ -177,6 +181,83 @@ TestPlugin::Status TestPlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMeta
 }
 
 
+//----------------------------------------------------------------------------
+// Internal packet processing plugins to test PID shards.
+// The plugin "shardsrc" sets the PID of each packet in 0-15.
+// The PID-shardable plugin "shardtest" drops PID 5 and reports its PID's.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ShardPluginData : public ts::Object
+    {
+    public:
+        ts::PIDSet        pids;
+        ts::PacketCounter packets;
+        ShardPluginData() : pids(), packets(0) {}
+    };
+
+    class ShardSourcePlugin : ts::ProcessorPlugin
+    {
+    public:
+        ShardSourcePlugin(ts::TSP* t) : ts::ProcessorPlugin(t) {}
+        virtual Status processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata& metadata) override
+        {
+            pkt.setPID(ts::PID(tsp->pluginPackets() % 16));
+            return TSP_OK;
+        }
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP* t) { return new ShardSourcePlugin(t); }
+    };
+
+    class ShardTestPlugin : ts::ProcessorPlugin
+    {
+    public:
+        ShardTestPlugin(ts::TSP* t) : ts::ProcessorPlugin(t), _data() {}
+        virtual bool start() override
+        {
+            _data.pids.reset();
+            _data.packets = 0;
+            return true;
+        }
+        virtual bool stop() override
+        {
+            tsp->signalPluginEvent(EVENT_SHARD, &_data);
+            return true;
+        }
+        virtual bool isPIDShardable() override { return true; }
+        virtual Status processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata& metadata) override
+        {
+            _data.pids.set(pkt.getPID());
+            _data.packets++;
+            return pkt.getPID() == 5 ? TSP_DROP : TSP_OK;
+        }
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP* t) { return new ShardTestPlugin(t); }
+        static constexpr uint32_t EVENT_SHARD = 0xBEEF0004;
+    private:
+        ShardPluginData _data;
+    };
+
+    class ShardEventHandler : public ts::PluginEventHandlerInterface
+    {
+    public:
+        ShardEventHandler() : pids(), packets() {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& ctx) override
+        {
+            ShardPluginData* data = dynamic_cast<ShardPluginData*>(ctx.pluginData());
+            if (data != nullptr) {
+                pids.push_back(data->pids);
+                packets.push_back(data->packets);
+            }
+        }
+        std::vector<ts::PIDSet> pids;
+        std::vector<ts::PacketCounter> packets;
+    };
+}
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint32_t ShardTestPlugin::EVENT_SHARD;
+#endif
+
+
 //----------------------------------------------------------------------------
 // A test plugin event handler.
 // We don't do the TSUNIT assertions in the event handler (called in plugin
@@ -324,3 +405,78 @@ void TSProcessorTest::testProcessing()
     TSUNIT_EQUAL(3,          handler2.logs[0].count);
     TSUNIT_EQUAL(26,         handler2.logs[0].packets);
 }
+
+void TSProcessorTest::testLockFree()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"test1", TestPlugin::CreateInstance);
+
+    // Long chain of plugins with a small buffer to force many wrap-ups and sleeps.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testLockFree";
+    opt.lock_free = true;
+    opt.lock_free_spin = 10;
+    opt.ts_buffer_size = ts::TSProcessorArgs::MIN_BUFFER_SIZE;
+    opt.input = {u"null", {u"100000"}};
+    opt.plugins = {
+        {u"test1", {u"--count", u"1000"}},
+        {u"test1", {u"--count", u"1000"}},
+        {u"test1", {u"--count", u"1000"}},
+        {u"test1", {u"--count", u"1000"}},
+    };
+    opt.output = {u"drop"};
+
+    ts::TSProcessor tsproc(CERR);
+    TestEventHandler handler;
+    ts::TSProcessor::Criteria crit;
+    crit.event_code = TestPlugin::EVENT_STOP;
+    tsproc.registerEventHandler(&handler, crit);
+
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // All packets went through all plugins.
+    TSUNIT_EQUAL(4, handler.logs.size());
+    for (size_t i = 0; i < handler.logs.size(); ++i) {
+        TSUNIT_EQUAL(0xBEEF0002, handler.logs[i].code);
+        TSUNIT_EQUAL(6,          handler.logs[i].count);
+        TSUNIT_EQUAL(100000,     handler.logs[i].packets);
+    }
+}
+
+void TSProcessorTest::testPIDShards()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"shardsrc", ShardSourcePlugin::CreateInstance);
+    ts::PluginRepository::Instance()->registerProcessor(u"shardtest", ShardTestPlugin::CreateInstance);
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testPIDShards";
+    opt.pid_shards = 4;
+    opt.input = {u"null", {u"16000"}};
+    opt.plugins = {
+        {u"shardsrc", {}},
+        {u"shardtest", {}},
+    };
+    opt.output = {u"drop"};
+
+    ts::TSProcessor tsproc(CERR);
+    ShardEventHandler handler;
+    ts::TSProcessor::Criteria crit;
+    crit.event_code = ShardTestPlugin::EVENT_SHARD;
+    tsproc.registerEventHandler(&handler, crit);
+
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // Four instances of the plugin, each one with a disjoint set of 4 PID's.
+    TSUNIT_EQUAL(4, handler.pids.size());
+    ts::PIDSet all;
+    ts::PacketCounter packets = 0;
+    for (size_t i = 0; i < handler.pids.size(); ++i) {
+        TSUNIT_EQUAL(4, handler.pids[i].count());
+        TSUNIT_ASSERT((all & handler.pids[i]).none());
+        all |= handler.pids[i];
+        packets += handler.packets[i];
+    }
+    TSUNIT_EQUAL(16, all.count());
+    TSUNIT_EQUAL(16000, packets);
+}
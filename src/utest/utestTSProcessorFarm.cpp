@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSProcessorFarm
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSProcessorFarm.h"
+#include "tsNullReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSProcessorFarmTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testChains();
+
+    TSUNIT_TEST_BEGIN(TSProcessorFarmTest);
+    TSUNIT_TEST(testChains);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(TSProcessorFarmTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSProcessorFarmTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TSProcessorFarmTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void TSProcessorFarmTest::testChains()
+{
+    ts::TSProcessorArgs args;
+    args.input.set(u"null", {u"1000"});
+    args.output.set(u"drop");
+    args.plugins.resize(1);
+    args.plugins[0].set(u"count");
+
+    ts::TSProcessorFarm farm(NULLREP);
+    TSUNIT_ASSERT(farm.addChain(u"first", args));
+    TSUNIT_ASSERT(farm.addChain(u"second", args));
+    TSUNIT_ASSERT(farm.addChain(u"third", args, false));
+    TSUNIT_ASSERT(!farm.addChain(u"first", args));
+    TSUNIT_ASSERT(!farm.startChain(u"fourth", NULLREP));
+    TSUNIT_ASSERT(!farm.stopChain(u"third", NULLREP));
+
+    // The statistics reporter is a thread of the chain, it does not fit in the budget.
+    ts::TSProcessorArgs stats_args(args);
+    stats_args.stats_interval = 1000;
+    TSUNIT_ASSERT(farm.addChain(u"stats", stats_args));
+
+    // Only one chain at a time.
+    ts::TSProcessorFarmArgs farm_args;
+    farm_args.thread_budget = 3;
+    TSUNIT_ASSERT(farm.start(farm_args));
+    farm.waitForTermination();
+
+    ts::TSProcessorFarm::ChainStatusVector chains;
+    farm.getChains(chains);
+    TSUNIT_EQUAL(4, chains.size());
+    TSUNIT_EQUAL(u"first", chains[0].name);
+    TSUNIT_EQUAL(3, chains[0].threads);
+    TSUNIT_EQUAL(1, chains[0].starts);
+    TSUNIT_ASSERT(chains[0].state == ts::TSProcessorFarm::ChainState::STOPPED);
+    TSUNIT_EQUAL(u"second", chains[1].name);
+    TSUNIT_EQUAL(1, chains[1].starts);
+    TSUNIT_ASSERT(chains[1].state == ts::TSProcessorFarm::ChainState::STOPPED);
+    TSUNIT_EQUAL(u"stats", chains[2].name);
+    TSUNIT_EQUAL(4, chains[2].threads);
+    TSUNIT_EQUAL(0, chains[2].starts);
+    TSUNIT_ASSERT(chains[2].state == ts::TSProcessorFarm::ChainState::STOPPED);
+    TSUNIT_EQUAL(u"third", chains[3].name);
+    TSUNIT_EQUAL(0, chains[3].starts);
+}
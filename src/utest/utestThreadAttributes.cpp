@@ -44,6 +44,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsThreadAttributes.h"
+#include "tsThread.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 
 
@@ -60,11 +62,17 @@ public:
     void testStackSize();
     void testDeleteWhenTerminated();
     void testPriority();
+    void testCPUAffinity();
+    void testNUMANode();
+    void testCPUList();
 
     TSUNIT_TEST_BEGIN(ThreadAttributesTest);
     TSUNIT_TEST(testStackSize);
     TSUNIT_TEST(testDeleteWhenTerminated);
     TSUNIT_TEST(testPriority);
+    TSUNIT_TEST(testCPUAffinity);
+    TSUNIT_TEST(testNUMANode);
+    TSUNIT_TEST(testCPUList);
     TSUNIT_TEST_END();
 };
 
@@ -133,3 +141,93 @@ void ThreadAttributesTest::testPriority()
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     TSUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+namespace {
+    // A thread which records the CPU it runs on.
+    class CPUThread: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(CPUThread);
+    public:
+        int cpu;
+        explicit CPUThread(const ts::ThreadAttributes& attributes) : ts::Thread(attributes), cpu(-1) {}
+        virtual ~CPUThread() override { waitForTermination(); }
+        virtual void main() override
+        {
+#if defined(TS_LINUX)
+            cpu = ::sched_getcpu();
+#endif
+        }
+    };
+}
+
+void ThreadAttributesTest::testCPUAffinity()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getCPUAffinity().empty()); // default value
+
+    const std::set<size_t> cpus({1, 3});
+    TSUNIT_ASSERT(attr.setCPUAffinity(cpus).getCPUAffinity() == cpus);
+    TSUNIT_ASSERT(attr.setCPUAffinity(std::set<size_t>()).getCPUAffinity().empty());
+
+#if defined(TS_LINUX)
+    // Pin a thread on the last CPU on which this process is allowed to run.
+    ::cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    TSUNIT_EQUAL(0, ::sched_getaffinity(0, sizeof(allowed), &allowed));
+    size_t last = 0;
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            last = cpu;
+        }
+    }
+    CPUThread thread(ts::ThreadAttributes().setCPUAffinity({last}));
+    TSUNIT_ASSERT(thread.start());
+    thread.waitForTermination();
+    debug() << "ThreadAttributesTest: thread pinned on CPU " << last << ", ran on CPU " << thread.cpu << std::endl;
+    TSUNIT_EQUAL(int(last), thread.cpu);
+#endif
+}
+
+void ThreadAttributesTest::testNUMANode()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getNUMANode() < 0); // default value
+    TSUNIT_EQUAL(0, attr.setNUMANode(0).getNUMANode());
+    TSUNIT_EQUAL(2, attr.setNUMANode(2).getNUMANode());
+    TSUNIT_EQUAL(-1, attr.setNUMANode(-1).getNUMANode());
+
+    // A NUMA node and an explicit CPU affinity are independent.
+    attr.setNUMANode(0).setCPUAffinity({0});
+    TSUNIT_EQUAL(0, attr.getNUMANode());
+    TSUNIT_ASSERT(attr.getCPUAffinity() == std::set<size_t>({0}));
+
+    // There is always at least one node. When NUMA topology is available, node 0 has CPU's.
+    TSUNIT_ASSERT(ts::NUMANodeCount() >= 1);
+    std::set<size_t> cpus;
+    if (ts::GetNUMANodeCPUs(0, cpus)) {
+        TSUNIT_ASSERT(!cpus.empty());
+    }
+    TSUNIT_ASSERT(!ts::GetNUMANodeCPUs(ts::NUMANodeCount() + 100, cpus));
+    TSUNIT_ASSERT(cpus.empty());
+}
+
+void ThreadAttributesTest::testCPUList()
+{
+    std::set<size_t> cpus;
+
+    TSUNIT_ASSERT(ts::DecodeCPUList(u"0-3,8,10-11", cpus));
+    TSUNIT_ASSERT(cpus == std::set<size_t>({0, 1, 2, 3, 8, 10, 11}));
+
+    TSUNIT_ASSERT(ts::DecodeCPUList(u"5", cpus));
+    TSUNIT_ASSERT(cpus == std::set<size_t>({5}));
+
+    TSUNIT_ASSERT(ts::DecodeCPUList(u"2-2,0", cpus));
+    TSUNIT_ASSERT(cpus == std::set<size_t>({0, 2}));
+
+    TSUNIT_ASSERT(!ts::DecodeCPUList(u"", cpus));
+    TSUNIT_ASSERT(cpus.empty());
+    TSUNIT_ASSERT(!ts::DecodeCPUList(u"0-3,x", cpus));
+    TSUNIT_ASSERT(cpus.empty());
+    TSUNIT_ASSERT(!ts::DecodeCPUList(u"3-1", cpus));
+    TSUNIT_ASSERT(cpus.empty());
+}